@@ -1,5 +1,6 @@
 #include "PKCAdapter.h"
 #include "runtime/tasksystem.h"
+#include "Proofs/powManager_ops.h"
 
 // =================================================
 // BINDING
@@ -16,17 +17,71 @@ void BlockchainAdapter::bindChain(PKCertChain* c)
 
 void BlockchainAdapter::init()
 {
+    // PoW search and verification share one pool; size it before first use
+    if (poolConfigured)
+        pkc_pool_default_configure(&poolConfig);
+
     if (!chain) return;
 
+    // the log and the chain are reconciled: an empty chain is rebuilt from
+    // the log before falling back to genesis, a loaded one picks up the
+    // records past its tip, and a log that disagrees with it is cut back
+    if (storeConfigured && !storeOpen) {
+        char path[512];
+        if (pkc_chain_store_default_path(chain->NetworkName, path, sizeof(path)) == OP_SUCCESS)
+            storeOpen = pkc_chain_store_open_chain(&store, path, &storeConfig, chain) == OP_SUCCESS;
+    }
+
+    // nothing in the log: bootstrap from a snapshot if one was given; the
+    // writer's first persist then copies those blocks into the log. A
+    // rejected snapshot (damaged, bad PoW, other network) leaves the chain
+    // empty, so it falls through to genesis and is not retried
+    if (chain->index == 0 && !bootstrapPath.empty() &&
+        pkc_snapshot_import_chain(bootstrapPath.c_str(), chain, &snapshotConfig, nullptr) != OP_SUCCESS)
+        bootstrapPath.clear();
+
     // optional: initialize genesis automatically if needed
     if (chain->index == 0) {
         Gensis_Block(chain);
     }
+
+    // from here on only the writer thread appends
+    if (!writerStarted) {
+        if (storeOpen)
+            pkc_chain_store_bind(&store, &writerConfig);
+        writerStarted = pkc_chain_writer_start(&writer, chain, &writerConfig) == OP_SUCCESS;
+    }
 }
 
 void BlockchainAdapter::tick()
 {
-    // telemetry only (future metrics, chain health, etc.)
+    // telemetry only: scrapes are answered from the last snapshot every tick,
+    // shards are re-aggregated at most once per PKC_METRICS_TICK_INTERVAL_NS
+    if (metricsListenFd >= 0 && metricsSnapshot.taken_ns != 0)
+        pkc_metrics_serve_pending(metricsListenFd, &metricsSnapshot);
+
+    const uint64_t now = pkc_metrics_now_ns();
+    if (now - lastMetricsTickNs < PKC_METRICS_TICK_INTERVAL_NS)
+        return;
+    lastMetricsTickNs = now;
+
+    pkc_metrics_gauge_set(PKC_GAUGE_POOL_QUEUED, (int64_t)pkc_pool_queued(pkc_pool_default()));
+    if (writerStarted)
+        pkc_metrics_gauge_set(PKC_GAUGE_CHAIN_WRITER_QUEUED, (int64_t)pkc_chain_writer_queued(&writer));
+    pkc_metrics_aggregate(&pkc_metrics_global, &metricsSnapshot);
+
+    if (!metricsExportPath.empty())
+        pkc_metrics_export_file(&metricsSnapshot, metricsExportPath.c_str());
+}
+
+BlockchainAdapter::~BlockchainAdapter()
+{
+    if (writerStarted)
+        pkc_chain_writer_stop(&writer);
+    if (storeOpen)
+        pkc_chain_store_close(&store);
+    if (metricsListenFd >= 0)
+        close(metricsListenFd);
 }
 
 // =================================================
@@ -38,7 +93,12 @@ TaskHandle BlockchainAdapter::getIndex()
     return taskSystem->submit(
         Input<NoInput>{},
         [this](Input<NoInput>) {
-            return chain->index;
+            if (!writerStarted)
+                return chain->index;
+
+            pkc_chain_tip_t tip{};
+            pkc_chain_tip_copy(&writer, &tip);
+            return tip.index;
         }
     );
 }
@@ -94,10 +154,20 @@ TaskHandle BlockchainAdapter::getBlock(uint32_t index)
         [this](Input<uint32_t> in) -> std::any {
 
             uint32_t i = in.get();
-            if (i >= chain->index)
+            if (!writerStarted) {
+                if (i >= chain->index)
+                    return false;
+                return chain->blocks[i];
+            }
+
+            // committed slots never change, so a copy under a read section is stable
+            uint32_t slot;
+            if (pkc_chain_reader_self(&writer, &slot) != OP_SUCCESS)
                 return false;
-
-            return chain->blocks[i];
+            const block* b = pkc_chain_read_block(&writer, pkc_chain_read_begin(&writer, slot), i);
+            std::any out = b ? std::any(*b) : std::any(false);
+            pkc_chain_read_end(&writer, slot);
+            return out;
         }
     );
 }
@@ -108,11 +178,33 @@ TaskHandle BlockchainAdapter::addBlock(const block& blk)
         Input<block>{blk},
         [this](Input<block> in) -> std::any {
 
-            if (chain->index >= 100)
-                return false;
+            const block& blk = in.get();
+            if (!writerStarted)
+                return pkc_chain_apply(chain, &blk, false) == OP_SUCCESS;
+
+            return pkc_chain_append(&writer, &blk, nullptr) == OP_SUCCESS;
+        }
+    );
+}
 
-            chain->blocks[chain->index++] = in.get();
-            return true;
+TaskHandle BlockchainAdapter::addBlockWithPoW(Tier_t tier)
+{
+    // the search itself fans out on the work pool; cancelMining() stops it
+    return taskSystem->submit(
+        Input<Tier_t>{tier},
+        [this](Input<Tier_t> in) -> std::any {
+            if (!writerStarted)
+                return PKCertChain_AddBlockWithPoW(chain, nullptr, in.get());
+
+            // mine on the published tip, then race the other candidates through the writer
+            pkc_chain_tip_t tip{};
+            pkc_chain_tip_copy(&writer, &tip);
+            block blk;
+            OpStatus_t st = PKCertChain_MineBlock(chain, nullptr, in.get(), &tip, &blk);
+            if (st != OP_SUCCESS)
+                return st;
+            // the writer retargets from the block's own solve as it commits
+            return pkc_chain_append(&writer, &blk, nullptr);
         }
     );
 }
@@ -125,11 +217,15 @@ TaskHandle BlockchainAdapter::setNetworkName(const std::string& name)
 {
     return taskSystem->submit(
         Input<std::string>{name},
-        [this](Input<std::string> in) {
+        [this](Input<std::string> in) -> std::any {
+            // the writer owns the chain once started; its fields are fixed
+            if (writerStarted)
+                return OP_INVALID_STATE;
 
             const auto& n = in.get();
             strncpy(chain->NetworkName, n.c_str(), sizeof(chain->NetworkName) - 1);
             chain->NetworkName[63] = '\0';
+            return OP_SUCCESS;
         }
     );
 }
@@ -138,8 +234,11 @@ TaskHandle BlockchainAdapter::setComplexity(uint8_t c)
 {
     return taskSystem->submit(
         Input<uint8_t>{c},
-        [this](Input<uint8_t> in) {
+        [this](Input<uint8_t> in) -> std::any {
+            if (writerStarted)
+                return OP_INVALID_STATE;
             chain->complexity = in.get();
+            return OP_SUCCESS;
         }
     );
 }
@@ -148,8 +247,11 @@ TaskHandle BlockchainAdapter::setNextChallengeId(uint64_t id)
 {
     return taskSystem->submit(
         Input<uint64_t>{id},
-        [this](Input<uint64_t> in) {
+        [this](Input<uint64_t> in) -> std::any {
+            if (writerStarted)
+                return OP_INVALID_STATE;
             chain->next_challenge_id = in.get();
+            return OP_SUCCESS;
         }
     );
 }
@@ -158,8 +260,11 @@ TaskHandle BlockchainAdapter::setAvgSolveTime(double t)
 {
     return taskSystem->submit(
         Input<double>{t},
-        [this](Input<double> in) {
+        [this](Input<double> in) -> std::any {
+            if (writerStarted)
+                return OP_INVALID_STATE;
             chain->avg_solve_time_seconds = in.get();
+            return OP_SUCCESS;
         }
     );
 }
@@ -177,7 +282,10 @@ TaskHandle BlockchainAdapter::updateLastIndexes(uint32_t mcu,
         Input<std::tuple<uint32_t,uint32_t,uint32_t,uint32_t>>{
             std::make_tuple(mcu, server, desktop, edge)
         },
-        [this](Input<std::tuple<uint32_t,uint32_t,uint32_t,uint32_t>> in) {
+        [this](Input<std::tuple<uint32_t,uint32_t,uint32_t,uint32_t>> in) -> std::any {
+            // the writer maintains these from committed blocks
+            if (writerStarted)
+                return OP_INVALID_STATE;
 
             auto [m, s, d, e] = in.get();
 
@@ -185,6 +293,7 @@ TaskHandle BlockchainAdapter::updateLastIndexes(uint32_t mcu,
             chain->lastServerBlockIndex = s;
             chain->lastDesktopBlockIndex = d;
             chain->lastEdgeBlockIndex = e;
+            return OP_SUCCESS;
         }
     );
 }
@@ -215,4 +324,110 @@ TaskHandle BlockchainAdapter::createCertificate(uint256 signPub,
             return cert;
         }
     );
-}
\ No newline at end of file
+}
+
+// =================================================
+// TELEMETRY
+// =================================================
+
+void BlockchainAdapter::setMetricsExportPath(const std::string& path)
+{
+    metricsExportPath = path;
+}
+
+bool BlockchainAdapter::setMetricsExportPort(uint16_t port)
+{
+    if (metricsListenFd >= 0) {
+        close(metricsListenFd);
+        metricsListenFd = -1;
+    }
+    if (port == 0)
+        return true;
+
+    return pkc_metrics_listen_loopback(port, &metricsListenFd) == OP_SUCCESS;
+}
+
+void BlockchainAdapter::watchQueueDepth(pkc_metric_gauge_t which, const size_t* count)
+{
+    pkc_metrics_watch_queue(&pkc_metrics_global, which, count);
+}
+
+const pkc_metrics_snapshot_t& BlockchainAdapter::metrics() const
+{
+    return metricsSnapshot;
+}
+
+// =================================================
+// WORK POOL
+// =================================================
+
+void BlockchainAdapter::setWorkPoolConfig(const pkc_pool_config_t& cfg)
+{
+    poolConfig = cfg;
+    poolConfigured = true;
+}
+
+void BlockchainAdapter::cancelMining()
+{
+    PowManager_Cancel();
+}
+
+// =================================================
+// CHAIN WRITER
+// =================================================
+
+void BlockchainAdapter::setChainWriterConfig(const pkc_chain_writer_config_t& cfg)
+{
+    writerConfig = cfg;
+}
+
+void BlockchainAdapter::setDurability(const pkc_chain_store_config_t& cfg)
+{
+    // takes effect at init(); the log replaces the writer's persist hook
+    storeConfig = cfg;
+    storeConfigured = true;
+}
+
+TaskHandle BlockchainAdapter::submitBlock(const block& blk)
+{
+    // fire-and-forget intake; the result arrives with the next published tip
+    return taskSystem->submit(
+        Input<block>{blk},
+        [this](Input<block> in) -> std::any {
+            if (!writerStarted)
+                return OP_INVALID_STATE;
+
+            const block& blk = in.get();
+            return pkc_chain_submit(&writer, &blk, nullptr);
+        }
+    );
+}
+
+// =================================================
+// SNAPSHOTS
+// =================================================
+
+void BlockchainAdapter::setSnapshotConfig(const pkc_snapshot_config_t& cfg)
+{
+    snapshotConfig = cfg;
+}
+
+void BlockchainAdapter::setBootstrapSnapshot(const std::string& path)
+{
+    // takes effect at init(), after the log replay and before genesis
+    bootstrapPath = path;
+}
+
+TaskHandle BlockchainAdapter::exportSnapshot(const std::string& path)
+{
+    // streams the committed prefix at the current tip; appends keep going
+    return taskSystem->submit(
+        Input<std::string>{path},
+        [this](Input<std::string> in) -> std::any {
+            if (!writerStarted)
+                return OP_INVALID_STATE;
+
+            return pkc_snapshot_export_writer(in.get().c_str(), &writer, &snapshotConfig, nullptr);
+        }
+    );
+}
@@ -13,11 +13,44 @@
 #include "protocol/blockchain/block.h"
 #include "protocol/blockchain/certificate.h"
 
+#include "telemetry/metrics_ops.h"
+#include "scheduler/workPool_ops.h"
+#include "blockchain/chainWriter_ops.h"
+#include "blockchain/chainStore_ops.h"
+#include "blockchain/chainSnapshot_ops.h"
+
 class PKCAdapter : public IAdapter {
 private:
     PKCertChain* chain = nullptr;
 
+    // single writer for blocks/index/last*BlockIndex once init() has run
+    pkc_chain_writer_t writer{};
+    pkc_chain_writer_config_t writerConfig{};
+    bool writerStarted = false;
+
+    // append log under $HOME/.pkcertchain/<network>/, opened in init()
+    pkc_chain_store_t store{};
+    pkc_chain_store_config_t storeConfig{};
+    bool storeConfigured = false;
+    bool storeOpen = false;
+
+    // snapshot streaming; the bootstrap file is only read by init() on an empty chain
+    pkc_snapshot_config_t snapshotConfig{};
+    std::string bootstrapPath;
+
+    // telemetry state, only touched from tick() and the setters below
+    pkc_metrics_snapshot_t metricsSnapshot{};
+    uint64_t lastMetricsTickNs = 0;
+    std::string metricsExportPath;
+    int metricsListenFd = -1;
+
+    // work pool sizing, applied in init() before the pool first starts
+    pkc_pool_config_t poolConfig{};
+    bool poolConfigured = false;
+
 public:
+    ~PKCAdapter();
+
     // =================================================
     // BINDING
     // =================================================
@@ -43,6 +76,7 @@ public:
     // =================================================
     TaskHandle getBlock(uint32_t index);
     TaskHandle addBlock(const block& blk);
+    TaskHandle addBlockWithPoW(Tier_t tier);
 
     // =================================================
     // SETTERS
@@ -66,4 +100,32 @@ public:
     TaskHandle createCertificate(uint256 signPub,
                                  uint256 encPub,
                                  ipv6_t id);
+
+    // =================================================
+    // TELEMETRY
+    // =================================================
+    void setMetricsExportPath(const std::string& path);
+    bool setMetricsExportPort(uint16_t port);
+    void watchQueueDepth(pkc_metric_gauge_t which, const size_t* count);
+    const pkc_metrics_snapshot_t& metrics() const;
+
+    // =================================================
+    // WORK POOL
+    // =================================================
+    void setWorkPoolConfig(const pkc_pool_config_t& cfg);
+    void cancelMining();
+
+    // =================================================
+    // CHAIN WRITER
+    // =================================================
+    void setChainWriterConfig(const pkc_chain_writer_config_t& cfg);
+    void setDurability(const pkc_chain_store_config_t& cfg);
+    TaskHandle submitBlock(const block& blk);
+
+    // =================================================
+    // SNAPSHOTS
+    // =================================================
+    void setSnapshotConfig(const pkc_snapshot_config_t& cfg);
+    void setBootstrapSnapshot(const std::string& path);
+    TaskHandle exportSnapshot(const std::string& path);
 };
\ No newline at end of file
@@ -0,0 +1,259 @@
+#ifndef MINI_POW_ARENA_H
+#define MINI_POW_ARENA_H
+
+
+#include "core/Global_Size_Offsets.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include "core/enums/OpStatus.h"
+#include "protocol/proofs/mini_pow/mini_pow_Matrix.h"
+#include "protocol/proofs/mini_pow/mini_pow_Solve_t.h"
+#include "protocol/proofs/mini_pow/SolvedMatricPoW.h"
+
+#ifndef MINI_POW_ARENA_INLINE
+#define MINI_POW_ARENA_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Session arena for the 4 MB MiniPoW working sets (matrices, solver
+ * accumulator, solved matrix).
+ *
+ * One pool per struct kind, each a single mapping cut into slabs rounded
+ * up to 2 MB. The mapping is tried with MAP_HUGETLB first and falls back to
+ * a 2 MB aligned anonymous mapping advised MADV_HUGEPAGE; either way it is
+ * prefaulted at init so sessions never take a page fault. Free slabs sit
+ * on a tagged Treiber stack: alloc and free are O(1) and lock-free.
+ *
+ * Slabs are handed out dirty unless MINI_POW_ARENA_ZERO is passed. Only
+ * mini_pow_solve_t needs it (it accumulates); construct_mini_pow_matrices
+ * and the solved-matrix copy overwrite every byte.
+ */
+
+#define MINI_POW_ARENA_HUGE_PAGE (2u * 1024u * 1024u)
+#define MINI_POW_ARENA_PAGE 4096u
+#define MINI_POW_ARENA_EMPTY UINT32_MAX
+
+#define MINI_POW_ARENA_ZERO 0x1u
+
+typedef enum {
+    MINI_POW_SLAB_MATRIX = 0,
+    MINI_POW_SLAB_SOLVE,
+    MINI_POW_SLAB_SOLVED,
+    MINI_POW_SLAB_KINDS,
+} mini_pow_slab_kind_t;
+
+typedef struct {
+    uint8_t *base;
+    uint8_t *map;
+    size_t map_len;
+    size_t slab_size;
+    size_t object_size;
+    uint32_t capacity;
+    bool huge;                          // MAP_HUGETLB, not just THP advice
+    _Atomic(uint64_t) head;             // (tag << 32) | slab index
+    _Atomic(uint32_t) *next;
+    _Atomic(uint32_t) in_use;
+} mini_pow_slab_pool_t;
+
+typedef struct {
+    mini_pow_slab_pool_t pools[MINI_POW_SLAB_KINDS];
+    _Atomic(uint64_t) exhausted;
+} mini_pow_arena_t;
+
+MINI_POW_ARENA_INLINE size_t mini_pow_arena_object_size(mini_pow_slab_kind_t kind)
+{
+    switch (kind) {
+        case MINI_POW_SLAB_MATRIX: return sizeof(mini_pow_Matrix);
+        case MINI_POW_SLAB_SOLVE:  return sizeof(mini_pow_solve_t);
+        case MINI_POW_SLAB_SOLVED: return sizeof(SolvedMatricPoW);
+        default: return 0;
+    }
+}
+
+static inline OpStatus_t mini_pow_slab_pool_map(mini_pow_slab_pool_t *pool)
+{
+    const size_t len = pool->slab_size * pool->capacity;
+
+#ifdef MAP_HUGETLB
+    void *p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+    if (p != MAP_FAILED) {
+        pool->map = pool->base = (uint8_t *)p;
+        pool->map_len = len;
+        pool->huge = true;
+        return OP_SUCCESS;
+    }
+#endif
+
+    // Over-map by one huge page so the slabs start 2 MB aligned for THP.
+    const size_t over = len + MINI_POW_ARENA_HUGE_PAGE;
+    void *q = mmap(NULL, over, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (q == MAP_FAILED) return OP_INVALID_STATE;
+
+    uint8_t *raw = (uint8_t *)q;
+    uint8_t *aligned = (uint8_t *)(((uintptr_t)raw + MINI_POW_ARENA_HUGE_PAGE - 1) & ~(uintptr_t)(MINI_POW_ARENA_HUGE_PAGE - 1));
+    const size_t head = (size_t)(aligned - raw);
+    const size_t tail = over - head - len;
+    if (head) munmap(raw, head);
+    if (tail) munmap(aligned + len, tail);
+
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+    // Prefault after the advice so the kernel can back it with huge pages.
+    for (size_t off = 0; off < len; off += MINI_POW_ARENA_PAGE) {
+        ((volatile uint8_t *)aligned)[off] = 0;
+    }
+
+    pool->map = pool->base = aligned;
+    pool->map_len = len;
+    pool->huge = false;
+    return OP_SUCCESS;
+}
+
+static inline OpStatus_t mini_pow_slab_pool_init(mini_pow_slab_pool_t *pool, mini_pow_slab_kind_t kind, uint32_t capacity)
+{
+    memset(pool, 0, sizeof(*pool));
+    pool->object_size = mini_pow_arena_object_size(kind);
+    pool->slab_size = (pool->object_size + MINI_POW_ARENA_HUGE_PAGE - 1) & ~(size_t)(MINI_POW_ARENA_HUGE_PAGE - 1);
+    pool->capacity = capacity;
+    atomic_init(&pool->in_use, 0);
+
+    pool->next = (_Atomic(uint32_t) *)mmap(NULL, capacity * sizeof(_Atomic(uint32_t)), PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((void *)pool->next == MAP_FAILED) {
+        pool->next = NULL;
+        return OP_INVALID_STATE;
+    }
+
+    OpStatus_t st = mini_pow_slab_pool_map(pool);
+    if (st != OP_SUCCESS) {
+        munmap((void *)pool->next, capacity * sizeof(_Atomic(uint32_t)));
+        pool->next = NULL;
+        return st;
+    }
+
+    for (uint32_t i = 0; i < capacity; ++i) {
+        atomic_init(&pool->next[i], i + 1 < capacity ? i + 1 : MINI_POW_ARENA_EMPTY);
+    }
+    atomic_init(&pool->head, 0);
+    return OP_SUCCESS;
+}
+
+static inline void mini_pow_slab_pool_destroy(mini_pow_slab_pool_t *pool)
+{
+    if (pool->map) munmap(pool->map, pool->map_len);
+    if (pool->next) munmap((void *)pool->next, pool->capacity * sizeof(_Atomic(uint32_t)));
+    memset(pool, 0, sizeof(*pool));
+}
+
+/*
+ * Maps and prefaults `sessions` slabs of every kind.
+ */
+static inline OpStatus_t mini_pow_arena_init(mini_pow_arena_t *arena, uint32_t sessions)
+{
+    if (!arena) return OP_NULL_PTR;
+    if (sessions == 0 || sessions >= MINI_POW_ARENA_EMPTY) return OP_INVALID_INPUT;
+
+    memset(arena, 0, sizeof(*arena));
+    atomic_init(&arena->exhausted, 0);
+    for (int k = 0; k < MINI_POW_SLAB_KINDS; ++k) {
+        OpStatus_t st = mini_pow_slab_pool_init(&arena->pools[k], (mini_pow_slab_kind_t)k, sessions);
+        if (st != OP_SUCCESS) {
+            for (int j = 0; j < k; ++j) mini_pow_slab_pool_destroy(&arena->pools[j]);
+            return st;
+        }
+    }
+    return OP_SUCCESS;
+}
+
+static inline void mini_pow_arena_destroy(mini_pow_arena_t *arena)
+{
+    if (!arena) return;
+    for (int k = 0; k < MINI_POW_SLAB_KINDS; ++k) mini_pow_slab_pool_destroy(&arena->pools[k]);
+}
+
+/*
+ * Pops a slab; NULL when the pool is exhausted (counted in `exhausted`).
+ */
+MINI_POW_ARENA_INLINE void *mini_pow_arena_alloc(mini_pow_arena_t *arena, mini_pow_slab_kind_t kind, uint32_t flags)
+{
+    if (!arena || (unsigned)kind >= MINI_POW_SLAB_KINDS) return NULL;
+    mini_pow_slab_pool_t *pool = &arena->pools[kind];
+
+    uint64_t head = atomic_load_explicit(&pool->head, memory_order_acquire);
+    for (;;) {
+        const uint32_t idx = (uint32_t)head;
+        if (idx == MINI_POW_ARENA_EMPTY || idx >= pool->capacity) {
+            atomic_fetch_add_explicit(&arena->exhausted, 1, memory_order_relaxed);
+            return NULL;
+        }
+        const uint32_t nxt = atomic_load_explicit(&pool->next[idx], memory_order_relaxed);
+        const uint64_t want = (((head >> 32) + 1) << 32) | nxt;
+        if (atomic_compare_exchange_weak_explicit(&pool->head, &head, want,
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            atomic_fetch_add_explicit(&pool->in_use, 1, memory_order_relaxed);
+            void *p = pool->base + (size_t)idx * pool->slab_size;
+            if (flags & MINI_POW_ARENA_ZERO) memset(p, 0, pool->object_size);
+            return p;
+        }
+    }
+}
+
+/*
+ * Returns a slab to its pool. Pointers that did not come from the pool
+ * are rejected with OP_INVALID_INPUT.
+ */
+MINI_POW_ARENA_INLINE OpStatus_t mini_pow_arena_free(mini_pow_arena_t *arena, mini_pow_slab_kind_t kind, void *ptr)
+{
+    if (!arena || !ptr) return OP_NULL_PTR;
+    if ((unsigned)kind >= MINI_POW_SLAB_KINDS) return OP_INVALID_INPUT;
+    mini_pow_slab_pool_t *pool = &arena->pools[kind];
+
+    const uint8_t *p = (const uint8_t *)ptr;
+    if (p < pool->base || p >= pool->base + (size_t)pool->capacity * pool->slab_size) return OP_INVALID_INPUT;
+    const size_t off = (size_t)(p - pool->base);
+    if (off % pool->slab_size != 0) return OP_INVALID_INPUT;
+    const uint32_t idx = (uint32_t)(off / pool->slab_size);
+
+    uint64_t head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&pool->next[idx], (uint32_t)head, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&pool->head, &head, (((head >> 32) + 1) << 32) | idx,
+                                                    memory_order_release, memory_order_relaxed));
+    atomic_fetch_sub_explicit(&pool->in_use, 1, memory_order_relaxed);
+    return OP_SUCCESS;
+}
+
+/* Typed helpers; zeroing follows what the next writer needs. */
+
+MINI_POW_ARENA_INLINE mini_pow_Matrix *mini_pow_arena_matrix(mini_pow_arena_t *arena)
+{
+    return (mini_pow_Matrix *)mini_pow_arena_alloc(arena, MINI_POW_SLAB_MATRIX, 0);
+}
+
+MINI_POW_ARENA_INLINE mini_pow_solve_t *mini_pow_arena_solve(mini_pow_arena_t *arena)
+{
+    return (mini_pow_solve_t *)mini_pow_arena_alloc(arena, MINI_POW_SLAB_SOLVE, MINI_POW_ARENA_ZERO);
+}
+
+MINI_POW_ARENA_INLINE SolvedMatricPoW *mini_pow_arena_solved(mini_pow_arena_t *arena)
+{
+    return (SolvedMatricPoW *)mini_pow_arena_alloc(arena, MINI_POW_SLAB_SOLVED, 0);
+}
+
+MINI_POW_ARENA_INLINE uint32_t mini_pow_arena_in_use(const mini_pow_arena_t *arena, mini_pow_slab_kind_t kind)
+{
+    return atomic_load_explicit(&arena->pools[kind].in_use, memory_order_relaxed);
+}
+
+MINI_POW_ARENA_INLINE bool mini_pow_arena_huge(const mini_pow_arena_t *arena)
+{
+    return arena->pools[MINI_POW_SLAB_MATRIX].huge;
+}
+
+#endif // MINI_POW_ARENA_H
@@ -0,0 +1,332 @@
+#ifndef MINI_POW_CLASSIFY_ENGINE_H
+#define MINI_POW_CLASSIFY_ENGINE_H
+
+
+#include "core/Global_Size_Offsets.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "core/enums/Tier.h"
+#include "core/enums/OpStatus.h"
+#include "protocol/proofs/mini_pow/mini_pow_challenge_t.h"
+#include "Proofs/MiniPoW/miniPoWClassify_ops.h"
+#include "Proofs/MiniPoW/miniPoWTiming_ops.h"
+#include "Proofs/MiniPoW/miniPoWSolve_ops.h"
+#include "Proofs/MiniPoW/miniPoWChallenge_ops.h"
+#include "telemetry/clock_ops.h"
+
+/*
+ * MiniPoW tier classification engine.
+ *
+ * Input is the full per-iteration latency series of a session plus an RTT
+ * baseline taken from no-op ACK probes (the miner ACKs without computing).
+ * Per iteration: compute_ns = max(0, latency - baseline). Outliers beyond
+ * k scaled MADs from the median are dropped, the tier is taken from the
+ * median of what is left, and a distribution-free confidence interval for
+ * that median is built from order statistics. Confidence is the share of
+ * the interval that falls inside the chosen tier band.
+ */
+
+#ifndef MINI_POW_RTT_PROBES_MAX
+#define MINI_POW_RTT_PROBES_MAX 32
+#endif
+
+#define MINI_POW_CLASSIFY_DEFAULT_MAD_K 3.5
+#define MINI_POW_CLASSIFY_DEFAULT_Z 1.96
+#define MINI_POW_CLASSIFY_CALIBRATION_HEADROOM 0.75
+#define MINI_POW_MAD_TO_SIGMA 1.4826
+
+typedef struct {
+    uint64_t server_max_ns;
+    uint64_t desktop_max_ns;
+    uint64_t edge_max_ns;
+    double outlier_mad_k;
+    double confidence_z;
+} mini_pow_classify_config_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t pending_start_ns;
+    uint64_t samples_ns[MINI_POW_RTT_PROBES_MAX];
+} mini_pow_rtt_baseline_t;
+
+typedef struct {
+    Tier_t tier;
+    double confidence;
+    uint64_t estimate_ns;
+    uint64_t ci_low_ns;
+    uint64_t ci_high_ns;
+    uint64_t rtt_baseline_ns;
+    uint32_t samples_used;
+    uint32_t samples_rejected;
+} mini_pow_classification_t;
+
+static inline void mini_pow_classify_config_default(mini_pow_classify_config_t *cfg)
+{
+    if (!cfg) return;
+    cfg->server_max_ns = MINI_POW_TIER_SERVER_MAX_NS;
+    cfg->desktop_max_ns = MINI_POW_TIER_DESKTOP_MAX_NS;
+    cfg->edge_max_ns = MINI_POW_TIER_EDGE_MAX_NS;
+    cfg->outlier_mad_k = MINI_POW_CLASSIFY_DEFAULT_MAD_K;
+    cfg->confidence_z = MINI_POW_CLASSIFY_DEFAULT_Z;
+}
+
+static inline bool mini_pow_classify_config_valid(const mini_pow_classify_config_t *cfg)
+{
+    return cfg && cfg->server_max_ns > 0 &&
+           cfg->server_max_ns < cfg->desktop_max_ns &&
+           cfg->desktop_max_ns < cfg->edge_max_ns &&
+           cfg->outlier_mad_k > 0.0 && cfg->confidence_z > 0.0;
+}
+
+/*
+ * Loads thresholds from a `key = value` file (`#` starts a comment).
+ * Keys: server_max_ns, desktop_max_ns, edge_max_ns, outlier_mad_k, confidence_z.
+ * Missing keys keep their current value; the result must stay ordered.
+ */
+static inline OpStatus_t mini_pow_classify_config_load(const char *path, mini_pow_classify_config_t *cfg)
+{
+    if (!path || !cfg) return OP_NULL_PTR;
+
+    FILE *f = fopen(path, "r");
+    if (!f) return OP_INVALID_INPUT;
+
+    mini_pow_classify_config_t next = *cfg;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char key[64];
+        char val[64];
+        if (sscanf(line, " %63[a-z_] = %63s", key, val) != 2) continue;
+
+        if (strcmp(key, "server_max_ns") == 0) next.server_max_ns = strtoull(val, NULL, 10);
+        else if (strcmp(key, "desktop_max_ns") == 0) next.desktop_max_ns = strtoull(val, NULL, 10);
+        else if (strcmp(key, "edge_max_ns") == 0) next.edge_max_ns = strtoull(val, NULL, 10);
+        else if (strcmp(key, "outlier_mad_k") == 0) next.outlier_mad_k = strtod(val, NULL);
+        else if (strcmp(key, "confidence_z") == 0) next.confidence_z = strtod(val, NULL);
+    }
+    fclose(f);
+
+    if (!mini_pow_classify_config_valid(&next)) return OP_INVALID_INPUT;
+    *cfg = next;
+    return OP_SUCCESS;
+}
+
+static inline OpStatus_t mini_pow_classify_config_save(const char *path, const mini_pow_classify_config_t *cfg)
+{
+    if (!path || !cfg) return OP_NULL_PTR;
+    if (!mini_pow_classify_config_valid(cfg)) return OP_INVALID_INPUT;
+
+    FILE *f = fopen(path, "w");
+    if (!f) return OP_INVALID_INPUT;
+    fprintf(f, "# MiniPoW per-iteration compute bounds (ns)\n");
+    fprintf(f, "server_max_ns = %llu\n", (unsigned long long)cfg->server_max_ns);
+    fprintf(f, "desktop_max_ns = %llu\n", (unsigned long long)cfg->desktop_max_ns);
+    fprintf(f, "edge_max_ns = %llu\n", (unsigned long long)cfg->edge_max_ns);
+    fprintf(f, "outlier_mad_k = %.4f\n", cfg->outlier_mad_k);
+    fprintf(f, "confidence_z = %.4f\n", cfg->confidence_z);
+    return fclose(f) == 0 ? OP_SUCCESS : OP_INVALID_INPUT;
+}
+
+static inline void mini_pow_rtt_baseline_init(mini_pow_rtt_baseline_t *rtt)
+{
+    if (!rtt) return;
+    memset(rtt, 0, sizeof(*rtt));
+}
+
+// Call right before sending a no-op probe challenge.
+static inline void mini_pow_rtt_probe_send(mini_pow_rtt_baseline_t *rtt)
+{
+    if (!rtt) return;
+    rtt->pending_start_ns = pkc_clock_now_ns();
+}
+
+// Call when the probe's ACK arrives.
+static inline void mini_pow_rtt_probe_ack(mini_pow_rtt_baseline_t *rtt)
+{
+    if (!rtt || rtt->pending_start_ns == 0) return;
+    uint64_t now = pkc_clock_now_ns();
+    if (rtt->count < MINI_POW_RTT_PROBES_MAX && now > rtt->pending_start_ns) {
+        rtt->samples_ns[rtt->count++] = now - rtt->pending_start_ns;
+    }
+    rtt->pending_start_ns = 0;
+}
+
+// Median probe RTT, 0 without probes.
+static inline uint64_t mini_pow_rtt_baseline_ns(const mini_pow_rtt_baseline_t *rtt)
+{
+    if (!rtt || rtt->count == 0) return 0;
+    uint64_t sorted[MINI_POW_RTT_PROBES_MAX];
+    memcpy(sorted, rtt->samples_ns, rtt->count * sizeof(uint64_t));
+    qsort(sorted, rtt->count, sizeof(uint64_t), mini_pow_timing_cmp_u64);
+    return mini_pow_timing_sorted_percentile(sorted, rtt->count, 50);
+}
+
+static inline Tier_t mini_pow_classify_tier_of(const mini_pow_classify_config_t *cfg, uint64_t ns)
+{
+    if (ns <= cfg->server_max_ns) return TIER_SERVER;
+    if (ns <= cfg->desktop_max_ns) return TIER_DESKTOP;
+    if (ns <= cfg->edge_max_ns) return TIER_EDGE;
+    return TIER_MCU;
+}
+
+static inline void mini_pow_classify_band(const mini_pow_classify_config_t *cfg, Tier_t tier,
+                                          double *lo, double *hi)
+{
+    switch (tier) {
+        case TIER_SERVER: *lo = 0.0; *hi = (double)cfg->server_max_ns; break;
+        case TIER_DESKTOP: *lo = (double)cfg->server_max_ns; *hi = (double)cfg->desktop_max_ns; break;
+        case TIER_EDGE: *lo = (double)cfg->desktop_max_ns; *hi = (double)cfg->edge_max_ns; break;
+        default: *lo = (double)cfg->edge_max_ns; *hi = INFINITY; break;
+    }
+}
+
+/*
+ * Classifies one session. `rtt` and `cfg` may be NULL (no baseline /
+ * default thresholds). Returns OP_INVALID_INPUT for an empty series.
+ */
+static inline OpStatus_t mini_pow_classify(const mini_pow_timing_t *series,
+                                           const mini_pow_rtt_baseline_t *rtt,
+                                           const mini_pow_classify_config_t *cfg,
+                                           mini_pow_classification_t *out)
+{
+    if (!series || !out) return OP_NULL_PTR;
+    if (series->count == 0) return OP_INVALID_INPUT;
+
+    mini_pow_classify_config_t def;
+    if (!cfg) {
+        mini_pow_classify_config_default(&def);
+        cfg = &def;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->rtt_baseline_ns = mini_pow_rtt_baseline_ns(rtt);
+
+    // 1. Subtract the wire baseline.
+    const uint32_t n = series->count;
+    uint64_t x[MINI_POW_MATRIX_N];
+    for (uint32_t i = 0; i < n; ++i) {
+        uint64_t s = series->samples_ns[i];
+        x[i] = s > out->rtt_baseline_ns ? s - out->rtt_baseline_ns : 0;
+    }
+    qsort(x, n, sizeof(uint64_t), mini_pow_timing_cmp_u64);
+
+    // 2. MAD outlier rejection around the median.
+    const double med = (double)mini_pow_timing_sorted_percentile(x, n, 50);
+    uint64_t dev[MINI_POW_MATRIX_N];
+    for (uint32_t i = 0; i < n; ++i) {
+        double d = fabs((double)x[i] - med);
+        dev[i] = (uint64_t)d;
+    }
+    qsort(dev, n, sizeof(uint64_t), mini_pow_timing_cmp_u64);
+    const double sigma = MINI_POW_MAD_TO_SIGMA * (double)mini_pow_timing_sorted_percentile(dev, n, 50);
+    const double limit = cfg->outlier_mad_k * sigma;
+
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        // sigma == 0 means at least half the samples are identical: keep those only.
+        if (fabs((double)x[i] - med) <= limit) x[kept++] = x[i];
+    }
+    out->samples_used = kept;
+    out->samples_rejected = n - kept;
+
+    // 3. Median and its order-statistic confidence interval.
+    out->estimate_ns = mini_pow_timing_sorted_percentile(x, kept, 50);
+    const double half = cfg->confidence_z * sqrt((double)kept) / 2.0;
+    long lo_rank = (long)floor((double)kept / 2.0 - half);
+    long hi_rank = (long)ceil((double)kept / 2.0 + half);
+    if (lo_rank < 1) lo_rank = 1;
+    if (hi_rank > (long)kept) hi_rank = (long)kept;
+    out->ci_low_ns = x[lo_rank - 1];
+    out->ci_high_ns = x[hi_rank - 1];
+
+    // 4. Tier and the share of the interval that agrees with it.
+    out->tier = mini_pow_classify_tier_of(cfg, out->estimate_ns);
+    double band_lo, band_hi;
+    mini_pow_classify_band(cfg, out->tier, &band_lo, &band_hi);
+    const double ci_lo = (double)out->ci_low_ns;
+    const double ci_hi = (double)out->ci_high_ns;
+    if (ci_hi <= ci_lo) {
+        out->confidence = 1.0;
+    } else {
+        double in_lo = ci_lo > band_lo ? ci_lo : band_lo;
+        double in_hi = ci_hi < band_hi ? ci_hi : band_hi;
+        out->confidence = in_hi > in_lo ? (in_hi - in_lo) / (ci_hi - ci_lo) : 0.0;
+    }
+    return OP_SUCCESS;
+}
+
+/*
+ * On-box recalibration. Times `iterations` outer-product updates locally,
+ * assumes this box belongs to `own_tier`, and rescales the thresholds so
+ * its median per-iteration time sits at MINI_POW_CLASSIFY_CALIBRATION_HEADROOM
+ * of that tier's upper bound (MCU: 2x the edge bound). Band ratios are
+ * preserved.
+ */
+static inline OpStatus_t mini_pow_classify_calibrate(mini_pow_classify_config_t *cfg,
+                                                     Tier_t own_tier,
+                                                     uint32_t iterations)
+{
+    if (!cfg) return OP_NULL_PTR;
+    if (iterations == 0 || iterations > MINI_POW_MATRIX_N) return OP_INVALID_INPUT;
+    if (!mini_pow_classify_config_valid(cfg)) return OP_INVALID_INPUT;
+
+    double anchor;
+    switch (own_tier) {
+        case TIER_SERVER: anchor = (double)cfg->server_max_ns * MINI_POW_CLASSIFY_CALIBRATION_HEADROOM; break;
+        case TIER_DESKTOP: anchor = (double)cfg->desktop_max_ns * MINI_POW_CLASSIFY_CALIBRATION_HEADROOM; break;
+        case TIER_EDGE: anchor = (double)cfg->edge_max_ns * MINI_POW_CLASSIFY_CALIBRATION_HEADROOM; break;
+        case TIER_MCU: anchor = (double)cfg->edge_max_ns * 2.0; break;
+        default: return OP_INVALID_INPUT;
+    }
+
+    mini_pow_solve_t *solve = (mini_pow_solve_t *)calloc(1, sizeof(mini_pow_solve_t));
+    mini_pow_challenge_t *ch = (mini_pow_challenge_t *)malloc(sizeof(mini_pow_challenge_t));
+    mini_pow_timing_t *timing = (mini_pow_timing_t *)malloc(sizeof(mini_pow_timing_t));
+    if (!solve || !ch || !timing) {
+        free(solve);
+        free(ch);
+        free(timing);
+        return OP_INVALID_INPUT;
+    }
+
+    mini_pow_challenge_init(ch);
+    mini_pow_timing_init(timing);
+    uint32_t lcg = 0x9E3779B9u;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        ch->iteration = i;
+        for (size_t k = 0; k < MINI_POW_MATRIX_N; ++k) {
+            lcg = lcg * 1664525u + 1013904223u;
+            ch->columnOfA[k] = (uint16_t)(lcg >> 16);
+            ch->rowOfB[k] = (uint16_t)lcg;
+        }
+        uint64_t t0 = pkc_clock_now_ns();
+        mini_pow_solve_update(solve, ch);
+        mini_pow_timing_record(timing, pkc_clock_now_ns() - t0);
+    }
+    mini_pow_timing_finalize(timing);
+    const double measured = (double)timing->median_ns;
+
+    free(solve);
+    free(ch);
+    free(timing);
+    if (measured <= 0.0) return OP_INVALID_STATE;
+
+    const double scale = measured / anchor;
+    mini_pow_classify_config_t next = *cfg;
+    next.server_max_ns = (uint64_t)((double)cfg->server_max_ns * scale);
+    next.desktop_max_ns = (uint64_t)((double)cfg->desktop_max_ns * scale);
+    next.edge_max_ns = (uint64_t)((double)cfg->edge_max_ns * scale);
+    if (!mini_pow_classify_config_valid(&next)) return OP_INVALID_STATE;
+
+    *cfg = next;
+    return OP_SUCCESS;
+}
+
+#endif // MINI_POW_CLASSIFY_ENGINE_H
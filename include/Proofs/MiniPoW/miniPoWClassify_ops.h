@@ -6,7 +6,31 @@
 
 #include <stdint.h>
 #include "core/enums/Tier.h"
+#include "Proofs/MiniPoW/miniPoWTiming_ops.h"
 
+/*
+ * Tier bounds. The original calibration is cumulative: the whole
+ * reference run of MINI_POW_TIER_REFERENCE_ITERATIONS outer products
+ * within 150/500/1500 us. The median classifier compares one iteration,
+ * so its bounds are those totals divided by the reference count.
+ */
+#ifndef MINI_POW_TIER_REFERENCE_ITERATIONS
+#define MINI_POW_TIER_REFERENCE_ITERATIONS 50ULL
+#endif
+#define MINI_POW_TIER_SERVER_TOTAL_US 150ULL
+#define MINI_POW_TIER_DESKTOP_TOTAL_US 500ULL
+#define MINI_POW_TIER_EDGE_TOTAL_US 1500ULL
+
+// Per-iteration outer-product time bounds (ns) for the median-based classifier.
+#ifndef MINI_POW_TIER_SERVER_MAX_NS
+#define MINI_POW_TIER_SERVER_MAX_NS (MINI_POW_TIER_SERVER_TOTAL_US * 1000ULL / MINI_POW_TIER_REFERENCE_ITERATIONS)
+#endif
+#ifndef MINI_POW_TIER_DESKTOP_MAX_NS
+#define MINI_POW_TIER_DESKTOP_MAX_NS (MINI_POW_TIER_DESKTOP_TOTAL_US * 1000ULL / MINI_POW_TIER_REFERENCE_ITERATIONS)
+#endif
+#ifndef MINI_POW_TIER_EDGE_MAX_NS
+#define MINI_POW_TIER_EDGE_MAX_NS (MINI_POW_TIER_EDGE_TOTAL_US * 1000ULL / MINI_POW_TIER_REFERENCE_ITERATIONS)
+#endif
 
 static inline void mini_pow_select_row_col(uint64_t challenge_id, uint16_t *row, uint16_t *col)
 {
@@ -20,11 +44,23 @@ static inline void mini_pow_select_row_col(uint64_t challenge_id, uint16_t *row,
 
 static inline Tier_t mini_pow_assign_tier(uint64_t elapsed_microseconds)
 {
-    // Hardcoded thresholds based on 50 iter matrix multiplications.
-    if (elapsed_microseconds <= 150) return TIER_SERVER;      // <= 0.15ms
-    if (elapsed_microseconds <= 500) return TIER_DESKTOP;     // <= 0.5ms
-    if (elapsed_microseconds <= 1500) return TIER_EDGE;       // <= 1.5ms
-    return TIER_MCU;                                          // > 1.5ms
+    // Cumulative thresholds for the reference run of matrix multiplications.
+    if (elapsed_microseconds <= MINI_POW_TIER_SERVER_TOTAL_US) return TIER_SERVER;      // <= 0.15ms
+    if (elapsed_microseconds <= MINI_POW_TIER_DESKTOP_TOTAL_US) return TIER_DESKTOP;    // <= 0.5ms
+    if (elapsed_microseconds <= MINI_POW_TIER_EDGE_TOTAL_US) return TIER_EDGE;          // <= 1.5ms
+    return TIER_MCU;                                                                     // > 1.5ms
+}
+
+/*
+ * Tier from the median per-iteration latency. A few slow iterations
+ * (scheduling, one retransmit) move the median far less than the sum.
+ */
+static inline Tier_t mini_pow_assign_tier_ns(uint64_t median_iteration_ns)
+{
+    if (median_iteration_ns <= MINI_POW_TIER_SERVER_MAX_NS) return TIER_SERVER;
+    if (median_iteration_ns <= MINI_POW_TIER_DESKTOP_MAX_NS) return TIER_DESKTOP;
+    if (median_iteration_ns <= MINI_POW_TIER_EDGE_MAX_NS) return TIER_EDGE;
+    return TIER_MCU;
 }
 
 #endif // MINI_POW_CLASSIFY_H
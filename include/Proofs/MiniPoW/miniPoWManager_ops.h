@@ -2,13 +2,17 @@
 #ifndef MINI_POW_MANAGER_H
 #define MINI_POW_MANAGER_H
 
-#include <stdio.h>
 #include "protocol/proofs/mini_pow/mini_pow_challenge_t.h"
 #include "Proofs/MiniPoW/miniPoWVerify_ops.h"
+#include "Proofs/MiniPoW/miniPoWVerifyParallel_ops.h"
 #include "Proofs/MiniPoW/miniPoWClassify_ops.h"
+#include "Proofs/MiniPoW/miniPoWClassifyEngine_ops.h"
+#include "Proofs/MiniPoW/miniPoWWindow_ops.h"
 #include "protocol/proofs/mini_pow/MiniPoW_ACK.h"
 #include "protocol/proofs/mini_pow/MiniPoWManagerTracker.h"
 #include "protocol/proofs/mini_pow/mini_pow_result.h"
+#include "telemetry/metrics_ops.h"
+#include "telemetry/trace_ops.h"
 
 static inline void minipow_manager_tracker_init(MiniPoWManagerTracker *mgr, uint32_t session_id) {
     if (!mgr) return;
@@ -24,36 +28,151 @@ static inline void minipow_manager_send(MiniPoWManagerTracker *mgr, uint32_t cha
     mini_pow_tracker_update_start(&mgr->timeTracker);
 }
 
-static inline void minipow_manager_receive_ack(MiniPoWManagerTracker *mgr) {
+/*
+ * Records the ACK for the outstanding iteration. `timing` (may be NULL)
+ * receives the per-iteration sample used for classification.
+ */
+static inline void minipow_manager_receive_ack(MiniPoWManagerTracker *mgr, mini_pow_timing_t *timing) {
     if (!mgr) return;
     mini_pow_tracker_update_receive(&mgr->timeTracker);
     
     uint64_t duration = mgr->timeTracker.recent_receive_time > mgr->timeTracker.recent_start_time ?
                         (mgr->timeTracker.recent_receive_time - mgr->timeTracker.recent_start_time) : 0;
     
-    printf("Iteration %u duration: %lu us (Cumulative: %lu us)\n", 
-           mgr->currentIteration, duration, mgr->timeTracker.cumulative_duration);
-           
+    mini_pow_timing_record(timing, duration);
+    pkc_metrics_observe_ns(PKC_HIST_MINI_POW_ITERATION, duration);
+    pkc_metrics_count(PKC_CTR_MINI_POW_ITERATIONS, 1);
+
+    // No stdio here: the next iteration's start timestamp must not absorb a write().
+    pkc_trace_mini_pow_iteration(mgr->sessionID, mgr->timeTracker.challenge_id, mgr->currentIteration,
+                                 mgr->timeTracker.recent_start_time, mgr->timeTracker.recent_receive_time,
+                                 duration);
+
     mgr->currentIteration++;
 }
 
-static inline mini_pow_result minipow_manager_finalize(MiniPoWManagerTracker *mgr, 
-                                                       const SolvedMatricPoW *solved, 
-                                                       const mini_pow_Matrix *matrices) {
+/*
+ * Pipelined variant: up to window->size challenges in flight, each with its
+ * own challenge_id (base + iteration) and send stamp. See miniPoWWindow_ops.h.
+ */
+static inline OpStatus_t minipow_manager_window_begin(MiniPoWManagerTracker *mgr, mini_pow_window_t *window,
+                                                      uint32_t base_challenge_id, uint32_t window_size) {
+    if (!mgr || !window) return OP_NULL_PTR;
+    mgr->currentIteration = 0;
+    mgr->timeTracker.challenge_id = base_challenge_id;
+    return mini_pow_window_init(window, base_challenge_id, window_size);
+}
+
+/*
+ * Claims the next iteration to put on the wire. `out_challenge_id` is what
+ * the challenge must carry so its ACK can be matched.
+ */
+static inline OpStatus_t minipow_manager_window_send_at(MiniPoWManagerTracker *mgr, mini_pow_window_t *window,
+                                                        uint64_t now, uint32_t *out_iteration,
+                                                        uint32_t *out_challenge_id) {
+    if (!mgr || !window || !out_iteration || !out_challenge_id) return OP_NULL_PTR;
+    OpStatus_t st = mini_pow_window_send(window, now, out_iteration);
+    if (st != OP_SUCCESS) return st;
+
+    *out_challenge_id = mini_pow_window_challenge_id(window, *out_iteration);
+    mgr->timeTracker.challenge_id = *out_challenge_id;
+    mgr->timeTracker.recent_start_time = now;
+    return OP_SUCCESS;
+}
+
+/*
+ * Matches an ACK by challenge id. Only the service time (solver compute,
+ * not the round trip) goes into `timing` and cumulative_duration; the
+ * first ACK carries the pipeline fill latency and is not sampled.
+ */
+static inline OpStatus_t minipow_manager_window_ack_at(MiniPoWManagerTracker *mgr, mini_pow_window_t *window,
+                                                       mini_pow_timing_t *timing, uint32_t challenge_id,
+                                                       uint64_t now) {
+    if (!mgr || !window) return OP_NULL_PTR;
+    uint32_t iteration;
+    uint64_t service;
+    bool sampled;
+    OpStatus_t st = mini_pow_window_ack(window, challenge_id, now, &iteration, &service, &sampled);
+    if (st != OP_SUCCESS) return st;
+
+    mgr->timeTracker.recent_receive_time = now;
+    if (sampled) {
+        mgr->timeTracker.cumulative_duration += service;
+        mini_pow_timing_record(timing, service);
+        pkc_metrics_observe_ns(PKC_HIST_MINI_POW_ITERATION, service);
+    }
+    pkc_metrics_count(PKC_CTR_MINI_POW_ITERATIONS, 1);
+
+    pkc_trace_mini_pow_iteration(mgr->sessionID, challenge_id, iteration,
+                                 window->sent_ns[iteration], now, service);
+
+    mgr->currentIteration++;
+    return OP_SUCCESS;
+}
+
+/* Clock-reading wrappers; the _at forms take an explicit timestamp. */
+static inline OpStatus_t minipow_manager_window_send(MiniPoWManagerTracker *mgr, mini_pow_window_t *window,
+                                                     uint32_t *out_iteration, uint32_t *out_challenge_id) {
+    return minipow_manager_window_send_at(mgr, window, mini_pow_tracker_get_current_ns(),
+                                          out_iteration, out_challenge_id);
+}
+
+static inline OpStatus_t minipow_manager_window_ack(MiniPoWManagerTracker *mgr, mini_pow_window_t *window,
+                                                    mini_pow_timing_t *timing, uint32_t challenge_id) {
+    return minipow_manager_window_ack_at(mgr, window, timing, challenge_id, mini_pow_tracker_get_current_ns());
+}
+
+/*
+ * Verifies the solved matrix and classifies the session with the tier
+ * engine. `rtt` (no-op probe baseline), `cfg` (thresholds) and
+ * `out_class` (full classification incl. confidence) may all be NULL.
+ */
+static inline mini_pow_result minipow_manager_finalize_ex(MiniPoWManagerTracker *mgr,
+                                                          mini_pow_timing_t *timing,
+                                                          const mini_pow_rtt_baseline_t *rtt,
+                                                          const mini_pow_classify_config_t *cfg,
+                                                          const SolvedMatricPoW *solved,
+                                                          const mini_pow_Matrix *matrices,
+                                                          mini_pow_classification_t *out_class) {
     mini_pow_result result;
     result.challengeid = mgr->timeTracker.challenge_id;
     result.sessionid = mgr->sessionID;
     result.minipowmatrix = matrices;
     result.solvedmatrix = solved;
-    result.isValid = mini_pow_verify(solved, matrices);
-    
+    uint64_t verify_start = pkc_metrics_now_ns();
+    result.isValid = mini_pow_verify_parallel(solved, matrices, 0, NULL);
+    uint64_t verify_end = pkc_metrics_now_ns();
+    pkc_metrics_observe_ns(PKC_HIST_MINI_POW_VERIFY, verify_end - verify_start);
+    pkc_metrics_count(PKC_CTR_MINI_POW_SESSIONS, 1);
+
+    mini_pow_classification_t cls;
+    memset(&cls, 0, sizeof(cls));
+    cls.tier = TIER_INVALID;
+
     if (result.isValid) {
-        result.tier = mini_pow_assign_tier(mgr->timeTracker.cumulative_duration);
+        if (timing && timing->count > 0 && mini_pow_classify(timing, rtt, cfg, &cls) == OP_SUCCESS) {
+            mini_pow_timing_finalize(timing);
+            result.tier = cls.tier;
+        } else {
+            result.tier = mini_pow_assign_tier(mgr->timeTracker.cumulative_duration / 1000ULL);
+            cls.tier = result.tier;
+        }
     } else {
         result.tier = TIER_INVALID;
     }
-    
+
+    pkc_trace_mini_pow_finalize(mgr->sessionID, result.challengeid, mgr->currentIteration,
+                                verify_start, verify_end, (uint16_t)result.tier);
+
+    if (out_class) *out_class = cls;
     return result;
 }
 
+static inline mini_pow_result minipow_manager_finalize(MiniPoWManagerTracker *mgr, 
+                                                       mini_pow_timing_t *timing,
+                                                       const SolvedMatricPoW *solved, 
+                                                       const mini_pow_Matrix *matrices) {
+    return minipow_manager_finalize_ex(mgr, timing, NULL, NULL, solved, matrices, NULL);
+}
+
 #endif // MINI_POW_MANAGER_H
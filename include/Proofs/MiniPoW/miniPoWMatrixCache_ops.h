@@ -0,0 +1,244 @@
+#ifndef MINI_POW_MATRIX_CACHE_H
+#define MINI_POW_MATRIX_CACHE_H
+
+
+#include "core/Global_Size_Offsets.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "core/datatypes/uint256_t.h"
+#include "core/enums/OpStatus.h"
+#include "protocol/blockchain/certificate.h"
+#include "crypto/SeedUtil.h"
+#include "Proofs/MiniPoW/miniPoWMatrix_ops.h"
+#include "Proofs/MiniPoW/miniPoWArena_ops.h"
+#include "telemetry/metrics_ops.h"
+
+/*
+ * Bounded LRU cache of generated MiniPoW matrices, keyed by the seed
+ * mini_pow_seed_gen derives from (cert, lastBlockHash, session, challenge).
+ * The challenge sender and the final verifier acquire the same entry, so
+ * a session generates its 2M CSPRNG draws once.
+ *
+ * Capacity is memory_budget / sizeof(mini_pow_Matrix) (and never more than
+ * the arena holds, when one is supplied). Entries are reference counted:
+ * only unreferenced entries are evicted. A new lastBlockHash invalidates
+ * every entry generated under the old one, since those sessions are dead;
+ * entries still referenced are unlinked at once and freed on release.
+ *
+ * Entries are few (budget / 4 MB), so lookup is a scan of the seed keys.
+ */
+
+#define MINI_POW_MATRIX_CACHE_NONE UINT32_MAX
+
+typedef struct {
+    uint256 seed;
+    uint256 block_hash;
+    mini_pow_Matrix *matrices;
+    uint32_t refs;
+    uint32_t prev;              // towards MRU
+    uint32_t next;              // towards LRU
+    bool used;
+    bool stale;                 // invalidated while referenced
+} mini_pow_matrix_cache_entry_t;
+
+typedef struct {
+    mini_pow_matrix_cache_entry_t *entries;
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t mru;
+    uint32_t lru;
+    size_t memory_budget;
+    mini_pow_arena_t *arena;    // NULL: malloc
+    uint256 block_hash;
+    bool has_block;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t invalidations;
+} mini_pow_matrix_cache_t;
+
+static inline OpStatus_t mini_pow_matrix_cache_init(mini_pow_matrix_cache_t *cache, size_t memory_budget,
+                                                    mini_pow_arena_t *arena)
+{
+    if (!cache) return OP_NULL_PTR;
+    memset(cache, 0, sizeof(*cache));
+
+    size_t cap = memory_budget / sizeof(mini_pow_Matrix);
+    if (arena && cap > arena->pools[MINI_POW_SLAB_MATRIX].capacity) cap = arena->pools[MINI_POW_SLAB_MATRIX].capacity;
+    if (cap == 0 || cap >= MINI_POW_MATRIX_CACHE_NONE) return OP_INVALID_INPUT;
+
+    cache->entries = (mini_pow_matrix_cache_entry_t *)calloc(cap, sizeof(mini_pow_matrix_cache_entry_t));
+    if (!cache->entries) return OP_INVALID_STATE;
+    cache->capacity = (uint32_t)cap;
+    cache->mru = cache->lru = MINI_POW_MATRIX_CACHE_NONE;
+    cache->memory_budget = memory_budget;
+    cache->arena = arena;
+    return OP_SUCCESS;
+}
+
+static inline void mini_pow_matrix_cache_free_matrices(mini_pow_matrix_cache_t *cache, mini_pow_Matrix *m)
+{
+    if (!m) return;
+    if (cache->arena) mini_pow_arena_free(cache->arena, MINI_POW_SLAB_MATRIX, m);
+    else free(m);
+}
+
+static inline void mini_pow_matrix_cache_unlink(mini_pow_matrix_cache_t *cache, uint32_t i)
+{
+    mini_pow_matrix_cache_entry_t *e = &cache->entries[i];
+    if (e->prev != MINI_POW_MATRIX_CACHE_NONE) cache->entries[e->prev].next = e->next;
+    else cache->mru = e->next;
+    if (e->next != MINI_POW_MATRIX_CACHE_NONE) cache->entries[e->next].prev = e->prev;
+    else cache->lru = e->prev;
+    e->prev = e->next = MINI_POW_MATRIX_CACHE_NONE;
+}
+
+static inline void mini_pow_matrix_cache_push_mru(mini_pow_matrix_cache_t *cache, uint32_t i)
+{
+    mini_pow_matrix_cache_entry_t *e = &cache->entries[i];
+    e->prev = MINI_POW_MATRIX_CACHE_NONE;
+    e->next = cache->mru;
+    if (cache->mru != MINI_POW_MATRIX_CACHE_NONE) cache->entries[cache->mru].prev = i;
+    cache->mru = i;
+    if (cache->lru == MINI_POW_MATRIX_CACHE_NONE) cache->lru = i;
+}
+
+static inline void mini_pow_matrix_cache_drop(mini_pow_matrix_cache_t *cache, uint32_t i)
+{
+    mini_pow_matrix_cache_entry_t *e = &cache->entries[i];
+    if (!e->stale) mini_pow_matrix_cache_unlink(cache, i);
+    mini_pow_matrix_cache_free_matrices(cache, e->matrices);
+    memset(e, 0, sizeof(*e));
+    cache->count--;
+}
+
+static inline void mini_pow_matrix_cache_destroy(mini_pow_matrix_cache_t *cache)
+{
+    if (!cache || !cache->entries) return;
+    for (uint32_t i = 0; i < cache->capacity; ++i) {
+        if (cache->entries[i].used) mini_pow_matrix_cache_free_matrices(cache, cache->entries[i].matrices);
+    }
+    free(cache->entries);
+    memset(cache, 0, sizeof(*cache));
+}
+
+/*
+ * Session invalidation: drops everything generated under another block
+ * hash. Referenced entries become stale and go on their last release.
+ */
+static inline void mini_pow_matrix_cache_invalidate_block(mini_pow_matrix_cache_t *cache, const uint256 *block_hash)
+{
+    if (!cache || !block_hash) return;
+    if (cache->has_block && memcmp(&cache->block_hash, block_hash, sizeof(uint256)) == 0) return;
+
+    for (uint32_t i = 0; i < cache->capacity; ++i) {
+        mini_pow_matrix_cache_entry_t *e = &cache->entries[i];
+        if (!e->used || e->stale || memcmp(&e->block_hash, block_hash, sizeof(uint256)) == 0) continue;
+        cache->invalidations++;
+        if (e->refs == 0) {
+            mini_pow_matrix_cache_drop(cache, i);
+        } else {
+            mini_pow_matrix_cache_unlink(cache, i);
+            e->stale = true;
+        }
+    }
+    cache->block_hash = *block_hash;
+    cache->has_block = true;
+}
+
+static inline uint32_t mini_pow_matrix_cache_make_room(mini_pow_matrix_cache_t *cache)
+{
+    for (uint32_t i = 0; i < cache->capacity; ++i) {
+        if (!cache->entries[i].used) return i;
+    }
+    for (uint32_t i = cache->lru; i != MINI_POW_MATRIX_CACHE_NONE; i = cache->entries[i].prev) {
+        if (cache->entries[i].refs == 0) {
+            mini_pow_matrix_cache_drop(cache, i);
+            cache->evictions++;
+            pkc_metrics_count(PKC_CTR_MINI_POW_MATRIX_CACHE_EVICTIONS, 1);
+            return i;
+        }
+    }
+    return MINI_POW_MATRIX_CACHE_NONE;
+}
+
+/*
+ * Returns the matrices for these inputs, generating them on a miss. Every
+ * successful acquire must be paired with mini_pow_matrix_cache_release.
+ * OP_INVALID_STATE when every entry is referenced or allocation fails.
+ */
+static inline OpStatus_t mini_pow_matrix_cache_acquire(mini_pow_matrix_cache_t *cache,
+                                                       const certificate *miner_cert,
+                                                       const uint256 *lastBlockHash,
+                                                       uint32_t sessionId,
+                                                       uint32_t challengeID,
+                                                       const mini_pow_Matrix **out)
+{
+    if (!cache || !cache->entries || !miner_cert || !lastBlockHash || !out) return OP_NULL_PTR;
+
+    mini_pow_matrix_cache_invalidate_block(cache, lastBlockHash);
+
+    uint256 seed;
+    OpStatus_t st = mini_pow_seed_gen(miner_cert, lastBlockHash, &sessionId, &challengeID, &seed);
+    if (st != OP_SUCCESS) return st;
+
+    for (uint32_t i = 0; i < cache->capacity; ++i) {
+        mini_pow_matrix_cache_entry_t *e = &cache->entries[i];
+        if (e->used && !e->stale && memcmp(&e->seed, &seed, sizeof(uint256)) == 0) {
+            e->refs++;
+            mini_pow_matrix_cache_unlink(cache, i);
+            mini_pow_matrix_cache_push_mru(cache, i);
+            cache->hits++;
+            pkc_metrics_count(PKC_CTR_MINI_POW_MATRIX_CACHE_HITS, 1);
+            *out = e->matrices;
+            return OP_SUCCESS;
+        }
+    }
+
+    cache->misses++;
+    pkc_metrics_count(PKC_CTR_MINI_POW_MATRIX_CACHE_MISSES, 1);
+
+    const uint32_t i = mini_pow_matrix_cache_make_room(cache);
+    if (i == MINI_POW_MATRIX_CACHE_NONE) return OP_INVALID_STATE;
+
+    // Generation overwrites every byte, so neither source is zeroed.
+    mini_pow_Matrix *m = cache->arena ? mini_pow_arena_matrix(cache->arena)
+                                      : (mini_pow_Matrix *)malloc(sizeof(mini_pow_Matrix));
+    if (!m) return OP_INVALID_STATE;
+
+    st = construct_mini_pow_matrices(miner_cert, lastBlockHash, sessionId, challengeID, m);
+    if (st != OP_SUCCESS) {
+        mini_pow_matrix_cache_free_matrices(cache, m);
+        return st;
+    }
+
+    mini_pow_matrix_cache_entry_t *e = &cache->entries[i];
+    e->seed = seed;
+    e->block_hash = *lastBlockHash;
+    e->matrices = m;
+    e->refs = 1;
+    e->used = true;
+    e->stale = false;
+    mini_pow_matrix_cache_push_mru(cache, i);
+    cache->count++;
+    *out = m;
+    return OP_SUCCESS;
+}
+
+static inline OpStatus_t mini_pow_matrix_cache_release(mini_pow_matrix_cache_t *cache, const mini_pow_Matrix *matrices)
+{
+    if (!cache || !matrices) return OP_NULL_PTR;
+    for (uint32_t i = 0; i < cache->capacity; ++i) {
+        mini_pow_matrix_cache_entry_t *e = &cache->entries[i];
+        if (!e->used || e->matrices != matrices) continue;
+        if (e->refs == 0) return OP_INVALID_STATE;
+        if (--e->refs == 0 && e->stale) mini_pow_matrix_cache_drop(cache, i);
+        return OP_SUCCESS;
+    }
+    return OP_INVALID_INPUT;
+}
+
+#endif // MINI_POW_MATRIX_CACHE_H
@@ -0,0 +1,407 @@
+#ifndef MINI_POW_SESSION_TABLE_H
+#define MINI_POW_SESSION_TABLE_H
+
+
+#include "core/Global_Size_Offsets.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "core/enums/OpStatus.h"
+#include "Proofs/MiniPoW/miniPoWManager_ops.h"
+#include "Proofs/MiniPoW/miniPoWChallenge_ops.h"
+#include "Proofs/MiniPoW/miniPoWChallengeSendQueue_ops.h"
+#include "Proofs/MiniPoW/miniPoWChallengeReceiveQueue_ops.h"
+
+/*
+ * Session table for running many MiniPoW classifications at once.
+ *
+ * Every session gets its own MiniPoWManagerTracker, window and timing
+ * series in a preallocated slot; session ids map to slots through an
+ * open-addressed index. pump() interleaves sends round-robin, one
+ * challenge per session per turn, until the send queue is full. Sessions
+ * that make no ACK progress for idle_timeout_ns, or outlive
+ * session_timeout_ns, are expired and their challenges pruned from both
+ * queues.
+ *
+ * Memory is bounded: the slots are sized up front and every open()
+ * charges the caller's per-session bytes (e.g. an arena matrix) against
+ * memory_budget. The 64 MB default is sized for verifiers working from
+ * the compact wire seed (charge 0): the fixed table for 512 sessions is
+ * about 8 MB. A verifier that keeps a full mini_pow_Matrix per session
+ * (4 MB at N = 1000) fits only about 14 of them in it and should set
+ * memory_budget = MINI_POW_SESSION_BUDGET_FOR(capacity, sizeof(mini_pow_Matrix)).
+ * Single-threaded, like the rest of the verifier loop; all timestamps are
+ * passed in.
+ */
+
+#ifndef MINI_POW_SESSIONS_DEFAULT
+#define MINI_POW_SESSIONS_DEFAULT 512
+#endif
+
+#define MINI_POW_SESSION_WINDOW_DEFAULT 4
+#define MINI_POW_SESSION_IDLE_TIMEOUT_NS 2000000000ULL
+#define MINI_POW_SESSION_TIMEOUT_NS 30000000000ULL
+#define MINI_POW_SESSION_BUDGET_DEFAULT ((size_t)64 * 1024 * 1024)
+// Fixed table plus `charge` bytes for every one of `sessions` slots.
+#define MINI_POW_SESSION_BUDGET_FOR(sessions, charge) \
+    (MINI_POW_SESSION_BUDGET_DEFAULT + (size_t)(sessions) * (size_t)(charge))
+
+typedef enum {
+    MINI_POW_SESSION_FREE = 0,
+    MINI_POW_SESSION_ACTIVE,
+    MINI_POW_SESSION_COMPLETE,
+} mini_pow_session_state_t;
+
+typedef struct {
+    uint32_t capacity;
+    uint32_t window;
+    uint64_t idle_timeout_ns;
+    uint64_t session_timeout_ns;
+    size_t memory_budget;
+} mini_pow_session_table_config_t;
+
+typedef struct {
+    uint32_t state;
+    uint32_t session_id;
+    uint64_t opened_ns;
+    uint64_t last_progress_ns;
+    size_t charge;
+    const mini_pow_Matrix *matrices;
+    void *user;
+    MiniPoWManagerTracker mgr;
+    mini_pow_window_t window;
+    mini_pow_timing_t timing;
+} mini_pow_session_slot_t;
+
+typedef struct {
+    mini_pow_session_table_config_t cfg;
+    mini_pow_session_slot_t *slots;
+    uint32_t *free_stack;
+    uint32_t free_top;
+    uint32_t *index;            // slot + 1, 0 = empty
+    uint32_t index_mask;
+    uint32_t cursor;
+    uint32_t active;
+    size_t bytes_fixed;
+    size_t bytes_charged;
+    uint64_t opened;
+    uint64_t completed;
+    uint64_t expired;
+    uint64_t refused;
+} mini_pow_session_table_t;
+
+/*
+ * Fills `out` with the challenge for (slot, iteration). Lets callers pick
+ * the source: full matrices, the compact wire expansion, or a stand-in.
+ */
+typedef OpStatus_t (*mini_pow_session_build_fn)(void *ctx, const mini_pow_session_slot_t *slot,
+                                               uint32_t iteration, uint32_t challenge_id,
+                                               mini_pow_challenge_t *out);
+
+static inline void mini_pow_session_table_config_default(mini_pow_session_table_config_t *cfg)
+{
+    if (!cfg) return;
+    cfg->capacity = MINI_POW_SESSIONS_DEFAULT;
+    cfg->window = MINI_POW_SESSION_WINDOW_DEFAULT;
+    cfg->idle_timeout_ns = MINI_POW_SESSION_IDLE_TIMEOUT_NS;
+    cfg->session_timeout_ns = MINI_POW_SESSION_TIMEOUT_NS;
+    cfg->memory_budget = MINI_POW_SESSION_BUDGET_DEFAULT;
+}
+
+static inline OpStatus_t mini_pow_session_table_init(mini_pow_session_table_t *t,
+                                                     const mini_pow_session_table_config_t *cfg)
+{
+    if (!t) return OP_NULL_PTR;
+    memset(t, 0, sizeof(*t));
+    if (cfg) t->cfg = *cfg;
+    else mini_pow_session_table_config_default(&t->cfg);
+
+    if (t->cfg.capacity == 0 || t->cfg.window == 0 || t->cfg.window > MINI_POW_WINDOW_MAX) return OP_INVALID_INPUT;
+
+    uint32_t index_len = 1;
+    while (index_len < t->cfg.capacity * 2u) index_len <<= 1;
+
+    t->bytes_fixed = (size_t)t->cfg.capacity * (sizeof(mini_pow_session_slot_t) + sizeof(uint32_t)) +
+                     (size_t)index_len * sizeof(uint32_t);
+    if (t->bytes_fixed > t->cfg.memory_budget) return OP_INVALID_INPUT;
+
+    t->slots = (mini_pow_session_slot_t *)calloc(t->cfg.capacity, sizeof(mini_pow_session_slot_t));
+    t->free_stack = (uint32_t *)malloc((size_t)t->cfg.capacity * sizeof(uint32_t));
+    t->index = (uint32_t *)calloc(index_len, sizeof(uint32_t));
+    if (!t->slots || !t->free_stack || !t->index) {
+        free(t->slots);
+        free(t->free_stack);
+        free(t->index);
+        memset(t, 0, sizeof(*t));
+        return OP_INVALID_STATE;
+    }
+
+    t->index_mask = index_len - 1;
+    for (uint32_t i = 0; i < t->cfg.capacity; ++i) {
+        t->free_stack[i] = t->cfg.capacity - 1 - i;
+    }
+    t->free_top = t->cfg.capacity;
+    return OP_SUCCESS;
+}
+
+static inline void mini_pow_session_table_destroy(mini_pow_session_table_t *t)
+{
+    if (!t) return;
+    free(t->slots);
+    free(t->free_stack);
+    free(t->index);
+    memset(t, 0, sizeof(*t));
+}
+
+static inline uint32_t mini_pow_session_table_hash(const mini_pow_session_table_t *t, uint32_t session_id)
+{
+    return (session_id * 0x9E3779B1u) & t->index_mask;
+}
+
+static inline uint32_t *mini_pow_session_table_probe(const mini_pow_session_table_t *t, uint32_t session_id)
+{
+    uint32_t h = mini_pow_session_table_hash(t, session_id);
+    for (;;) {
+        uint32_t *e = &t->index[h];
+        if (*e == 0 || t->slots[*e - 1].session_id == session_id) return e;
+        h = (h + 1) & t->index_mask;
+    }
+}
+
+static inline mini_pow_session_slot_t *mini_pow_session_table_find(mini_pow_session_table_t *t, uint32_t session_id)
+{
+    if (!t || !t->index) return NULL;
+    uint32_t *e = mini_pow_session_table_probe(t, session_id);
+    return *e ? &t->slots[*e - 1] : NULL;
+}
+
+/* Linear-probing delete with backward shift, so lookups never see holes. */
+static inline void mini_pow_session_table_unindex(mini_pow_session_table_t *t, uint32_t session_id)
+{
+    uint32_t *e = mini_pow_session_table_probe(t, session_id);
+    if (*e == 0) return;
+
+    uint32_t hole = (uint32_t)(e - t->index);
+    uint32_t j = hole;
+    *e = 0;
+    for (;;) {
+        j = (j + 1) & t->index_mask;
+        if (t->index[j] == 0) return;
+        uint32_t home = mini_pow_session_table_hash(t, t->slots[t->index[j] - 1].session_id);
+        // Move j into the hole unless its home lies cyclically in (hole, j].
+        bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (!stays) {
+            t->index[hole] = t->index[j];
+            t->index[j] = 0;
+            hole = j;
+        }
+    }
+}
+
+/*
+ * Admits a session. `charge` is the caller's per-session memory (0 when the
+ * verifier works from the compact wire seed only). Returns OP_INVALID_STATE
+ * when the table is full or the budget would be exceeded.
+ */
+static inline OpStatus_t mini_pow_session_table_open(mini_pow_session_table_t *t, uint32_t session_id,
+                                                     uint32_t base_challenge_id, const mini_pow_Matrix *matrices,
+                                                     size_t charge, uint64_t now, void *user,
+                                                     mini_pow_session_slot_t **out_slot)
+{
+    if (!t || !t->slots) return OP_NULL_PTR;
+    if (mini_pow_session_table_find(t, session_id)) return OP_INVALID_INPUT;
+    if (t->free_top == 0 || t->bytes_fixed + t->bytes_charged + charge > t->cfg.memory_budget) {
+        t->refused++;
+        return OP_INVALID_STATE;
+    }
+
+    const uint32_t idx = t->free_stack[--t->free_top];
+    mini_pow_session_slot_t *s = &t->slots[idx];
+    s->state = MINI_POW_SESSION_ACTIVE;
+    s->session_id = session_id;
+    s->opened_ns = now;
+    s->last_progress_ns = now;
+    s->charge = charge;
+    s->matrices = matrices;
+    s->user = user;
+    minipow_manager_tracker_init(&s->mgr, session_id);
+    mini_pow_timing_init(&s->timing);
+    minipow_manager_window_begin(&s->mgr, &s->window, base_challenge_id, t->cfg.window);
+
+    *mini_pow_session_table_probe(t, session_id) = idx + 1;
+    t->bytes_charged += charge;
+    t->active++;
+    t->opened++;
+    if (out_slot) *out_slot = s;
+    return OP_SUCCESS;
+}
+
+/*
+ * Drops a session and prunes its outstanding challenges. Either queue may
+ * be NULL.
+ */
+static inline OpStatus_t mini_pow_session_table_close(mini_pow_session_table_t *t, uint32_t session_id,
+                                                      mini_pow_challenge_queue_t *send_q,
+                                                      mini_pow_challenge_receive_queue_t *recv_q)
+{
+    mini_pow_session_slot_t *s = mini_pow_session_table_find(t, session_id);
+    if (!s) return OP_INVALID_INPUT;
+
+    mini_pow_challenge_queue_prune_by_session(send_q, session_id);
+    mini_pow_challenge_receive_queue_prune_by_session(recv_q, session_id);
+
+    mini_pow_session_table_unindex(t, session_id);
+    t->bytes_charged -= s->charge;
+    t->active--;
+    s->state = MINI_POW_SESSION_FREE;
+    t->free_stack[t->free_top++] = (uint32_t)(s - t->slots);
+    return OP_SUCCESS;
+}
+
+/*
+ * Default builder: column i of A and row i of B from the slot's matrices.
+ */
+static inline OpStatus_t mini_pow_session_build_from_matrices(void *ctx, const mini_pow_session_slot_t *slot,
+                                                              uint32_t iteration, uint32_t challenge_id,
+                                                              mini_pow_challenge_t *out)
+{
+    (void)ctx;
+    if (!slot->matrices) return OP_INVALID_STATE;
+    out->challenge_id = challenge_id;
+    out->session_id = slot->session_id;
+    out->iteration = iteration;
+    for (size_t k = 0; k < MINI_POW_MATRIX_N; ++k) {
+        out->columnOfA[k] = slot->matrices->A[k][iteration];
+        out->rowOfB[k] = slot->matrices->B[iteration][k];
+    }
+    return OP_SUCCESS;
+}
+
+/*
+ * Round-robin scheduler: one challenge per session per turn until the
+ * queue is full or no session has window left. Returns the number sent.
+ * A session whose builder fails is skipped for this pump.
+ */
+static inline uint32_t mini_pow_session_table_pump(mini_pow_session_table_t *t, uint64_t now,
+                                                   mini_pow_challenge_queue_t *send_q,
+                                                   mini_pow_session_build_fn build, void *ctx)
+{
+    if (!t || !t->slots || !send_q) return 0;
+    if (!build) build = mini_pow_session_build_from_matrices;
+
+    uint32_t sent = 0;
+    bool progress = true;
+    mini_pow_challenge_t ch;
+
+    while (progress && send_q->count < MINI_POW_CHALLENGE_QUEUE_MAX) {
+        progress = false;
+        for (uint32_t n = 0; n < t->cfg.capacity && send_q->count < MINI_POW_CHALLENGE_QUEUE_MAX; ++n) {
+            mini_pow_session_slot_t *s = &t->slots[t->cursor];
+            t->cursor = (t->cursor + 1 == t->cfg.capacity) ? 0 : t->cursor + 1;
+            if (s->state != MINI_POW_SESSION_ACTIVE || !mini_pow_window_can_send(&s->window)) continue;
+
+            const uint32_t iteration = s->window.next_send;
+            const uint32_t challenge_id = mini_pow_window_challenge_id(&s->window, iteration);
+            if (build(ctx, s, iteration, challenge_id, &ch) != OP_SUCCESS) continue;
+            if (mini_pow_challenge_queue_add(send_q, &ch) != OP_SUCCESS) return sent;
+
+            uint32_t it, cid;
+            minipow_manager_window_send_at(&s->mgr, &s->window, now, &it, &cid);
+            sent++;
+            progress = true;
+        }
+    }
+    return sent;
+}
+
+/*
+ * Routes an ACK to its session. A session that has all N ACKs becomes
+ * MINI_POW_SESSION_COMPLETE and stops being scheduled or expired.
+ */
+static inline OpStatus_t mini_pow_session_table_ack(mini_pow_session_table_t *t, uint32_t session_id,
+                                                    uint32_t challenge_id, uint64_t now)
+{
+    mini_pow_session_slot_t *s = mini_pow_session_table_find(t, session_id);
+    if (!s || s->state != MINI_POW_SESSION_ACTIVE) return OP_INVALID_INPUT;
+
+    OpStatus_t st = minipow_manager_window_ack_at(&s->mgr, &s->window, &s->timing, challenge_id, now);
+    if (st != OP_SUCCESS) return st;
+
+    s->last_progress_ns = now;
+    if (mini_pow_window_done(&s->window)) {
+        s->state = MINI_POW_SESSION_COMPLETE;
+        t->completed++;
+    }
+    return OP_SUCCESS;
+}
+
+/*
+ * Expires stalled or overlong sessions. Their ids go to `out_ids` (may be
+ * NULL) so the caller can release per-session memory; with `out_ids` set,
+ * at most `max_ids` sessions are expired per call and the rest are left
+ * for the next sweep. Returns the number expired.
+ */
+static inline uint32_t mini_pow_session_table_expire(mini_pow_session_table_t *t, uint64_t now,
+                                                     mini_pow_challenge_queue_t *send_q,
+                                                     mini_pow_challenge_receive_queue_t *recv_q,
+                                                     uint32_t *out_ids, uint32_t max_ids)
+{
+    if (!t || !t->slots) return 0;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < t->cfg.capacity; ++i) {
+        mini_pow_session_slot_t *s = &t->slots[i];
+        if (s->state != MINI_POW_SESSION_ACTIVE) continue;
+        const bool idle = now - s->last_progress_ns > t->cfg.idle_timeout_ns;
+        const bool overlong = now - s->opened_ns > t->cfg.session_timeout_ns;
+        if (!idle && !overlong) continue;
+
+        if (out_ids) {
+            if (n == max_ids) break;
+            out_ids[n] = s->session_id;
+        }
+        n++;
+        t->expired++;
+        mini_pow_session_table_close(t, s->session_id, send_q, recv_q);
+    }
+    return n;
+}
+
+/*
+ * Tier from the session's service-time series alone (no matrix check);
+ * the window already keeps the round trip out of the samples.
+ */
+static inline OpStatus_t mini_pow_session_table_classify(mini_pow_session_table_t *t, uint32_t session_id,
+                                                         const mini_pow_classify_config_t *cfg,
+                                                         mini_pow_classification_t *out_class)
+{
+    mini_pow_session_slot_t *s = mini_pow_session_table_find(t, session_id);
+    if (!s) return OP_INVALID_INPUT;
+    if (s->state != MINI_POW_SESSION_COMPLETE) return OP_INVALID_STATE;
+    return mini_pow_classify(&s->timing, NULL, cfg, out_class);
+}
+
+/*
+ * Verifies the solved matrix against the slot's matrices and classifies.
+ */
+static inline mini_pow_result mini_pow_session_table_finalize(mini_pow_session_table_t *t, uint32_t session_id,
+                                                              const mini_pow_classify_config_t *cfg,
+                                                              const SolvedMatricPoW *solved,
+                                                              mini_pow_classification_t *out_class)
+{
+    mini_pow_result result;
+    memset(&result, 0, sizeof(result));
+    result.tier = TIER_INVALID;
+
+    mini_pow_session_slot_t *s = mini_pow_session_table_find(t, session_id);
+    if (!s || s->state != MINI_POW_SESSION_COMPLETE || !s->matrices) return result;
+    return minipow_manager_finalize_ex(&s->mgr, &s->timing, NULL, cfg, solved, s->matrices, out_class);
+}
+
+static inline size_t mini_pow_session_table_bytes(const mini_pow_session_table_t *t)
+{
+    return t->bytes_fixed + t->bytes_charged;
+}
+
+#endif // MINI_POW_SESSION_TABLE_H
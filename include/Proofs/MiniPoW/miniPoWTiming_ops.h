@@ -0,0 +1,81 @@
+#ifndef MINI_POW_TIMING_H
+#define MINI_POW_TIMING_H
+
+
+#include "core/Global_Size_Offsets.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MINI_POW_TIMING_INLINE
+#define MINI_POW_TIMING_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Per-iteration latency series of one MiniPoW session (nanoseconds).
+ * Kept next to MiniPowTracker: the tracker still accumulates
+ * cumulative_duration, this keeps every sample so classification can use
+ * order statistics instead of a raw sum.
+ */
+typedef struct __attribute__((aligned(8))) {
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t min_ns;
+    uint64_t median_ns;
+    uint64_t p99_ns;
+    uint64_t samples_ns[MINI_POW_MATRIX_N];
+} mini_pow_timing_t;
+
+MINI_POW_TIMING_INLINE void mini_pow_timing_init(mini_pow_timing_t *timing)
+{
+    if (!timing) return;
+    timing->count = 0;
+    timing->reserved = 0;
+    timing->min_ns = 0;
+    timing->median_ns = 0;
+    timing->p99_ns = 0;
+}
+
+MINI_POW_TIMING_INLINE void mini_pow_timing_record(mini_pow_timing_t *timing, uint64_t duration_ns)
+{
+    if (!timing || timing->count >= MINI_POW_MATRIX_N) return;
+    timing->samples_ns[timing->count++] = duration_ns;
+}
+
+static inline int mini_pow_timing_cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Nearest-rank percentile (0..100) over an already sorted series.
+ */
+MINI_POW_TIMING_INLINE uint64_t mini_pow_timing_sorted_percentile(const uint64_t *sorted, uint32_t n, uint32_t pct)
+{
+    if (n == 0) return 0;
+    uint32_t rank = (uint32_t)(((uint64_t)pct * n + 99) / 100);
+    if (rank == 0) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+/*
+ * Computes min / median / p99 over the recorded samples. The samples are
+ * sorted on a copy so the series stays in iteration order.
+ */
+static inline void mini_pow_timing_finalize(mini_pow_timing_t *timing)
+{
+    if (!timing || timing->count == 0) return;
+
+    uint64_t sorted[MINI_POW_MATRIX_N];
+    memcpy(sorted, timing->samples_ns, (size_t)timing->count * sizeof(uint64_t));
+    qsort(sorted, timing->count, sizeof(uint64_t), mini_pow_timing_cmp_u64);
+
+    timing->min_ns = sorted[0];
+    timing->median_ns = mini_pow_timing_sorted_percentile(sorted, timing->count, 50);
+    timing->p99_ns = mini_pow_timing_sorted_percentile(sorted, timing->count, 99);
+}
+
+#endif // MINI_POW_TIMING_H
@@ -4,9 +4,9 @@
 
 #include "core/Global_Size_Offsets.h"
 #include "protocol/proofs/mini_pow/MiniPowTracker.h"
+#include "telemetry/clock_ops.h"
 #include <stdint.h>
 #include <string.h>
-#include <time.h>
 
 #ifndef MINI_POW_TRACKER_INLINE
 #define MINI_POW_TRACKER_INLINE static inline __attribute__((always_inline))
@@ -15,7 +15,8 @@
 /*
  * MiniPowTracker
  * Tracks start time, receive time, and cumulative duration for challenges
- * using Linux monotonic time (microseconds).
+ * in nanoseconds from pkc_clock_now_ns (calibrated invariant TSC, falling
+ * back to CLOCK_MONOTONIC).
  */
 // typedef struct __attribute__((aligned(4))) {
 //     uint32_t challenge_id;
@@ -35,25 +36,21 @@ MINI_POW_TRACKER_INLINE void mini_pow_tracker_init(MiniPowTracker *tracker)
     tracker->cumulative_duration = 0;
 }
 
-MINI_POW_TRACKER_INLINE uint64_t mini_pow_tracker_get_current_us(void)
+MINI_POW_TRACKER_INLINE uint64_t mini_pow_tracker_get_current_ns(void)
 {
-    struct timespec ts;
-    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
-        return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)(ts.tv_nsec / 1000ULL);
-    }
-    return 0;
+    return pkc_clock_now_ns();
 }
 
 MINI_POW_TRACKER_INLINE void mini_pow_tracker_update_start(MiniPowTracker *tracker)
 {
     if (!tracker) return;
-    tracker->recent_start_time = mini_pow_tracker_get_current_us();
+    tracker->recent_start_time = mini_pow_tracker_get_current_ns();
 }
 
 MINI_POW_TRACKER_INLINE void mini_pow_tracker_update_receive(MiniPowTracker *tracker)
 {
     if (!tracker) return;
-    tracker->recent_receive_time = mini_pow_tracker_get_current_us();
+    tracker->recent_receive_time = mini_pow_tracker_get_current_ns();
     if (tracker->recent_receive_time > tracker->recent_start_time) {
         tracker->cumulative_duration += (tracker->recent_receive_time - tracker->recent_start_time);
     }
@@ -0,0 +1,150 @@
+#ifndef MINI_POW_VERIFY_PARALLEL_H
+#define MINI_POW_VERIFY_PARALLEL_H
+
+
+#include "core/Global_Size_Offsets.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "protocol/proofs/mini_pow/mini_pow_Matrix.h"
+#include "protocol/proofs/mini_pow/SolvedMatricPoW.h"
+#include "core/enums/OpStatus.h"
+#include "scheduler/workPool_ops.h"
+
+#ifndef MINI_POW_VERIFY_PARALLEL_INLINE
+#define MINI_POW_VERIFY_PARALLEL_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Exact multi-threaded MiniPoW verification.
+ *
+ * Output rows are handed out in chunks from a shared counter, lowest rows
+ * first, so every worker stays busy and a corrupt early row is reached at
+ * once. Each row is recomputed as sum_k A[row][k] * B[k][*] into a row
+ * accumulator (sequential over B, auto-vectorised) and compared with the
+ * submitted row. The first mismatch sets a shared abort flag that every
+ * worker checks between rows, and records its (row, col).
+ *
+ * Workers are tasks on the shared pool (scheduler/workPool_ops.h) in the
+ * verification class, so verification is picked up ahead of mining.
+ */
+
+#ifndef MINI_POW_VERIFY_THREADS_MAX
+#define MINI_POW_VERIFY_THREADS_MAX 64
+#endif
+
+#ifndef MINI_POW_VERIFY_ROW_CHUNK
+#define MINI_POW_VERIFY_ROW_CHUNK 4
+#endif
+
+typedef struct {
+    bool valid;
+    uint32_t row;               // first mismatch seen, valid == false
+    uint32_t col;
+    uint32_t expected;
+    uint32_t submitted;
+    uint32_t rows_checked;
+} mini_pow_verify_report_t;
+
+typedef struct {
+    const SolvedMatricPoW *solved;
+    const mini_pow_Matrix *matrices;
+    _Atomic(uint32_t) next_row;
+    _Atomic(uint32_t) rows_checked;
+    _Atomic(int) abort;
+    mini_pow_verify_report_t *report;
+} mini_pow_verify_job_t;
+
+/*
+ * Recomputes one output row into `acc` and compares it. Returns the first
+ * mismatching column, or MINI_POW_MATRIX_N when the row matches.
+ */
+MINI_POW_VERIFY_PARALLEL_INLINE uint32_t mini_pow_verify_row(const mini_pow_Matrix *m, const SolvedMatricPoW *s,
+                                                             uint32_t row, uint32_t *restrict acc)
+{
+    memset(acc, 0, MINI_POW_MATRIX_N * sizeof(uint32_t));
+    for (uint32_t k = 0; k < MINI_POW_MATRIX_N; ++k) {
+        const uint32_t a = m->A[row][k];
+        const uint16_t *restrict b = m->B[k];
+        for (uint32_t c = 0; c < MINI_POW_MATRIX_N; ++c) {
+            acc[c] += a * (uint32_t)b[c];
+        }
+    }
+    if (memcmp(acc, s->Matrix[row], MINI_POW_MATRIX_N * sizeof(uint32_t)) == 0) return MINI_POW_MATRIX_N;
+    for (uint32_t c = 0; c < MINI_POW_MATRIX_N; ++c) {
+        if (acc[c] != s->Matrix[row][c]) return c;
+    }
+    return MINI_POW_MATRIX_N;
+}
+
+static inline void mini_pow_verify_worker(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    mini_pow_verify_job_t *job = (mini_pow_verify_job_t *)arg;
+    uint32_t acc[MINI_POW_MATRIX_N] __attribute__((aligned(64)));
+
+    while (!atomic_load_explicit(&job->abort, memory_order_relaxed) && !pkc_pool_cancelled(cancel)) {
+        const uint32_t first = atomic_fetch_add_explicit(&job->next_row, MINI_POW_VERIFY_ROW_CHUNK, memory_order_relaxed);
+        if (first >= MINI_POW_MATRIX_N) break;
+        const uint32_t last = first + MINI_POW_VERIFY_ROW_CHUNK < MINI_POW_MATRIX_N ? first + MINI_POW_VERIFY_ROW_CHUNK
+                                                                                    : MINI_POW_MATRIX_N;
+        for (uint32_t row = first; row < last; ++row) {
+            if (atomic_load_explicit(&job->abort, memory_order_relaxed)) return;
+            const uint32_t col = mini_pow_verify_row(job->matrices, job->solved, row, acc);
+            atomic_fetch_add_explicit(&job->rows_checked, 1, memory_order_relaxed);
+            if (col != MINI_POW_MATRIX_N) {
+                int expected = 0;
+                if (atomic_compare_exchange_strong_explicit(&job->abort, &expected, 1,
+                                                            memory_order_acq_rel, memory_order_relaxed)) {
+                    job->report->row = row;
+                    job->report->col = col;
+                    job->report->expected = acc[col];
+                    job->report->submitted = job->solved->Matrix[row][col];
+                }
+                return;
+            }
+        }
+    }
+}
+
+/* One share per pool worker; the calling thread takes one of them. */
+MINI_POW_VERIFY_PARALLEL_INLINE uint32_t mini_pow_verify_default_threads(void)
+{
+    uint32_t n = pkc_pool_workers(pkc_pool_default());
+    if (n == 0) n = 1;
+    return n > MINI_POW_VERIFY_THREADS_MAX ? MINI_POW_VERIFY_THREADS_MAX : n;
+}
+
+/*
+ * Verifies `solved` against `matrices` on `threads` workers (0 = every
+ * pool worker). The calling thread is one of the workers. `report` may be
+ * NULL; on rejection it carries the mismatching cell.
+ */
+static inline bool mini_pow_verify_parallel(const SolvedMatricPoW *solved, const mini_pow_Matrix *matrices,
+                                            uint32_t threads, mini_pow_verify_report_t *report)
+{
+    mini_pow_verify_report_t local;
+    if (!report) report = &local;
+    memset(report, 0, sizeof(*report));
+    if (!solved || !matrices) return false;
+
+    if (threads == 0) threads = mini_pow_verify_default_threads();
+    if (threads > MINI_POW_VERIFY_THREADS_MAX) threads = MINI_POW_VERIFY_THREADS_MAX;
+
+    mini_pow_verify_job_t job;
+    job.solved = solved;
+    job.matrices = matrices;
+    job.report = report;
+    atomic_init(&job.next_row, 0);
+    atomic_init(&job.rows_checked, 0);
+    atomic_init(&job.abort, 0);
+
+    pkc_pool_fork_join(pkc_pool_default(), PKC_POOL_PRIO_VERIFY, threads, mini_pow_verify_worker, &job, NULL);
+
+    report->rows_checked = atomic_load_explicit(&job.rows_checked, memory_order_relaxed);
+    report->valid = !atomic_load_explicit(&job.abort, memory_order_acquire);
+    return report->valid;
+}
+
+#endif // MINI_POW_VERIFY_PARALLEL_H
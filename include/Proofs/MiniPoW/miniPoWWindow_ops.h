@@ -0,0 +1,121 @@
+#ifndef MINI_POW_WINDOW_H
+#define MINI_POW_WINDOW_H
+
+
+#include "core/Global_Size_Offsets.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "core/enums/OpStatus.h"
+
+#ifndef MINI_POW_WINDOW_INLINE
+#define MINI_POW_WINDOW_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Sliding window for pipelined MiniPoW challenge streaming.
+ *
+ * Up to `size` iterations are in flight at once; iteration i travels as
+ * challenge_id = base_challenge_id + i so every ACK maps back to its own
+ * send timestamp. Each ACK yields a service time
+ *
+ *     service = ack_ns - max(sent_ns[i], previous_ack_ns)
+ *
+ * i.e. how long the miner spent on this iteration once it had both the
+ * work and a free solver. While the pipe is full that is pure compute;
+ * the round trip only shows up in the first ACK, which is not sampled.
+ */
+
+#ifndef MINI_POW_WINDOW_MAX
+#define MINI_POW_WINDOW_MAX 64 // must stay below the receive queue depth
+#endif
+
+#ifndef MINI_POW_WINDOW_DEFAULT
+#define MINI_POW_WINDOW_DEFAULT 16
+#endif
+
+typedef struct __attribute__((aligned(8))) {
+    uint32_t size;
+    uint32_t base_challenge_id;
+    uint32_t next_send;
+    uint32_t acked;
+    uint64_t last_ack_ns;
+    uint64_t sent_ns[MINI_POW_MATRIX_N];
+    uint8_t acked_bits[(MINI_POW_MATRIX_N + 7) / 8];
+} mini_pow_window_t;
+
+MINI_POW_WINDOW_INLINE OpStatus_t mini_pow_window_init(mini_pow_window_t *w, uint32_t base_challenge_id, uint32_t size)
+{
+    if (!w) return OP_NULL_PTR;
+    if (size == 0 || size > MINI_POW_WINDOW_MAX) return OP_INVALID_INPUT;
+    w->size = size;
+    w->base_challenge_id = base_challenge_id;
+    w->next_send = 0;
+    w->acked = 0;
+    w->last_ack_ns = 0;
+    memset(w->acked_bits, 0, sizeof(w->acked_bits));
+    return OP_SUCCESS;
+}
+
+MINI_POW_WINDOW_INLINE uint32_t mini_pow_window_in_flight(const mini_pow_window_t *w)
+{
+    return w->next_send - w->acked;
+}
+
+MINI_POW_WINDOW_INLINE bool mini_pow_window_can_send(const mini_pow_window_t *w)
+{
+    return w && w->next_send < MINI_POW_MATRIX_N && mini_pow_window_in_flight(w) < w->size;
+}
+
+MINI_POW_WINDOW_INLINE bool mini_pow_window_done(const mini_pow_window_t *w)
+{
+    return w && w->acked >= MINI_POW_MATRIX_N;
+}
+
+MINI_POW_WINDOW_INLINE uint32_t mini_pow_window_challenge_id(const mini_pow_window_t *w, uint32_t iteration)
+{
+    return w->base_challenge_id + iteration;
+}
+
+/*
+ * Claims the next iteration to send and stamps it. Returns OP_INVALID_STATE
+ * when the window is full or every iteration has been sent.
+ */
+MINI_POW_WINDOW_INLINE OpStatus_t mini_pow_window_send(mini_pow_window_t *w, uint64_t now_ns, uint32_t *out_iteration)
+{
+    if (!w || !out_iteration) return OP_NULL_PTR;
+    if (!mini_pow_window_can_send(w)) return OP_INVALID_STATE;
+    uint32_t i = w->next_send++;
+    w->sent_ns[i] = now_ns;
+    *out_iteration = i;
+    return OP_SUCCESS;
+}
+
+/*
+ * Matches an ACK to its iteration. On success `out_service_ns` holds the
+ * service time and `out_sampled` says whether it is free of the round trip
+ * (false only for the very first ACK of the session).
+ */
+MINI_POW_WINDOW_INLINE OpStatus_t mini_pow_window_ack(mini_pow_window_t *w, uint32_t challenge_id, uint64_t now_ns,
+                                                      uint32_t *out_iteration, uint64_t *out_service_ns,
+                                                      bool *out_sampled)
+{
+    if (!w || !out_iteration || !out_service_ns || !out_sampled) return OP_NULL_PTR;
+
+    uint32_t i = challenge_id - w->base_challenge_id;
+    if (i >= w->next_send) return OP_INVALID_INPUT;
+    if (w->acked_bits[i >> 3] & (uint8_t)(1u << (i & 7))) return OP_INVALID_INPUT; // duplicate
+    w->acked_bits[i >> 3] |= (uint8_t)(1u << (i & 7));
+
+    const uint64_t ready = w->sent_ns[i] > w->last_ack_ns ? w->sent_ns[i] : w->last_ack_ns;
+    *out_sampled = w->acked > 0;
+    *out_service_ns = now_ns > ready ? now_ns - ready : 0;
+    *out_iteration = i;
+
+    w->last_ack_ns = now_ns;
+    w->acked++;
+    return OP_SUCCESS;
+}
+
+#endif // MINI_POW_WINDOW_H
@@ -0,0 +1,437 @@
+#ifndef MINI_POW_WIRE_H
+#define MINI_POW_WIRE_H
+
+
+#include "core/Global_Size_Offsets.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "core/datatypes/uint256_t.h"
+#include "core/enums/OpStatus.h"
+#include "crypto/SeedUtil.h"
+#include "net/NetworkSerialization.h"
+#include "protocol/proofs/mini_pow/mini_pow_challenge_t.h"
+#include "protocol/proofs/mini_pow/mini_pow_Matrix.h"
+
+#ifndef MINI_POW_WIRE_INLINE
+#define MINI_POW_WIRE_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Compact MiniPoW transport.
+ *
+ * Challenges travel as (seed, session, challenge, iteration) and the miner
+ * regenerates column i of A and row i of B from the same CSPRNG stream
+ * construct_mini_pow_matrices uses:
+ *
+ *     A[r][c] = csprng(seed, r * N + c)
+ *     B[r][c] = csprng(seed, N * N + r * N + c)
+ *
+ * Note that a seed-holding miner can front-load work, so per-iteration
+ * timing is only meaningful as session throughput in this mode.
+ *
+ * The solved matrix travels as a Merkle root over its rows. The verifier
+ * derives spot-check rows from the root (Fiat-Shamir), the miner opens
+ * them, and each opened row is recomputed by streaming B one row at a
+ * time, so a check holds O(spot_checks * N) words instead of N * N.
+ *
+ * Leaf  = H(0x00 || row_be32 || C[row][0..N) as be32)
+ * Inner = H(0x01 || left || right); an unpaired node is promoted as is.
+ */
+
+#define MINI_POW_MERKLE_DEPTH 10
+_Static_assert((1u << MINI_POW_MERKLE_DEPTH) >= MINI_POW_MATRIX_N, "MINI_POW_MERKLE_DEPTH too small for MINI_POW_MATRIX_N");
+
+#ifndef MINI_POW_SPOT_CHECKS
+#define MINI_POW_SPOT_CHECKS 16
+#endif
+
+#define MINI_POW_SPOT_CHECKS_MAX 64
+
+#define MINI_POW_CHALLENGE_WIRE_SIZE (UINT32_SIZE * 3 + UINT256_SIZE)
+#define MINI_POW_COMMIT_WIRE_SIZE (UINT32_SIZE * 2 + UINT256_SIZE)
+#define MINI_POW_OPENING_WIRE_SIZE (UINT32_SIZE * 2 + UINT32_SIZE * MINI_POW_MATRIX_N + UINT256_SIZE * MINI_POW_MERKLE_DEPTH)
+
+typedef struct __attribute__((aligned(4))) {
+    uint32_t challenge_id;
+    uint32_t session_id;
+    uint32_t iteration;
+    uint256 seed;
+} mini_pow_challenge_wire_t;
+
+typedef struct __attribute__((aligned(4))) {
+    uint32_t challenge_id;
+    uint32_t session_id;
+    uint256 root;
+} mini_pow_solved_commit_t;
+
+typedef struct __attribute__((aligned(4))) {
+    uint32_t row;
+    uint32_t path_len;
+    uint32_t values[MINI_POW_MATRIX_N];
+    uint256 path[MINI_POW_MERKLE_DEPTH];
+} mini_pow_row_opening_t;
+
+/*
+ * Miner-side tree. Levels are stored back to back starting with the N
+ * leaves; rounding up each level adds at most one node per level over 2N.
+ */
+typedef struct __attribute__((aligned(4))) {
+    uint32_t levels;
+    uint32_t level_off[MINI_POW_MERKLE_DEPTH + 1];
+    uint32_t level_len[MINI_POW_MERKLE_DEPTH + 1];
+    uint256 nodes[2 * MINI_POW_MATRIX_N + MINI_POW_MERKLE_DEPTH];
+} mini_pow_merkle_tree_t;
+
+typedef struct __attribute__((aligned(4))) {
+    uint32_t challenge_id;
+    uint32_t session_id;
+    uint256 seed;
+    uint256 root;
+    uint32_t count;
+    uint32_t rows[MINI_POW_SPOT_CHECKS_MAX];
+} mini_pow_spot_check_t;
+
+/* ---------------- challenges ---------------- */
+
+MINI_POW_WIRE_INLINE OpStatus_t mini_pow_wire_element(const uint256 *seed, uint32_t index, uint16_t *out)
+{
+    return mini_pow_csprng(seed, &index, out);
+}
+
+MINI_POW_WIRE_INLINE void mini_pow_challenge_wire_pack(mini_pow_challenge_wire_t *wire, const uint256 *seed,
+                                                       uint32_t session_id, uint32_t challenge_id, uint32_t iteration)
+{
+    if (!wire || !seed) return;
+    wire->challenge_id = challenge_id;
+    wire->session_id = session_id;
+    wire->iteration = iteration;
+    wire->seed = *seed;
+}
+
+MINI_POW_WIRE_INLINE OpStatus_t mini_pow_challenge_wire_serialize(const mini_pow_challenge_wire_t *wire,
+                                                                  uint8_t *buf, size_t len)
+{
+    if (!wire || !buf) return OP_NULL_PTR;
+    if (len < MINI_POW_CHALLENGE_WIRE_SIZE) return OP_BUFFER_TOO_SMALL;
+    serialize_u32_be(wire->challenge_id, buf);
+    serialize_u32_be(wire->session_id, buf + UINT32_SIZE);
+    serialize_u32_be(wire->iteration, buf + UINT32_SIZE * 2);
+    return uint256_serialize_be(&wire->seed, buf + UINT32_SIZE * 3, UINT256_SIZE);
+}
+
+MINI_POW_WIRE_INLINE OpStatus_t mini_pow_challenge_wire_deserialize(const uint8_t *buf, size_t len,
+                                                                    mini_pow_challenge_wire_t *wire)
+{
+    if (!wire || !buf) return OP_NULL_PTR;
+    if (len < MINI_POW_CHALLENGE_WIRE_SIZE) return OP_BUFFER_TOO_SMALL;
+    deserialize_u32_be(buf, &wire->challenge_id, UINT32_SIZE);
+    deserialize_u32_be(buf + UINT32_SIZE, &wire->session_id, UINT32_SIZE);
+    deserialize_u32_be(buf + UINT32_SIZE * 2, &wire->iteration, UINT32_SIZE);
+    if (wire->iteration >= MINI_POW_MATRIX_N) return OP_INVALID_INPUT;
+    return uint256_deserialize_be(buf + UINT32_SIZE * 3, UINT256_SIZE, &wire->seed);
+}
+
+/*
+ * Rebuilds the full challenge (column i of A, row i of B) on the miner.
+ */
+MINI_POW_WIRE_INLINE OpStatus_t mini_pow_challenge_expand(const mini_pow_challenge_wire_t *wire,
+                                                          mini_pow_challenge_t *out)
+{
+    if (!wire || !out) return OP_NULL_PTR;
+    const uint32_t i = wire->iteration;
+    if (i >= MINI_POW_MATRIX_N) return OP_INVALID_INPUT;
+
+    out->challenge_id = wire->challenge_id;
+    out->session_id = wire->session_id;
+    out->iteration = i;
+
+    const uint32_t b_base = (uint32_t)MINI_POW_MATRIX_N * MINI_POW_MATRIX_N + i * MINI_POW_MATRIX_N;
+    for (uint32_t k = 0; k < MINI_POW_MATRIX_N; ++k) {
+        OpStatus_t st = mini_pow_wire_element(&wire->seed, k * MINI_POW_MATRIX_N + i, &out->columnOfA[k]);
+        if (st != OP_SUCCESS) return st;
+        st = mini_pow_wire_element(&wire->seed, b_base + k, &out->rowOfB[k]);
+        if (st != OP_SUCCESS) return st;
+    }
+    return OP_SUCCESS;
+}
+
+/* ---------------- commitment ---------------- */
+
+static inline void mini_pow_merkle_leaf(uint32_t row, const uint32_t values[MINI_POW_MATRIX_N], uint256 *out)
+{
+    uint8_t buf[1 + UINT32_SIZE + UINT32_SIZE * MINI_POW_MATRIX_N];
+    buf[0] = 0x00;
+    serialize_u32_be(row, buf + 1);
+    for (uint32_t c = 0; c < MINI_POW_MATRIX_N; ++c) {
+        serialize_u32_be(values[c], buf + 1 + UINT32_SIZE + c * UINT32_SIZE);
+    }
+    hash256_buffer(buf, sizeof(buf), out);
+}
+
+MINI_POW_WIRE_INLINE void mini_pow_merkle_node(const uint256 *left, const uint256 *right, uint256 *out)
+{
+    uint8_t buf[1 + UINT256_SIZE * 2];
+    buf[0] = 0x01;
+    uint256_serialize_be(left, buf + 1, UINT256_SIZE);
+    uint256_serialize_be(right, buf + 1 + UINT256_SIZE, UINT256_SIZE);
+    hash256_buffer(buf, sizeof(buf), out);
+}
+
+static inline OpStatus_t mini_pow_merkle_build(mini_pow_merkle_tree_t *tree,
+                                               const uint32_t matrix[MINI_POW_MATRIX_N][MINI_POW_MATRIX_N])
+{
+    if (!tree || !matrix) return OP_NULL_PTR;
+
+    for (uint32_t r = 0; r < MINI_POW_MATRIX_N; ++r) {
+        mini_pow_merkle_leaf(r, matrix[r], &tree->nodes[r]);
+    }
+    tree->levels = 1;
+    tree->level_off[0] = 0;
+    tree->level_len[0] = MINI_POW_MATRIX_N;
+
+    uint32_t off = 0, len = MINI_POW_MATRIX_N, next = MINI_POW_MATRIX_N;
+    while (len > 1) {
+        const uint32_t parent_len = (len + 1) / 2;
+        for (uint32_t p = 0; p < parent_len; ++p) {
+            const uint32_t l = off + 2 * p;
+            if (2 * p + 1 < len) {
+                mini_pow_merkle_node(&tree->nodes[l], &tree->nodes[l + 1], &tree->nodes[next + p]);
+            } else {
+                tree->nodes[next + p] = tree->nodes[l];
+            }
+        }
+        tree->level_off[tree->levels] = next;
+        tree->level_len[tree->levels] = parent_len;
+        tree->levels++;
+        off = next;
+        next += parent_len;
+        len = parent_len;
+    }
+    return OP_SUCCESS;
+}
+
+MINI_POW_WIRE_INLINE const uint256 *mini_pow_merkle_root(const mini_pow_merkle_tree_t *tree)
+{
+    return &tree->nodes[tree->level_off[tree->levels - 1]];
+}
+
+MINI_POW_WIRE_INLINE void mini_pow_solved_commit(mini_pow_solved_commit_t *commit, const mini_pow_merkle_tree_t *tree,
+                                                 uint32_t session_id, uint32_t challenge_id)
+{
+    if (!commit || !tree) return;
+    commit->challenge_id = challenge_id;
+    commit->session_id = session_id;
+    commit->root = *mini_pow_merkle_root(tree);
+}
+
+MINI_POW_WIRE_INLINE OpStatus_t mini_pow_solved_commit_serialize(const mini_pow_solved_commit_t *commit,
+                                                                 uint8_t *buf, size_t len)
+{
+    if (!commit || !buf) return OP_NULL_PTR;
+    if (len < MINI_POW_COMMIT_WIRE_SIZE) return OP_BUFFER_TOO_SMALL;
+    serialize_u32_be(commit->challenge_id, buf);
+    serialize_u32_be(commit->session_id, buf + UINT32_SIZE);
+    return uint256_serialize_be(&commit->root, buf + UINT32_SIZE * 2, UINT256_SIZE);
+}
+
+MINI_POW_WIRE_INLINE OpStatus_t mini_pow_solved_commit_deserialize(const uint8_t *buf, size_t len,
+                                                                   mini_pow_solved_commit_t *commit)
+{
+    if (!commit || !buf) return OP_NULL_PTR;
+    if (len < MINI_POW_COMMIT_WIRE_SIZE) return OP_BUFFER_TOO_SMALL;
+    deserialize_u32_be(buf, &commit->challenge_id, UINT32_SIZE);
+    deserialize_u32_be(buf + UINT32_SIZE, &commit->session_id, UINT32_SIZE);
+    return uint256_deserialize_be(buf + UINT32_SIZE * 2, UINT256_SIZE, &commit->root);
+}
+
+/*
+ * Miner side: row values plus the sibling path. Promoted (unpaired) levels
+ * contribute no sibling, so path_len can be shorter than the depth.
+ */
+static inline OpStatus_t mini_pow_merkle_open(const mini_pow_merkle_tree_t *tree,
+                                              const uint32_t matrix[MINI_POW_MATRIX_N][MINI_POW_MATRIX_N],
+                                              uint32_t row, mini_pow_row_opening_t *out)
+{
+    if (!tree || !matrix || !out) return OP_NULL_PTR;
+    if (row >= MINI_POW_MATRIX_N) return OP_INVALID_INPUT;
+
+    out->row = row;
+    out->path_len = 0;
+    memcpy(out->values, matrix[row], sizeof(out->values));
+
+    uint32_t idx = row;
+    for (uint32_t lvl = 0; lvl + 1 < tree->levels; ++lvl) {
+        const uint32_t sib = idx ^ 1u;
+        if (sib < tree->level_len[lvl]) {
+            out->path[out->path_len++] = tree->nodes[tree->level_off[lvl] + sib];
+        }
+        idx >>= 1;
+    }
+    return OP_SUCCESS;
+}
+
+MINI_POW_WIRE_INLINE OpStatus_t mini_pow_row_opening_serialize(const mini_pow_row_opening_t *op, uint8_t *buf, size_t len)
+{
+    if (!op || !buf) return OP_NULL_PTR;
+    if (op->path_len > MINI_POW_MERKLE_DEPTH) return OP_INVALID_INPUT;
+    if (len < MINI_POW_OPENING_WIRE_SIZE) return OP_BUFFER_TOO_SMALL;
+    memset(buf, 0, MINI_POW_OPENING_WIRE_SIZE);
+    size_t off = 0;
+    serialize_u32_be(op->row, buf + off);
+    off += UINT32_SIZE;
+    serialize_u32_be(op->path_len, buf + off);
+    off += UINT32_SIZE;
+    for (uint32_t c = 0; c < MINI_POW_MATRIX_N; ++c, off += UINT32_SIZE) {
+        serialize_u32_be(op->values[c], buf + off);
+    }
+    for (uint32_t p = 0; p < op->path_len; ++p, off += UINT256_SIZE) {
+        uint256_serialize_be(&op->path[p], buf + off, UINT256_SIZE);
+    }
+    return OP_SUCCESS;
+}
+
+MINI_POW_WIRE_INLINE OpStatus_t mini_pow_row_opening_deserialize(const uint8_t *buf, size_t len, mini_pow_row_opening_t *op)
+{
+    if (!op || !buf) return OP_NULL_PTR;
+    if (len < MINI_POW_OPENING_WIRE_SIZE) return OP_BUFFER_TOO_SMALL;
+    size_t off = 0;
+    deserialize_u32_be(buf + off, &op->row, UINT32_SIZE);
+    off += UINT32_SIZE;
+    deserialize_u32_be(buf + off, &op->path_len, UINT32_SIZE);
+    off += UINT32_SIZE;
+    if (op->row >= MINI_POW_MATRIX_N || op->path_len > MINI_POW_MERKLE_DEPTH) return OP_INVALID_INPUT;
+    for (uint32_t c = 0; c < MINI_POW_MATRIX_N; ++c, off += UINT32_SIZE) {
+        deserialize_u32_be(buf + off, &op->values[c], UINT32_SIZE);
+    }
+    for (uint32_t p = 0; p < op->path_len; ++p, off += UINT256_SIZE) {
+        uint256_deserialize_be(buf + off, UINT256_SIZE, &op->path[p]);
+    }
+    return OP_SUCCESS;
+}
+
+/*
+ * Recomputes the root from an opening. The tree shape is fixed by N, so
+ * the verifier knows at which levels a sibling is expected.
+ */
+static inline bool mini_pow_merkle_verify_opening(const uint256 *root, const mini_pow_row_opening_t *op)
+{
+    if (!root || !op || op->row >= MINI_POW_MATRIX_N) return false;
+
+    uint256 h;
+    mini_pow_merkle_leaf(op->row, op->values, &h);
+
+    uint32_t idx = op->row, len = MINI_POW_MATRIX_N, used = 0;
+    while (len > 1) {
+        const uint32_t sib = idx ^ 1u;
+        if (sib < len) {
+            if (used >= op->path_len) return false;
+            uint256 parent;
+            if (idx & 1u) mini_pow_merkle_node(&op->path[used], &h, &parent);
+            else mini_pow_merkle_node(&h, &op->path[used], &parent);
+            h = parent;
+            used++;
+        }
+        idx >>= 1;
+        len = (len + 1) / 2;
+    }
+    return used == op->path_len && memcmp(&h, root, sizeof(uint256)) == 0;
+}
+
+/* ---------------- spot checks ---------------- */
+
+/*
+ * Picks `count` distinct rows from H(root || seed || session || challenge || ctr).
+ * Both sides derive the same set once the root is fixed, so the miner cannot
+ * choose which rows get checked.
+ */
+static inline OpStatus_t mini_pow_spot_check_begin(mini_pow_spot_check_t *check, const uint256 *seed,
+                                                   const mini_pow_solved_commit_t *commit, uint32_t count)
+{
+    if (!check || !seed || !commit) return OP_NULL_PTR;
+    if (count == 0 || count > MINI_POW_SPOT_CHECKS_MAX || count > MINI_POW_MATRIX_N) return OP_INVALID_INPUT;
+
+    check->challenge_id = commit->challenge_id;
+    check->session_id = commit->session_id;
+    check->seed = *seed;
+    check->root = commit->root;
+    check->count = 0;
+
+    uint8_t buf[UINT256_SIZE * 2 + UINT32_SIZE * 3];
+    uint256_serialize_be(&commit->root, buf, UINT256_SIZE);
+    uint256_serialize_be(seed, buf + UINT256_SIZE, UINT256_SIZE);
+    serialize_u32_be(commit->session_id, buf + UINT256_SIZE * 2);
+    serialize_u32_be(commit->challenge_id, buf + UINT256_SIZE * 2 + UINT32_SIZE);
+
+    for (uint32_t ctr = 0; check->count < count; ++ctr) {
+        serialize_u32_be(ctr, buf + UINT256_SIZE * 2 + UINT32_SIZE * 2);
+        uint256 h;
+        uint8_t hb[UINT256_SIZE];
+        uint64_t x;
+        hash256_buffer(buf, sizeof(buf), &h);
+        uint256_serialize_be(&h, hb, UINT256_SIZE);
+        deserialize_u64_be(hb, &x, UINT64_SIZE);
+
+        const uint32_t row = (uint32_t)(x % MINI_POW_MATRIX_N);
+        bool dup = false;
+        for (uint32_t j = 0; j < check->count; ++j) dup |= check->rows[j] == row;
+        if (!dup) check->rows[check->count++] = row;
+    }
+    return OP_SUCCESS;
+}
+
+/*
+ * Checks every opening against the root and recomputes the opened rows of
+ * A x B from the seed. B is regenerated one row at a time and folded into
+ * all accumulators at once: O(count * N) memory, N * N CSPRNG draws.
+ * `openings[j]` must open `check->rows[j]`.
+ */
+static inline bool mini_pow_spot_check_verify(const mini_pow_spot_check_t *check,
+                                              const mini_pow_row_opening_t *openings, uint32_t count)
+{
+    if (!check || !openings || count != check->count || count == 0) return false;
+
+    for (uint32_t j = 0; j < count; ++j) {
+        if (openings[j].row != check->rows[j]) return false;
+        if (!mini_pow_merkle_verify_opening(&check->root, &openings[j])) return false;
+    }
+
+    uint32_t *acc = (uint32_t *)calloc((size_t)count * MINI_POW_MATRIX_N, sizeof(uint32_t));
+    uint16_t *a_rows = (uint16_t *)malloc((size_t)count * MINI_POW_MATRIX_N * sizeof(uint16_t));
+    uint16_t *b_row = (uint16_t *)malloc(MINI_POW_MATRIX_N * sizeof(uint16_t));
+    bool ok = acc && a_rows && b_row;
+
+    for (uint32_t j = 0; ok && j < count; ++j) {
+        const uint32_t base = check->rows[j] * MINI_POW_MATRIX_N;
+        for (uint32_t k = 0; ok && k < MINI_POW_MATRIX_N; ++k) {
+            ok = mini_pow_wire_element(&check->seed, base + k, &a_rows[(size_t)j * MINI_POW_MATRIX_N + k]) == OP_SUCCESS;
+        }
+    }
+
+    for (uint32_t k = 0; ok && k < MINI_POW_MATRIX_N; ++k) {
+        const uint32_t b_base = (uint32_t)MINI_POW_MATRIX_N * MINI_POW_MATRIX_N + k * MINI_POW_MATRIX_N;
+        for (uint32_t c = 0; ok && c < MINI_POW_MATRIX_N; ++c) {
+            ok = mini_pow_wire_element(&check->seed, b_base + c, &b_row[c]) == OP_SUCCESS;
+        }
+        for (uint32_t j = 0; ok && j < count; ++j) {
+            const uint32_t a = a_rows[(size_t)j * MINI_POW_MATRIX_N + k];
+            uint32_t *dst = acc + (size_t)j * MINI_POW_MATRIX_N;
+            for (uint32_t c = 0; c < MINI_POW_MATRIX_N; ++c) {
+                dst[c] += a * (uint32_t)b_row[c];
+            }
+        }
+    }
+
+    for (uint32_t j = 0; ok && j < count; ++j) {
+        ok = memcmp(acc + (size_t)j * MINI_POW_MATRIX_N, openings[j].values, MINI_POW_MATRIX_N * sizeof(uint32_t)) == 0;
+    }
+
+    free(acc);
+    free(a_rows);
+    free(b_row);
+    return ok;
+}
+
+#endif // MINI_POW_WIRE_H
@@ -0,0 +1,179 @@
+#ifndef TIER_POW_BENCH_H
+#define TIER_POW_BENCH_H
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "Proofs/TierPoW/tierPoWChallenge_ops.h"
+#include "Proofs/TierPoW/tierPoWSolve_ops.h"
+#include "core/enums/OpStatus.h"
+#include "telemetry/clock_ops.h"
+#include "telemetry/metrics_ops.h"
+#include "scheduler/workPool_ops.h"
+
+/*
+ * Local TierPoW hashrate and solve-time estimates.
+ *
+ * tier_pow_bench_run times tier_pow_hash_attempt (the solver's exact inner
+ * step) on `threads` concurrent pool workers (the pool the solver runs on)
+ * for a fixed wall budget and reports
+ * hashes/sec per thread and in total. With that, a challenge's expected
+ * solve time is expected_hashes / rate, where expected_hashes is 2^(c+2)
+ * for leading-zero complexity c and 2^256 / target in target mode.
+ *
+ * tier_pow_budget_check refuses (OP_INVALID_STATE) a search whose expected
+ * time exceeds the budget, so PowManager_Run never starts a search that
+ * cannot finish. The process-wide estimate is benchmarked once, lazily,
+ * and published as the tier_pow_bench_hashrate gauge.
+ */
+
+#ifndef TIER_POW_BENCH_DURATION_NS
+#define TIER_POW_BENCH_DURATION_NS 50000000ULL   // 50 ms
+#endif
+
+#ifndef TIER_POW_SOLVE_BUDGET_SECONDS_DEFAULT
+#define TIER_POW_SOLVE_BUDGET_SECONDS_DEFAULT 3600.0
+#endif
+
+#define TIER_POW_BENCH_THREADS_MAX 64
+#define TIER_POW_BENCH_BATCH 256
+
+typedef struct {
+    double hashes_per_sec;          // all threads
+    double per_thread;              // hashes_per_sec / threads
+    uint32_t threads;
+    uint64_t hashes;
+    uint64_t measured_ns;
+    double budget_seconds;          // searches expected to take longer are refused
+    bool measured;
+} tier_pow_hashrate_t;
+
+typedef struct {
+    uint256 challenge;
+    uint64_t deadline_ns;
+    _Atomic(uint64_t) hashes;
+    _Atomic(uint32_t) workers;
+} tier_pow_bench_job_t;
+
+static inline void tier_pow_bench_worker(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)cancel;
+    tier_pow_bench_job_t *job = (tier_pow_bench_job_t *)arg;
+    const uint32_t index = atomic_fetch_add_explicit(&job->workers, 1, memory_order_relaxed);
+    uint256 hash;
+    uint64_t nonce = (uint64_t)index << 40, done = 0, sink = 0;
+    do {
+        for (uint32_t i = 0; i < TIER_POW_BENCH_BATCH; ++i) {
+            tier_pow_hash_attempt(&job->challenge, nonce++, &hash);
+            uint64_t word;
+            memcpy(&word, &hash, sizeof(word));
+            sink ^= word;
+        }
+        done += TIER_POW_BENCH_BATCH;
+    } while (pkc_clock_now_ns() < job->deadline_ns);
+
+    __asm__ volatile("" : : "r"(sink));
+    atomic_fetch_add_explicit(&job->hashes, done, memory_order_relaxed);
+}
+
+/*
+ * Measures the local hashrate on `threads` workers (0 = one per pool
+ * worker, and never more) for `duration_ns` (0 = TIER_POW_BENCH_DURATION_NS).
+ * The caller takes one of the shares.
+ */
+static inline OpStatus_t tier_pow_bench_run(uint32_t threads, uint64_t duration_ns, tier_pow_hashrate_t *out)
+{
+    if (!out) return OP_NULL_PTR;
+    pkc_pool_t *pool = pkc_pool_default();
+    const uint32_t available = pkc_pool_workers(pool) ? pkc_pool_workers(pool) : 1;
+    if (threads == 0 || threads > available) threads = available;
+    if (threads > TIER_POW_BENCH_THREADS_MAX) threads = TIER_POW_BENCH_THREADS_MAX;
+    if (duration_ns == 0) duration_ns = TIER_POW_BENCH_DURATION_NS;
+
+    tier_pow_bench_job_t job;
+    memset(&job.challenge, 0xA5, sizeof(job.challenge));
+    atomic_init(&job.hashes, 0);
+    atomic_init(&job.workers, 0);
+    // Workers stop at a shared deadline; late starters only lower the count.
+    const uint64_t start = pkc_clock_now_ns();
+    job.deadline_ns = start + duration_ns;
+
+    pkc_pool_fork_join(pool, PKC_POOL_PRIO_MINE, threads, tier_pow_bench_worker, &job, NULL);
+    const uint64_t elapsed = pkc_clock_now_ns() - start;
+
+    const double budget = out->budget_seconds > 0.0 ? out->budget_seconds : TIER_POW_SOLVE_BUDGET_SECONDS_DEFAULT;
+    memset(out, 0, sizeof(*out));
+    out->threads = atomic_load_explicit(&job.workers, memory_order_relaxed);
+    out->hashes = atomic_load_explicit(&job.hashes, memory_order_relaxed);
+    out->measured_ns = elapsed;
+    out->hashes_per_sec = elapsed ? (double)out->hashes * 1e9 / (double)elapsed : 0.0;
+    out->per_thread = out->hashes_per_sec / out->threads;
+    out->budget_seconds = budget;
+    out->measured = out->hashes > 0;
+
+    pkc_metrics_gauge_set(PKC_GAUGE_TIER_POW_BENCH_HASHRATE, (int64_t)out->hashes_per_sec);
+    pkc_metrics_gauge_set(PKC_GAUGE_TIER_POW_BENCH_THREADS, (int64_t)out->threads);
+    return out->measured ? OP_SUCCESS : OP_INVALID_STATE;
+}
+
+/* log2 of the expected number of attempts for a challenge. */
+static inline double tier_pow_expected_hashes_log2(const tier_pow_challenge_t *pow)
+{
+    if (tier_pow_challenge_is_target(pow)) return tier_pow_target_work_log2(tier_pow_challenge_get_target_bits(pow));
+    return tier_pow_complexity_work_log2(pow->complexity);
+}
+
+/*
+ * Expected solve time in seconds on `threads` solver threads, scaling the
+ * per-thread rate (pool workers are pinned one per CPU). INFINITY without
+ * a measurement.
+ */
+static inline double tier_pow_expected_solve_seconds(const tier_pow_hashrate_t *rate, const tier_pow_challenge_t *pow,
+                                                     uint32_t threads)
+{
+    if (!rate || !pow || !rate->measured || !(rate->per_thread > 0.0)) return INFINITY;
+    if (threads == 0) threads = 1;
+    return exp2(tier_pow_expected_hashes_log2(pow)) / (rate->per_thread * threads);
+}
+
+/*
+ * OP_SUCCESS when the search is expected to finish within the budget,
+ * OP_INVALID_STATE (and tier_pow_refused_total) when it is not.
+ */
+static inline OpStatus_t tier_pow_budget_check(const tier_pow_hashrate_t *rate, const tier_pow_challenge_t *pow,
+                                               uint32_t threads, double *out_expected_seconds)
+{
+    if (!rate || !pow) return OP_NULL_PTR;
+    const double expected = tier_pow_expected_solve_seconds(rate, pow, threads);
+    if (out_expected_seconds) *out_expected_seconds = expected;
+    if (expected <= rate->budget_seconds) return OP_SUCCESS;
+    pkc_metrics_count(PKC_CTR_TIER_POW_REFUSED, 1);
+    return OP_INVALID_STATE;
+}
+
+/*
+ * Process-wide estimate used by PowManager_Run: per-thread rate measured
+ * on one worker on first use. Call tier_pow_bench_run(1, 0, &tier_pow_hashrate_global)
+ * at startup to pay for it up front; budget_seconds set beforehand is kept.
+ */
+__attribute__((weak)) tier_pow_hashrate_t tier_pow_hashrate_global;
+__attribute__((weak)) pthread_once_t tier_pow_hashrate_global_once = PTHREAD_ONCE_INIT;
+
+static inline void tier_pow_hashrate_global_init(void)
+{
+    if (!tier_pow_hashrate_global.measured) tier_pow_bench_run(1, 0, &tier_pow_hashrate_global);
+}
+
+// Concurrent first callers wait for the one measurement instead of each running it.
+static inline tier_pow_hashrate_t *tier_pow_hashrate_default(void)
+{
+    pthread_once(&tier_pow_hashrate_global_once, tier_pow_hashrate_global_init);
+    return &tier_pow_hashrate_global;
+}
+
+#endif // TIER_POW_BENCH_H
@@ -12,6 +12,7 @@
 #include "crypto/SignUtils.h"
 #include "net/NetworkSerialization.h"
 #include "core/Global_Size_Offsets.h"
+#include "Proofs/TierPoW/tierPoWTarget_ops.h"
 
 #define TIER_POW_CHALLENGE_INLINE static inline __attribute__((always_inline))
 
@@ -21,7 +22,8 @@
  * tier_pow_challenge_t:
  *  - 4-byte aligned (32-bit alignment)
  *  - deterministic 256-bit challenge
- *  - complexity 0-255 bits
+ *  - complexity 0-255 bits, or the exponent of a compact target when
+ *    reserved[] holds a non-zero mantissa (tierPoWTarget_ops.h)
  *  - padding to keep size a 32-bit multiple
  */
 // typedef struct __attribute__((aligned(4))) {
@@ -74,7 +76,24 @@ TIER_POW_CHALLENGE_INLINE void tier_pow_challenge_copy(tier_pow_challenge_t *dst
     uint256_copy(&dst->challenge, &src->challenge);
     dst->complexity = src->complexity;
     dst->challenge_id = src->challenge_id;
-    memset(dst->reserved, 0, sizeof(dst->reserved));
+    memcpy(dst->reserved, src->reserved, sizeof(dst->reserved));
+}
+
+TIER_POW_CHALLENGE_INLINE bool tier_pow_challenge_is_target(const tier_pow_challenge_t *pow)
+{
+    return (pow->reserved[0] | pow->reserved[1] | pow->reserved[2]) != 0;
+}
+
+TIER_POW_CHALLENGE_INLINE uint32_t tier_pow_challenge_get_target_bits(const tier_pow_challenge_t *pow)
+{
+    return tier_pow_target_bits_pack(pow->complexity, pow->reserved);
+}
+
+TIER_POW_CHALLENGE_INLINE OpStatus_t tier_pow_challenge_set_target_bits(tier_pow_challenge_t *pow, uint32_t bits)
+{
+    if (!tier_pow_target_bits_valid(bits)) return OP_INVALID_INPUT;
+    tier_pow_target_bits_unpack(bits, &pow->complexity, pow->reserved);
+    return OP_SUCCESS;
 }
 
 /* Moved to NetworkSerialization.h */
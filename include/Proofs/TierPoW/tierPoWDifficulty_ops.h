@@ -0,0 +1,399 @@
+#ifndef TIER_POW_DIFFICULTY_H
+#define TIER_POW_DIFFICULTY_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "blockhain/PKCertChain.h"
+#include "core/enums/OpStatus.h"
+#include "core/enums/Tier.h"
+#include "Proofs/TierPoW/tierPoWTarget_ops.h"
+
+/*
+ * Per-tier TierPoW difficulty controller.
+ *
+ * Each tier keeps a ring of recent solves, stored normalised to one unit
+ * of work (seconds / 2^complexity), so samples taken at different
+ * complexities stay comparable. The mean is estimated either by EWMA or
+ * by the window median (divided by ln 2, since solve times are roughly
+ * exponential). The controller then moves its fractional complexity
+ * towards log2(target / estimate), at most max_step bits per solve, and
+ * only changes the integer chain field once the fractional state is past
+ * the rounding point by `hysteresis`. One outlier can therefore move the
+ * difficulty by at most max_step, and only after min_samples solves.
+ *
+ * In target mode (version TIER_POW_VERSION_TARGET) the fractional state is
+ * issued directly as a compact 256-bit target, re-issued whenever it has
+ * drifted more than target_deadband bits (0.02 bits ~ 1.4% of work) from
+ * the last one, instead of waiting for a whole bit.
+ *
+ * Observations come from the chain's commit path (pkc_chain_retarget) and
+ * the tier index's seeding, one committed block each; miners and
+ * validators only read the issued complexity or target. Both go through
+ * the controller's lock, so a miner asking for the next target never sees
+ * a half-updated tier.
+ *
+ * The tier -> PKCertChain field mapping is a table (tier_pow_chain_fields)
+ * instead of switch statements at every use site.
+ */
+
+#define TIER_POW_DIFFICULTY_TIERS 4
+#define TIER_POW_DIFFICULTY_WINDOW 32
+#define TIER_POW_LN2 0.69314718055994530942
+
+#ifndef TIER_POW_TARGET_SECONDS_DEFAULT
+#define TIER_POW_TARGET_SECONDS_DEFAULT 600.0
+#endif
+
+typedef enum {
+    TIER_POW_ESTIMATOR_EWMA = 0,
+    TIER_POW_ESTIMATOR_MEDIAN = 1,
+} tier_pow_estimator_t;
+
+typedef struct {
+    double target_seconds[TIER_POW_DIFFICULTY_TIERS];   // MCU, EDGE, DESKTOP, SERVER
+    tier_pow_estimator_t estimator;
+    double ewma_alpha;
+    double max_step;            // bits of complexity per solve
+    double hysteresis;          // bits past the rounding point before the integer moves
+    uint32_t min_samples;
+    uint8_t min_complexity;
+    uint8_t max_complexity;
+    uint8_t version;            // TIER_POW_VERSION_*
+    double target_deadband;     // bits, target mode
+} tier_pow_difficulty_config_t;
+
+typedef struct {
+    double samples[TIER_POW_DIFFICULTY_WINDOW];     // seconds per 2^complexity
+    uint32_t count;
+    uint32_t head;
+    double ewma;
+    double state;               // fractional complexity
+    bool seeded;
+    uint8_t applied;
+    uint32_t applied_bits;      // target mode, 0 until seeded
+    uint64_t updates;
+} tier_pow_difficulty_tier_t;
+
+typedef struct {
+    tier_pow_difficulty_config_t cfg;
+    tier_pow_difficulty_tier_t tiers[TIER_POW_DIFFICULTY_TIERS];
+    pthread_mutex_t lock;       // tiers
+    bool ready;
+} tier_pow_difficulty_t;
+
+/* ---------------- tier -> chain field table ---------------- */
+
+typedef struct {
+    Tier_t tier;
+    size_t complexity_off;
+    size_t complexity_size;
+    size_t last_index_off;
+    size_t last_index_size;
+} tier_pow_chain_field_t;
+
+#define TIER_POW_CHAIN_FIELD(t, cx, li) \
+    { t, offsetof(PKCertChain, cx), sizeof(((PKCertChain *)0)->cx), \
+      offsetof(PKCertChain, li), sizeof(((PKCertChain *)0)->li) }
+
+static const tier_pow_chain_field_t tier_pow_chain_fields[TIER_POW_DIFFICULTY_TIERS] = {
+    TIER_POW_CHAIN_FIELD(TIER_MCU, MCUComplexity, lastMCUBlockIndex),
+    TIER_POW_CHAIN_FIELD(TIER_EDGE, EdgeComplexity, lastEdgeBlockIndex),
+    TIER_POW_CHAIN_FIELD(TIER_DESKTOP, DesktopComplexity, lastDesktopBlockIndex),
+    TIER_POW_CHAIN_FIELD(TIER_SERVER, ServerComplexity, lastServerBlockIndex),
+};
+
+static inline int tier_pow_difficulty_slot(Tier_t tier)
+{
+    for (int i = 0; i < TIER_POW_DIFFICULTY_TIERS; ++i) {
+        if (tier_pow_chain_fields[i].tier == tier) return i;
+    }
+    return -1;
+}
+
+static inline const tier_pow_chain_field_t *tier_pow_chain_field(Tier_t tier)
+{
+    int slot = tier_pow_difficulty_slot(tier);
+    return slot < 0 ? NULL : &tier_pow_chain_fields[slot];
+}
+
+static inline uint64_t tier_pow_chain_field_load(const PKCertChain *chain, size_t off, size_t size)
+{
+    const unsigned char *p = (const unsigned char *)chain + off;
+    switch (size) {
+        case 1: { uint8_t v; memcpy(&v, p, 1); return v; }
+        case 2: { uint16_t v; memcpy(&v, p, 2); return v; }
+        case 4: { uint32_t v; memcpy(&v, p, 4); return v; }
+        default: { uint64_t v; memcpy(&v, p, 8); return v; }
+    }
+}
+
+static inline void tier_pow_chain_field_store(PKCertChain *chain, size_t off, size_t size, uint64_t value)
+{
+    unsigned char *p = (unsigned char *)chain + off;
+    switch (size) {
+        case 1: { uint8_t v = (uint8_t)value; memcpy(p, &v, 1); break; }
+        case 2: { uint16_t v = (uint16_t)value; memcpy(p, &v, 2); break; }
+        case 4: { uint32_t v = (uint32_t)value; memcpy(p, &v, 4); break; }
+        default: { memcpy(p, &value, 8); break; }
+    }
+}
+
+static inline uint8_t tier_pow_chain_complexity(const PKCertChain *chain, const tier_pow_chain_field_t *f)
+{
+    return (uint8_t)tier_pow_chain_field_load(chain, f->complexity_off, f->complexity_size);
+}
+
+static inline void tier_pow_chain_set_complexity(PKCertChain *chain, const tier_pow_chain_field_t *f, uint8_t c)
+{
+    tier_pow_chain_field_store(chain, f->complexity_off, f->complexity_size, c);
+}
+
+static inline uint32_t tier_pow_chain_last_index(const PKCertChain *chain, const tier_pow_chain_field_t *f)
+{
+    return (uint32_t)tier_pow_chain_field_load(chain, f->last_index_off, f->last_index_size);
+}
+
+static inline void tier_pow_chain_set_last_index(PKCertChain *chain, const tier_pow_chain_field_t *f, uint64_t index)
+{
+    tier_pow_chain_field_store(chain, f->last_index_off, f->last_index_size, index);
+}
+
+/* ---------------- controller ---------------- */
+
+static inline void tier_pow_difficulty_config_default(tier_pow_difficulty_config_t *cfg)
+{
+    if (!cfg) return;
+    for (int i = 0; i < TIER_POW_DIFFICULTY_TIERS; ++i) cfg->target_seconds[i] = TIER_POW_TARGET_SECONDS_DEFAULT;
+    cfg->estimator = TIER_POW_ESTIMATOR_MEDIAN;
+    cfg->ewma_alpha = 0.2;
+    cfg->max_step = 2.0;
+    cfg->hysteresis = 0.15;
+    cfg->min_samples = 3;
+    cfg->min_complexity = 1;
+    cfg->max_complexity = 255;
+    cfg->version = TIER_POW_VERSION_LEADING_ZERO;
+    cfg->target_deadband = 0.02;
+}
+
+static inline OpStatus_t tier_pow_difficulty_init(tier_pow_difficulty_t *ctl, const tier_pow_difficulty_config_t *cfg)
+{
+    if (!ctl) return OP_NULL_PTR;
+    memset(ctl, 0, sizeof(*ctl));
+    if (cfg) ctl->cfg = *cfg;
+    else tier_pow_difficulty_config_default(&ctl->cfg);
+
+    const tier_pow_difficulty_config_t *c = &ctl->cfg;
+    for (int i = 0; i < TIER_POW_DIFFICULTY_TIERS; ++i) {
+        if (!(c->target_seconds[i] > 0.0)) return OP_INVALID_INPUT;
+    }
+    if (!(c->ewma_alpha > 0.0 && c->ewma_alpha <= 1.0) || !(c->max_step > 0.0) || c->hysteresis < 0.0 ||
+        c->hysteresis >= 0.5 || c->min_samples == 0 || c->min_samples > TIER_POW_DIFFICULTY_WINDOW ||
+        c->min_complexity > c->max_complexity || c->version > TIER_POW_VERSION_TARGET ||
+        !(c->target_deadband >= 0.0)) {
+        return OP_INVALID_INPUT;
+    }
+    pthread_mutex_init(&ctl->lock, NULL);
+    ctl->ready = true;
+    return OP_SUCCESS;
+}
+
+static inline int tier_pow_difficulty_cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Mean seconds per unit of work (2^0) for the tier; 0 with no samples.
+ */
+static inline double tier_pow_difficulty_unit_seconds(const tier_pow_difficulty_t *ctl, int slot)
+{
+    const tier_pow_difficulty_tier_t *t = &ctl->tiers[slot];
+    if (t->count == 0) return 0.0;
+    if (ctl->cfg.estimator == TIER_POW_ESTIMATOR_EWMA) return t->ewma;
+
+    double sorted[TIER_POW_DIFFICULTY_WINDOW];
+    memcpy(sorted, t->samples, t->count * sizeof(double));
+    qsort(sorted, t->count, sizeof(double), tier_pow_difficulty_cmp_double);
+    double median = (t->count & 1) ? sorted[t->count / 2]
+                                   : 0.5 * (sorted[t->count / 2 - 1] + sorted[t->count / 2]);
+    return median / TIER_POW_LN2;
+}
+
+/*
+ * Expected solve time at `complexity` from the current estimate.
+ */
+static inline double tier_pow_difficulty_expected_seconds(tier_pow_difficulty_t *ctl, Tier_t tier, double complexity)
+{
+    int slot = ctl && ctl->ready ? tier_pow_difficulty_slot(tier) : -1;
+    if (slot < 0) return 0.0;
+    pthread_mutex_lock(&ctl->lock);
+    const double unit = tier_pow_difficulty_unit_seconds(ctl, slot);
+    pthread_mutex_unlock(&ctl->lock);
+    return unit * exp2(complexity);
+}
+
+/*
+ * Adds one solve at (possibly fractional) `complexity_used` to the window
+ * and steps the fractional state. False until min_samples solves are in.
+ * Under ctl->lock.
+ */
+static inline bool tier_pow_difficulty_record(tier_pow_difficulty_t *ctl, int slot, double complexity_used,
+                                              double solve_seconds)
+{
+    const tier_pow_difficulty_config_t *cfg = &ctl->cfg;
+    tier_pow_difficulty_tier_t *t = &ctl->tiers[slot];
+    if (!(solve_seconds > 0.0)) solve_seconds = 1e-6;
+
+    const double unit = solve_seconds * exp2(-complexity_used);
+    t->samples[t->head] = unit;
+    t->head = (t->head + 1) % TIER_POW_DIFFICULTY_WINDOW;
+    if (t->count < TIER_POW_DIFFICULTY_WINDOW) t->count++;
+    t->ewma = (t->count == 1) ? unit : t->ewma + cfg->ewma_alpha * (unit - t->ewma);
+    t->updates++;
+
+    if (t->count < cfg->min_samples) return false;
+
+    const double est = tier_pow_difficulty_unit_seconds(ctl, slot);
+    const double ideal = log2(cfg->target_seconds[slot] / est);
+    double step = ideal - t->state;
+    if (step > cfg->max_step) step = cfg->max_step;
+    if (step < -cfg->max_step) step = -cfg->max_step;
+    t->state += step;
+    if (t->state < cfg->min_complexity) t->state = cfg->min_complexity;
+    if (t->state > cfg->max_complexity) t->state = cfg->max_complexity;
+    return true;
+}
+
+/*
+ * Records one solve made at `complexity_used` and returns the complexity
+ * for the next one in `out_complexity`.
+ */
+static inline OpStatus_t tier_pow_difficulty_observe(tier_pow_difficulty_t *ctl, Tier_t tier, uint8_t complexity_used,
+                                                     double solve_seconds, uint8_t *out_complexity)
+{
+    if (!ctl || !out_complexity) return OP_NULL_PTR;
+    if (!ctl->ready) return OP_INVALID_STATE;
+    const int slot = tier_pow_difficulty_slot(tier);
+    if (slot < 0) return OP_INVALID_INPUT;
+
+    pthread_mutex_lock(&ctl->lock);
+    tier_pow_difficulty_tier_t *t = &ctl->tiers[slot];
+    if (!t->seeded) {
+        t->state = complexity_used;
+        t->applied = complexity_used;
+        t->seeded = true;
+    }
+
+    if (tier_pow_difficulty_record(ctl, slot, complexity_used, solve_seconds) &&
+        fabs(t->state - (double)t->applied) >= 0.5 + ctl->cfg.hysteresis) {
+        t->applied = (uint8_t)lround(t->state);
+    }
+
+    *out_complexity = t->applied;
+    pthread_mutex_unlock(&ctl->lock);
+    return OP_SUCCESS;
+}
+
+/*
+ * Compact target the tier should mine at next. Before the first target
+ * solve it is the target equivalent of `complexity`.
+ */
+static inline uint32_t tier_pow_difficulty_target_bits(tier_pow_difficulty_t *ctl, Tier_t tier, uint8_t complexity)
+{
+    const int slot = ctl && ctl->ready ? tier_pow_difficulty_slot(tier) : -1;
+    uint32_t bits = 0;
+    if (slot >= 0) {
+        pthread_mutex_lock(&ctl->lock);
+        bits = ctl->tiers[slot].applied_bits;
+        pthread_mutex_unlock(&ctl->lock);
+    }
+    return bits != 0 ? bits : tier_pow_target_from_complexity((double)complexity);
+}
+
+/*
+ * Target-mode counterpart of tier_pow_difficulty_observe: records a solve
+ * made at `bits_used` and returns the next compact target in `out_bits`.
+ */
+static inline OpStatus_t tier_pow_difficulty_observe_target(tier_pow_difficulty_t *ctl, Tier_t tier, uint32_t bits_used,
+                                                            double solve_seconds, uint32_t *out_bits)
+{
+    if (!ctl || !out_bits) return OP_NULL_PTR;
+    if (!ctl->ready) return OP_INVALID_STATE;
+    const int slot = tier_pow_difficulty_slot(tier);
+    if (slot < 0 || !tier_pow_target_bits_valid(bits_used)) return OP_INVALID_INPUT;
+
+    pthread_mutex_lock(&ctl->lock);
+    tier_pow_difficulty_tier_t *t = &ctl->tiers[slot];
+    const double used = tier_pow_target_complexity(bits_used);
+    if (!t->seeded || t->applied_bits == 0) {
+        t->state = used;
+        t->applied = (uint8_t)lround(used);
+        t->applied_bits = bits_used;
+        t->seeded = true;
+    }
+
+    if (tier_pow_difficulty_record(ctl, slot, used, solve_seconds) &&
+        fabs(t->state - tier_pow_target_complexity(t->applied_bits)) > ctl->cfg.target_deadband) {
+        t->applied_bits = tier_pow_target_from_complexity(t->state);
+        t->applied = (uint8_t)lround(tier_pow_target_complexity(t->applied_bits));
+    }
+
+    *out_bits = t->applied_bits;
+    pthread_mutex_unlock(&ctl->lock);
+    return OP_SUCCESS;
+}
+
+/*
+ * Starts a tier with no solves yet at the compact target `bits`, e.g. the
+ * one a snapshot carries, so it issues what the exporting node would
+ * have. A tier that is already seeded keeps its state.
+ */
+static inline OpStatus_t tier_pow_difficulty_resume_target(tier_pow_difficulty_t *ctl, Tier_t tier, uint32_t bits)
+{
+    if (!ctl) return OP_NULL_PTR;
+    if (!ctl->ready) return OP_INVALID_STATE;
+    const int slot = tier_pow_difficulty_slot(tier);
+    if (slot < 0 || !tier_pow_target_bits_valid(bits)) return OP_INVALID_INPUT;
+
+    pthread_mutex_lock(&ctl->lock);
+    tier_pow_difficulty_tier_t *t = &ctl->tiers[slot];
+    if (!t->seeded) {
+        t->state = tier_pow_target_complexity(bits);
+        t->applied = (uint8_t)lround(t->state);
+        t->applied_bits = bits;
+        t->seeded = true;
+    }
+    pthread_mutex_unlock(&ctl->lock);
+    return OP_SUCCESS;
+}
+
+/*
+ * Process-wide controller used by the chain's commit path and its miners,
+ * default config on first use. Replace it with
+ * tier_pow_difficulty_init(tier_pow_difficulty_default(), cfg) before
+ * any miner or writer runs.
+ */
+__attribute__((weak)) tier_pow_difficulty_t tier_pow_difficulty_global;
+__attribute__((weak)) pthread_once_t tier_pow_difficulty_global_once = PTHREAD_ONCE_INIT;
+
+static inline void tier_pow_difficulty_global_init(void)
+{
+    if (!tier_pow_difficulty_global.ready) tier_pow_difficulty_init(&tier_pow_difficulty_global, NULL);
+}
+
+static inline tier_pow_difficulty_t *tier_pow_difficulty_default(void)
+{
+    pthread_once(&tier_pow_difficulty_global_once, tier_pow_difficulty_global_init);
+    return &tier_pow_difficulty_global;
+}
+
+#endif // TIER_POW_DIFFICULTY_H
@@ -0,0 +1,112 @@
+#ifndef TIER_POW_SOLVE_PARALLEL_H
+#define TIER_POW_SOLVE_PARALLEL_H
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "Proofs/TierPoW/tierPoWChallenge_ops.h"
+#include "Proofs/TierPoW/tierPoWSolve_ops.h"
+#include "core/enums/OpStatus.h"
+#include "scheduler/workPool_ops.h"
+
+/*
+ * TierPoW search on the shared pool, mining class.
+ *
+ * Nonces are handed out in chunks from a shared counter; the first worker
+ * to find a solution publishes it and the others stop at their next
+ * chunk. The caller's cancellation token is polled once per chunk, so a
+ * cancelled search returns within one chunk of hashing. Between chunks a
+ * worker also yields to queued verification and validation tasks
+ * (pkc_pool_yield), so mining never holds those classes back by more
+ * than one chunk. Any nonce that
+ * meets the target is a valid solution, so which worker wins does not
+ * matter to the verifier.
+ */
+
+#ifndef TIER_POW_SOLVE_CHUNK
+#define TIER_POW_SOLVE_CHUNK 4096
+#endif
+
+typedef struct {
+    const tier_pow_challenge_t *pow;
+    pkc_pool_t *pool;
+    tier_pow_target_t target;
+    bool target_mode;
+    _Atomic(uint64_t) next_nonce;
+    _Atomic(uint64_t) hashes;
+    _Atomic(int) found;
+    uint64_t nonce;                 // written by the CAS winner
+} tier_pow_solve_job_t;
+
+static inline void tier_pow_solve_worker(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    tier_pow_solve_job_t *job = (tier_pow_solve_job_t *)arg;
+    const uint256 *challenge = tier_pow_challenge_get_challenge(job->pow);
+    uint256 hash;
+
+    while (!atomic_load_explicit(&job->found, memory_order_relaxed) && !pkc_pool_cancelled(cancel)) {
+        const uint64_t first = atomic_fetch_add_explicit(&job->next_nonce, TIER_POW_SOLVE_CHUNK, memory_order_relaxed);
+        if (first > UINT64_MAX - TIER_POW_SOLVE_CHUNK) return;
+        uint64_t n = first;
+        for (; n < first + TIER_POW_SOLVE_CHUNK; ++n) {
+            tier_pow_hash_attempt(challenge, n, &hash);
+            const bool met = job->target_mode ? tier_pow_check_target_met(&hash, &job->target)
+                                              : tier_pow_check_complexity_met(&hash, job->pow->complexity);
+            if (met) break;
+        }
+        const bool hit = n < first + TIER_POW_SOLVE_CHUNK;
+        atomic_fetch_add_explicit(&job->hashes, n - first + (hit ? 1 : 0), memory_order_relaxed);
+        if (hit) {
+            int expected = 0;
+            if (atomic_compare_exchange_strong_explicit(&job->found, &expected, 1, memory_order_acq_rel,
+                                                        memory_order_relaxed)) {
+                job->nonce = n;
+            }
+            return;
+        }
+        pkc_pool_yield(job->pool, PKC_POOL_PRIO_MINE);
+    }
+}
+
+/*
+ * Searches `pow` on `threads` workers (0 = one per pool worker, the caller
+ * taking one share) and fills `solved` on success. `cancel` may be NULL;
+ * `hashes` (optional) receives the attempts made. OP_INVALID_STATE when
+ * cancelled, OP_INVALID_INPUT for a malformed target.
+ */
+static inline OpStatus_t tier_pow_solve_parallel(const tier_pow_challenge_t *pow, tier_pow_solve_t *solved,
+                                                 uint32_t threads, const pkc_pool_cancel_t *cancel,
+                                                 uint64_t *hashes)
+{
+    if (!pow || !solved) return OP_NULL_PTR;
+
+    tier_pow_solve_job_t job;
+    memset(&job.target, 0, sizeof(job.target));
+    bool target_valid;
+    job.pow = pow;
+    job.target_mode = tier_pow_challenge_target(pow, &job.target, &target_valid);
+    if (!target_valid) return OP_INVALID_INPUT;
+    atomic_init(&job.next_nonce, 0);
+    atomic_init(&job.hashes, 0);
+    atomic_init(&job.found, 0);
+    job.nonce = 0;
+
+    pkc_pool_t *pool = pkc_pool_default();
+    job.pool = pool;
+    if (threads == 0) threads = pkc_pool_workers(pool) ? pkc_pool_workers(pool) : 1;
+    pkc_pool_fork_join(pool, PKC_POOL_PRIO_MINE, threads, tier_pow_solve_worker, &job, cancel);
+
+    if (hashes) *hashes = atomic_load_explicit(&job.hashes, memory_order_relaxed);
+    if (!atomic_load_explicit(&job.found, memory_order_acquire)) return OP_INVALID_STATE;
+
+    tier_pow_solve_set_challenge_id(solved, pow->challenge_id);
+    tier_pow_solve_set_complexity(solved, pow->complexity);
+    memcpy(solved->reserved, pow->reserved, sizeof(solved->reserved));
+    tier_pow_solve_set_nonce(solved, job.nonce);
+    return OP_SUCCESS;
+}
+
+#endif // TIER_POW_SOLVE_PARALLEL_H
@@ -78,21 +78,63 @@ TIER_POW_SOLVE_INLINE bool tier_pow_check_complexity_met(uint256 *hash, uint8_t
     return leading_zeros == (uint16_t)(complexity + 1);
 }
 
+TIER_POW_SOLVE_INLINE bool tier_pow_solve_is_target(const tier_pow_solve_t *pow)
+{
+    return (pow->reserved[0] | pow->reserved[1] | pow->reserved[2]) != 0;
+}
+
+TIER_POW_SOLVE_INLINE uint32_t tier_pow_solve_get_target_bits(const tier_pow_solve_t *pow)
+{
+    return tier_pow_target_bits_pack(pow->complexity, pow->reserved);
+}
+
+/*
+ * One search attempt: H(challenge || H(nonce)). Shared by the solver, the
+ * verifier and the hashrate benchmark so all three time the same work.
+ */
+TIER_POW_SOLVE_INLINE void tier_pow_hash_attempt(const uint256 *challenge, uint64_t nonce, uint256 *hash)
+{
+    uint8_t nonce_buf[UINT64_SIZE];
+    uint8_t concat_buf[UINT256_SIZE * 2];
+    serialize_u64_be(nonce, nonce_buf);
+    hash256_buffer(nonce_buf, UINT64_SIZE, hash);
+    uint256_serialize_two_be(challenge, hash, concat_buf, UINT256_SIZE * 2);
+    hash256_buffer(concat_buf, sizeof(concat_buf), hash);
+}
+
+/*
+ * Expands the challenge's acceptance rule once per search: false for
+ * leading-zero mode, true with `target` filled in for target mode.
+ */
+TIER_POW_SOLVE_INLINE bool tier_pow_challenge_target(const tier_pow_challenge_t *pow, tier_pow_target_t *target,
+                                                     bool *valid)
+{
+    *valid = true;
+    if (!tier_pow_challenge_is_target(pow)) return false;
+    *valid = tier_pow_target_expand(tier_pow_challenge_get_target_bits(pow), target) == OP_SUCCESS;
+    return true;
+}
+
 TIER_POW_SOLVE_INLINE void tier_pow_solve_challenge(tier_pow_challenge_t *pow, tier_pow_solve_t **solved)
 {
+    tier_pow_target_t target = {{0}};
+    bool target_valid;
+    const bool target_mode = tier_pow_challenge_target(pow, &target, &target_valid);
+    if (!target_valid) {
+        *solved = NULL;
+        return;
+    }
+
     bool found = false;
     uint64_t found_nonce = 0;
     const uint256 *challenge = tier_pow_challenge_get_challenge(pow);
     uint256 hash;
-    uint8_t nonce_buf[UINT64_SIZE];
-    uint8_t concat_buf[UINT256_SIZE * 2];
     for (uint64_t i = 0; i <= UINT64_MAX && !found; i++)
     {
-        serialize_u64_be(i, nonce_buf);
-        hash256_buffer(nonce_buf, UINT64_SIZE, &hash);
-        uint256_serialize_two_be(challenge, &hash, concat_buf, UINT256_SIZE * 2);
-        hash256_buffer(concat_buf, sizeof(concat_buf), &hash);
-        if (tier_pow_check_complexity_met(&hash, pow->complexity)) {
+        tier_pow_hash_attempt(challenge, i, &hash);
+        const bool met = target_mode ? tier_pow_check_target_met(&hash, &target)
+                                     : tier_pow_check_complexity_met(&hash, pow->complexity);
+        if (met) {
             found = true;
             found_nonce = i;
         }
@@ -104,6 +146,7 @@ TIER_POW_SOLVE_INLINE void tier_pow_solve_challenge(tier_pow_challenge_t *pow, t
     {
         tier_pow_solve_set_challenge_id(*solved, pow->challenge_id);
         tier_pow_solve_set_complexity(*solved, pow->complexity);
+        memcpy((*solved)->reserved, pow->reserved, sizeof((*solved)->reserved));
         tier_pow_solve_set_nonce(*solved, found_nonce);
     }
 
@@ -0,0 +1,154 @@
+#ifndef TIER_POW_TARGET_H
+#define TIER_POW_TARGET_H
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "core/datatypes/uint256_t.h"
+#include "net/NetworkSerialization.h"
+#include "core/Global_Size_Offsets.h"
+#include "core/enums/OpStatus.h"
+
+#define TIER_POW_TARGET_INLINE static inline __attribute__((always_inline))
+
+/*
+ * 256-bit target mode for TierPoW (hash < target).
+ *
+ * Leading-zero complexity c accepts a hash with exactly c + 1 leading zero
+ * bits, i.e. 2^(c+2) expected hashes, so each step doubles the work. In
+ * target mode the expected work is 2^256 / target, and the compact form
+ * below has 16-24 bits of mantissa, so work moves in steps well under 0.01%.
+ *
+ * The target travels in the existing challenge/solve bytes, so the wire
+ * size is unchanged:
+ *   complexity   exponent e (bytes, 1..32)
+ *   reserved[3]  mantissa m, big-endian, non-zero
+ *   target = m * 256^(e - 3)
+ * A zero mantissa (every pre-existing challenge) means leading-zero mode.
+ * The mode a block was mined under is recorded as its PoW version in
+ * block.reserved[0] (see block_get_pow_version).
+ */
+
+#define TIER_POW_VERSION_LEADING_ZERO 0
+#define TIER_POW_VERSION_TARGET 1
+
+#define TIER_POW_TARGET_EXP_MAX 32
+#define TIER_POW_TARGET_MANTISSA_MAX 0xFFFFFFu
+
+/* Fractional complexity range representable with a >= 16-bit mantissa. */
+#define TIER_POW_TARGET_COMPLEXITY_MIN 0.0
+#define TIER_POW_TARGET_COMPLEXITY_MAX 238.0
+
+// Four 64-bit limbs, most significant first, so compare is lexicographic.
+typedef struct {
+    uint64_t limb[4];
+} tier_pow_target_t;
+
+TIER_POW_TARGET_INLINE uint32_t tier_pow_target_bits_pack(uint8_t exponent, const uint8_t mantissa[3])
+{
+    return ((uint32_t)exponent << 24) | ((uint32_t)mantissa[0] << 16) | ((uint32_t)mantissa[1] << 8) | mantissa[2];
+}
+
+TIER_POW_TARGET_INLINE void tier_pow_target_bits_unpack(uint32_t bits, uint8_t *exponent, uint8_t mantissa[3])
+{
+    *exponent = (uint8_t)(bits >> 24);
+    mantissa[0] = (uint8_t)(bits >> 16);
+    mantissa[1] = (uint8_t)(bits >> 8);
+    mantissa[2] = (uint8_t)bits;
+}
+
+TIER_POW_TARGET_INLINE bool tier_pow_target_bits_valid(uint32_t bits)
+{
+    const uint32_t e = bits >> 24;
+    return (bits & TIER_POW_TARGET_MANTISSA_MAX) != 0 && e >= 1 && e <= TIER_POW_TARGET_EXP_MAX;
+}
+
+static inline uint64_t tier_pow_target_load_be64(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return __builtin_bswap64(v);
+}
+
+/*
+ * Expands compact bits into limbs. Mantissa bytes that fall below 2^0
+ * (e < 3) are dropped, as in the usual compact encoding.
+ */
+static inline OpStatus_t tier_pow_target_expand(uint32_t bits, tier_pow_target_t *out)
+{
+    if (!out) return OP_NULL_PTR;
+    if (!tier_pow_target_bits_valid(bits)) return OP_INVALID_INPUT;
+
+    uint8_t be[UINT256_SIZE];
+    memset(be, 0, sizeof(be));
+    uint8_t e, m[3];
+    tier_pow_target_bits_unpack(bits, &e, m);
+    for (int i = 0; i < 3; ++i) {
+        const int idx = UINT256_SIZE - (int)e + i;
+        if (idx >= 0 && idx < UINT256_SIZE) be[idx] = m[i];
+    }
+    for (int l = 0; l < 4; ++l) out->limb[l] = tier_pow_target_load_be64(be + 8 * l);
+    return (out->limb[0] | out->limb[1] | out->limb[2] | out->limb[3]) ? OP_SUCCESS : OP_INVALID_INPUT;
+}
+
+/*
+ * hash < target. The top limb decides all but ~2^-64 of the calls, so the
+ * remaining limbs are only touched on a tie.
+ */
+TIER_POW_TARGET_INLINE bool tier_pow_check_target_met(const uint256 *hash, const tier_pow_target_t *target)
+{
+    uint8_t be[UINT256_SIZE];
+    uint256_serialize_be(hash, be, UINT256_SIZE);
+
+    uint64_t h = tier_pow_target_load_be64(be);
+    if (__builtin_expect(h != target->limb[0], 1)) return h < target->limb[0];
+    for (int l = 1; l < 4; ++l) {
+        h = tier_pow_target_load_be64(be + 8 * l);
+        if (h != target->limb[l]) return h < target->limb[l];
+    }
+    return false;
+}
+
+/* log2 of the expected hashes for a target: 256 - log2(target). */
+static inline double tier_pow_target_work_log2(uint32_t bits)
+{
+    if (!tier_pow_target_bits_valid(bits)) return 0.0;
+    const double m = (double)(bits & TIER_POW_TARGET_MANTISSA_MAX);
+    return 256.0 - (log2(m) + 8.0 * ((double)(bits >> 24) - 3.0));
+}
+
+/* Leading-zero complexity with the same expected work (work = 2^(c+2)). */
+static inline double tier_pow_target_complexity(uint32_t bits)
+{
+    return tier_pow_target_work_log2(bits) - 2.0;
+}
+
+static inline double tier_pow_complexity_work_log2(uint8_t complexity)
+{
+    return (double)complexity + 2.0;
+}
+
+/*
+ * Compact bits for fractional complexity c: target = 2^(254 - c), with the
+ * exponent chosen so the mantissa keeps at least 16 significant bits.
+ */
+static inline uint32_t tier_pow_target_from_complexity(double complexity)
+{
+    if (!(complexity >= TIER_POW_TARGET_COMPLEXITY_MIN)) complexity = TIER_POW_TARGET_COMPLEXITY_MIN;
+    if (complexity > TIER_POW_TARGET_COMPLEXITY_MAX) complexity = TIER_POW_TARGET_COMPLEXITY_MAX;
+
+    const double log2_target = 254.0 - complexity;
+    int shift = 8 * (((int)floor(log2_target) - 16) / 8);
+    uint64_t m = (uint64_t)llround(exp2(log2_target - shift));
+    if (m > TIER_POW_TARGET_MANTISSA_MAX) {
+        m = (m + 128) >> 8;
+        shift += 8;
+    }
+    const uint32_t e = (uint32_t)(shift / 8 + 3);
+    return (e << 24) | (uint32_t)m;
+}
+
+#endif // TIER_POW_TARGET_H
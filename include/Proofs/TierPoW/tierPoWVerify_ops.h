@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #define TIER_POW_VERIFY_INLINE static inline __attribute__((always_inline))
 
 #include "Proofs/TierPoW/tierPoWChallenge_ops.h"
@@ -19,15 +20,43 @@ TIER_POW_VERIFY_INLINE bool isValidTierChallenge(const tier_pow_challenge_t* pow
     if(!solve || !pow) return false;
     if (!(solve->challenge_id == pow->challenge_id)) return false;
 
+    tier_pow_target_t target = {{0}};
+    bool target_valid;
+    const bool target_mode = tier_pow_challenge_target(pow, &target, &target_valid);
+    if (!target_valid) return false;
+
     uint256 hash;
-    uint8_t nonce_buf[UINT64_SIZE];
-    uint8_t concat_buf[UINT256_SIZE * 2];
-
-    serialize_u64_be(solve->nonce, nonce_buf);
-    hash256_buffer(nonce_buf, UINT64_SIZE, &hash);
-    uint256_serialize_two_be(&pow->challenge, &hash, concat_buf, UINT256_SIZE * 2);
-    hash256_buffer(concat_buf, sizeof(concat_buf), &hash);
-    return tier_pow_check_complexity_met(&hash, pow->complexity);
+    tier_pow_hash_attempt(&pow->challenge, solve->nonce, &hash);
+    return target_mode ? tier_pow_check_target_met(&hash, &target)
+                       : tier_pow_check_complexity_met(&hash, pow->complexity);
+}
+
+#define TIER_POW_BOUND_MAX 32
+
+/*
+ * Challenge a block's solution is searched and checked against: the stored
+ * challenge hashed with `bound`, bytes of the block it does not cover
+ * (block.reserved: PoW version, certificate op, padding). Changing any of
+ * them after the fact invalidates the solution.
+ */
+TIER_POW_VERIFY_INLINE void tier_pow_challenge_bind(const tier_pow_challenge_t *pow, const uint8_t *bound, size_t len,
+                                                    tier_pow_challenge_t *out)
+{
+    uint8_t buf[UINT256_SIZE + TIER_POW_BOUND_MAX];
+    if (len > TIER_POW_BOUND_MAX) len = TIER_POW_BOUND_MAX;
+    *out = *pow;
+    uint256_serialize_be(&pow->challenge, buf, UINT256_SIZE);
+    memcpy(buf + UINT256_SIZE, bound, len);
+    hash256_buffer(buf, UINT256_SIZE + len, &out->challenge);
+}
+
+TIER_POW_VERIFY_INLINE bool isValidBoundTierChallenge(const tier_pow_challenge_t *pow, const tier_pow_solve_t *solve,
+                                                      const uint8_t *bound, size_t len)
+{
+    if (!pow || !solve || !bound) return false;
+    tier_pow_challenge_t bound_pow;
+    tier_pow_challenge_bind(pow, bound, len, &bound_pow);
+    return isValidTierChallenge(&bound_pow, solve);
 }
 
 /* Moved to NetworkSerialization.h */
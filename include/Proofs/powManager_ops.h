@@ -7,14 +7,22 @@
 #include <stdbool.h>
 #include <time.h>
 #include <stdio.h>
+#include <pthread.h>
 
 #include "blockchain/block.h"
 #include "blockchain/pkcertchain_ops.h"
+#include "blockchain/chainWriter_ops.h"
+#include "blockchain/chainTierIndex_ops.h"
 #include "Proofs/TierPoW/tierPoWChallenge_ops.h"
 #include "Proofs/TierPoW/tierPoWSolve_ops.h"
 #include "Proofs/TierPoW/tierPoWVerify_ops.h"
 #include "Proofs/TierPoW/tierPoWResult_ops.h"
+#include "Proofs/TierPoW/tierPoWDifficulty_ops.h"
+#include "Proofs/TierPoW/tierPoWBench_ops.h"
+#include "Proofs/TierPoW/tierPoWSolveParallel_ops.h"
+#include "scheduler/workPool_ops.h"
 #include "core/enums/OpStatus.h"
+#include "telemetry/metrics_ops.h"
 
 // typedef struct {
 //     PKCertChain *chain;
@@ -25,23 +33,47 @@
 //     double solve_time_seconds;
 // } PowManager;
 
-static inline uint8_t bayesian_update(uint8_t current_complexity, double solve_time_seconds) {
-    const double target_time = 600.0;
-    if (solve_time_seconds <= 0.0) solve_time_seconds = 0.1;
-    
-    double next = current_complexity;
-    
-    if (target_time < solve_time_seconds) {
-        double ratio = (solve_time_seconds - target_time) / target_time;
-        next -= (current_complexity * ratio);
-    } else if (target_time > solve_time_seconds) {
-        double ratio = (target_time - solve_time_seconds) / target_time;
-        next += (current_complexity * ratio);
+/*
+ * Every TierPoW search gets its own cancellation token for the length of
+ * the run (PowManager's layout belongs to the shared protocol headers, so
+ * the token lives in the run's frame) and links it into the in-flight
+ * list. PowManager_Cancel cancels every search in flight; a run starting
+ * afterwards gets a fresh token and cannot clear another run's cancel.
+ */
+typedef struct pow_manager_run {
+    pkc_pool_cancel_t cancel;
+    struct pow_manager_run *next;
+} pow_manager_run_t;
+
+__attribute__((weak)) pthread_mutex_t pow_manager_runs_lock = PTHREAD_MUTEX_INITIALIZER;
+__attribute__((weak)) pow_manager_run_t *pow_manager_runs;
+
+static inline void pow_manager_run_begin(pow_manager_run_t *run)
+{
+    pkc_pool_cancel_init(&run->cancel);
+    pthread_mutex_lock(&pow_manager_runs_lock);
+    run->next = pow_manager_runs;
+    pow_manager_runs = run;
+    pthread_mutex_unlock(&pow_manager_runs_lock);
+}
+
+static inline void pow_manager_run_end(pow_manager_run_t *run)
+{
+    pthread_mutex_lock(&pow_manager_runs_lock);
+    for (pow_manager_run_t **p = &pow_manager_runs; *p; p = &(*p)->next) {
+        if (*p == run) {
+            *p = run->next;
+            break;
+        }
     }
-    
-    if (next > 255.0) return 255;
-    if (next < 1.0) return 1;
-    return (uint8_t)next;
+    pthread_mutex_unlock(&pow_manager_runs_lock);
+}
+
+static inline void PowManager_Cancel(void)
+{
+    pthread_mutex_lock(&pow_manager_runs_lock);
+    for (pow_manager_run_t *r = pow_manager_runs; r; r = r->next) pkc_pool_cancel(&r->cancel);
+    pthread_mutex_unlock(&pow_manager_runs_lock);
 }
 
 static inline double get_monotonic_time_sec() {
@@ -50,90 +82,80 @@ static inline double get_monotonic_time_sec() {
     return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
-static inline OpStatus_t generate_tier_pow_challenge(block *blk,
-                                                     uint8_t complexity,
-                                                     tier_pow_challenge_t *pow)
+/*
+ * Reference block of `tier` for a block mined at chain index `end`: the
+ * newest block of the tier below `end` in the tier index bound to `chain`,
+ * or `fallback` (the chain's or the tip's last index) when that is newer
+ * or there is no index. The index is only read here, through its
+ * published per-tier counts; the chain writer keeps it in sync.
+ */
+static inline uint32_t pow_manager_reference_index(const PKCertChain *chain, Tier_t tier, uint32_t end,
+                                                   uint32_t fallback)
 {
-    uint8_t buf[CERT_SIZE + UINT256_SIZE + UINT64_SIZE + UINT64_SIZE + 4 * UINT8_SIZE];
-    const size_t packed_len = sizeof(buf);
-
-    if (!blk || !pow) return OP_NULL_PTR;
-
-    uint256_serialize_be(&blk->cert.pubSignKey, buf, UINT256_SIZE);
-    uint256_serialize_be(&blk->cert.pubEncKey, buf + UINT256_SIZE, UINT256_SIZE);
-    buf[CERT_SIZE - 1] = blk->cert.id;
-
-    uint256_serialize_be(&blk->prevHash, buf + CERT_SIZE, UINT256_SIZE);
-    serialize_u64_be(blk->height, buf + CERT_SIZE + UINT256_SIZE);
-    serialize_u64_be(blk->timestamp, buf + CERT_SIZE + UINT256_SIZE + UINT64_SIZE);
-    serialize_u8(blk->tier, buf + CERT_SIZE + UINT256_SIZE + 2 * UINT64_SIZE);
-
-    hash256_buffer(buf, packed_len, &pow->challenge);
-
-    pow->complexity = complexity;
-
-    return OP_SUCCESS;
+    const pkc_tier_index_t *tiers = pkc_tier_index_for(chain);
+    const uint32_t *newest = NULL;
+    if (!tiers || pkc_tier_index_last_k_below(tiers, tier, end, 1, &newest) == 0) return fallback;
+    return *newest > fallback ? *newest : fallback;
 }
 
-static inline OpStatus_t PowManager_Run(PowManager *manager, block *currentBlock) {
-    uint32_t lastIndex = 0;
-    uint8_t complexity = 0;
-
-    switch(manager->tier) {
-        case TIER_MCU: 
-            lastIndex = manager->chain->lastMCUBlockIndex; 
-            complexity = manager->chain->MCUComplexity; 
-            break;
-        case TIER_SERVER: 
-            lastIndex = manager->chain->lastServerBlockIndex; 
-            complexity = manager->chain->ServerComplexity; 
-            break;
-        case TIER_DESKTOP: 
-            lastIndex = manager->chain->lastDesktopBlockIndex; 
-            complexity = manager->chain->DesktopComplexity; 
-            break;
-        case TIER_EDGE: 
-            lastIndex = manager->chain->lastEdgeBlockIndex; 
-            complexity = manager->chain->EdgeComplexity; 
-            break;
-        default: 
-            return OP_INVALID_INPUT;
-    }
+/*
+ * Mines `currentBlock` at `complexity` against the tier's reference block
+ * at `lastIndex`. Writes nothing on the chain or the difficulty
+ * controller, so it can run while a chain writer owns them and on any
+ * number of miner threads: the retarget happens when the block commits
+ * (pkc_chain_retarget). The solution is bound to currentBlock->reserved
+ * (tier_pow_challenge_bind), so set its certificate op before mining.
+ */
+static inline OpStatus_t PowManager_RunFrom(PowManager *manager, block *currentBlock, uint32_t lastIndex,
+                                            uint8_t complexity) {
+    if (!manager || !currentBlock) return OP_NULL_PTR;
+    if (!tier_pow_chain_field((Tier_t)manager->tier)) return OP_INVALID_INPUT;
 
     block *refBlock = &manager->chain->blocks[lastIndex];
+    tier_pow_difficulty_t *difficulty = tier_pow_difficulty_default();
+    const uint8_t powVersion = difficulty->cfg.version;
 
     generate_tier_pow_challenge(refBlock, complexity, &manager->challenge);
+    uint32_t targetBits = 0;
+    if (powVersion == TIER_POW_VERSION_TARGET) {
+        targetBits = tier_pow_difficulty_target_bits(difficulty, (Tier_t)manager->tier, complexity);
+        tier_pow_challenge_set_target_bits(&manager->challenge, targetBits);
+    }
+    block_set_pow_version(currentBlock, powVersion);
+    tier_pow_challenge_t bound;
+    tier_pow_challenge_bind(&manager->challenge, currentBlock->reserved, sizeof(currentBlock->reserved), &bound);
+
+    // Refuse searches that cannot finish (e.g. 100+ zero bits) before starting them.
+    const uint32_t solverThreads = pkc_pool_workers(pkc_pool_default()) ? pkc_pool_workers(pkc_pool_default()) : 1;
+    OpStatus_t budget = tier_pow_budget_check(tier_pow_hashrate_default(), &bound, solverThreads, NULL);
+    if (budget != OP_SUCCESS) return budget;
 
     tier_pow_solve_init(&manager->solve);
-    tier_pow_solve_t *solve_ptr = &manager->solve;
-    
-    // Simulate / execute the real work
+    pow_manager_run_t run;
+    pow_manager_run_begin(&run);
+    uint64_t hashes = 0;
+
     double start_time = get_monotonic_time_sec();
-    // To prevent total system freezing in integration testing if complexity == 100,
-    // we do a standard solve run. However, 100 leading zeros is unreachable quickly.
-    // If the system test modifies complexity to manageable, this will return quickly.
-    tier_pow_solve_challenge(&manager->challenge, &solve_ptr); 
+    OpStatus_t solved = tier_pow_solve_parallel(&bound, &manager->solve, solverThreads,
+                                                &run.cancel, &hashes);
     double end_time = get_monotonic_time_sec();
+    pow_manager_run_end(&run);
     
     manager->solve_time_seconds = end_time - start_time;
 
-    if (!solve_ptr || !isValidTierChallenge(&manager->challenge, &manager->solve)) {
-        return OP_INVALID_INPUT;
+    pkc_metrics_count_tier_hashes((Tier_t)manager->tier, hashes);
+    if (solved != OP_SUCCESS) {
+        return solved;
     }
 
-    switch(manager->tier) {
-        case TIER_MCU: 
-            manager->chain->MCUComplexity = bayesian_update(manager->chain->MCUComplexity, manager->solve_time_seconds); 
-            break;
-        case TIER_SERVER: 
-            manager->chain->ServerComplexity = bayesian_update(manager->chain->ServerComplexity, manager->solve_time_seconds); 
-            break;
-        case TIER_DESKTOP: 
-            manager->chain->DesktopComplexity = bayesian_update(manager->chain->DesktopComplexity, manager->solve_time_seconds); 
-            break;
-        case TIER_EDGE: 
-            manager->chain->EdgeComplexity = bayesian_update(manager->chain->EdgeComplexity, manager->solve_time_seconds); 
-            break;
+    pkc_metrics_observe_tier_solve_ns((Tier_t)manager->tier, (uint64_t)(manager->solve_time_seconds * 1e9));
+    pkc_metrics_count(PKC_CTR_TIER_POW_SOLVES, 1);
+
+    uint64_t verify_start = pkc_metrics_now_ns();
+    bool solve_valid = isValidTierChallenge(&bound, &manager->solve);
+    pkc_metrics_observe_ns(PKC_HIST_TIER_POW_VERIFY, pkc_metrics_now_ns() - verify_start);
+    if (!solve_valid) {
+        return OP_INVALID_INPUT;
     }
 
     if (manager->miniResult) {
@@ -149,35 +171,67 @@ static inline OpStatus_t PowManager_Run(PowManager *manager, block *currentBlock
     
     currentBlock->tierPoWResult = tr;
 
-    switch(manager->tier) {
-        case TIER_MCU: manager->chain->lastMCUBlockIndex = currentBlock->height; break;
-        case TIER_SERVER: manager->chain->lastServerBlockIndex = currentBlock->height; break;
-        case TIER_DESKTOP: manager->chain->lastDesktopBlockIndex = currentBlock->height; break;
-        case TIER_EDGE: manager->chain->lastEdgeBlockIndex = currentBlock->height; break;
-    }
+    return OP_SUCCESS;
+}
 
+static inline OpStatus_t PowManager_Run(PowManager *manager, block *currentBlock) {
+    const tier_pow_chain_field_t *field = tier_pow_chain_field((Tier_t)manager->tier);
+    if (!field) return OP_INVALID_INPUT;
+
+    const uint32_t lastIndex = pow_manager_reference_index(manager->chain, (Tier_t)manager->tier,
+                                                           manager->chain->index,
+                                                           tier_pow_chain_last_index(manager->chain, field));
+    OpStatus_t st = PowManager_RunFrom(manager, currentBlock, lastIndex,
+                                       tier_pow_chain_complexity(manager->chain, field));
+    if (st != OP_SUCCESS) return st;
+
+    pkc_chain_retarget(manager->chain, currentBlock);
+    tier_pow_chain_set_last_index(manager->chain, field, currentBlock->height);
     return OP_SUCCESS;
 }
 
-static inline OpStatus_t PKCertChain_AddBlockWithPoW(PKCertChain *chain, MiniPowResult *miniResult, Tier_t tier)
+/*
+ * Mines the next block of `tier` into `out`. With `tip` the height,
+ * prevHash, complexity and reference block come from that published tip
+ * (chain writer running; hand `out` to pkc_chain_append, which retargets
+ * as it commits), otherwise from the chain itself.
+ * A bound tier index supplies the reference block when it knows a newer
+ * one (pow_manager_reference_index).
+ */
+static inline OpStatus_t PKCertChain_MineBlock(PKCertChain *chain, MiniPowResult *miniResult, Tier_t tier,
+                                               const pkc_chain_tip_t *tip, block *out)
 {
-    if (!chain) return OP_NULL_PTR;
-    
-    block *blk = &chain->blocks[chain->index];
-    block_init(blk);
-    blk->height = chain->index;
-    blk->tier = tier;
+    if (!chain || !out) return OP_NULL_PTR;
+    const tier_pow_chain_field_t *field = tier_pow_chain_field(tier);
+    if (!field) return OP_INVALID_INPUT;
+
+    block_init(out);
+    out->height = tip ? tip->index : chain->index;
+    out->tier = tier;
+    if (tip) out->prevHash = tip->hash;
+    else if (chain->index > 0) block_link_hash(&chain->blocks[chain->index - 1], &out->prevHash);
 
     PowManager manager;
     manager.chain = chain;
     manager.tier = tier;
     manager.miniResult = miniResult;
 
-    OpStatus_t st = PowManager_Run(&manager, blk);
+    const uint32_t lastIndex = pow_manager_reference_index(chain, tier, (uint32_t)out->height,
+                                                           tip ? pkc_chain_tip_last_index(tip, tier)
+                                                               : tier_pow_chain_last_index(chain, field));
+    const uint8_t complexity = tip ? pkc_chain_tip_complexity(tip, tier) : tier_pow_chain_complexity(chain, field);
+    return PowManager_RunFrom(&manager, out, lastIndex, complexity);
+}
+
+static inline OpStatus_t PKCertChain_AddBlockWithPoW(PKCertChain *chain, MiniPowResult *miniResult, Tier_t tier)
+{
+    if (!chain) return OP_NULL_PTR;
+
+    block blk;
+    OpStatus_t st = PKCertChain_MineBlock(chain, miniResult, tier, NULL, &blk);
     if(st != OP_SUCCESS) return st;
 
-    chain->index++;
-    return OP_SUCCESS;
+    return pkc_chain_apply(chain, &blk, false);
 }
 
 #endif // POW_MANAGER_H
@@ -0,0 +1,323 @@
+#ifndef BLOCK_BULK_H
+#define BLOCK_BULK_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+#include "blockchain/block.h"
+#include "blockchain/blockView_ops.h"
+#include "scheduler/workPool_ops.h"
+#include "core/enums/OpStatus.h"
+
+#ifndef BLOCK_BULK_INLINE
+#define BLOCK_BULK_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Bulk block (de)serialization over arrays of canonical BLOCK_SIZE records.
+ *
+ * block_serialize byte-swaps field by field through the scalar helpers.
+ * On a little-endian host a big-endian uint256 / uint512 is the word
+ * array's bytes in reverse, so the vector kernel does each key, hash and
+ * signature with one byte shuffle (vpshufb + lane swap on AVX2, two
+ * pshufb on SSSE3) and the 64-bit fields with bswap. Builds without
+ * either ISA, or on big-endian hosts, use the scalar path.
+ *
+ * The kernel is tied to the field offsets in blockView_ops.h. The first
+ * bulk call checks it against block_serialize / block_deserialize on probe
+ * blocks and stays on the scalar path for good if they disagree. Every
+ * record is fully written, tail bytes zeroed, so output is deterministic.
+ *
+ * Calls of BLOCKS_BULK_PARALLEL_MIN blocks or more are split over the
+ * work pool in BLOCKS_BULK_CHUNK pieces; the _seq variants never fork and
+ * are the ones to use from inside pool tasks.
+ *
+ * Deserialization is a decoder, not a validator: the vector kernel copies
+ * every field as it is and never fails, so whatever checks block_deserialize
+ * makes on its own are skipped on that path. Only hand it records that are
+ * already trusted, such as the hash-checked state file this node wrote;
+ * anything from a peer goes through block_deserialize and
+ * pkc_chain_validate instead.
+ */
+
+#ifndef BLOCKS_BULK_PARALLEL_MIN
+#define BLOCKS_BULK_PARALLEL_MIN 8192
+#endif
+
+#ifndef BLOCKS_BULK_CHUNK
+#define BLOCKS_BULK_CHUNK 2048
+#endif
+
+#if (defined(__AVX2__) || defined(__SSSE3__)) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define BLOCKS_BULK_SIMD 1
+#else
+#define BLOCKS_BULK_SIMD 0
+#endif
+
+#if BLOCKS_BULK_SIMD && defined(__AVX2__)
+#define BLOCKS_BULK_ISA "avx2"
+#elif BLOCKS_BULK_SIMD
+#define BLOCKS_BULK_ISA "ssse3"
+#else
+#define BLOCKS_BULK_ISA "scalar"
+#endif
+
+/* 0 = not checked yet, 1 = vector kernel verified, -1 = scalar only. */
+__attribute__((weak)) _Atomic(int) blocks_bulk_simd_state = 0;
+
+/* ---------------- scalar reference ---------------- */
+
+static inline OpStatus_t blocks_serialize_scalar(const block *blocks, size_t n, uint8_t *buf)
+{
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t *out = buf + i * BLOCK_SIZE;
+        memset(out, 0, BLOCK_SIZE);
+        OpStatus_t st = block_serialize(&blocks[i], out, BLOCK_SIZE);
+        if (st != OP_SUCCESS) return st;
+    }
+    return OP_SUCCESS;
+}
+
+static inline OpStatus_t blocks_deserialize_scalar(const uint8_t *buf, block *blocks, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        OpStatus_t st = block_deserialize(buf + i * BLOCK_SIZE, BLOCK_SIZE, &blocks[i]);
+        if (st != OP_SUCCESS) return st;
+    }
+    return OP_SUCCESS;
+}
+
+/* ---------------- vector kernel ---------------- */
+
+#if BLOCKS_BULK_SIMD
+
+/* dst[0..32) = src[31..0]; src and dst may be unaligned, not overlapping. */
+BLOCK_BULK_INLINE void blocks_rev32(uint8_t *dst, const uint8_t *src)
+{
+#if defined(__AVX2__)
+    const __m256i rev = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                         15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)src), rev);
+    _mm256_storeu_si256((__m256i *)dst, _mm256_permute4x64_epi64(v, 0x4E));
+#else
+    const __m128i rev = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), rev);
+    __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + 16)), rev);
+    _mm_storeu_si128((__m128i *)dst, hi);
+    _mm_storeu_si128((__m128i *)(dst + 16), lo);
+#endif
+}
+
+BLOCK_BULK_INLINE void blocks_rev64(uint8_t *dst, const uint8_t *src)
+{
+    blocks_rev32(dst, src + 32);
+    blocks_rev32(dst + 32, src);
+}
+
+BLOCK_BULK_INLINE void blocks_store_be64(uint8_t *dst, uint64_t x)
+{
+    x = __builtin_bswap64(x);
+    memcpy(dst, &x, sizeof(x));
+}
+
+BLOCK_BULK_INLINE uint64_t blocks_load_be64(const uint8_t *src)
+{
+    uint64_t x;
+    memcpy(&x, src, sizeof(x));
+    return __builtin_bswap64(x);
+}
+
+#define BLOCKS_BULK_ID_SIZE (sizeof(((certificate *)0)->id) < BLOCK_VIEW_CERT_ID_SIZE ? sizeof(((certificate *)0)->id) : BLOCK_VIEW_CERT_ID_SIZE)
+#define BLOCKS_BULK_RESERVED_SIZE                                                                        \
+    (BLOCK_VIEW_RESERVED_OFFSET >= BLOCK_SIZE ? 0                                                        \
+     : BLOCK_SIZE - BLOCK_VIEW_RESERVED_OFFSET < sizeof(((block *)0)->reserved) ? BLOCK_SIZE - BLOCK_VIEW_RESERVED_OFFSET \
+                                                                                 : sizeof(((block *)0)->reserved))
+
+BLOCK_BULK_INLINE void blocks_serialize_one(const block *b, uint8_t *out)
+{
+    blocks_rev32(out + BLOCK_VIEW_PUB_SIGN_KEY_OFFSET, (const uint8_t *)&b->cert.pubSignKey);
+    blocks_rev32(out + BLOCK_VIEW_PUB_ENC_KEY_OFFSET, (const uint8_t *)&b->cert.pubEncKey);
+    memset(out + BLOCK_VIEW_CERT_ID_OFFSET, 0, BLOCK_VIEW_CERT_ID_SIZE);
+    memcpy(out + BLOCK_VIEW_CERT_ID_OFFSET, &b->cert.id, BLOCKS_BULK_ID_SIZE);
+    blocks_rev32(out + BLOCK_VIEW_CERT_HASH_OFFSET, (const uint8_t *)&b->CurrentCertHash);
+    blocks_rev32(out + BLOCK_VIEW_PREV_HASH_OFFSET, (const uint8_t *)&b->prevHash);
+    blocks_rev64(out + BLOCK_VIEW_SIGNATURE_OFFSET, (const uint8_t *)&b->SignedByVerifier);
+    blocks_store_be64(out + BLOCK_VIEW_HEIGHT_OFFSET, b->height);
+    blocks_store_be64(out + BLOCK_VIEW_TIMESTAMP_OFFSET, b->timestamp);
+    out[BLOCK_VIEW_TIER_OFFSET] = (uint8_t)b->tier;
+    if (BLOCK_VIEW_RESERVED_OFFSET < BLOCK_SIZE) {
+        memset(out + BLOCK_VIEW_RESERVED_OFFSET, 0, BLOCK_SIZE - BLOCK_VIEW_RESERVED_OFFSET);
+        memcpy(out + BLOCK_VIEW_RESERVED_OFFSET, b->reserved, BLOCKS_BULK_RESERVED_SIZE);
+    }
+}
+
+BLOCK_BULK_INLINE void blocks_deserialize_one(const uint8_t *in, block *b)
+{
+    memset(b, 0, sizeof(*b));
+    blocks_rev32((uint8_t *)&b->cert.pubSignKey, in + BLOCK_VIEW_PUB_SIGN_KEY_OFFSET);
+    blocks_rev32((uint8_t *)&b->cert.pubEncKey, in + BLOCK_VIEW_PUB_ENC_KEY_OFFSET);
+    memcpy(&b->cert.id, in + BLOCK_VIEW_CERT_ID_OFFSET, BLOCKS_BULK_ID_SIZE);
+    blocks_rev32((uint8_t *)&b->CurrentCertHash, in + BLOCK_VIEW_CERT_HASH_OFFSET);
+    blocks_rev32((uint8_t *)&b->prevHash, in + BLOCK_VIEW_PREV_HASH_OFFSET);
+    blocks_rev64((uint8_t *)&b->SignedByVerifier, in + BLOCK_VIEW_SIGNATURE_OFFSET);
+    b->height = blocks_load_be64(in + BLOCK_VIEW_HEIGHT_OFFSET);
+    b->timestamp = blocks_load_be64(in + BLOCK_VIEW_TIMESTAMP_OFFSET);
+    b->tier = (Tier_t)in[BLOCK_VIEW_TIER_OFFSET];
+    if (BLOCK_VIEW_RESERVED_OFFSET < BLOCK_SIZE)
+        memcpy(b->reserved, in + BLOCK_VIEW_RESERVED_OFFSET, BLOCKS_BULK_RESERVED_SIZE);
+}
+
+/* Fills a probe block with distinct bytes in every field the wire carries. */
+static inline void blocks_bulk_probe(block *b, uint32_t seed)
+{
+    memset(b, 0, sizeof(*b));
+    uint8_t *p = (uint8_t *)b;
+    const size_t head = offsetof(block, reserved) + sizeof(b->reserved);
+    for (size_t i = 0; i < head; ++i) p[i] = (uint8_t)(i * 37 + seed * 101 + 1);
+    b->tier = (Tier_t)(seed % 4 + 1);
+    memset(&b->miniPowResult, 0, sizeof(b->miniPowResult));
+    memset(&b->tierPoWResult, 0, sizeof(b->tierPoWResult));
+}
+
+/* Checks the kernel against the scalar path on probe blocks. */
+static inline bool blocks_bulk_verify(void)
+{
+    for (uint32_t seed = 0; seed < 4; ++seed) {
+        block b, scalar, vector;
+        uint8_t want[BLOCK_SIZE], got[BLOCK_SIZE];
+        blocks_bulk_probe(&b, seed);
+        memset(want, 0, sizeof(want));
+        if (block_serialize(&b, want, BLOCK_SIZE) != OP_SUCCESS) return false;
+        blocks_serialize_one(&b, got);
+        if (memcmp(want, got, BLOCK_SIZE) != 0) return false;
+
+        memset(&scalar, 0, sizeof(scalar));
+        memset(&vector, 0, sizeof(vector));
+        if (block_deserialize(want, BLOCK_SIZE, &scalar) != OP_SUCCESS) return false;
+        blocks_deserialize_one(want, &vector);
+        if (memcmp(&scalar, &vector, sizeof(block)) != 0) return false;
+    }
+    return true;
+}
+
+#endif // BLOCKS_BULK_SIMD
+
+/* True when bulk calls run the vector kernel (checks it on first use). */
+static inline bool blocks_bulk_simd(void)
+{
+#if BLOCKS_BULK_SIMD
+    int state = atomic_load_explicit(&blocks_bulk_simd_state, memory_order_acquire);
+    if (state == 0) {
+        // Racing first callers compute the same answer.
+        state = blocks_bulk_verify() ? 1 : -1;
+        atomic_store_explicit(&blocks_bulk_simd_state, state, memory_order_release);
+    }
+    return state > 0;
+#else
+    return false;
+#endif
+}
+
+/* ---------------- sequential entry points ---------------- */
+
+static inline OpStatus_t blocks_serialize_seq(const block *blocks, size_t n, uint8_t *buf)
+{
+#if BLOCKS_BULK_SIMD
+    if (blocks_bulk_simd()) {
+        for (size_t i = 0; i < n; ++i) blocks_serialize_one(&blocks[i], buf + i * BLOCK_SIZE);
+        return OP_SUCCESS;
+    }
+#endif
+    return blocks_serialize_scalar(blocks, n, buf);
+}
+
+static inline OpStatus_t blocks_deserialize_seq(const uint8_t *buf, block *blocks, size_t n)
+{
+#if BLOCKS_BULK_SIMD
+    if (blocks_bulk_simd()) {
+        for (size_t i = 0; i < n; ++i) blocks_deserialize_one(buf + i * BLOCK_SIZE, &blocks[i]);
+        return OP_SUCCESS;
+    }
+#endif
+    return blocks_deserialize_scalar(buf, blocks, n);
+}
+
+/* ---------------- parallel ---------------- */
+
+typedef struct {
+    const block *src_blocks;
+    block *dst_blocks;
+    const uint8_t *src_buf;
+    uint8_t *dst_buf;
+    size_t n;
+    bool serialize;
+    _Atomic(size_t) next;
+    _Atomic(int) status;
+} blocks_bulk_job_t;
+
+static inline void blocks_bulk_worker(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)cancel;
+    blocks_bulk_job_t *job = (blocks_bulk_job_t *)arg;
+    size_t first;
+    while ((first = atomic_fetch_add_explicit(&job->next, BLOCKS_BULK_CHUNK, memory_order_relaxed)) < job->n) {
+        const size_t k = job->n - first < BLOCKS_BULK_CHUNK ? job->n - first : BLOCKS_BULK_CHUNK;
+        const OpStatus_t st = job->serialize
+            ? blocks_serialize_seq(job->src_blocks + first, k, job->dst_buf + first * BLOCK_SIZE)
+            : blocks_deserialize_seq(job->src_buf + first * BLOCK_SIZE, job->dst_blocks + first, k);
+        if (st != OP_SUCCESS) atomic_store_explicit(&job->status, (int)st, memory_order_relaxed);
+    }
+}
+
+static inline OpStatus_t blocks_bulk_run(blocks_bulk_job_t *job)
+{
+    // Small calls never touch the pool, so they do not bring it up either.
+    pkc_pool_t *pool = job->n < BLOCKS_BULK_PARALLEL_MIN ? NULL : pkc_pool_default();
+    const uint32_t workers = pool ? pkc_pool_workers(pool) : 0;
+    if (workers < 2) {
+        return job->serialize ? blocks_serialize_seq(job->src_blocks, job->n, job->dst_buf)
+                              : blocks_deserialize_seq(job->src_buf, job->dst_blocks, job->n);
+    }
+    blocks_bulk_simd(); // settle the kernel check before the workers race on it
+    atomic_init(&job->next, 0);
+    atomic_init(&job->status, (int)OP_SUCCESS);
+    const size_t chunks = (job->n + BLOCKS_BULK_CHUNK - 1) / BLOCKS_BULK_CHUNK;
+    pkc_pool_fork_join(pool, PKC_POOL_PRIO_VALIDATE, chunks < workers ? (uint32_t)chunks : workers,
+                       blocks_bulk_worker, job, NULL);
+    return (OpStatus_t)atomic_load_explicit(&job->status, memory_order_relaxed);
+}
+
+/*
+ * Serializes n blocks into n * BLOCK_SIZE bytes of `buf` (len bytes
+ * available). Output is byte-identical to block_serialize per record.
+ */
+static inline OpStatus_t blocks_serialize(const block *blocks, size_t n, uint8_t *buf, size_t len)
+{
+    if ((!blocks || !buf) && n) return OP_NULL_PTR;
+    if (len / BLOCK_SIZE < n) return OP_BUFFER_TOO_SMALL;
+    blocks_bulk_job_t job = { .src_blocks = blocks, .dst_buf = buf, .n = n, .serialize = true };
+    return blocks_bulk_run(&job);
+}
+
+/*
+ * Deserializes n BLOCK_SIZE records from `buf` (len bytes) into `blocks`.
+ * Trusted input only; see the note at the top.
+ */
+static inline OpStatus_t blocks_deserialize(const uint8_t *buf, size_t len, block *blocks, size_t n)
+{
+    if ((!blocks || !buf) && n) return OP_NULL_PTR;
+    if (len / BLOCK_SIZE < n) return OP_BUFFER_TOO_SMALL;
+    blocks_bulk_job_t job = { .src_buf = buf, .dst_blocks = blocks, .n = n, .serialize = false };
+    return blocks_bulk_run(&job);
+}
+
+#endif // BLOCK_BULK_H
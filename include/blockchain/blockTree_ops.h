@@ -0,0 +1,535 @@
+#ifndef PKC_BLOCK_TREE_H
+#define PKC_BLOCK_TREE_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "blockchain/block.h"
+#include "blockchain/block_ops.h"
+#include "blockhain/PKCertChain.h"
+#include "blockchain/blockView_ops.h"
+#include "blockchain/chainColumns_ops.h"
+#include "blockchain/chainTierIndex_ops.h"
+#include "blockchain/chainWriter_ops.h"
+#include "Proofs/TierPoW/tierPoWDifficulty_ops.h"
+#include "Proofs/TierPoW/tierPoWVerify_ops.h"
+#include "core/enums/OpStatus.h"
+#include "core/enums/Tier.h"
+#include "telemetry/metrics_ops.h"
+
+#ifndef PKC_BLOCK_TREE_INLINE
+#define PKC_BLOCK_TREE_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Fork-aware block store.
+ *
+ * Every block received is kept as a node of a tree keyed by its block
+ * hash (block_link_hash, over the whole serialized record), the value
+ * a child added to the tree commits to in prevHash. Keying by the block
+ * rather than its certificate lets two competing blocks for the same
+ * certificate, or a revocation and the issue it revokes, stand side by
+ * side. A node carries its parent, the cumulative TierPoW work of its
+ * branch per tier (2^complexity per block, or 2^254 / target, the same
+ * scale) and the branch's score, the tier-weighted sum of that work. Work
+ * and score are 256-bit integers, saturating, so every node picks the
+ * same best tip whatever its floating point: the node with the highest
+ * score, and on a tie the first one seen.
+ *
+ * The best branch is mirrored as a height -> node array and, when a chain
+ * is attached, into chain->blocks, chain->index, the last*BlockIndex
+ * fields and the per-tier complexity fields. Each node carries the tier
+ * state of its branch: the newest block of each tier and the complexity
+ * each tier last solved at (rounded in target mode), so connecting a node
+ * restores exactly what its branch issues next; the attached tip keeps
+ * the chain's own fields. A block that extends the best tip is one append. A side branch
+ * that overtakes it is a reorg: walk back from the new tip to the first
+ * node on the best branch, drop the heights above that fork point and
+ * write the new suffix. Nothing below the fork point is touched, and the
+ * optional columns and tier index are truncated to the fork point and
+ * appended to in the same way, so a reorg costs O(depth) whatever the
+ * chain length.
+ *
+ * A reorg rewrites committed slots, which the chain writer promises never
+ * to do, so a tree owns its chain the way a writer would and the two do
+ * not run on the same chain. The chain log (chainStore_ops.h) and the
+ * certificate index (certStatus_ops.h) only ever append, so the tree does
+ * not keep them: after a PKC_TREE_REORG the owner truncates the log to
+ * fork_height + 1 (pkc_chain_store_truncate) and rebuilds the index
+ * (pkc_cert_index_build) before appending the new suffix. The difficulty
+ * controller keeps the solves it observed on the old branch. Nothing is
+ * pruned: side branches stay until the tree is destroyed.
+ */
+
+#define PKC_TREE_NONE UINT32_MAX
+
+#ifndef PKC_TREE_INITIAL_NODES
+#define PKC_TREE_INITIAL_NODES 1024
+#endif
+
+typedef enum {
+    PKC_TREE_EXTENDED = 0,          // extended the best tip
+    PKC_TREE_SIDE,                  // stored on a branch that is not best
+    PKC_TREE_REORG,                 // its branch overtook the best tip
+    PKC_TREE_DUPLICATE              // already in the tree, nothing changed
+} pkc_tree_outcome_t;
+
+typedef struct {
+    pkc_tree_outcome_t outcome;
+    uint32_t node;
+    uint64_t fork_height;           // REORG: highest height both branches share
+    uint32_t disconnected;          // REORG: blocks dropped from the best branch
+    uint32_t connected;             // blocks written to it
+} pkc_tree_result_t;
+
+// 256-bit unsigned, most significant limb first like tier_pow_target_t
+typedef struct {
+    uint64_t limb[4];
+} pkc_tree_work_t;
+
+typedef struct {
+    uint32_t tier_weight[TIER_POW_DIFFICULTY_TIERS];    // tier_pow_chain_fields order
+    bool require_pow;               // check each block's TierPoW against its branch on add
+    pkc_chain_columns_t *columns;   // optional, kept in step with the best branch
+    pkc_tier_index_t *tiers;        // optional, likewise
+} pkc_tree_config_t;
+
+typedef struct {
+    block blk;
+    uint256 hash;                   // block_link_hash(&blk), the node's key
+    uint32_t parent;                // PKC_TREE_NONE at the root
+    uint32_t last_index[TIER_POW_DIFFICULTY_TIERS];     // newest block of each tier on the branch
+    uint32_t last_node[TIER_POW_DIFFICULTY_TIERS];      // its node: the tier's reference block
+    uint8_t complexity[TIER_POW_DIFFICULTY_TIERS];      // tier complexity fields with this node as tip
+    pkc_tree_work_t work[TIER_POW_DIFFICULTY_TIERS];    // cumulative, per tier
+    pkc_tree_work_t score;
+    bool active;                    // on the best branch
+} pkc_tree_node_t;
+
+typedef struct {
+    uint64_t tag;                   // first word of the key
+    uint32_t node;                  // PKC_TREE_NONE when free
+} pkc_tree_slot_t;
+
+typedef struct {
+    pkc_tree_config_t cfg;
+    PKCertChain *chain;             // NULL: the best branch lives in the tree only
+
+    pkc_tree_node_t *nodes;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t *active;               // best branch, node per height
+    uint32_t *path;                 // reorg scratch
+    uint32_t height;                // best branch length
+    uint32_t best;
+
+    pkc_tree_slot_t *table;         // open addressing, power-of-two size
+    uint32_t table_mask;
+} pkc_block_tree_t;
+
+/* ---------------- config and lifecycle ---------------- */
+
+static inline void pkc_tree_config_default(pkc_tree_config_t *cfg)
+{
+    if (!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) cfg->tier_weight[t] = 1;
+}
+
+static inline void pkc_tree_destroy(pkc_block_tree_t *t)
+{
+    if (!t) return;
+    free(t->nodes);
+    free(t->active);
+    free(t->path);
+    free(t->table);
+    memset(t, 0, sizeof(*t));
+}
+
+/* First word of a hash; the keys are hashes, so it spreads well enough. */
+PKC_BLOCK_TREE_INLINE uint64_t pkc_tree_tag(const uint256 *hash)
+{
+    uint64_t tag;
+    memcpy(&tag, hash, sizeof(tag));
+    return tag;
+}
+
+PKC_BLOCK_TREE_INLINE uint32_t pkc_tree_bucket(const pkc_block_tree_t *t, uint64_t tag)
+{
+    return (uint32_t)((tag * 0x9E3779B97F4A7C15ULL) >> 32) & t->table_mask;
+}
+
+static inline OpStatus_t pkc_tree_rehash(pkc_block_tree_t *t, uint32_t size)
+{
+    pkc_tree_slot_t *table = (pkc_tree_slot_t *)malloc((size_t)size * sizeof(*table));
+    if (!table) return OP_INVALID_STATE;
+    for (uint32_t i = 0; i < size; ++i) table[i].node = PKC_TREE_NONE;
+    free(t->table);
+    t->table = table;
+    t->table_mask = size - 1;
+    for (uint32_t n = 0; n < t->count; ++n) {
+        const uint64_t tag = pkc_tree_tag(&t->nodes[n].hash);
+        uint32_t i = pkc_tree_bucket(t, tag);
+        while (t->table[i].node != PKC_TREE_NONE) i = (i + 1) & t->table_mask;
+        t->table[i] = (pkc_tree_slot_t){ tag, n };
+    }
+    return OP_SUCCESS;
+}
+
+/* Node storage for at least `need` nodes; the table stays at most half full. */
+static inline OpStatus_t pkc_tree_reserve(pkc_block_tree_t *t, uint32_t need)
+{
+    if (need > t->capacity) {
+        uint32_t cap = t->capacity ? t->capacity : PKC_TREE_INITIAL_NODES;
+        while (cap < need) cap *= 2;
+        pkc_tree_node_t *nodes = (pkc_tree_node_t *)realloc(t->nodes, (size_t)cap * sizeof(*nodes));
+        if (!nodes) return OP_INVALID_STATE;
+        t->nodes = nodes;
+        uint32_t *active = (uint32_t *)realloc(t->active, (size_t)cap * sizeof(*active));
+        if (!active) return OP_INVALID_STATE;
+        t->active = active;
+        uint32_t *path = (uint32_t *)realloc(t->path, (size_t)cap * sizeof(*path));
+        if (!path) return OP_INVALID_STATE;
+        t->path = path;
+        t->capacity = cap;
+    }
+    if ((uint64_t)need * 2 > (uint64_t)t->table_mask + 1) {
+        uint32_t size = t->table ? (t->table_mask + 1) * 2 : PKC_TREE_INITIAL_NODES * 2;
+        while ((uint64_t)need * 2 > size) size *= 2;
+        return pkc_tree_rehash(t, size);
+    }
+    return OP_SUCCESS;
+}
+
+static inline OpStatus_t pkc_tree_init(pkc_block_tree_t *t, const pkc_tree_config_t *cfg)
+{
+    if (!t) return OP_NULL_PTR;
+    memset(t, 0, sizeof(*t));
+    if (cfg) t->cfg = *cfg;
+    else pkc_tree_config_default(&t->cfg);
+    t->best = PKC_TREE_NONE;
+    OpStatus_t st = pkc_tree_reserve(t, 1);
+    if (st != OP_SUCCESS) pkc_tree_destroy(t);
+    return st;
+}
+
+/* ---------------- lookups ---------------- */
+
+/* Node holding the block whose block_link_hash is `hash`, PKC_TREE_NONE if unknown. */
+static inline uint32_t pkc_tree_find(const pkc_block_tree_t *t, const uint256 *hash)
+{
+    if (!t || !hash || t->count == 0) return PKC_TREE_NONE;
+    const uint64_t tag = pkc_tree_tag(hash);
+    for (uint32_t i = pkc_tree_bucket(t, tag);; i = (i + 1) & t->table_mask) {
+        const pkc_tree_slot_t *s = &t->table[i];
+        if (s->node == PKC_TREE_NONE) return PKC_TREE_NONE;
+        if (s->tag == tag && memcmp(&t->nodes[s->node].hash, hash, sizeof(uint256)) == 0) return s->node;
+    }
+}
+
+PKC_BLOCK_TREE_INLINE const pkc_tree_node_t *pkc_tree_node(const pkc_block_tree_t *t, uint32_t id)
+{
+    return id < t->count ? &t->nodes[id] : NULL;
+}
+
+PKC_BLOCK_TREE_INLINE const pkc_tree_node_t *pkc_tree_best(const pkc_block_tree_t *t)
+{
+    return pkc_tree_node(t, t->best);
+}
+
+/* Block at `height` on the best branch, NULL past its tip. */
+PKC_BLOCK_TREE_INLINE const block *pkc_tree_active_block(const pkc_block_tree_t *t, uint64_t height)
+{
+    return height < t->height ? &t->nodes[t->active[height]].blk : NULL;
+}
+
+/* ---------------- work ---------------- */
+
+PKC_BLOCK_TREE_INLINE int pkc_tree_work_cmp(const pkc_tree_work_t *a, const pkc_tree_work_t *b)
+{
+    for (int l = 0; l < 4; ++l) {
+        if (a->limb[l] != b->limb[l]) return a->limb[l] < b->limb[l] ? -1 : 1;
+    }
+    return 0;
+}
+
+/* a += b, saturating at 2^256 - 1. */
+PKC_BLOCK_TREE_INLINE void pkc_tree_work_add(pkc_tree_work_t *a, const pkc_tree_work_t *b)
+{
+    unsigned __int128 carry = 0;
+    for (int l = 3; l >= 0; --l) {
+        carry += (unsigned __int128)a->limb[l] + b->limb[l];
+        a->limb[l] = (uint64_t)carry;
+        carry >>= 64;
+    }
+    if (carry) memset(a->limb, 0xFF, sizeof(a->limb));
+}
+
+/* a * w, saturating. */
+PKC_BLOCK_TREE_INLINE pkc_tree_work_t pkc_tree_work_scale(const pkc_tree_work_t *a, uint32_t w)
+{
+    pkc_tree_work_t out;
+    unsigned __int128 carry = 0;
+    for (int l = 3; l >= 0; --l) {
+        carry += (unsigned __int128)a->limb[l] * w;
+        out.limb[l] = (uint64_t)carry;
+        carry >>= 64;
+    }
+    if (carry) memset(out.limb, 0xFF, sizeof(out.limb));
+    return out;
+}
+
+/* floor(2^k / d) for k < 256 and d > 0. */
+static inline pkc_tree_work_t pkc_tree_work_pow2_div(uint32_t k, uint32_t d)
+{
+    pkc_tree_work_t out = {{0, 0, 0, 0}};
+    unsigned __int128 rem = 0;
+    for (int l = 0; l < 4; ++l) {
+        const uint32_t lo = 64 * (uint32_t)(3 - l);
+        rem = (rem << 64) | (k >= lo && k < lo + 64 ? (uint64_t)1 << (k - lo) : 0);
+        out.limb[l] = (uint64_t)(rem / d);
+        rem %= d;
+    }
+    return out;
+}
+
+/*
+ * Work one block adds to its tier: 2^complexity, or 2^254 / target in
+ * target mode (the leading-zero complexity with the same expected work),
+ * at least 1.
+ */
+static inline pkc_tree_work_t pkc_tree_block_work(const block *b)
+{
+    const tier_pow_challenge_t *c = &b->tierPoWResult.challenge;
+    pkc_tree_work_t w = {{0, 0, 0, 0}};
+    if (block_get_pow_version(b) == TIER_POW_VERSION_TARGET) {
+        const uint32_t bits = tier_pow_challenge_get_target_bits(c);
+        // target = m * 2^shift, the dropped mantissa bytes of e < 3 already shifted out
+        const int32_t shift = 8 * ((int32_t)(bits >> 24) - 3);
+        const uint32_t m = shift >= 0 ? bits & TIER_POW_TARGET_MANTISSA_MAX
+                                      : (bits & TIER_POW_TARGET_MANTISSA_MAX) >> -shift;
+        if (tier_pow_target_bits_valid(bits) && m != 0) {
+            w = pkc_tree_work_pow2_div(254u - (uint32_t)(shift > 0 ? shift : 0), m);
+            if (!(w.limb[0] | w.limb[1] | w.limb[2] | w.limb[3])) w.limb[3] = 1;
+            return w;
+        }
+    }
+    const uint8_t complexity = tier_pow_challenge_get_complexity(c);
+    w.limb[3 - complexity / 64] = (uint64_t)1 << (complexity % 64);
+    return w;
+}
+
+/* Complexity a block solved at, the nearest whole one in target mode. */
+static inline uint8_t pkc_tree_block_complexity(const block *b)
+{
+    const tier_pow_challenge_t *c = &b->tierPoWResult.challenge;
+    if (block_get_pow_version(b) != TIER_POW_VERSION_TARGET) return tier_pow_challenge_get_complexity(c);
+    const uint32_t bits = tier_pow_challenge_get_target_bits(c);
+    if (!tier_pow_target_bits_valid(bits)) return tier_pow_challenge_get_complexity(c);
+    const double x = tier_pow_target_complexity(bits);
+    return x < 1.0 ? 1 : (x > 255.0 ? 255 : (uint8_t)lround(x));
+}
+
+/* ---------------- best branch ---------------- */
+
+/* Makes node `id` the next block of the best branch. Its parent is the current tip. */
+static inline void pkc_tree_connect(pkc_block_tree_t *t, uint32_t id)
+{
+    pkc_tree_node_t *n = &t->nodes[id];
+    const uint32_t h = t->height;
+    n->active = true;
+    t->active[h] = id;
+    t->height = h + 1;
+    t->best = id;
+
+    if (t->chain) {
+        PKCertChain *chain = t->chain;
+        block_copy(&chain->blocks[h], &n->blk);
+        chain->index = h + 1;
+        for (int s = 0; s < TIER_POW_DIFFICULTY_TIERS; ++s) {
+            tier_pow_chain_set_last_index(chain, &tier_pow_chain_fields[s], n->last_index[s]);
+            tier_pow_chain_set_complexity(chain, &tier_pow_chain_fields[s], n->complexity[s]);
+        }
+    }
+    if (t->cfg.columns) pkc_columns_append(t->cfg.columns, &n->blk, 1);
+    if (t->cfg.tiers) pkc_tier_index_append(t->cfg.tiers, &n->blk, 1);
+}
+
+/* Drops the best branch above height `keep - 1`. */
+static inline void pkc_tree_disconnect(pkc_block_tree_t *t, uint32_t keep)
+{
+    for (uint32_t h = keep; h < t->height; ++h) t->nodes[t->active[h]].active = false;
+    t->height = keep;
+    if (t->cfg.columns) pkc_columns_truncate(t->cfg.columns, keep);
+    if (t->cfg.tiers) pkc_tier_index_truncate(t->cfg.tiers, keep);
+}
+
+/* ---------------- insertion ---------------- */
+
+static inline uint32_t pkc_tree_push(pkc_block_tree_t *t, const block *blk, const uint256 *hash, uint32_t parent)
+{
+    const uint32_t id = t->count++;
+    pkc_tree_node_t *n = &t->nodes[id];
+    block_copy(&n->blk, blk);
+    n->hash = *hash;
+    n->parent = parent;
+    n->active = false;
+    if (parent == PKC_TREE_NONE) {
+        memset(n->last_index, 0, sizeof(n->last_index));        // genesis stands in for every tier
+        for (int s = 0; s < TIER_POW_DIFFICULTY_TIERS; ++s) n->last_node[s] = id;
+        memset(n->complexity, 0, sizeof(n->complexity));       // pkc_tree_attach: the chain's
+        memset(n->work, 0, sizeof(n->work));
+        memset(&n->score, 0, sizeof(n->score));
+    } else {
+        const pkc_tree_node_t *p = &t->nodes[parent];
+        memcpy(n->last_index, p->last_index, sizeof(n->last_index));
+        memcpy(n->last_node, p->last_node, sizeof(n->last_node));
+        memcpy(n->complexity, p->complexity, sizeof(n->complexity));
+        memcpy(n->work, p->work, sizeof(n->work));
+        n->score = p->score;
+    }
+    const int slot = tier_pow_difficulty_slot(blk->tier);
+    if (slot >= 0) {
+        const pkc_tree_work_t w = pkc_tree_block_work(blk);
+        const pkc_tree_work_t weighted = pkc_tree_work_scale(&w, t->cfg.tier_weight[slot]);
+        n->last_index[slot] = (uint32_t)blk->height;
+        n->last_node[slot] = id;
+        n->complexity[slot] = pkc_tree_block_complexity(blk);
+        pkc_tree_work_add(&n->work[slot], &w);
+        pkc_tree_work_add(&n->score, &weighted);
+    }
+
+    const uint64_t tag = pkc_tree_tag(hash);
+    uint32_t i = pkc_tree_bucket(t, tag);
+    while (t->table[i].node != PKC_TREE_NONE) i = (i + 1) & t->table_mask;
+    t->table[i] = (pkc_tree_slot_t){ tag, id };
+    return id;
+}
+
+/*
+ * Adopts `chain` as the best branch: blocks [0, chain->index) become the
+ * root and its descendants, linked by position, and later best-branch
+ * changes are written back to it. The root and the tip take the chain's
+ * complexity fields; the nodes between carry what their tiers solved at.
+ * The tree must be empty and no chain writer may be running on `chain`
+ * (OP_INVALID_STATE); the same block twice is OP_INVALID_INPUT.
+ */
+static inline OpStatus_t pkc_tree_attach(pkc_block_tree_t *t, PKCertChain *chain)
+{
+    if (!t || !chain) return OP_NULL_PTR;
+    if (t->count != 0 || chain->index == 0) return OP_INVALID_STATE;
+    // a running writer owns the chain and promises its readers no rewrites
+    bool owned = false;
+    pthread_mutex_lock(&pkc_chain_writers_lock);
+    for (const pkc_chain_writer_t *w = pkc_chain_writers_live; w && !owned; w = w->live_next) owned = w->chain == chain;
+    pthread_mutex_unlock(&pkc_chain_writers_lock);
+    if (owned) return OP_INVALID_STATE;
+    OpStatus_t st = pkc_tree_reserve(t, chain->index);
+    if (st != OP_SUCCESS) return st;
+    for (uint32_t i = 0; i < chain->index; ++i) {
+        uint256 hash;
+        if ((st = block_link_hash(&chain->blocks[i], &hash)) != OP_SUCCESS) return st;
+        if (pkc_tree_find(t, &hash) != PKC_TREE_NONE) return OP_INVALID_INPUT;
+        const uint32_t id = pkc_tree_push(t, &chain->blocks[i], &hash, i ? t->active[i - 1] : PKC_TREE_NONE);
+        t->nodes[id].active = true;
+        t->active[i] = id;
+        if (i == 0 || i == chain->index - 1) {
+            for (int s = 0; s < TIER_POW_DIFFICULTY_TIERS; ++s)
+                t->nodes[id].complexity[s] = tier_pow_chain_complexity(chain, &tier_pow_chain_fields[s]);
+        }
+    }
+    t->height = chain->index;
+    t->best = t->active[chain->index - 1];
+    t->chain = chain;
+    if (t->cfg.columns && (st = pkc_columns_sync(t->cfg.columns, chain)) != OP_SUCCESS) return st;
+    if (t->cfg.tiers && (st = pkc_tier_index_sync(t->cfg.tiers, chain)) != OP_SUCCESS) return st;
+    return OP_SUCCESS;
+}
+
+/*
+ * Adds a block whose parent (prevHash, the parent's block_link_hash)
+ * is already in the tree, or the root of an empty, unattached tree
+ * (height 0). Moves the best tip when its branch now scores highest,
+ * reorganizing if it was a side branch.
+ * OP_INVALID_STATE for an unknown parent, OP_INVALID_INPUT for a height
+ * that does not follow the parent's, an unknown tier or, with
+ * require_pow, a challenge its branch did not issue or a bad solution.
+ */
+static inline OpStatus_t pkc_tree_add(pkc_block_tree_t *t, const block *blk, pkc_tree_result_t *res)
+{
+    if (!t || !blk) return OP_NULL_PTR;
+    pkc_tree_result_t local;
+    if (!res) res = &local;
+    memset(res, 0, sizeof(*res));
+
+    uint256 hash;
+    OpStatus_t st = block_link_hash(blk, &hash);
+    if (st != OP_SUCCESS) return st;
+    const uint32_t known = pkc_tree_find(t, &hash);
+    if (known != PKC_TREE_NONE) {
+        res->outcome = PKC_TREE_DUPLICATE;
+        res->node = known;
+        return OP_SUCCESS;
+    }
+
+    uint32_t parent = PKC_TREE_NONE;
+    if (t->count == 0) {
+        if (blk->height != 0 || t->chain) return OP_INVALID_STATE;
+    } else {
+        parent = pkc_tree_find(t, &blk->prevHash);
+        if (parent == PKC_TREE_NONE) return OP_INVALID_STATE;
+        if (blk->height != t->nodes[parent].blk.height + 1) return OP_INVALID_INPUT;
+        if (!tier_pow_chain_field(blk->tier)) return OP_INVALID_INPUT;
+        if (t->chain && blk->height >= PKC_CHAIN_CAPACITY(t->chain)) return OP_BUFFER_TOO_SMALL;
+        const pkc_tree_node_t *p = &t->nodes[parent];
+        if (t->cfg.require_pow &&
+            (!pkc_block_pow_follows(blk, &t->nodes[p->last_node[tier_pow_difficulty_slot(blk->tier)]].blk) ||
+             !pkc_block_pow_valid(blk)))
+            return OP_INVALID_INPUT;
+    }
+
+    if ((st = pkc_tree_reserve(t, t->count + 1)) != OP_SUCCESS) return st;
+    const uint32_t id = pkc_tree_push(t, blk, &hash, parent);
+    res->node = id;
+
+    // weights are non-negative, so a child never scores below its parent
+    if (parent == PKC_TREE_NONE || parent == t->best) {
+        pkc_tree_connect(t, id);
+        res->outcome = PKC_TREE_EXTENDED;
+        res->connected = 1;
+        pkc_metrics_count(PKC_CTR_CHAIN_APPENDS, 1);
+        return OP_SUCCESS;
+    }
+    if (pkc_tree_work_cmp(&t->nodes[id].score, &t->nodes[t->best].score) <= 0) {
+        res->outcome = PKC_TREE_SIDE;
+        return OP_SUCCESS;
+    }
+
+    // Overtaken: collect the new branch back to the fork point, newest first.
+    uint32_t depth = 0;
+    uint32_t fork = id;
+    while (!t->nodes[fork].active) {
+        t->path[depth++] = fork;
+        fork = t->nodes[fork].parent;
+    }
+    const uint32_t keep = (uint32_t)t->nodes[fork].blk.height + 1;
+    res->outcome = PKC_TREE_REORG;
+    res->fork_height = keep - 1;
+    res->disconnected = t->height - keep;
+    res->connected = depth;
+
+    pkc_tree_disconnect(t, keep);
+    while (depth > 0) pkc_tree_connect(t, t->path[--depth]);
+
+    pkc_metrics_count(PKC_CTR_CHAIN_REORGS, 1);
+    pkc_metrics_count(PKC_CTR_CHAIN_REORG_BLOCKS, res->disconnected);
+    return OP_SUCCESS;
+}
+
+#endif // PKC_BLOCK_TREE_H
@@ -0,0 +1,240 @@
+#ifndef BLOCK_VIEW_H
+#define BLOCK_VIEW_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "blockchain/block.h"
+#include "blockchain/block_ops.h"
+#include "Proofs/TierPoW/tierPoWResult_ops.h"
+#include "core/enums/OpStatus.h"
+
+#ifndef BLOCK_VIEW_INLINE
+#define BLOCK_VIEW_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Zero-copy view over a canonical serialized block.
+ *
+ *   [0, BLOCK_SIZE)  block_serialize: cert (pubSignKey | pubEncKey | id) |
+ *                    CurrentCertHash | prevHash | SignedByVerifier |
+ *                    height | timestamp | tier | reserved
+ *   then             MiniPowResult | TierPowResult (BLOCK_SERIALIZED_SIZE)
+ *
+ * A view only holds the pointer; each accessor decodes its own field from
+ * big-endian on demand, so intake, mmap'd files and validation can read a
+ * height or a key without a block_deserialize of the whole record. The
+ * *_raw accessors return the wire bytes themselves for comparisons and
+ * hashing. Views over BLOCK_SIZE bytes (snapshot chunks, bulk buffers)
+ * work for everything but the PoW result sections.
+ *
+ * The bytes are not copied: they must outlive the view and not change
+ * underneath it.
+ */
+
+/* Field offsets, in block_serialize order. */
+#ifndef BLOCK_VIEW_PUB_SIGN_KEY_OFFSET
+#define BLOCK_VIEW_PUB_SIGN_KEY_OFFSET 0
+#define BLOCK_VIEW_PUB_ENC_KEY_OFFSET (BLOCK_VIEW_PUB_SIGN_KEY_OFFSET + UINT256_SIZE)
+#define BLOCK_VIEW_CERT_ID_OFFSET (BLOCK_VIEW_PUB_ENC_KEY_OFFSET + UINT256_SIZE)
+#define BLOCK_VIEW_CERT_HASH_OFFSET CERT_SIZE
+#define BLOCK_VIEW_PREV_HASH_OFFSET (BLOCK_VIEW_CERT_HASH_OFFSET + UINT256_SIZE)
+#define BLOCK_VIEW_SIGNATURE_OFFSET (BLOCK_VIEW_PREV_HASH_OFFSET + UINT256_SIZE)
+#define BLOCK_VIEW_HEIGHT_OFFSET (BLOCK_VIEW_SIGNATURE_OFFSET + 2 * UINT256_SIZE)
+#define BLOCK_VIEW_TIMESTAMP_OFFSET (BLOCK_VIEW_HEIGHT_OFFSET + UINT64_SIZE)
+#define BLOCK_VIEW_TIER_OFFSET (BLOCK_VIEW_TIMESTAMP_OFFSET + UINT64_SIZE)
+#define BLOCK_VIEW_RESERVED_OFFSET (BLOCK_VIEW_TIER_OFFSET + UINT8_SIZE)
+#endif
+
+#define BLOCK_VIEW_CERT_ID_SIZE (CERT_SIZE - BLOCK_VIEW_CERT_ID_OFFSET)
+#define BLOCK_VIEW_MINI_POW_OFFSET BLOCK_SIZE
+#define BLOCK_VIEW_TIER_POW_OFFSET (BLOCK_SIZE + MINI_POW_RESULT_SERIALIZED_SIZE)
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t len;                     // BLOCK_SIZE or BLOCK_SERIALIZED_SIZE (or more)
+} block_view;
+
+BLOCK_VIEW_INLINE OpStatus_t block_view_init(block_view *v, const uint8_t *bytes, size_t len)
+{
+    if (!v || !bytes) return OP_NULL_PTR;
+    if (len < BLOCK_SIZE) return OP_BUFFER_TOO_SMALL;
+    v->bytes = bytes;
+    v->len = len;
+    return OP_SUCCESS;
+}
+
+BLOCK_VIEW_INLINE bool block_view_has_pow(const block_view *v)
+{
+    return v->len >= BLOCK_SERIALIZED_SIZE;
+}
+
+/* ---------------- scalar fields ---------------- */
+
+BLOCK_VIEW_INLINE uint64_t block_view_u64(const uint8_t *p)
+{
+    uint64_t x = 0;
+    deserialize_u64_be(p, &x, UINT64_SIZE);
+    return x;
+}
+
+BLOCK_VIEW_INLINE uint64_t block_view_height(const block_view *v)
+{
+    return block_view_u64(v->bytes + BLOCK_VIEW_HEIGHT_OFFSET);
+}
+
+BLOCK_VIEW_INLINE uint64_t block_view_timestamp(const block_view *v)
+{
+    return block_view_u64(v->bytes + BLOCK_VIEW_TIMESTAMP_OFFSET);
+}
+
+BLOCK_VIEW_INLINE Tier_t block_view_tier(const block_view *v)
+{
+    return (Tier_t)v->bytes[BLOCK_VIEW_TIER_OFFSET];
+}
+
+/* TierPoW version (reserved[0]); 0 when the serialized head carries no reserved bytes. */
+BLOCK_VIEW_INLINE uint8_t block_view_pow_version(const block_view *v)
+{
+    return BLOCK_VIEW_RESERVED_OFFSET < BLOCK_SIZE ? v->bytes[BLOCK_VIEW_RESERVED_OFFSET] : 0;
+}
+
+/* ---------------- raw wire bytes ---------------- */
+
+BLOCK_VIEW_INLINE const uint8_t *block_view_cert_raw(const block_view *v)
+{
+    return v->bytes;
+}
+
+BLOCK_VIEW_INLINE const uint8_t *block_view_pub_sign_key_raw(const block_view *v)
+{
+    return v->bytes + BLOCK_VIEW_PUB_SIGN_KEY_OFFSET;
+}
+
+BLOCK_VIEW_INLINE const uint8_t *block_view_pub_enc_key_raw(const block_view *v)
+{
+    return v->bytes + BLOCK_VIEW_PUB_ENC_KEY_OFFSET;
+}
+
+BLOCK_VIEW_INLINE const uint8_t *block_view_cert_id_raw(const block_view *v)
+{
+    return v->bytes + BLOCK_VIEW_CERT_ID_OFFSET;
+}
+
+BLOCK_VIEW_INLINE const uint8_t *block_view_cert_hash_raw(const block_view *v)
+{
+    return v->bytes + BLOCK_VIEW_CERT_HASH_OFFSET;
+}
+
+BLOCK_VIEW_INLINE const uint8_t *block_view_prev_hash_raw(const block_view *v)
+{
+    return v->bytes + BLOCK_VIEW_PREV_HASH_OFFSET;
+}
+
+BLOCK_VIEW_INLINE const uint8_t *block_view_signature_raw(const block_view *v)
+{
+    return v->bytes + BLOCK_VIEW_SIGNATURE_OFFSET;
+}
+
+/* PoW result sections; NULL on a BLOCK_SIZE view. */
+BLOCK_VIEW_INLINE const uint8_t *block_view_mini_pow_raw(const block_view *v)
+{
+    return block_view_has_pow(v) ? v->bytes + BLOCK_VIEW_MINI_POW_OFFSET : NULL;
+}
+
+BLOCK_VIEW_INLINE const uint8_t *block_view_tier_pow_raw(const block_view *v)
+{
+    return block_view_has_pow(v) ? v->bytes + BLOCK_VIEW_TIER_POW_OFFSET : NULL;
+}
+
+/* ---------------- decoded fields ---------------- */
+
+BLOCK_VIEW_INLINE OpStatus_t block_view_pub_sign_key(const block_view *v, uint256 *out)
+{
+    if (!v || !out) return OP_NULL_PTR;
+    return uint256_deserialize_be(block_view_pub_sign_key_raw(v), UINT256_SIZE, out);
+}
+
+BLOCK_VIEW_INLINE OpStatus_t block_view_pub_enc_key(const block_view *v, uint256 *out)
+{
+    if (!v || !out) return OP_NULL_PTR;
+    return uint256_deserialize_be(block_view_pub_enc_key_raw(v), UINT256_SIZE, out);
+}
+
+BLOCK_VIEW_INLINE OpStatus_t block_view_cert_hash(const block_view *v, uint256 *out)
+{
+    if (!v || !out) return OP_NULL_PTR;
+    return uint256_deserialize_be(block_view_cert_hash_raw(v), UINT256_SIZE, out);
+}
+
+BLOCK_VIEW_INLINE OpStatus_t block_view_prev_hash(const block_view *v, uint256 *out)
+{
+    if (!v || !out) return OP_NULL_PTR;
+    return uint256_deserialize_be(block_view_prev_hash_raw(v), UINT256_SIZE, out);
+}
+
+/* Compares a field against a native uint256 without decoding the field. */
+BLOCK_VIEW_INLINE bool block_view_key_equals(const uint8_t *raw, const uint256 *key)
+{
+    uint8_t be[UINT256_SIZE];
+    return uint256_serialize_be(key, be, UINT256_SIZE) == OP_SUCCESS && memcmp(raw, be, UINT256_SIZE) == 0;
+}
+
+/* ---------------- hashing ---------------- */
+
+/* hash256 of the canonical block head, as hashed after block_serialize. */
+BLOCK_VIEW_INLINE OpStatus_t block_view_hash(const block_view *v, uint256 *out)
+{
+    if (!v || !out) return OP_NULL_PTR;
+    hash256_buffer(v->bytes, BLOCK_SIZE, out);
+    return OP_SUCCESS;
+}
+
+/* hash256 of the whole view, PoW sections included when present. */
+BLOCK_VIEW_INLINE OpStatus_t block_view_hash_full(const block_view *v, uint256 *out)
+{
+    if (!v || !out) return OP_NULL_PTR;
+    hash256_buffer(v->bytes, block_view_has_pow(v) ? BLOCK_SERIALIZED_SIZE : BLOCK_SIZE, out);
+    return OP_SUCCESS;
+}
+
+/*
+ * Hash a child commits to in prevHash: hash256 of the block's full
+ * serialized record with reserved[] appended, since BLOCK_SIZE may end
+ * before it (see block_view_pow_version). The block tree keys its nodes
+ * by it and the columns check links against it.
+ */
+static inline OpStatus_t block_link_hash(const block *blk, uint256 *out)
+{
+    if (!blk || !out) return OP_NULL_PTR;
+    uint8_t buf[BLOCK_SERIALIZED_SIZE + sizeof(blk->reserved)];
+    memset(buf, 0, sizeof(buf));
+    OpStatus_t st = block_serialize(blk, buf, BLOCK_SERIALIZED_SIZE);
+    if (st != OP_SUCCESS) return st;
+    memcpy(buf + BLOCK_SERIALIZED_SIZE, blk->reserved, sizeof(blk->reserved));
+    hash256_buffer(buf, sizeof(buf), out);
+    return OP_SUCCESS;
+}
+
+/* Same bytes as hash_certificate() over the deserialized cert. */
+BLOCK_VIEW_INLINE OpStatus_t block_view_cert_digest(const block_view *v, uint256 *out)
+{
+    if (!v || !out) return OP_NULL_PTR;
+    hash256_buffer(block_view_cert_raw(v), CERT_SIZE, out);
+    return OP_SUCCESS;
+}
+
+/* ---------------- materialize ---------------- */
+
+/* Full decode, for the consumers that do need a struct; PoW results only when the view has them. */
+BLOCK_VIEW_INLINE OpStatus_t block_view_to_block(const block_view *v, block *out)
+{
+    if (!v || !out) return OP_NULL_PTR;
+    return block_deserialize(v->bytes, block_view_has_pow(v) ? BLOCK_SERIALIZED_SIZE : BLOCK_SIZE, out);
+}
+
+#endif // BLOCK_VIEW_H
@@ -38,7 +38,7 @@
 //     uint64_t height; //8
 //     uint64_t timestamp;   // 8 monotonic time, canonical 64-bit
 //     Tier_t tier; // 1 byte
-//     uint8_t reserved[3]; // padding
+//     uint8_t reserved[3]; // [0] TierPoW version, [1] certificate op, rest padding
 //     MiniPowResult miniPowResult;
 //     TierPowResult tierPoWResult;
 // } block;
@@ -127,6 +127,34 @@ BLOCK_INLINE void block_set_tier(block *blk, Tier_t tier)
     blk->tier = tier;
 }
 
+/* TierPoW version (TIER_POW_VERSION_*), kept in reserved[0]; 0 on old blocks. */
+BLOCK_INLINE uint8_t block_get_pow_version(const block *blk)
+{
+    return blk->reserved[0];
+}
+
+BLOCK_INLINE void block_set_pow_version(block *blk, uint8_t version)
+{
+    blk->reserved[0] = version;
+}
+
+#define BLOCK_CERT_OP_ISSUE 0       // issues (or renews) the block's certificate
+#define BLOCK_CERT_OP_REVOKE 1      // revokes the certificate the block names
+
+/*
+ * Certificate operation (BLOCK_CERT_OP_*), kept in reserved[1]; 0 on old
+ * blocks. Set it before mining: the TierPoW solution is bound to reserved.
+ */
+BLOCK_INLINE uint8_t block_get_cert_op(const block *blk)
+{
+    return blk->reserved[1];
+}
+
+BLOCK_INLINE void block_set_cert_op(block *blk, uint8_t op)
+{
+    blk->reserved[1] = op;
+}
+
 BLOCK_INLINE void block_copy(block *dst, const block *src)
 {
     cert_copy(&dst->cert, &src->cert);
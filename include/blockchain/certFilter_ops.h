@@ -0,0 +1,412 @@
+#ifndef PKC_CERT_FILTER_H
+#define PKC_CERT_FILTER_H
+
+
+
+#include <math.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "blockchain/block.h"
+#include "blockhain/PKCertChain.h"
+#include "blockchain/pkcertchain_ops.h"
+#include "core/enums/OpStatus.h"
+
+#ifndef PKC_CERT_FILTER_INLINE
+#define PKC_CERT_FILTER_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Certificate membership filter.
+ *
+ * A split-block Bloom filter over the pubSignKey, pubEncKey and id of
+ * every certificate on the chain. Each item hashes to one 32-byte block
+ * (half a cache line) and sets one bit in each of its eight 32-bit words,
+ * so a check is one hash and one memory access. The three kinds hash
+ * with different seeds.
+ *
+ * The filter is sized up front for `capacity` certificates and a target
+ * false-positive rate; pkc_cert_filter_size picks the block count from
+ * the expected fill. It only grows: blocks are added as they are appended
+ * (pkc_cert_filter_append / sync), and adds may run while other threads
+ * check. A certificate with a zero pubSignKey is skipped.
+ *
+ * With AVX2 a check is one 32-byte load and a vptest against the eight
+ * bits. Adds set bits with atomic ORs, so none are lost; a check racing
+ * the add of the same item may miss it, as if it had run just before.
+ * Thread-sanitized builds take the scalar path, which loads each word
+ * atomically.
+ *
+ * pkc_cert_filter_save writes it next to the chain state file, tagged
+ * with how many blocks it covers and the CurrentCertHash of the last one,
+ * so a node can load it and sync only the blocks appended since.
+ *
+ *   magic "PKCF" | version | fpr (1e-9 units, u64) | capacity | blocks |
+ *   count | items (u64) | tip hash | words (u32 each) | hash256(all above)
+ */
+
+#define PKC_CERT_FILTER_FILE "certFilter"
+#define PKC_CERT_FILTER_MAGIC "PKCF"
+#define PKC_CERT_FILTER_MAGIC_LEN 4
+#define PKC_CERT_FILTER_VERSION 1
+#define PKC_CERT_FILTER_HEADER_SIZE (PKC_CERT_FILTER_MAGIC_LEN + 1 + 8 + 4 + 4 + 4 + 8 + UINT256_SIZE)
+
+#ifndef PKC_CERT_FILTER_FPR
+#define PKC_CERT_FILTER_FPR 0.01
+#endif
+
+#define PKC_CERT_FILTER_WORDS 8         // 32-bit words per block
+#define PKC_CERT_FILTER_ITEMS 3         // items per certificate
+
+typedef enum {
+    PKC_CERT_FILTER_SIGN_KEY = 0,
+    PKC_CERT_FILTER_ENC_KEY,
+    PKC_CERT_FILTER_ID
+} pkc_cert_filter_kind_t;
+
+typedef struct {
+    uint32_t *words;                // blocks * PKC_CERT_FILTER_WORDS, 32-byte aligned
+    uint32_t blocks;
+    uint32_t capacity;              // certificates it was sized for
+    double fpr;                     // target rate at capacity
+    uint64_t items;                 // hashes added; writer only
+    const PKCertChain *chain;       // set by sync / build / load
+    uint32_t count;                 // chain blocks applied
+} pkc_cert_filter_t;
+
+/* ---------------- sizing ---------------- */
+
+/* Expected false-positive rate of `blocks` blocks holding `items` items. */
+static inline double pkc_cert_filter_expected_fpr(uint64_t items, uint32_t blocks)
+{
+    if (!blocks) return 1.0;
+    // items per block are Poisson(lambda); a block holding j misses a word
+    // bit with probability (31/32)^j, and all eight words must match
+    const double lambda = (double)items / blocks;
+    const double stop = lambda + 12.0 * sqrt(lambda) + 32.0;
+    double p = exp(-lambda), fpr = 0.0;
+    for (uint32_t j = 0; j <= (uint32_t)stop; ++j) {
+        if (j) p *= lambda / j;
+        fpr += p * pow(1.0 - pow(31.0 / 32.0, (double)j), PKC_CERT_FILTER_WORDS);
+    }
+    return fpr;
+}
+
+/* Fewest blocks keeping `capacity` certificates at or under `fpr`. */
+static inline uint32_t pkc_cert_filter_size(uint32_t capacity, double fpr)
+{
+    const uint64_t items = (uint64_t)capacity * PKC_CERT_FILTER_ITEMS;
+    uint64_t lo = 1, hi = items ? items : 1;     // one item per block is always enough below 1e-9
+    while (pkc_cert_filter_expected_fpr(items, (uint32_t)hi) > fpr && hi < UINT32_MAX / 2) hi *= 2;
+    while (lo < hi) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        if (pkc_cert_filter_expected_fpr(items, (uint32_t)mid) <= fpr) hi = mid;
+        else lo = mid + 1;
+    }
+    return (uint32_t)hi;
+}
+
+/* ---------------- lifecycle ---------------- */
+
+static inline void pkc_cert_filter_destroy(pkc_cert_filter_t *f)
+{
+    if (!f) return;
+    free(f->words);
+    memset(f, 0, sizeof(*f));
+}
+
+PKC_CERT_FILTER_INLINE OpStatus_t pkc_cert_filter_alloc(pkc_cert_filter_t *f, uint32_t blocks)
+{
+    const size_t bytes = (size_t)blocks * PKC_CERT_FILTER_WORDS * sizeof(uint32_t);
+    f->words = (uint32_t *)aligned_alloc(32, bytes);
+    if (!f->words) return OP_INVALID_STATE;
+    memset(f->words, 0, bytes);
+    f->blocks = blocks;
+    return OP_SUCCESS;
+}
+
+/* `fpr` 0 picks PKC_CERT_FILTER_FPR. */
+static inline OpStatus_t pkc_cert_filter_init(pkc_cert_filter_t *f, uint32_t capacity, double fpr)
+{
+    if (!f) return OP_NULL_PTR;
+    if (fpr == 0.0) fpr = PKC_CERT_FILTER_FPR;
+    if (capacity == 0 || capacity > (1u << 28) || !(fpr >= 1e-9 && fpr < 0.5)) return OP_INVALID_INPUT;
+    memset(f, 0, sizeof(*f));
+    OpStatus_t st = pkc_cert_filter_alloc(f, pkc_cert_filter_size(capacity, fpr));
+    if (st != OP_SUCCESS) return st;
+    f->capacity = capacity;
+    f->fpr = fpr;
+    return OP_SUCCESS;
+}
+
+/* Empties the filter, keeping its size. Owner only, no readers. */
+static inline void pkc_cert_filter_clear(pkc_cert_filter_t *f)
+{
+    memset(f->words, 0, (size_t)f->blocks * PKC_CERT_FILTER_WORDS * sizeof(uint32_t));
+    f->items = 0;
+    f->count = 0;
+    f->chain = NULL;
+}
+
+/* ---------------- hashing ---------------- */
+
+PKC_CERT_FILTER_INLINE uint64_t pkc_cert_filter_mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/* One 64-bit hash of a 32-byte key or a 16-byte id; the products are independent. */
+PKC_CERT_FILTER_INLINE uint64_t pkc_cert_filter_hash(pkc_cert_filter_kind_t kind, const void *item, size_t len)
+{
+    uint64_t w[4] = {0, 0, 0, 0};
+    memcpy(w, item, len <= sizeof(w) ? len : sizeof(w));
+    const uint64_t h = (w[0] * 0x9E3779B97F4A7C15ULL) ^ (w[1] * 0xC2B2AE3D27D4EB4FULL) ^
+                       (w[2] * 0x165667B19E3779F9ULL) ^ (w[3] * 0x27D4EB2F165667C5ULL) ^
+                       ((uint64_t)(kind + 1) * 0x94D049BB133111EBULL);
+    return pkc_cert_filter_mix(h);
+}
+
+static const uint32_t pkc_cert_filter_salt[PKC_CERT_FILTER_WORDS] = {
+    0x47B6137BU, 0x44974D91U, 0x8824AD5BU, 0xA2B7289DU, 0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U,
+};
+
+PKC_CERT_FILTER_INLINE uint32_t *pkc_cert_filter_block(const pkc_cert_filter_t *f, uint64_t h)
+{
+    return f->words + (size_t)(((h >> 32) * f->blocks) >> 32) * PKC_CERT_FILTER_WORDS;
+}
+
+/* ---------------- add / check ---------------- */
+
+PKC_CERT_FILTER_INLINE void pkc_cert_filter_add_hash(pkc_cert_filter_t *f, uint64_t h)
+{
+    uint32_t *blk = pkc_cert_filter_block(f, h);
+    for (int i = 0; i < PKC_CERT_FILTER_WORDS; ++i) {
+        const uint32_t bit = ((uint32_t)h * pkc_cert_filter_salt[i]) >> 27;
+        __atomic_fetch_or(&blk[i], 1u << bit, __ATOMIC_RELAXED);
+    }
+    f->items++;
+}
+
+#if defined(__AVX2__) && !defined(__SANITIZE_THREAD__)
+PKC_CERT_FILTER_INLINE bool pkc_cert_filter_has_hash(const pkc_cert_filter_t *f, uint64_t h)
+{
+    const __m256i salt = _mm256_loadu_si256((const __m256i *)pkc_cert_filter_salt);
+    const __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)(uint32_t)h), salt), 27);
+    const __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+    return _mm256_testc_si256(_mm256_load_si256((const __m256i *)pkc_cert_filter_block(f, h)), mask);
+}
+#else
+PKC_CERT_FILTER_INLINE bool pkc_cert_filter_has_hash(const pkc_cert_filter_t *f, uint64_t h)
+{
+    // no early exit: a mispredicted branch costs more than the remaining words
+    const uint32_t *blk = pkc_cert_filter_block(f, h);
+    uint32_t hit = 1;
+    for (int i = 0; i < PKC_CERT_FILTER_WORDS; ++i) {
+        const uint32_t bit = ((uint32_t)h * pkc_cert_filter_salt[i]) >> 27;
+        hit &= __atomic_load_n(&blk[i], __ATOMIC_RELAXED) >> bit;
+    }
+    return hit & 1;
+}
+#endif
+
+/* Whether a certificate with this pubSignKey may be on the chain; false is definite. */
+PKC_CERT_FILTER_INLINE bool pkc_cert_filter_has_sign_key(const pkc_cert_filter_t *f, const uint256 *key)
+{
+    return pkc_cert_filter_has_hash(f, pkc_cert_filter_hash(PKC_CERT_FILTER_SIGN_KEY, key, sizeof(*key)));
+}
+
+PKC_CERT_FILTER_INLINE bool pkc_cert_filter_has_enc_key(const pkc_cert_filter_t *f, const uint256 *key)
+{
+    return pkc_cert_filter_has_hash(f, pkc_cert_filter_hash(PKC_CERT_FILTER_ENC_KEY, key, sizeof(*key)));
+}
+
+PKC_CERT_FILTER_INLINE bool pkc_cert_filter_has_id(const pkc_cert_filter_t *f, const ipv6_t *id)
+{
+    return pkc_cert_filter_has_hash(f, pkc_cert_filter_hash(PKC_CERT_FILTER_ID, id, sizeof(*id)));
+}
+
+PKC_CERT_FILTER_INLINE void pkc_cert_filter_add_cert(pkc_cert_filter_t *f, const certificate *cert)
+{
+    static const uint256 zero;
+    if (memcmp(&cert->pubSignKey, &zero, sizeof(zero)) == 0) return;
+    pkc_cert_filter_add_hash(f, pkc_cert_filter_hash(PKC_CERT_FILTER_SIGN_KEY, &cert->pubSignKey, sizeof(uint256)));
+    pkc_cert_filter_add_hash(f, pkc_cert_filter_hash(PKC_CERT_FILTER_ENC_KEY, &cert->pubEncKey, sizeof(uint256)));
+    pkc_cert_filter_add_hash(f, pkc_cert_filter_hash(PKC_CERT_FILTER_ID, &cert->id, sizeof(ipv6_t)));
+}
+
+/* ---------------- append ---------------- */
+
+/* Adds the certificates of n blocks that follow the current count. */
+static inline OpStatus_t pkc_cert_filter_append(pkc_cert_filter_t *f, const block *blocks, uint32_t n)
+{
+    if (!f || (!blocks && n)) return OP_NULL_PTR;
+    for (uint32_t i = 0; i < n; ++i) pkc_cert_filter_add_cert(f, &blocks[i].cert);
+    f->count += n;
+    return OP_SUCCESS;
+}
+
+/* Adds whatever chain->blocks has past the filter's count. */
+static inline OpStatus_t pkc_cert_filter_sync(pkc_cert_filter_t *f, const PKCertChain *chain)
+{
+    if (!f || !chain) return OP_NULL_PTR;
+    if (f->chain && f->chain != chain) return OP_INVALID_INPUT;
+    if (chain->index < f->count) return OP_INVALID_STATE;
+    f->chain = chain;
+    return pkc_cert_filter_append(f, &chain->blocks[f->count], chain->index - f->count);
+}
+
+static inline OpStatus_t pkc_cert_filter_build(pkc_cert_filter_t *f, const PKCertChain *chain)
+{
+    if (!f || !chain) return OP_NULL_PTR;
+    pkc_cert_filter_clear(f);
+    return pkc_cert_filter_sync(f, chain);
+}
+
+/* ---------------- persistence ---------------- */
+
+PKC_CERT_FILTER_INLINE OpStatus_t pkc_cert_filter_path(const char *network_name, char *out, size_t n)
+{
+    const char *home = getenv("HOME");
+    if (!home || home[0] == '\0') return OP_INVALID_INPUT;
+    const int len = snprintf(out, n, "%s/%s/%s/%s", home, PKCERTCHAIN_BASE_SUBDIR, network_name, PKC_CERT_FILTER_FILE);
+    return len > 0 && (size_t)len < n ? OP_SUCCESS : OP_INVALID_INPUT;
+}
+
+/* CurrentCertHash of the last block the filter covers, zero for none. */
+PKC_CERT_FILTER_INLINE void pkc_cert_filter_tip(const PKCertChain *chain, uint32_t count, uint8_t out[UINT256_SIZE])
+{
+    memset(out, 0, UINT256_SIZE);
+    if (count) uint256_serialize_be(&chain->blocks[count - 1].CurrentCertHash, out, UINT256_SIZE);
+}
+
+/* Writes the filter beside the chain state of `network_name`; it must cover a prefix of `chain`. */
+static inline OpStatus_t pkc_cert_filter_save(const pkc_cert_filter_t *f, const char *network_name, const PKCertChain *chain)
+{
+    if (!f || !chain) return OP_NULL_PTR;
+    if (!network_name || network_name[0] == '\0') return OP_INVALID_INPUT;
+    if (f->count > chain->index) return OP_INVALID_STATE;
+
+    char path[512];
+    OpStatus_t st = pkc_cert_filter_path(network_name, path, sizeof(path));
+    if (st != OP_SUCCESS) return st;
+    st = ensure_wallet_dir(network_name);
+    if (st != OP_SUCCESS) return st;
+
+    const size_t words = (size_t)f->blocks * PKC_CERT_FILTER_WORDS;
+    const size_t payload_len = PKC_CERT_FILTER_HEADER_SIZE + words * UINT32_SIZE;
+    uint8_t *buf = (uint8_t *)malloc(payload_len + UINT256_SIZE);
+    if (!buf) return OP_INVALID_STATE;
+
+    size_t off = 0;
+    memcpy(buf + off, PKC_CERT_FILTER_MAGIC, PKC_CERT_FILTER_MAGIC_LEN);
+    off += PKC_CERT_FILTER_MAGIC_LEN;
+    serialize_u8(PKC_CERT_FILTER_VERSION, buf + off);
+    off += 1;
+    serialize_u64_be((uint64_t)llround(f->fpr * 1e9), buf + off);
+    off += UINT64_SIZE;
+    serialize_u32_be(f->capacity, buf + off);
+    off += UINT32_SIZE;
+    serialize_u32_be(f->blocks, buf + off);
+    off += UINT32_SIZE;
+    serialize_u32_be(f->count, buf + off);
+    off += UINT32_SIZE;
+    serialize_u64_be(f->items, buf + off);
+    off += UINT64_SIZE;
+    pkc_cert_filter_tip(chain, f->count, buf + off);
+    off += UINT256_SIZE;
+    for (size_t i = 0; i < words; ++i, off += UINT32_SIZE)
+        serialize_u32_be(__atomic_load_n(&f->words[i], __ATOMIC_RELAXED), buf + off);
+
+    uint256 hash;
+    hash256_buffer(buf, payload_len, &hash);
+    uint256_serialize_be(&hash, buf + payload_len, UINT256_SIZE);
+    st = save_file_0600(path, buf, payload_len + UINT256_SIZE);
+    free(buf);
+    return st;
+}
+
+/*
+ * Loads the filter saved for `network_name` and checks it covers a prefix
+ * of `chain`; sync then adds the blocks appended since. OP_INVALID_STATE
+ * means the file belongs to another chain and the filter must be built.
+ * `f` is zeroed or initialized; it is replaced only on success.
+ */
+static inline OpStatus_t pkc_cert_filter_load(pkc_cert_filter_t *f, const char *network_name, const PKCertChain *chain)
+{
+    if (!f || !chain) return OP_NULL_PTR;
+    if (!network_name || network_name[0] == '\0') return OP_INVALID_INPUT;
+
+    char path[512];
+    OpStatus_t st = pkc_cert_filter_path(network_name, path, sizeof(path));
+    if (st != OP_SUCCESS) return st;
+    uint8_t *buf = NULL;
+    size_t len = 0;
+    int err = 0;
+    st = read_file_alloc(path, &buf, &len, &err);
+    if (st != OP_SUCCESS) return st;
+
+    st = OP_INVALID_INPUT;
+    if (len < PKC_CERT_FILTER_HEADER_SIZE + UINT256_SIZE) goto out;
+    const size_t payload_len = len - UINT256_SIZE;
+    uint256 calc;
+    uint8_t calc_buf[UINT256_SIZE];
+    hash256_buffer(buf, payload_len, &calc);
+    uint256_serialize_be(&calc, calc_buf, sizeof(calc_buf));
+    if (memcmp(calc_buf, buf + payload_len, UINT256_SIZE) != 0) goto out;
+    if (memcmp(buf, PKC_CERT_FILTER_MAGIC, PKC_CERT_FILTER_MAGIC_LEN) != 0) goto out;
+    if (buf[PKC_CERT_FILTER_MAGIC_LEN] != PKC_CERT_FILTER_VERSION) goto out;
+
+    size_t off = PKC_CERT_FILTER_MAGIC_LEN + 1;
+    uint64_t fpr = 0, items = 0;
+    uint32_t capacity = 0, blocks = 0, count = 0;
+    deserialize_u64_be(buf + off, &fpr, sizeof(uint64_t));
+    off += UINT64_SIZE;
+    deserialize_u32_be(buf + off, &capacity, sizeof(uint32_t));
+    off += UINT32_SIZE;
+    deserialize_u32_be(buf + off, &blocks, sizeof(uint32_t));
+    off += UINT32_SIZE;
+    deserialize_u32_be(buf + off, &count, sizeof(uint32_t));
+    off += UINT32_SIZE;
+    deserialize_u64_be(buf + off, &items, sizeof(uint64_t));
+    off += UINT64_SIZE;
+    if (blocks == 0 || payload_len != PKC_CERT_FILTER_HEADER_SIZE + (size_t)blocks * PKC_CERT_FILTER_WORDS * UINT32_SIZE)
+        goto out;
+
+    uint8_t tip[UINT256_SIZE];
+    st = OP_INVALID_STATE;
+    if (count > chain->index) goto out;
+    pkc_cert_filter_tip(chain, count, tip);
+    if (memcmp(tip, buf + off, UINT256_SIZE) != 0) goto out;
+    off += UINT256_SIZE;
+
+    pkc_cert_filter_t loaded = {0};
+    st = pkc_cert_filter_alloc(&loaded, blocks);
+    if (st != OP_SUCCESS) goto out;
+    for (size_t i = 0; i < (size_t)blocks * PKC_CERT_FILTER_WORDS; ++i, off += UINT32_SIZE)
+        deserialize_u32_be(buf + off, &loaded.words[i], sizeof(uint32_t));
+    loaded.capacity = capacity;
+    loaded.fpr = (double)fpr / 1e9;
+    loaded.items = items;
+    loaded.count = count;
+    loaded.chain = chain;
+    pkc_cert_filter_destroy(f);
+    *f = loaded;
+out:
+    free(buf);
+    return st;
+}
+
+#endif // PKC_CERT_FILTER_H
@@ -0,0 +1,521 @@
+#ifndef PKC_CERT_STATUS_H
+#define PKC_CERT_STATUS_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blockchain/block.h"
+#include "blockchain/block_ops.h"
+#include "blockchain/certFilter_ops.h"
+#include "blockhain/PKCertChain.h"
+#include "core/enums/OpStatus.h"
+
+#ifndef PKC_CERT_STATUS_INLINE
+#define PKC_CERT_STATUS_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Certificate status index.
+ *
+ * Answers "is this pubSignKey current?" without touching chain->blocks.
+ * Two open-addressing tables are maintained as blocks are appended:
+ *
+ *   key -> status, the id it was issued under, the issuing height and
+ *          the height that superseded or revoked it
+ *   id  -> latest height touching the id and its current key
+ *
+ * A block issues its certificate unless block_get_cert_op says
+ * BLOCK_CERT_OP_REVOKE; the op is bound into the block's TierPoW
+ * (pkc_block_pow_valid), so a relayed block cannot be flipped. Issuing a
+ * new key for an id supersedes the id's previous key; re-issuing the same
+ * key renews it. Revocation is final: a revoked key stays revoked if it
+ * is issued again. Blocks without a certificate (zero pubSignKey, e.g.
+ * bare mined blocks) are skipped.
+ *
+ * The index applies whatever the chain accepted; who may revoke or
+ * supersede is decided before that, by pkc_cert_block_authorised in
+ * pkc_chain_validate. A revocation must carry a cert_sign signature
+ * (block.SignedByVerifier) over its certificate by the network key
+ * (genesis), the revoked key itself or the current key of the id it was
+ * issued under; an issue that would supersede an id's current key must be
+ * signed by the network key or that current key. New ids and renewals
+ * need no signature.
+ *
+ * A membership filter over every certificate applied (certFilter_ops.h)
+ * sits in front of the key table, so lookups for keys that were never on
+ * the chain, the common case for a TLS terminator, usually stop at one
+ * filter block. The chain writer saves it beside the chain state every
+ * pkc_chain_writer_config_t.cert_filter_save_ns and when it stops, next
+ * to whatever persist hook it runs; pkc_cert_index_load reopens the index
+ * from that file and only hashes the blocks appended since.
+ *
+ * Tables are sized for `capacity` keys and ids up front and never move.
+ * One thread appends (the chain writer via pkc_chain_writer_config_t.certs,
+ * or pkc_cert_index_sync on a quiescent chain). Queries may run on any
+ * thread at the same time: each block is applied inside a sequence lock
+ * and a query retries if it overlapped one.
+ */
+
+#define PKC_CERT_LOAD(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define PKC_CERT_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PKC_CERT_PAUSE() __builtin_ia32_pause()
+#else
+#define PKC_CERT_PAUSE() ((void)0)
+#endif
+
+_Static_assert(sizeof(uint256) == 4 * sizeof(uint64_t), "pubSignKey is stored as four words");
+_Static_assert(sizeof(ipv6_t) <= 2 * sizeof(uint64_t), "cert id is stored in two words");
+
+typedef enum {
+    PKC_CERT_UNKNOWN = 0,           // never on the chain
+    PKC_CERT_CURRENT,
+    PKC_CERT_SUPERSEDED,            // a later block issued another key for the same id
+    PKC_CERT_REVOKED
+} pkc_cert_status_t;
+
+typedef struct {
+    pkc_cert_status_t status;
+    ipv6_t id;
+    uint64_t height;                // block that issued the key
+    uint64_t changed;               // block that superseded or revoked it, 0 while current
+} pkc_cert_info_t;
+
+typedef struct {
+    uint64_t key[4];                // all zero: free slot
+    uint64_t id[2];
+    uint64_t height;
+    uint64_t changed;
+    uint64_t status;
+} pkc_cert_key_slot_t;
+
+typedef struct {
+    uint64_t id[2];
+    uint64_t key[4];                // current key, zero when the id has none
+    uint64_t height;
+    uint64_t used;
+} pkc_cert_id_slot_t;
+
+typedef struct {
+    pkc_cert_key_slot_t *keys;
+    pkc_cert_id_slot_t *ids;
+    uint32_t key_mask;
+    uint32_t id_mask;
+    uint32_t nkeys;
+    uint32_t nids;
+    uint32_t capacity;              // distinct keys, and distinct ids
+
+    pkc_cert_filter_t filter;       // every certificate applied
+
+    const PKCertChain *chain;       // set by sync / build
+    uint32_t count;                 // chain blocks applied
+    uint64_t seq;                   // odd while a block is being applied
+} pkc_cert_index_t;
+
+/* ---------------- lifecycle ---------------- */
+
+static inline void pkc_cert_index_destroy(pkc_cert_index_t *ix)
+{
+    if (!ix) return;
+    free(ix->keys);
+    free(ix->ids);
+    pkc_cert_filter_destroy(&ix->filter);
+    memset(ix, 0, sizeof(*ix));
+}
+
+PKC_CERT_STATUS_INLINE uint64_t pkc_cert_pow2(uint64_t n)
+{
+    uint64_t p = 64;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+/* `fpr` is the filter's false-positive target, 0 for PKC_CERT_FILTER_FPR. */
+static inline OpStatus_t pkc_cert_index_init(pkc_cert_index_t *ix, uint32_t capacity, double fpr)
+{
+    if (!ix) return OP_NULL_PTR;
+    if (capacity == 0 || capacity > (1u << 28)) return OP_INVALID_INPUT;
+    memset(ix, 0, sizeof(*ix));
+    const uint64_t slots = pkc_cert_pow2((uint64_t)capacity * 2);      // at most half full
+    ix->keys = (pkc_cert_key_slot_t *)calloc(slots, sizeof(pkc_cert_key_slot_t));
+    ix->ids = (pkc_cert_id_slot_t *)calloc(slots, sizeof(pkc_cert_id_slot_t));
+    if (!ix->keys || !ix->ids) {
+        pkc_cert_index_destroy(ix);
+        return OP_INVALID_STATE;
+    }
+    OpStatus_t st = pkc_cert_filter_init(&ix->filter, capacity, fpr);
+    if (st != OP_SUCCESS) {
+        pkc_cert_index_destroy(ix);
+        return st;
+    }
+    ix->key_mask = (uint32_t)(slots - 1);
+    ix->id_mask = (uint32_t)(slots - 1);
+    ix->capacity = capacity;
+    return OP_SUCCESS;
+}
+
+/* ---------------- hashing ---------------- */
+
+PKC_CERT_STATUS_INLINE bool pkc_cert_key_zero(const uint64_t k[4])
+{
+    return (k[0] | k[1] | k[2] | k[3]) == 0;
+}
+
+PKC_CERT_STATUS_INLINE uint32_t pkc_cert_key_bucket(const pkc_cert_index_t *ix, const uint64_t k[4])
+{
+    return (uint32_t)((k[0] * 0x9E3779B97F4A7C15ULL) >> 32) & ix->key_mask;
+}
+
+PKC_CERT_STATUS_INLINE uint32_t pkc_cert_id_bucket(const pkc_cert_index_t *ix, const uint64_t id[2])
+{
+    uint64_t h = id[0] ^ (id[1] * 0xC2B2AE3D27D4EB4FULL);
+    h ^= h >> 29;
+    return (uint32_t)((h * 0x9E3779B97F4A7C15ULL) >> 32) & ix->id_mask;
+}
+
+/* ---------------- writer side ---------------- */
+
+/* Slot holding `k`, or the free slot it would go in. Appending thread only. */
+PKC_CERT_STATUS_INLINE pkc_cert_key_slot_t *pkc_cert_key_probe(pkc_cert_index_t *ix, const uint64_t k[4])
+{
+    for (uint32_t i = pkc_cert_key_bucket(ix, k);; i = (i + 1) & ix->key_mask) {
+        pkc_cert_key_slot_t *s = &ix->keys[i];
+        if (pkc_cert_key_zero(s->key) || memcmp(s->key, k, sizeof(s->key)) == 0) return s;
+    }
+}
+
+PKC_CERT_STATUS_INLINE pkc_cert_id_slot_t *pkc_cert_id_probe(pkc_cert_index_t *ix, const uint64_t id[2])
+{
+    for (uint32_t i = pkc_cert_id_bucket(ix, id);; i = (i + 1) & ix->id_mask) {
+        pkc_cert_id_slot_t *s = &ix->ids[i];
+        if (!s->used || (s->id[0] == id[0] && s->id[1] == id[1])) return s;
+    }
+}
+
+PKC_CERT_STATUS_INLINE void pkc_cert_store_words(uint64_t *dst, const uint64_t *src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) PKC_CERT_STORE(dst[i], src[i]);
+}
+
+PKC_CERT_STATUS_INLINE void pkc_cert_key_claim(pkc_cert_index_t *ix, pkc_cert_key_slot_t *s, const uint64_t k[4])
+{
+    if (!pkc_cert_key_zero(s->key)) return;
+    pkc_cert_store_words(s->key, k, 4);
+    ix->nkeys++;
+}
+
+PKC_CERT_STATUS_INLINE void pkc_cert_id_claim(pkc_cert_index_t *ix, pkc_cert_id_slot_t *s, const uint64_t id[2])
+{
+    if (s->used) return;
+    pkc_cert_store_words(s->id, id, 2);
+    PKC_CERT_STORE(s->used, 1);
+    ix->nids++;
+}
+
+/* Marks the key in `s` superseded or revoked at `height`. */
+PKC_CERT_STATUS_INLINE void pkc_cert_key_retire(pkc_cert_key_slot_t *s, pkc_cert_status_t status, uint64_t height)
+{
+    PKC_CERT_STORE(s->status, (uint64_t)status);
+    PKC_CERT_STORE(s->changed, height);
+}
+
+PKC_CERT_STATUS_INLINE void pkc_cert_clear_current(pkc_cert_id_slot_t *s, const uint64_t k[4])
+{
+    static const uint64_t none[4] = {0, 0, 0, 0};
+    if (s->used && memcmp(s->key, k, sizeof(s->key)) == 0) pkc_cert_store_words(s->key, none, 4);
+}
+
+/* `filter`: also add the certificate to the filter (false when it already holds the block). */
+static inline OpStatus_t pkc_cert_index_apply(pkc_cert_index_t *ix, const block *b, bool filter)
+{
+    uint64_t k[4] = {0}, id[2] = {0};
+    memcpy(k, &b->cert.pubSignKey, sizeof(k));
+    memcpy(id, &b->cert.id, sizeof(b->cert.id));
+    if (pkc_cert_key_zero(k)) return OP_SUCCESS;
+
+    pkc_cert_key_slot_t *ks = pkc_cert_key_probe(ix, k);
+    const bool new_key = pkc_cert_key_zero(ks->key);
+    const bool revoke = block_get_cert_op(b) == BLOCK_CERT_OP_REVOKE;
+    // a revocation is filed under the id the key was issued for
+    const uint64_t *target = revoke && !new_key ? ks->id : id;
+    pkc_cert_id_slot_t *is = pkc_cert_id_probe(ix, target);
+    if ((new_key && ix->nkeys == ix->capacity) || (!is->used && ix->nids == ix->capacity))
+        return OP_BUFFER_TOO_SMALL;
+    // filter bits go in before the key, so a negative never hides a table entry
+    if (filter) pkc_cert_filter_add_cert(&ix->filter, &b->cert);
+    if (!new_key && ks->status == PKC_CERT_REVOKED) return OP_SUCCESS;      // final
+    // a key re-issued under another id leaves its old id without a current key
+    pkc_cert_id_slot_t *moved = NULL;
+    if (!revoke && !new_key && (ks->id[0] != id[0] || ks->id[1] != id[1])) moved = pkc_cert_id_probe(ix, ks->id);
+
+    PKC_CERT_STORE(ix->seq, ix->seq + 1);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    pkc_cert_key_claim(ix, ks, k);
+    pkc_cert_id_claim(ix, is, target);
+    if (revoke) {
+        if (new_key) {
+            pkc_cert_store_words(ks->id, id, 2);
+            PKC_CERT_STORE(ks->height, b->height);
+        }
+        pkc_cert_key_retire(ks, PKC_CERT_REVOKED, b->height);
+        pkc_cert_clear_current(is, k);
+    } else {
+        if (moved) pkc_cert_clear_current(moved, k);
+        if (!pkc_cert_key_zero(is->key) && memcmp(is->key, k, sizeof(is->key)) != 0)
+            pkc_cert_key_retire(pkc_cert_key_probe(ix, is->key), PKC_CERT_SUPERSEDED, b->height);
+        pkc_cert_store_words(is->key, k, 4);
+        pkc_cert_store_words(ks->id, id, 2);
+        PKC_CERT_STORE(ks->height, b->height);
+        PKC_CERT_STORE(ks->changed, 0);
+        PKC_CERT_STORE(ks->status, (uint64_t)PKC_CERT_CURRENT);
+    }
+    PKC_CERT_STORE(is->height, b->height);
+
+    __atomic_store_n(&ix->seq, ix->seq + 1, __ATOMIC_RELEASE);
+    return OP_SUCCESS;
+}
+
+/* Applies n blocks that follow the current count. */
+static inline OpStatus_t pkc_cert_index_append(pkc_cert_index_t *ix, const block *blocks, uint32_t n)
+{
+    if (!ix || (!blocks && n)) return OP_NULL_PTR;
+    for (uint32_t i = 0; i < n; ++i) {
+        OpStatus_t st = pkc_cert_index_apply(ix, &blocks[i], true);
+        if (st != OP_SUCCESS) return st;
+        ix->count++;
+        ix->filter.count++;
+    }
+    return OP_SUCCESS;
+}
+
+/* Applies whatever chain->blocks has past the index's count. */
+static inline OpStatus_t pkc_cert_index_sync(pkc_cert_index_t *ix, const PKCertChain *chain)
+{
+    if (!ix || !chain) return OP_NULL_PTR;
+    if (ix->chain && ix->chain != chain) return OP_INVALID_INPUT;
+    if (chain->index < ix->count) return OP_INVALID_STATE;
+    ix->chain = chain;
+    ix->filter.chain = chain;
+    return pkc_cert_index_append(ix, &chain->blocks[ix->count], chain->index - ix->count);
+}
+
+PKC_CERT_STATUS_INLINE void pkc_cert_index_reset(pkc_cert_index_t *ix)
+{
+    memset(ix->keys, 0, ((size_t)ix->key_mask + 1) * sizeof(*ix->keys));
+    memset(ix->ids, 0, ((size_t)ix->id_mask + 1) * sizeof(*ix->ids));
+    ix->nkeys = ix->nids = ix->count = 0;
+    ix->chain = NULL;
+}
+
+/* Rebuilds from block 0. Owner only, no readers. */
+static inline OpStatus_t pkc_cert_index_build(pkc_cert_index_t *ix, const PKCertChain *chain)
+{
+    if (!ix || !chain) return OP_NULL_PTR;
+    pkc_cert_index_reset(ix);
+    pkc_cert_filter_clear(&ix->filter);
+    return pkc_cert_index_sync(ix, chain);
+}
+
+/*
+ * Opens the index over `chain` with the filter saved beside its state
+ * (pkc_cert_filter_load): the key and id tables are rebuilt from block 0,
+ * but only blocks appended since the save are added to the filter. With
+ * no usable file (none, another chain, another size) it is a build.
+ * Owner only, no readers.
+ */
+static inline OpStatus_t pkc_cert_index_load(pkc_cert_index_t *ix, const PKCertChain *chain)
+{
+    if (!ix || !chain) return OP_NULL_PTR;
+    pkc_cert_filter_t loaded = {0};
+    if (pkc_cert_filter_load(&loaded, chain->NetworkName, chain) != OP_SUCCESS ||
+        loaded.capacity != ix->filter.capacity || loaded.blocks != ix->filter.blocks) {
+        pkc_cert_filter_destroy(&loaded);
+        return pkc_cert_index_build(ix, chain);
+    }
+    pkc_cert_index_reset(ix);
+    pkc_cert_filter_destroy(&ix->filter);
+    ix->filter = loaded;
+    for (uint32_t i = 0; i < loaded.count; ++i) {
+        OpStatus_t st = pkc_cert_index_apply(ix, &chain->blocks[i], false);
+        if (st != OP_SUCCESS) return st;
+        ix->count++;
+    }
+    return pkc_cert_index_sync(ix, chain);
+}
+
+/* ---------------- queries ---------------- */
+
+/* Whether `key` may be on the chain; false is definite. */
+PKC_CERT_STATUS_INLINE bool pkc_cert_maybe_known(const pkc_cert_index_t *ix, const uint256 *key)
+{
+    return pkc_cert_filter_has_sign_key(&ix->filter, key);
+}
+
+/*
+ * Status of `key`, with its details in `info` (optional) unless it is
+ * unknown. Constant time; safe against a concurrent appender.
+ */
+static inline pkc_cert_status_t pkc_cert_status(const pkc_cert_index_t *ix, const uint256 *key, pkc_cert_info_t *info)
+{
+    if (!ix || !key) return PKC_CERT_UNKNOWN;
+    uint64_t k[4];
+    memcpy(k, key, sizeof(k));
+    if (pkc_cert_key_zero(k) || !pkc_cert_filter_has_sign_key(&ix->filter, key)) return PKC_CERT_UNKNOWN;
+
+    for (;;) {
+        const uint64_t seq = __atomic_load_n(&ix->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            PKC_CERT_PAUSE();
+            continue;
+        }
+        pkc_cert_status_t status = PKC_CERT_UNKNOWN;
+        uint64_t id[2] = {0, 0}, height = 0, changed = 0;
+        for (uint32_t i = pkc_cert_key_bucket(ix, k);; i = (i + 1) & ix->key_mask) {
+            const pkc_cert_key_slot_t *s = &ix->keys[i];
+            const uint64_t w0 = PKC_CERT_LOAD(s->key[0]), w1 = PKC_CERT_LOAD(s->key[1]);
+            const uint64_t w2 = PKC_CERT_LOAD(s->key[2]), w3 = PKC_CERT_LOAD(s->key[3]);
+            if ((w0 | w1 | w2 | w3) == 0) break;
+            if (w0 != k[0] || w1 != k[1] || w2 != k[2] || w3 != k[3]) continue;
+            status = (pkc_cert_status_t)PKC_CERT_LOAD(s->status);
+            id[0] = PKC_CERT_LOAD(s->id[0]);
+            id[1] = PKC_CERT_LOAD(s->id[1]);
+            height = PKC_CERT_LOAD(s->height);
+            changed = PKC_CERT_LOAD(s->changed);
+            break;
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (PKC_CERT_LOAD(ix->seq) != seq) continue;
+
+        if (info && status != PKC_CERT_UNKNOWN) {
+            info->status = status;
+            memcpy(&info->id, id, sizeof(info->id));
+            info->height = height;
+            info->changed = changed;
+        }
+        return status;
+    }
+}
+
+/*
+ * Latest height touching `id` and its current key (zero when every key
+ * it had is superseded away or revoked). False if the id is unknown.
+ */
+static inline bool pkc_cert_latest(const pkc_cert_index_t *ix, const ipv6_t *id, uint64_t *height, uint256 *current)
+{
+    if (!ix || !id || !pkc_cert_filter_has_id(&ix->filter, id)) return false;
+    uint64_t want[2] = {0, 0};
+    memcpy(want, id, sizeof(*id));
+
+    for (;;) {
+        const uint64_t seq = __atomic_load_n(&ix->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            PKC_CERT_PAUSE();
+            continue;
+        }
+        bool found = false;
+        uint64_t h = 0, key[4] = {0, 0, 0, 0};
+        for (uint32_t i = pkc_cert_id_bucket(ix, want);; i = (i + 1) & ix->id_mask) {
+            const pkc_cert_id_slot_t *s = &ix->ids[i];
+            if (!PKC_CERT_LOAD(s->used)) break;
+            if (PKC_CERT_LOAD(s->id[0]) != want[0] || PKC_CERT_LOAD(s->id[1]) != want[1]) continue;
+            found = true;
+            h = PKC_CERT_LOAD(s->height);
+            for (int w = 0; w < 4; ++w) key[w] = PKC_CERT_LOAD(s->key[w]);
+            break;
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (PKC_CERT_LOAD(ix->seq) != seq) continue;
+
+        if (found && height) *height = h;
+        if (found && current) memcpy(current, key, sizeof(key));
+        return found;
+    }
+}
+
+/* ---------------- authorisation ---------------- */
+
+PKC_CERT_STATUS_INLINE bool pkc_cert_signed_by(const block *b, const uint256 *key)
+{
+    uint64_t k[4];
+    memcpy(k, key, sizeof(k));
+    return !pkc_cert_key_zero(k) && cert_verify(&b->cert, key, &b->SignedByVerifier) == OP_SIGN_VERIFIED_TRUE;
+}
+
+/* First block in [1, end) revoking `key`, or 0. */
+static inline uint32_t pkc_cert_chain_revoked_at(const PKCertChain *chain, uint32_t end, const uint256 *key)
+{
+    for (uint32_t j = 1; j < end; ++j) {
+        const block *b = &chain->blocks[j];
+        if (block_get_cert_op(b) == BLOCK_CERT_OP_REVOKE && memcmp(&b->cert.pubSignKey, key, sizeof(*key)) == 0)
+            return j;
+    }
+    return 0;
+}
+
+/*
+ * Current key of `id` over blocks [1, end) by the index's rules, replayed
+ * from the chain: the newest issue under the id whose key was not revoked
+ * before it, unless that key was revoked or issued under another id since.
+ * False when the id has no current key.
+ */
+static inline bool pkc_cert_chain_current(const PKCertChain *chain, uint32_t end, const ipv6_t *id, uint256 *out)
+{
+    for (uint32_t j = end; j-- > 1;) {
+        const block *b = &chain->blocks[j];
+        uint64_t k[4];
+        memcpy(k, &b->cert.pubSignKey, sizeof(k));
+        if (pkc_cert_key_zero(k) || block_get_cert_op(b) == BLOCK_CERT_OP_REVOKE ||
+            memcmp(&b->cert.id, id, sizeof(*id)) != 0)
+            continue;
+        const uint32_t revoked = pkc_cert_chain_revoked_at(chain, end, &b->cert.pubSignKey);
+        if (revoked && revoked < j) continue;       // ignored issue; an older one may still stand
+        if (revoked) return false;
+        for (uint32_t m = j + 1; m < end; ++m) {
+            if (memcmp(&chain->blocks[m].cert.pubSignKey, &b->cert.pubSignKey, sizeof(uint256)) == 0) return false;
+        }
+        *out = b->cert.pubSignKey;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Whether `b` may be appended to `chain` as far as its certificate goes:
+ * revocations and superseding issues need a signature by a key with
+ * authority over the certificate (see the top of this file).
+ */
+static inline bool pkc_cert_block_authorised(const PKCertChain *chain, const block *b)
+{
+    uint64_t k[4];
+    memcpy(k, &b->cert.pubSignKey, sizeof(k));
+    if (pkc_cert_key_zero(k)) return true;
+    if (chain->index > 0 && pkc_cert_signed_by(b, &chain->blocks[0].cert.pubSignKey)) return true;
+
+    uint256 current;
+    if (block_get_cert_op(b) == BLOCK_CERT_OP_REVOKE) {
+        if (pkc_cert_signed_by(b, &b->cert.pubSignKey)) return true;
+        // the id the key was last issued under, not whatever id the revocation names
+        for (uint32_t j = chain->index; j-- > 1;) {
+            const block *issued = &chain->blocks[j];
+            if (block_get_cert_op(issued) == BLOCK_CERT_OP_REVOKE ||
+                memcmp(&issued->cert.pubSignKey, &b->cert.pubSignKey, sizeof(uint256)) != 0)
+                continue;
+            return pkc_cert_chain_current(chain, chain->index, &issued->cert.id, &current) &&
+                   pkc_cert_signed_by(b, &current);
+        }
+        return false;
+    }
+    if (!pkc_cert_chain_current(chain, chain->index, &b->cert.id, &current) ||
+        memcmp(&current, &b->cert.pubSignKey, sizeof(current)) == 0)
+        return true;
+    return pkc_cert_signed_by(b, &current);
+}
+
+#endif // PKC_CERT_STATUS_H
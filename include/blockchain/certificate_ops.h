@@ -96,5 +96,17 @@ CERT_INLINE OpStatus_t cert_sign(const certificate *cert, const uint256 *priv_ke
     return sign_buffer_ed25519(buf, sizeof(buf), priv_key, out_sig);
 }
 
+/* OP_SIGN_VERIFIED_TRUE when `sig` is cert_sign's signature by the holder of `pub_key`. */
+CERT_INLINE OpStatus_t cert_verify(const certificate *cert, const uint256 *pub_key, const uint512 *sig)
+{
+    if (!cert || !pub_key || !sig) return OP_NULL_PTR;
+
+    uint8_t buf[CERT_SIZE];
+    OpStatus_t st = cert_serialize(cert, buf, sizeof(buf));
+    if (st != OP_SUCCESS) return st;
+
+    return verify_buffer_ed25519(buf, sizeof(buf), pub_key, sig);
+}
+
 
 #endif // CERTIFICATE_H
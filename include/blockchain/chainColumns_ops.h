@@ -0,0 +1,260 @@
+#ifndef PKC_CHAIN_COLUMNS_H
+#define PKC_CHAIN_COLUMNS_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "blockchain/block.h"
+#include "blockchain/blockView_ops.h"
+#include "blockhain/PKCertChain.h"
+#include "core/enums/OpStatus.h"
+#include "core/enums/Tier.h"
+
+#ifndef PKC_COLUMNS_INLINE
+#define PKC_COLUMNS_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Columnar side-store for the hot block fields.
+ *
+ * A block puts height, tier and the two hashes next to the 64-byte
+ * verifier signature and both PoW results, so a scan over chain->blocks
+ * pulls a few hundred bytes per block through the cache to look at one
+ * byte. The columns keep those fields in parallel arrays:
+ *
+ *   tier       1 byte / block    tier scans, 64 blocks per cache line
+ *   height     8 bytes / block
+ *   prev_hash  32 bytes / block  linkage checks
+ *   hash       32 bytes / block  block_link_hash, what the next prev_hash must be
+ *   cert_hash  32 bytes / block  cert hash lookups
+ *
+ * The columns only grow. The chain writer appends a batch to them before
+ * publishing the tip that covers it (pkc_chain_writer_config_t.columns),
+ * so entries below tip->index are safe to read inside a read section,
+ * like the blocks themselves. Without a writer, pkc_columns_sync catches
+ * up with chain->index.
+ *
+ * Tier scans compare 32 (AVX2) or 16 (SSE2) tier bytes at a time and walk
+ * the match mask.
+ */
+
+#ifndef PKC_COLUMNS_ALIGN
+#define PKC_COLUMNS_ALIGN 64
+#endif
+
+#define PKC_COLUMNS_NONE UINT32_MAX
+
+typedef struct {
+    uint8_t *tier;
+    uint64_t *height;
+    uint256 *prev_hash;
+    uint256 *hash;
+    uint256 *cert_hash;
+    uint32_t count;                 // blocks mirrored; writer only
+    uint32_t capacity;
+} pkc_chain_columns_t;
+
+/* ---------------- lifecycle ---------------- */
+
+PKC_COLUMNS_INLINE void *pkc_columns_alloc(size_t bytes)
+{
+    // aligned_alloc wants a multiple of the alignment
+    const size_t rounded = (bytes + PKC_COLUMNS_ALIGN - 1) / PKC_COLUMNS_ALIGN * PKC_COLUMNS_ALIGN;
+    return aligned_alloc(PKC_COLUMNS_ALIGN, rounded ? rounded : PKC_COLUMNS_ALIGN);
+}
+
+static inline void pkc_columns_destroy(pkc_chain_columns_t *c)
+{
+    if (!c) return;
+    free(c->tier);
+    free(c->height);
+    free(c->prev_hash);
+    free(c->hash);
+    free(c->cert_hash);
+    memset(c, 0, sizeof(*c));
+}
+
+static inline OpStatus_t pkc_columns_init(pkc_chain_columns_t *c, uint32_t capacity)
+{
+    if (!c) return OP_NULL_PTR;
+    if (capacity == 0) return OP_INVALID_INPUT;
+    memset(c, 0, sizeof(*c));
+    c->tier = (uint8_t *)pkc_columns_alloc(capacity);
+    c->height = (uint64_t *)pkc_columns_alloc((size_t)capacity * sizeof(uint64_t));
+    c->prev_hash = (uint256 *)pkc_columns_alloc((size_t)capacity * sizeof(uint256));
+    c->hash = (uint256 *)pkc_columns_alloc((size_t)capacity * sizeof(uint256));
+    c->cert_hash = (uint256 *)pkc_columns_alloc((size_t)capacity * sizeof(uint256));
+    if (!c->tier || !c->height || !c->prev_hash || !c->hash || !c->cert_hash) {
+        pkc_columns_destroy(c);
+        return OP_INVALID_STATE;
+    }
+    c->capacity = capacity;
+    return OP_SUCCESS;
+}
+
+/* ---------------- append ---------------- */
+
+/* Mirrors n blocks that follow the current count. */
+static inline OpStatus_t pkc_columns_append(pkc_chain_columns_t *c, const block *blocks, uint32_t n)
+{
+    if (!c || (!blocks && n)) return OP_NULL_PTR;
+    if (n > c->capacity - c->count) return OP_BUFFER_TOO_SMALL;
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint32_t at = c->count + i;
+        c->tier[at] = (uint8_t)blocks[i].tier;
+        c->height[at] = blocks[i].height;
+        c->prev_hash[at] = blocks[i].prevHash;
+        c->cert_hash[at] = blocks[i].CurrentCertHash;
+        OpStatus_t st = block_link_hash(&blocks[i], &c->hash[at]);
+        if (st != OP_SUCCESS) return st;
+    }
+    c->count += n;
+    return OP_SUCCESS;
+}
+
+/* Appends whatever chain->blocks has past the columns' count. */
+static inline OpStatus_t pkc_columns_sync(pkc_chain_columns_t *c, const PKCertChain *chain)
+{
+    if (!c || !chain) return OP_NULL_PTR;
+    if (chain->index < c->count) return OP_INVALID_STATE;
+    return pkc_columns_append(c, &chain->blocks[c->count], chain->index - c->count);
+}
+
+static inline OpStatus_t pkc_columns_build(pkc_chain_columns_t *c, const PKCertChain *chain)
+{
+    if (!c || !chain) return OP_NULL_PTR;
+    c->count = 0;
+    return pkc_columns_sync(c, chain);
+}
+
+/* Drops blocks `count` and up ahead of a reorg. Owner only, no readers. */
+static inline OpStatus_t pkc_columns_truncate(pkc_chain_columns_t *c, uint32_t count)
+{
+    if (!c) return OP_NULL_PTR;
+    if (count > c->count) return OP_INVALID_STATE;
+    c->count = count;
+    return OP_SUCCESS;
+}
+
+/* ---------------- tier scans ---------------- */
+
+/* Match mask of tier bytes [i, i + width) against `tier`, bit k = tier[i + k]. */
+#if defined(__AVX2__)
+#define PKC_COLUMNS_WIDTH 32
+PKC_COLUMNS_INLINE uint32_t pkc_columns_match(const uint8_t *p, __m256i needle)
+{
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), needle));
+}
+#define PKC_COLUMNS_NEEDLE(t) _mm256_set1_epi8((char)(t))
+typedef __m256i pkc_columns_needle_t;
+#elif defined(__SSE2__)
+#define PKC_COLUMNS_WIDTH 16
+PKC_COLUMNS_INLINE uint32_t pkc_columns_match(const uint8_t *p, __m128i needle)
+{
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), needle));
+}
+#define PKC_COLUMNS_NEEDLE(t) _mm_set1_epi8((char)(t))
+typedef __m128i pkc_columns_needle_t;
+#else
+#define PKC_COLUMNS_WIDTH 0
+#endif
+
+/*
+ * Writes the heights of blocks in [first, end) whose tier is `tier` to
+ * `out` (at most `max`) and returns how many matched in total.
+ */
+static inline uint32_t pkc_columns_find_tier(const pkc_chain_columns_t *c, uint32_t first, uint32_t end,
+                                             Tier_t tier, uint64_t *out, uint32_t max)
+{
+    if (end > c->count) end = c->count;
+    uint32_t found = 0;
+    uint32_t i = first;
+#if PKC_COLUMNS_WIDTH
+    const pkc_columns_needle_t needle = PKC_COLUMNS_NEEDLE(tier);
+    for (; i + PKC_COLUMNS_WIDTH <= end; i += PKC_COLUMNS_WIDTH) {
+        uint32_t mask = pkc_columns_match(c->tier + i, needle);
+        while (mask) {
+            const uint32_t k = (uint32_t)__builtin_ctz(mask);
+            if (found < max) out[found] = c->height[i + k];
+            found++;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        if (c->tier[i] != (uint8_t)tier) continue;
+        if (found < max) out[found] = c->height[i];
+        found++;
+    }
+    return found;
+}
+
+static inline uint32_t pkc_columns_count_tier(const pkc_chain_columns_t *c, uint32_t first, uint32_t end, Tier_t tier)
+{
+    if (end > c->count) end = c->count;
+    uint32_t found = 0;
+    uint32_t i = first;
+#if PKC_COLUMNS_WIDTH
+    const pkc_columns_needle_t needle = PKC_COLUMNS_NEEDLE(tier);
+    for (; i + PKC_COLUMNS_WIDTH <= end; i += PKC_COLUMNS_WIDTH)
+        found += (uint32_t)__builtin_popcount(pkc_columns_match(c->tier + i, needle));
+#endif
+    for (; i < end; ++i) found += c->tier[i] == (uint8_t)tier;
+    return found;
+}
+
+/* Index of the last block of `tier` below `end`, PKC_COLUMNS_NONE if there is none. */
+static inline uint32_t pkc_columns_last_of_tier(const pkc_chain_columns_t *c, uint32_t end, Tier_t tier)
+{
+    if (end > c->count) end = c->count;
+    uint32_t i = end;
+#if PKC_COLUMNS_WIDTH
+    const pkc_columns_needle_t needle = PKC_COLUMNS_NEEDLE(tier);
+    while (i >= PKC_COLUMNS_WIDTH) {
+        const uint32_t mask = pkc_columns_match(c->tier + i - PKC_COLUMNS_WIDTH, needle);
+        if (mask) return i - PKC_COLUMNS_WIDTH + 31u - (uint32_t)__builtin_clz(mask);
+        i -= PKC_COLUMNS_WIDTH;
+    }
+#endif
+    while (i > 0) {
+        --i;
+        if (c->tier[i] == (uint8_t)tier) return i;
+    }
+    return PKC_COLUMNS_NONE;
+}
+
+/* ---------------- hash columns ---------------- */
+
+/*
+ * First i in [first, end) whose prev_hash is not the block_link_hash of
+ * block i - 1, or PKC_COLUMNS_NONE when every link in the range holds.
+ */
+static inline uint32_t pkc_columns_first_broken_link(const pkc_chain_columns_t *c, uint32_t first, uint32_t end)
+{
+    if (end > c->count) end = c->count;
+    for (uint32_t i = first ? first : 1; i < end; ++i) {
+        if (memcmp(&c->prev_hash[i], &c->hash[i - 1], sizeof(uint256)) != 0) return i;
+    }
+    return PKC_COLUMNS_NONE;
+}
+
+/* Most recent block below `end` carrying `cert_hash`, PKC_COLUMNS_NONE if none. */
+static inline uint32_t pkc_columns_find_cert_hash(const pkc_chain_columns_t *c, uint32_t end, const uint256 *cert_hash)
+{
+    if (end > c->count) end = c->count;
+    for (uint32_t i = end; i > 0; --i) {
+        if (memcmp(&c->cert_hash[i - 1], cert_hash, sizeof(uint256)) == 0) return i - 1;
+    }
+    return PKC_COLUMNS_NONE;
+}
+
+#endif // PKC_CHAIN_COLUMNS_H
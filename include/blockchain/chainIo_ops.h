@@ -0,0 +1,444 @@
+#ifndef PKC_CHAIN_IO_H
+#define PKC_CHAIN_IO_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+/* linux/fs.h (via io_uring.h) defines its own BLOCK_SIZE; keep the chain's. */
+#pragma push_macro("BLOCK_SIZE")
+#undef BLOCK_SIZE
+#include <linux/io_uring.h>
+#undef BLOCK_SIZE
+#pragma pop_macro("BLOCK_SIZE")
+
+#include "core/enums/OpStatus.h"
+
+#ifndef PKC_IO_INLINE
+#define PKC_IO_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Asynchronous file I/O for the chain log and snapshots.
+ *
+ * The io_uring backend talks to the kernel through the raw syscalls and
+ * the uapi header (no liburing). A fixed set of page-aligned buffers is
+ * registered once, so reads and writes are READ_FIXED / WRITE_FIXED with
+ * no per-call page pinning. Operations are only queued until
+ * pkc_io_submit, which hands the whole batch to the kernel in one
+ * io_uring_enter and optionally waits for completions in the same call.
+ *
+ * When io_uring is unavailable (old kernel, seccomp, ENOMEM on the ring)
+ * or `force_blocking` is set, the same API runs on pread/pwrite/fdatasync:
+ * queued operations execute in order inside pkc_io_submit and their
+ * completions are reaped exactly like the ring's. Callers therefore never
+ * branch on the backend.
+ *
+ * Ordering: PKC_IO_LINK chains an operation to the next one queued (it
+ * starts only after this one succeeds); PKC_IO_DRAIN starts an operation
+ * only after everything submitted before it has completed, which is what
+ * an fdatasync covering earlier in-flight writes needs.
+ *
+ * Not thread-safe: one owner thread (the chain writer) per pkc_io_t.
+ * The kernel cancels ring requests whose submitting thread exits, so a
+ * thread reaps everything it submitted before it returns.
+ */
+
+#ifndef PKC_IO_ENTRIES
+#define PKC_IO_ENTRIES 64
+#endif
+
+#ifndef PKC_IO_BUFFERS
+#define PKC_IO_BUFFERS 8
+#endif
+
+#ifndef PKC_IO_BUFFER_SIZE
+#define PKC_IO_BUFFER_SIZE (256u * 1024u)
+#endif
+
+#define PKC_IO_LINK 0x1u
+#define PKC_IO_DRAIN 0x2u
+
+typedef enum {
+    PKC_IO_BACKEND_BLOCKING = 0,
+    PKC_IO_BACKEND_URING = 1,
+} pkc_io_backend_t;
+
+typedef enum {
+    PKC_IO_OP_READ = 0,
+    PKC_IO_OP_WRITE,
+    PKC_IO_OP_FDATASYNC,
+} pkc_io_opcode_t;
+
+typedef struct {
+    uint32_t entries;               // 0: PKC_IO_ENTRIES
+    uint32_t buffers;               // 0: PKC_IO_BUFFERS
+    uint32_t buffer_size;           // 0: PKC_IO_BUFFER_SIZE, rounded up to 4 KiB
+    bool force_blocking;
+} pkc_io_config_t;
+
+typedef struct {
+    uint64_t user_data;
+    int32_t res;                    // bytes transferred, 0 for fdatasync, -errno on failure
+} pkc_io_completion_t;
+
+typedef struct {
+    pkc_io_opcode_t op;
+    int fd;
+    uint32_t buf;
+    uint32_t len;
+    uint64_t off;
+    uint64_t user_data;
+    uint32_t flags;
+} pkc_io_op_t;
+
+typedef struct {
+    pkc_io_backend_t backend;
+    pkc_io_config_t cfg;
+    uint8_t *buffers;               // cfg.buffers * cfg.buffer_size, page aligned
+
+    // io_uring
+    int ring_fd;
+    void *sq_map;
+    void *cq_map;
+    size_t sq_map_len;
+    size_t cq_map_len;
+    struct io_uring_sqe *sqes;
+    size_t sqes_len;
+    _Atomic(unsigned) *sq_head;
+    _Atomic(unsigned) *sq_tail;
+    unsigned sq_mask;
+    unsigned *sq_array;
+    _Atomic(unsigned) *cq_head;
+    _Atomic(unsigned) *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+
+    // blocking fallback: queued ops and produced completions
+    pkc_io_op_t *ops;
+    pkc_io_completion_t *done;
+    uint32_t done_head;
+    uint32_t done_count;
+
+    uint32_t queued;                // not yet submitted
+    uint32_t inflight;              // submitted, not yet reaped
+    uint64_t submits;               // io_uring_enter / submit calls
+} pkc_io_t;
+
+PKC_IO_INLINE uint8_t *pkc_io_buffer(pkc_io_t *io, uint32_t idx)
+{
+    return io->buffers + (size_t)idx * io->cfg.buffer_size;
+}
+
+PKC_IO_INLINE bool pkc_io_is_uring(const pkc_io_t *io)
+{
+    return io->backend == PKC_IO_BACKEND_URING;
+}
+
+/* Operations that can be queued before the ring (or fallback queue) is full. */
+PKC_IO_INLINE uint32_t pkc_io_space(const pkc_io_t *io)
+{
+    const uint32_t used = io->queued + io->inflight;
+    return used < io->cfg.entries ? io->cfg.entries - used : 0;
+}
+
+/* ---------------- io_uring backend ---------------- */
+
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+
+static inline void pkc_io_uring_unmap(pkc_io_t *io)
+{
+    if (io->sqes) munmap(io->sqes, io->sqes_len);
+    if (io->cq_map && io->cq_map != io->sq_map) munmap(io->cq_map, io->cq_map_len);
+    if (io->sq_map) munmap(io->sq_map, io->sq_map_len);
+    io->sqes = NULL;
+    io->sq_map = io->cq_map = NULL;
+}
+
+static inline bool pkc_io_uring_setup(pkc_io_t *io)
+{
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    // CQ twice the SQ so completions of a full submission never overflow.
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = io->cfg.entries * 2;
+    const long fd = syscall(__NR_io_uring_setup, io->cfg.entries, &p);
+    if (fd < 0) return false;
+    io->ring_fd = (int)fd;
+
+    io->sq_map_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    io->cq_map_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (io->cq_map_len > io->sq_map_len) io->sq_map_len = io->cq_map_len;
+        io->cq_map_len = io->sq_map_len;
+    }
+    io->sq_map = mmap(NULL, io->sq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, io->ring_fd,
+                      IORING_OFF_SQ_RING);
+    if (io->sq_map == MAP_FAILED) {
+        io->sq_map = NULL;
+        goto fail;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        io->cq_map = io->sq_map;
+    } else {
+        io->cq_map = mmap(NULL, io->cq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, io->ring_fd,
+                          IORING_OFF_CQ_RING);
+        if (io->cq_map == MAP_FAILED) {
+            io->cq_map = NULL;
+            goto fail;
+        }
+    }
+    io->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    io->sqes = (struct io_uring_sqe *)mmap(NULL, io->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                           io->ring_fd, IORING_OFF_SQES);
+    if (io->sqes == MAP_FAILED) {
+        io->sqes = NULL;
+        goto fail;
+    }
+
+    uint8_t *sq = (uint8_t *)io->sq_map;
+    uint8_t *cq = (uint8_t *)io->cq_map;
+    io->sq_head = (_Atomic(unsigned) *)(sq + p.sq_off.head);
+    io->sq_tail = (_Atomic(unsigned) *)(sq + p.sq_off.tail);
+    io->sq_mask = *(unsigned *)(sq + p.sq_off.ring_mask);
+    io->sq_array = (unsigned *)(sq + p.sq_off.array);
+    io->cq_head = (_Atomic(unsigned) *)(cq + p.cq_off.head);
+    io->cq_tail = (_Atomic(unsigned) *)(cq + p.cq_off.tail);
+    io->cq_mask = *(unsigned *)(cq + p.cq_off.ring_mask);
+    io->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    io->cfg.entries = p.sq_entries;
+
+    // One registration for the whole area: fixed ops address into it with buf_index 0.
+    struct iovec iov = { io->buffers, (size_t)io->cfg.buffers * io->cfg.buffer_size };
+    if (syscall(__NR_io_uring_register, io->ring_fd, IORING_REGISTER_BUFFERS, &iov, 1) < 0) goto fail;
+    return true;
+
+fail:
+    pkc_io_uring_unmap(io);
+    close(io->ring_fd);
+    io->ring_fd = -1;
+    return false;
+}
+
+static inline void pkc_io_uring_queue(pkc_io_t *io, const pkc_io_op_t *op)
+{
+    const unsigned tail = atomic_load_explicit(io->sq_tail, memory_order_relaxed);
+    const unsigned idx = tail & io->sq_mask;
+    struct io_uring_sqe *sqe = &io->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = op->fd;
+    sqe->user_data = op->user_data;
+    if (op->flags & PKC_IO_LINK) sqe->flags |= IOSQE_IO_LINK;
+    if (op->flags & PKC_IO_DRAIN) sqe->flags |= IOSQE_IO_DRAIN;
+    if (op->op == PKC_IO_OP_FDATASYNC) {
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    } else {
+        sqe->opcode = op->op == PKC_IO_OP_READ ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+        sqe->addr = (uint64_t)(uintptr_t)pkc_io_buffer(io, op->buf);
+        sqe->len = op->len;
+        sqe->off = op->off;
+        sqe->buf_index = 0;
+    }
+    io->sq_array[idx] = idx;
+    atomic_store_explicit(io->sq_tail, tail + 1, memory_order_release);
+}
+
+static inline OpStatus_t pkc_io_uring_enter(pkc_io_t *io, uint32_t wait_nr)
+{
+    for (;;) {
+        const unsigned flags = wait_nr ? IORING_ENTER_GETEVENTS : 0;
+        const long r = syscall(__NR_io_uring_enter, io->ring_fd, io->queued, wait_nr, flags, NULL, 0);
+        if (r >= 0) {
+            io->inflight += (uint32_t)r;
+            io->queued -= (uint32_t)r;
+            if (io->queued == 0) return OP_SUCCESS;
+            if (r == 0) return OP_INVALID_STATE;
+            continue;
+        }
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+        return OP_INVALID_STATE;
+    }
+}
+
+static inline uint32_t pkc_io_uring_reap(pkc_io_t *io, pkc_io_completion_t *out, uint32_t max)
+{
+    unsigned head = atomic_load_explicit(io->cq_head, memory_order_relaxed);
+    const unsigned tail = atomic_load_explicit(io->cq_tail, memory_order_acquire);
+    uint32_t n = 0;
+    while (head != tail && n < max) {
+        const struct io_uring_cqe *cqe = &io->cqes[head & io->cq_mask];
+        out[n].user_data = cqe->user_data;
+        out[n].res = cqe->res;
+        ++n;
+        ++head;
+    }
+    atomic_store_explicit(io->cq_head, head, memory_order_release);
+    io->inflight -= n;
+    return n;
+}
+
+#else
+
+static inline bool pkc_io_uring_setup(pkc_io_t *io) { (void)io; return false; }
+static inline void pkc_io_uring_unmap(pkc_io_t *io) { (void)io; }
+static inline void pkc_io_uring_queue(pkc_io_t *io, const pkc_io_op_t *op) { (void)io; (void)op; }
+static inline OpStatus_t pkc_io_uring_enter(pkc_io_t *io, uint32_t wait_nr) { (void)io; (void)wait_nr; return OP_INVALID_STATE; }
+static inline uint32_t pkc_io_uring_reap(pkc_io_t *io, pkc_io_completion_t *out, uint32_t max) { (void)io; (void)out; (void)max; return 0; }
+
+#endif
+
+/* ---------------- blocking backend ---------------- */
+
+static inline int32_t pkc_io_blocking_run(pkc_io_t *io, const pkc_io_op_t *op)
+{
+    if (op->op == PKC_IO_OP_FDATASYNC) return fdatasync(op->fd) == 0 ? 0 : -errno;
+
+    uint8_t *p = pkc_io_buffer(io, op->buf);
+    size_t done = 0;
+    while (done < op->len) {
+        const ssize_t r = op->op == PKC_IO_OP_READ
+                              ? pread(op->fd, p + done, op->len - done, (off_t)(op->off + done))
+                              : pwrite(op->fd, p + done, op->len - done, (off_t)(op->off + done));
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return done ? (int32_t)done : -errno;
+        }
+        if (r == 0) break;
+        done += (size_t)r;
+    }
+    return (int32_t)done;
+}
+
+static inline void pkc_io_blocking_submit(pkc_io_t *io)
+{
+    bool chain_failed = false;
+    for (uint32_t i = 0; i < io->queued; ++i) {
+        const pkc_io_op_t *op = &io->ops[i];
+        int32_t res = chain_failed ? -ECANCELED : pkc_io_blocking_run(io, op);
+        const bool short_rw = op->op != PKC_IO_OP_FDATASYNC && res >= 0 && (uint32_t)res < op->len;
+        // Same rule as the ring: a failed or short link cancels the rest of its chain.
+        chain_failed = (op->flags & PKC_IO_LINK) && (chain_failed || res < 0 || short_rw);
+
+        const uint32_t slot = (io->done_head + io->done_count) % (io->cfg.entries * 2);
+        io->done[slot].user_data = op->user_data;
+        io->done[slot].res = res;
+        io->done_count++;
+    }
+    io->inflight += io->queued;
+    io->queued = 0;
+}
+
+/* ---------------- API ---------------- */
+
+static inline void pkc_io_destroy(pkc_io_t *io);
+
+/*
+ * Sets up the backend and its buffers. Falls back to blocking I/O when
+ * the ring cannot be created or the buffers cannot be registered.
+ */
+static inline OpStatus_t pkc_io_init(pkc_io_t *io, const pkc_io_config_t *cfg)
+{
+    if (!io) return OP_NULL_PTR;
+    memset(io, 0, sizeof(*io));
+    io->ring_fd = -1;
+    if (cfg) io->cfg = *cfg;
+    if (io->cfg.entries == 0) io->cfg.entries = PKC_IO_ENTRIES;
+    if (io->cfg.buffers == 0) io->cfg.buffers = PKC_IO_BUFFERS;
+    if (io->cfg.buffer_size == 0) io->cfg.buffer_size = PKC_IO_BUFFER_SIZE;
+    io->cfg.buffer_size = (io->cfg.buffer_size + 4095u) & ~4095u;
+    if (io->cfg.buffers > UINT16_MAX) return OP_INVALID_INPUT;
+
+    io->buffers = (uint8_t *)aligned_alloc(4096, (size_t)io->cfg.buffers * io->cfg.buffer_size);
+    if (!io->buffers) return OP_INVALID_STATE;
+
+    io->backend = !io->cfg.force_blocking && pkc_io_uring_setup(io) ? PKC_IO_BACKEND_URING : PKC_IO_BACKEND_BLOCKING;
+    if (io->backend == PKC_IO_BACKEND_BLOCKING) {
+        io->ops = (pkc_io_op_t *)calloc(io->cfg.entries, sizeof(*io->ops));
+        io->done = (pkc_io_completion_t *)calloc((size_t)io->cfg.entries * 2, sizeof(*io->done));
+        if (!io->ops || !io->done) {
+            pkc_io_destroy(io);
+            return OP_INVALID_STATE;
+        }
+    }
+    return OP_SUCCESS;
+}
+
+static inline void pkc_io_destroy(pkc_io_t *io)
+{
+    if (!io) return;
+    if (io->ring_fd >= 0) {
+        pkc_io_uring_unmap(io);
+        close(io->ring_fd);
+        io->ring_fd = -1;
+    }
+    free(io->ops);
+    free(io->done);
+    free(io->buffers);
+    io->ops = NULL;
+    io->done = NULL;
+    io->buffers = NULL;
+}
+
+/*
+ * Queues one operation on registered buffer `buf` (ignored for
+ * fdatasync). OP_BUFFER_TOO_SMALL when the queue is full: submit and reap
+ * first.
+ */
+static inline OpStatus_t pkc_io_queue(pkc_io_t *io, pkc_io_opcode_t op, int fd, uint32_t buf, uint32_t len,
+                                      uint64_t off, uint64_t user_data, uint32_t flags)
+{
+    if (!io) return OP_NULL_PTR;
+    if (op != PKC_IO_OP_FDATASYNC && (buf >= io->cfg.buffers || len > io->cfg.buffer_size)) return OP_INVALID_INPUT;
+    if (pkc_io_space(io) == 0) return OP_BUFFER_TOO_SMALL;
+
+    const pkc_io_op_t o = { op, fd, buf, len, off, user_data, flags };
+    if (pkc_io_is_uring(io)) pkc_io_uring_queue(io, &o);
+    else io->ops[io->queued] = o;
+    io->queued++;
+    return OP_SUCCESS;
+}
+
+/*
+ * Submits everything queued in one call and, with `wait_nr`, blocks until
+ * at least that many completions are ready to reap.
+ */
+static inline OpStatus_t pkc_io_submit(pkc_io_t *io, uint32_t wait_nr)
+{
+    if (!io) return OP_NULL_PTR;
+    if (io->queued == 0 && wait_nr == 0) return OP_SUCCESS;
+    io->submits++;
+    if (!pkc_io_is_uring(io)) {
+        pkc_io_blocking_submit(io);
+        return OP_SUCCESS;
+    }
+    if (wait_nr > io->inflight + io->queued) wait_nr = io->inflight + io->queued;
+    return pkc_io_uring_enter(io, wait_nr);
+}
+
+/* Pops up to `max` completions without blocking. */
+static inline uint32_t pkc_io_reap(pkc_io_t *io, pkc_io_completion_t *out, uint32_t max)
+{
+    if (!io || !out) return 0;
+    if (pkc_io_is_uring(io)) return pkc_io_uring_reap(io, out, max);
+
+    uint32_t n = 0;
+    while (io->done_count > 0 && n < max) {
+        out[n++] = io->done[io->done_head];
+        io->done_head = (io->done_head + 1) % (io->cfg.entries * 2);
+        io->done_count--;
+    }
+    io->inflight -= n;
+    return n;
+}
+
+#endif // PKC_CHAIN_IO_H
@@ -0,0 +1,957 @@
+#ifndef PKC_CHAIN_SNAPSHOT_H
+#define PKC_CHAIN_SNAPSHOT_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "blockchain/block.h"
+#include "blockchain/blockView_ops.h"
+#include "blockhain/PKCertChain.h"
+#include "blockchain/chainWriter_ops.h"
+#include "blockchain/chainStore_ops.h"
+#include "blockchain/chainIo_ops.h"
+#include "scheduler/workPool_ops.h"
+#include "core/enums/OpStatus.h"
+#include "telemetry/metrics_ops.h"
+
+#ifndef PKC_SNAPSHOT_INLINE
+#define PKC_SNAPSHOT_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Streaming chain snapshots for bootstrapping a node.
+ *
+ *   header (160)  magic "PKCS" | version | complexity | next_challenge_id |
+ *                 blocks | chunk_blocks | tier complexity[4] |
+ *                 NetworkName[64] | tier target bits[4] | hash256(header)
+ *   chunk  (64 + payload)  magic "PKCK" | codec | first | count | raw_len |
+ *                 payload_len | hash256(raw) ; payload
+ *   trailer (64)  magic "PKCE" | chunks | blocks | hash256(all chunk hashes)
+ *
+ * A chunk's raw bytes are `count` canonical block_serialize records of
+ * BLOCK_SERIALIZED_SIZE, PoW results included, so an import with
+ * `require_pow` has the solutions to check. It also checks every prevHash
+ * link and that each challenge is the one the tier's previous block
+ * issues (pkc_block_pow_follows); the solutions and the links inside a
+ * chunk are checked in parallel, the rest in order before `apply`. The
+ * payload is either those bytes or their zero-run encoding, whichever is
+ * smaller. The trailer hash binds the chunk list, so truncated, dropped
+ * or reordered chunks are caught before any block is handed over.
+ *
+ * The header carries each tier's complexity field and, in target mode,
+ * the compact target the difficulty controller issues it (both in
+ * tier_pow_chain_fields order), so a node bootstrapped from the snapshot
+ * issues and checks the same challenges as the one that exported it.
+ *
+ * Export runs in windows of chunks: the work pool reads, serializes,
+ * hashes and compresses a window in parallel, then the frames stream out
+ * through pkc_io (registered buffers, one fdatasync at the end). From a
+ * running writer it captures the tip once and reads the committed blocks
+ * below it, which the writer never rewrites, so appends continue
+ * throughout. Import maps the file, checks the frame list against the
+ * trailer, then decodes, hashes and validates each window in parallel and
+ * hands the chunks to `apply` in order on the calling thread.
+ */
+
+#define PKC_SNAPSHOT_MAGIC "PKCS"
+#define PKC_SNAPSHOT_CHUNK_MAGIC "PKCK"
+#define PKC_SNAPSHOT_END_MAGIC "PKCE"
+#define PKC_SNAPSHOT_MAGIC_LEN 4
+#define PKC_SNAPSHOT_VERSION 3
+#define PKC_SNAPSHOT_HEADER_SIZE 160
+#define PKC_SNAPSHOT_CHUNK_HEADER_SIZE 64
+#define PKC_SNAPSHOT_TRAILER_SIZE 64
+#define PKC_SNAPSHOT_RECORD_SIZE BLOCK_SERIALIZED_SIZE
+
+#ifndef PKC_SNAPSHOT_CHUNK_BLOCKS
+#define PKC_SNAPSHOT_CHUNK_BLOCKS 1024
+#endif
+
+#define PKC_SNAPSHOT_WINDOW_MAX 256
+
+typedef enum {
+    PKC_SNAPSHOT_CODEC_RAW = 0,
+    PKC_SNAPSHOT_CODEC_ZRLE = 1,
+} pkc_snapshot_codec_t;
+
+typedef struct {
+    uint32_t chunk_blocks;          // 0: PKC_SNAPSHOT_CHUNK_BLOCKS
+    uint32_t window_chunks;         // chunks in flight; 0: twice the pool workers
+    bool no_compress;               // always store raw payloads
+    bool require_pow;               // import: re-check each block's link and TierPoW
+    pkc_io_config_t io;             // export writes
+} pkc_snapshot_config_t;
+
+typedef struct {
+    char NetworkName[64];
+    uint8_t complexity;
+    uint64_t next_challenge_id;
+    uint64_t blocks;
+    uint8_t tier_complexity[TIER_POW_DIFFICULTY_TIERS];     // tier_pow_chain_fields order
+    uint32_t target_bits[TIER_POW_DIFFICULTY_TIERS];        // likewise; 0 outside target mode
+} pkc_snapshot_meta_t;
+
+typedef struct {
+    uint64_t blocks;
+    uint64_t chunks;
+    uint64_t raw_bytes;             // serialized blocks
+    uint64_t file_bytes;
+    uint64_t elapsed_ns;
+} pkc_snapshot_stats_t;
+
+/*
+ * Export source: blocks [first, first + count). Either fill `scratch` and
+ * point `*out` at it, or point `*out` at the source's own storage.
+ * Called from pool workers concurrently.
+ */
+typedef OpStatus_t (*pkc_snapshot_read_fn)(void *ctx, uint64_t first, uint32_t count, block *scratch,
+                                           const block **out);
+
+/* Import sink: blocks [first, first + count), called in order on the importing thread. */
+typedef OpStatus_t (*pkc_snapshot_apply_fn)(void *ctx, uint64_t first, const block *blocks, uint32_t count);
+
+/* ---------------- zero-run codec ---------------- */
+
+/*
+ * Token stream: t < 0x80 is a literal of t + 1 bytes; 0x80 <= t < 0xFF a
+ * run of t - 0x7F zeros; 0xFF a run of zeros whose length (u16 BE) follows.
+ * Zero runs shorter than 4 stay in literals.
+ */
+
+/* Appends a literal run; false once the output would reach `n`. */
+PKC_SNAPSHOT_INLINE bool pkc_snapshot_zrle_literal(const uint8_t *p, size_t k, uint8_t *out, size_t *o, size_t n)
+{
+    while (k > 0) {
+        const size_t m = k < 128 ? k : 128;
+        if (*o + 1 + m >= n) return false;
+        out[(*o)++] = (uint8_t)(m - 1);
+        memcpy(out + *o, p, m);
+        *o += m;
+        p += m;
+        k -= m;
+    }
+    return true;
+}
+
+/* Encodes `in`; returns the encoded length, or 0 when it would not be smaller than `n`. */
+static inline size_t pkc_snapshot_zrle_encode(const uint8_t *in, size_t n, uint8_t *out)
+{
+    size_t o = 0, i = 0, lit = 0;       // lit: start of the pending literal
+    while (i < n) {
+        if (in[i] != 0) {
+            ++i;
+            continue;
+        }
+        size_t z = 0;
+        while (i + z < n && in[i + z] == 0 && z < UINT16_MAX) ++z;
+        if (z < 4) {
+            i += z;
+            continue;
+        }
+        if (!pkc_snapshot_zrle_literal(in + lit, i - lit, out, &o, n)) return 0;
+        if (z < 128) {
+            if (o + 1 >= n) return 0;
+            out[o++] = (uint8_t)(0x7F + z);
+        } else {
+            if (o + 3 >= n) return 0;
+            out[o++] = 0xFF;
+            out[o++] = (uint8_t)(z >> 8);
+            out[o++] = (uint8_t)z;
+        }
+        i += z;
+        lit = i;
+    }
+    if (!pkc_snapshot_zrle_literal(in + lit, n - lit, out, &o, n)) return 0;
+    return o;
+}
+
+/* Decodes exactly `n` bytes; false on malformed or short input. */
+static inline bool pkc_snapshot_zrle_decode(const uint8_t *in, size_t len, uint8_t *out, size_t n)
+{
+    size_t i = 0, o = 0;
+    while (i < len) {
+        const uint8_t t = in[i++];
+        if (t < 0x80) {
+            const size_t k = (size_t)t + 1;
+            if (i + k > len || o + k > n) return false;
+            memcpy(out + o, in + i, k);
+            i += k;
+            o += k;
+            continue;
+        }
+        size_t z;
+        if (t == 0xFF) {
+            if (i + 2 > len) return false;
+            z = ((size_t)in[i] << 8) | in[i + 1];
+            i += 2;
+        } else {
+            z = (size_t)t - 0x7F;
+        }
+        if (o + z > n) return false;
+        memset(out + o, 0, z);
+        o += z;
+    }
+    return o == n;
+}
+
+/* ---------------- output stream ---------------- */
+
+typedef struct {
+    pkc_io_t io;
+    int fd;
+    uint64_t off;                   // file offset of the current buffer
+    uint32_t cur;
+    uint32_t fill;
+    uint64_t free;                  // buffers not in flight (cur excluded)
+    OpStatus_t error;
+} pkc_snapshot_sink_t;
+
+static inline void pkc_snapshot_sink_reap(pkc_snapshot_sink_t *s, bool wait)
+{
+    if (pkc_io_submit(&s->io, wait ? 1 : 0) != OP_SUCCESS) s->error = OP_INVALID_STATE;
+    pkc_io_completion_t done[PKC_IO_ENTRIES];
+    uint32_t n;
+    while ((n = pkc_io_reap(&s->io, done, PKC_IO_ENTRIES)) > 0) {
+        for (uint32_t i = 0; i < n; ++i) {
+            const uint64_t len = done[i].user_data >> 16;
+            if (len == 0) {             // fdatasync
+                if (done[i].res < 0) s->error = OP_INVALID_STATE;
+                continue;
+            }
+            s->free |= 1ULL << (done[i].user_data & 0xFFFF);
+            if (done[i].res < 0 || (uint64_t)done[i].res != len) s->error = OP_INVALID_STATE;
+        }
+    }
+}
+
+/* Queues the current buffer and moves to a free one. */
+static inline void pkc_snapshot_sink_rotate(pkc_snapshot_sink_t *s)
+{
+    if (s->fill == 0) return;
+    if (pkc_io_queue(&s->io, PKC_IO_OP_WRITE, s->fd, s->cur, s->fill, s->off,
+                     (uint64_t)s->cur | ((uint64_t)s->fill << 16), 0) != OP_SUCCESS) {
+        s->error = OP_INVALID_STATE;
+        return;
+    }
+    s->off += s->fill;
+    s->fill = 0;
+    pkc_snapshot_sink_reap(s, false);
+    while (s->free == 0 && s->error == OP_SUCCESS) pkc_snapshot_sink_reap(s, true);
+    if (s->free == 0) return;
+    s->cur = (uint32_t)__builtin_ctzll(s->free);
+    s->free &= ~(1ULL << s->cur);
+}
+
+static inline void pkc_snapshot_sink_put(pkc_snapshot_sink_t *s, const uint8_t *p, size_t n)
+{
+    while (n > 0 && s->error == OP_SUCCESS) {
+        const size_t room = s->io.cfg.buffer_size - s->fill;
+        const size_t k = n < room ? n : room;
+        memcpy(pkc_io_buffer(&s->io, s->cur) + s->fill, p, k);
+        s->fill += (uint32_t)k;
+        p += k;
+        n -= k;
+        if (s->fill == s->io.cfg.buffer_size) pkc_snapshot_sink_rotate(s);
+    }
+}
+
+static inline OpStatus_t pkc_snapshot_sink_open(pkc_snapshot_sink_t *s, const char *path, const pkc_io_config_t *cfg)
+{
+    memset(s, 0, sizeof(*s));
+    pkc_io_config_t io_cfg = cfg ? *cfg : (pkc_io_config_t){0};
+    if (io_cfg.buffers == 0) io_cfg.buffers = PKC_IO_BUFFERS;
+    if (io_cfg.buffers > 64) io_cfg.buffers = 64;
+    if (io_cfg.entries < io_cfg.buffers + 1) io_cfg.entries = io_cfg.buffers + 1;
+    s->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (s->fd < 0) return OP_INVALID_INPUT;
+    if (pkc_io_init(&s->io, &io_cfg) != OP_SUCCESS) {
+        close(s->fd);
+        return OP_INVALID_INPUT;
+    }
+    s->free = (s->io.cfg.buffers == 64 ? ~0ULL : (1ULL << s->io.cfg.buffers) - 1) & ~1ULL;
+    s->cur = 0;
+    return OP_SUCCESS;
+}
+
+/* Writes the tail, waits for every write, fdatasyncs and closes. */
+static inline OpStatus_t pkc_snapshot_sink_close(pkc_snapshot_sink_t *s)
+{
+    if (s->error == OP_SUCCESS && s->fill > 0) pkc_snapshot_sink_rotate(s);
+    if (s->error == OP_SUCCESS &&
+        pkc_io_queue(&s->io, PKC_IO_OP_FDATASYNC, s->fd, 0, 0, 0, 0, PKC_IO_DRAIN) != OP_SUCCESS)
+        s->error = OP_INVALID_STATE;
+    while (s->io.inflight + s->io.queued > 0) {
+        const uint32_t before = s->io.inflight + s->io.queued;
+        pkc_snapshot_sink_reap(s, true);
+        if (s->error != OP_SUCCESS && s->io.inflight + s->io.queued == before) break;
+    }
+    pkc_io_destroy(&s->io);
+    if (close(s->fd) != 0 && s->error == OP_SUCCESS) s->error = OP_INVALID_STATE;
+    s->fd = -1;
+    return s->error;
+}
+
+/* ---------------- chunks ---------------- */
+
+typedef struct {
+    uint64_t first;
+    uint32_t count;
+    uint8_t codec;
+    uint32_t raw_len;
+    uint32_t payload_len;
+    uint8_t hash[UINT256_SIZE];
+    const uint8_t *payload;         // import: into the mapping
+    uint256 tail;                   // import with require_pow: block_link_hash of the last block
+    OpStatus_t status;
+} pkc_snapshot_chunk_t;
+
+static inline void pkc_snapshot_chunk_header(const pkc_snapshot_chunk_t *c, uint8_t *out)
+{
+    memset(out, 0, PKC_SNAPSHOT_CHUNK_HEADER_SIZE);
+    memcpy(out, PKC_SNAPSHOT_CHUNK_MAGIC, PKC_SNAPSHOT_MAGIC_LEN);
+    out[4] = c->codec;
+    serialize_u64_be(c->first, out + 8);
+    serialize_u32_be(c->count, out + 16);
+    serialize_u32_be(c->raw_len, out + 20);
+    serialize_u32_be(c->payload_len, out + 24);
+    memcpy(out + 32, c->hash, UINT256_SIZE);
+}
+
+static inline bool pkc_snapshot_chunk_parse(const uint8_t *in, pkc_snapshot_chunk_t *c)
+{
+    if (memcmp(in, PKC_SNAPSHOT_CHUNK_MAGIC, PKC_SNAPSHOT_MAGIC_LEN) != 0) return false;
+    c->codec = in[4];
+    deserialize_u64_be(in + 8, &c->first, sizeof(uint64_t));
+    deserialize_u32_be(in + 16, &c->count, sizeof(uint32_t));
+    deserialize_u32_be(in + 20, &c->raw_len, sizeof(uint32_t));
+    deserialize_u32_be(in + 24, &c->payload_len, sizeof(uint32_t));
+    memcpy(c->hash, in + 32, UINT256_SIZE);
+    return c->codec <= PKC_SNAPSHOT_CODEC_ZRLE && c->raw_len == (uint64_t)c->count * PKC_SNAPSHOT_RECORD_SIZE &&
+           c->payload_len <= c->raw_len;
+}
+
+PKC_SNAPSHOT_INLINE void pkc_snapshot_hash(const uint8_t *p, size_t n, uint8_t out[UINT256_SIZE])
+{
+    uint256 h;
+    hash256_buffer(p, n, &h);
+    uint256_serialize_be(&h, out, UINT256_SIZE);
+}
+
+/* Work-pool window shared by export and import. */
+typedef struct {
+    const pkc_snapshot_config_t *cfg;
+    pkc_snapshot_chunk_t *chunks;   // this window
+    uint32_t nchunks;
+    _Atomic(uint32_t) next;
+    uint8_t **raw;                  // per window slot, raw_len capacity
+    uint8_t **payload;              // export: encoded payload per slot
+    block **blocks;                 // per window slot, chunk_blocks each
+    pkc_snapshot_read_fn read;
+    void *read_ctx;
+} pkc_snapshot_job_t;
+
+PKC_SNAPSHOT_INLINE uint32_t pkc_snapshot_threads(void)
+{
+    const uint32_t workers = pkc_pool_workers(pkc_pool_default());
+    return workers ? workers : 1;
+}
+
+static inline void pkc_snapshot_free_slots(pkc_snapshot_job_t *job, uint32_t slots)
+{
+    for (uint32_t i = 0; i < slots; ++i) {
+        if (job->raw) free(job->raw[i]);
+        if (job->payload) free(job->payload[i]);
+        if (job->blocks) free(job->blocks[i]);
+    }
+    free(job->raw);
+    free(job->payload);
+    free(job->blocks);
+    free(job->chunks);
+}
+
+static inline OpStatus_t pkc_snapshot_alloc_slots(pkc_snapshot_job_t *job, uint32_t slots, uint32_t chunk_blocks,
+                                                  bool payload)
+{
+    job->chunks = (pkc_snapshot_chunk_t *)calloc(slots, sizeof(*job->chunks));
+    job->raw = (uint8_t **)calloc(slots, sizeof(*job->raw));
+    job->payload = payload ? (uint8_t **)calloc(slots, sizeof(*job->payload)) : NULL;
+    job->blocks = (block **)calloc(slots, sizeof(*job->blocks));
+    if (!job->chunks || !job->raw || !job->blocks || (payload && !job->payload)) return OP_INVALID_INPUT;
+    for (uint32_t i = 0; i < slots; ++i) {
+        job->raw[i] = (uint8_t *)malloc((size_t)chunk_blocks * PKC_SNAPSHOT_RECORD_SIZE);
+        job->blocks[i] = (block *)malloc((size_t)chunk_blocks * sizeof(block));
+        if (payload) job->payload[i] = (uint8_t *)malloc((size_t)chunk_blocks * PKC_SNAPSHOT_RECORD_SIZE);
+        if (!job->raw[i] || !job->blocks[i] || (payload && !job->payload[i])) return OP_INVALID_INPUT;
+    }
+    return OP_SUCCESS;
+}
+
+static inline uint32_t pkc_snapshot_window(const pkc_snapshot_config_t *cfg)
+{
+    uint32_t w = cfg->window_chunks ? cfg->window_chunks : 2 * pkc_snapshot_threads();
+    if (w < 2) w = 2;
+    return w > PKC_SNAPSHOT_WINDOW_MAX ? PKC_SNAPSHOT_WINDOW_MAX : w;
+}
+
+/* ---------------- records ---------------- */
+
+static inline OpStatus_t pkc_snapshot_serialize_records(const block *blocks, uint32_t n, uint8_t *raw)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        uint8_t *out = raw + (size_t)i * PKC_SNAPSHOT_RECORD_SIZE;
+        memset(out, 0, PKC_SNAPSHOT_RECORD_SIZE);
+        OpStatus_t st = block_serialize(&blocks[i], out, PKC_SNAPSHOT_RECORD_SIZE);
+        if (st != OP_SUCCESS) return st;
+    }
+    return OP_SUCCESS;
+}
+
+static inline OpStatus_t pkc_snapshot_deserialize_records(const uint8_t *raw, block *blocks, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        OpStatus_t st = block_deserialize(raw + (size_t)i * PKC_SNAPSHOT_RECORD_SIZE, PKC_SNAPSHOT_RECORD_SIZE, &blocks[i]);
+        if (st != OP_SUCCESS) return st;
+    }
+    return OP_SUCCESS;
+}
+
+/* ---------------- export ---------------- */
+
+static inline void pkc_snapshot_encode_chunk(pkc_snapshot_job_t *job, uint32_t slot)
+{
+    pkc_snapshot_chunk_t *c = &job->chunks[slot];
+    const block *blocks = NULL;
+    c->status = job->read(job->read_ctx, c->first, c->count, job->blocks[slot], &blocks);
+    if (c->status != OP_SUCCESS) return;
+
+    uint8_t *raw = job->raw[slot];
+    c->status = pkc_snapshot_serialize_records(blocks, c->count, raw);
+    if (c->status != OP_SUCCESS) return;
+    pkc_snapshot_hash(raw, c->raw_len, c->hash);
+
+    const size_t enc = job->cfg->no_compress ? 0 : pkc_snapshot_zrle_encode(raw, c->raw_len, job->payload[slot]);
+    c->codec = enc ? PKC_SNAPSHOT_CODEC_ZRLE : PKC_SNAPSHOT_CODEC_RAW;
+    c->payload_len = enc ? (uint32_t)enc : c->raw_len;
+    c->payload = enc ? job->payload[slot] : raw;
+}
+
+static inline void pkc_snapshot_encode_worker(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)cancel;
+    pkc_snapshot_job_t *job = (pkc_snapshot_job_t *)arg;
+    uint32_t slot;
+    while ((slot = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed)) < job->nchunks)
+        pkc_snapshot_encode_chunk(job, slot);
+}
+
+static inline void pkc_snapshot_header(const pkc_snapshot_meta_t *meta, uint32_t chunk_blocks, uint8_t *out)
+{
+    memset(out, 0, PKC_SNAPSHOT_HEADER_SIZE);
+    memcpy(out, PKC_SNAPSHOT_MAGIC, PKC_SNAPSHOT_MAGIC_LEN);
+    out[4] = PKC_SNAPSHOT_VERSION;
+    out[5] = meta->complexity;
+    serialize_u64_be(meta->next_challenge_id, out + 8);
+    serialize_u64_be(meta->blocks, out + 16);
+    serialize_u32_be(chunk_blocks, out + 24);
+    memcpy(out + 28, meta->tier_complexity, TIER_POW_DIFFICULTY_TIERS);
+    memcpy(out + 32, meta->NetworkName, 64);
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) serialize_u32_be(meta->target_bits[t], out + 96 + 4 * t);
+    pkc_snapshot_hash(out, PKC_SNAPSHOT_HEADER_SIZE - UINT256_SIZE, out + PKC_SNAPSHOT_HEADER_SIZE - UINT256_SIZE);
+}
+
+/*
+ * Writes `meta->blocks` blocks from `read` to `path`. The source is read
+ * concurrently by pool workers; the file is replaced and fdatasync'ed.
+ */
+static inline OpStatus_t pkc_snapshot_export(const char *path, const pkc_snapshot_meta_t *meta,
+                                             pkc_snapshot_read_fn read, void *read_ctx,
+                                             const pkc_snapshot_config_t *cfg, pkc_snapshot_stats_t *stats)
+{
+    if (!path || !meta || !read) return OP_NULL_PTR;
+    const pkc_snapshot_config_t def = {0};
+    if (!cfg) cfg = &def;
+    const uint32_t chunk_blocks = cfg->chunk_blocks ? cfg->chunk_blocks : PKC_SNAPSHOT_CHUNK_BLOCKS;
+    if ((uint64_t)chunk_blocks * PKC_SNAPSHOT_RECORD_SIZE > UINT32_MAX) return OP_INVALID_INPUT;
+    const uint32_t window = pkc_snapshot_window(cfg);
+    const uint64_t start = pkc_metrics_now_ns();
+
+    pkc_snapshot_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.cfg = cfg;
+    job.read = read;
+    job.read_ctx = read_ctx;
+    OpStatus_t st = pkc_snapshot_alloc_slots(&job, window, chunk_blocks, true);
+    const uint64_t nchunks_total = (meta->blocks + chunk_blocks - 1) / chunk_blocks;
+    uint8_t *hashes = (uint8_t *)malloc((size_t)(nchunks_total ? nchunks_total : 1) * UINT256_SIZE);
+    if (st != OP_SUCCESS || !hashes) {
+        pkc_snapshot_free_slots(&job, window);
+        free(hashes);
+        return OP_INVALID_INPUT;
+    }
+
+    pkc_snapshot_sink_t sink;
+    if ((st = pkc_snapshot_sink_open(&sink, path, &cfg->io)) != OP_SUCCESS) {
+        pkc_snapshot_free_slots(&job, window);
+        free(hashes);
+        return st;
+    }
+    uint8_t hdr[PKC_SNAPSHOT_HEADER_SIZE];
+    pkc_snapshot_header(meta, chunk_blocks, hdr);
+    pkc_snapshot_sink_put(&sink, hdr, sizeof(hdr));
+
+    uint64_t raw_bytes = 0, chunk = 0;
+    for (uint64_t first = 0; first < meta->blocks && st == OP_SUCCESS && sink.error == OP_SUCCESS;) {
+        job.nchunks = 0;
+        atomic_store(&job.next, 0);
+        for (; job.nchunks < window && first < meta->blocks; ++job.nchunks) {
+            pkc_snapshot_chunk_t *c = &job.chunks[job.nchunks];
+            memset(c, 0, sizeof(*c));
+            c->first = first;
+            c->count = meta->blocks - first < chunk_blocks ? (uint32_t)(meta->blocks - first) : chunk_blocks;
+            c->raw_len = c->count * PKC_SNAPSHOT_RECORD_SIZE;
+            first += c->count;
+        }
+        pkc_pool_fork_join(pkc_pool_default(), PKC_POOL_PRIO_VALIDATE, pkc_snapshot_threads(),
+                           pkc_snapshot_encode_worker, &job, NULL);
+
+        for (uint32_t i = 0; i < job.nchunks; ++i) {
+            const pkc_snapshot_chunk_t *c = &job.chunks[i];
+            if ((st = c->status) != OP_SUCCESS) break;
+            uint8_t ch[PKC_SNAPSHOT_CHUNK_HEADER_SIZE];
+            pkc_snapshot_chunk_header(c, ch);
+            pkc_snapshot_sink_put(&sink, ch, sizeof(ch));
+            pkc_snapshot_sink_put(&sink, c->payload, c->payload_len);
+            memcpy(hashes + chunk * UINT256_SIZE, c->hash, UINT256_SIZE);
+            raw_bytes += c->raw_len;
+            chunk++;
+        }
+    }
+
+    uint8_t trailer[PKC_SNAPSHOT_TRAILER_SIZE];
+    memset(trailer, 0, sizeof(trailer));
+    memcpy(trailer, PKC_SNAPSHOT_END_MAGIC, PKC_SNAPSHOT_MAGIC_LEN);
+    serialize_u64_be(chunk, trailer + 8);
+    serialize_u64_be(meta->blocks, trailer + 16);
+    pkc_snapshot_hash(hashes, (size_t)chunk * UINT256_SIZE, trailer + 32);
+    pkc_snapshot_sink_put(&sink, trailer, sizeof(trailer));
+    const uint64_t file_bytes = sink.off + sink.fill;
+
+    const OpStatus_t io_st = pkc_snapshot_sink_close(&sink);
+    if (st == OP_SUCCESS) st = io_st;
+    pkc_snapshot_free_slots(&job, window);
+    free(hashes);
+    if (st != OP_SUCCESS) {
+        unlink(path);
+        return st;
+    }
+    if (stats) {
+        stats->blocks = meta->blocks;
+        stats->chunks = chunk;
+        stats->raw_bytes = raw_bytes;
+        stats->file_bytes = file_bytes;
+        stats->elapsed_ns = pkc_metrics_now_ns() - start;
+    }
+    return OP_SUCCESS;
+}
+
+/* Source over chain->blocks, read in place (no copy). */
+static inline OpStatus_t pkc_snapshot_read_chain(void *ctx, uint64_t first, uint32_t count, block *scratch,
+                                                 const block **out)
+{
+    (void)scratch;
+    const PKCertChain *chain = (const PKCertChain *)ctx;
+    if (first + count > PKC_CHAIN_CAPACITY(chain)) return OP_INVALID_INPUT;
+    *out = &chain->blocks[first];
+    return OP_SUCCESS;
+}
+
+/* Per-tier difficulty for the header, from complexity fields in tier_pow_chain_fields order. */
+PKC_SNAPSHOT_INLINE void pkc_snapshot_meta_tiers(pkc_snapshot_meta_t *meta, const uint8_t *complexity)
+{
+    tier_pow_difficulty_t *ctl = tier_pow_difficulty_default();
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        meta->tier_complexity[t] = complexity[t];
+        meta->target_bits[t] = ctl->cfg.version == TIER_POW_VERSION_TARGET
+                                   ? tier_pow_difficulty_target_bits(ctl, tier_pow_chain_fields[t].tier, complexity[t])
+                                   : 0;
+    }
+}
+
+PKC_SNAPSHOT_INLINE void pkc_snapshot_meta_from_chain(const PKCertChain *chain, uint64_t blocks,
+                                                      pkc_snapshot_meta_t *meta)
+{
+    memset(meta, 0, sizeof(*meta));
+    memcpy(meta->NetworkName, chain->NetworkName, sizeof(meta->NetworkName));
+    meta->complexity = chain->complexity;
+    meta->next_challenge_id = chain->next_challenge_id;
+    meta->blocks = blocks;
+    uint8_t complexity[TIER_POW_DIFFICULTY_TIERS];
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t)
+        complexity[t] = tier_pow_chain_complexity(chain, &tier_pow_chain_fields[t]);
+    pkc_snapshot_meta_tiers(meta, complexity);
+}
+
+/* Snapshot of a chain nobody is appending to. */
+static inline OpStatus_t pkc_snapshot_export_chain(const char *path, const PKCertChain *chain,
+                                                   const pkc_snapshot_config_t *cfg, pkc_snapshot_stats_t *stats)
+{
+    if (!chain) return OP_NULL_PTR;
+    pkc_snapshot_meta_t meta;
+    pkc_snapshot_meta_from_chain(chain, chain->index, &meta);
+    return pkc_snapshot_export(path, &meta, pkc_snapshot_read_chain, (void *)chain, cfg, stats);
+}
+
+/*
+ * Snapshot of a running writer's chain as of the tip at the call. Appends
+ * keep going: blocks below the captured index are never rewritten.
+ */
+static inline OpStatus_t pkc_snapshot_export_writer(const char *path, pkc_chain_writer_t *w,
+                                                    const pkc_snapshot_config_t *cfg, pkc_snapshot_stats_t *stats)
+{
+    if (!w) return OP_NULL_PTR;
+    pkc_chain_tip_t tip = {0};
+    OpStatus_t st = pkc_chain_tip_copy(w, &tip);
+    if (st != OP_SUCCESS) return st;
+    pkc_snapshot_meta_t meta;
+    pkc_snapshot_meta_from_chain(w->chain, tip.index, &meta);
+    pkc_snapshot_meta_tiers(&meta, tip.complexity);     // as of the captured tip
+    return pkc_snapshot_export(path, &meta, pkc_snapshot_read_chain, w->chain, cfg, stats);
+}
+
+/* ---------------- import ---------------- */
+
+/* Checks a header's magic, version and hash and reads its fields. */
+static inline bool pkc_snapshot_parse_header(const uint8_t *hdr, pkc_snapshot_meta_t *meta, uint32_t *chunk_blocks)
+{
+    uint8_t h[UINT256_SIZE];
+    pkc_snapshot_hash(hdr, PKC_SNAPSHOT_HEADER_SIZE - UINT256_SIZE, h);
+    if (memcmp(hdr, PKC_SNAPSHOT_MAGIC, PKC_SNAPSHOT_MAGIC_LEN) != 0 || hdr[4] != PKC_SNAPSHOT_VERSION ||
+        memcmp(h, hdr + PKC_SNAPSHOT_HEADER_SIZE - UINT256_SIZE, UINT256_SIZE) != 0)
+        return false;
+    memset(meta, 0, sizeof(*meta));
+    meta->complexity = hdr[5];
+    deserialize_u64_be(hdr + 8, &meta->next_challenge_id, sizeof(uint64_t));
+    deserialize_u64_be(hdr + 16, &meta->blocks, sizeof(uint64_t));
+    deserialize_u32_be(hdr + 24, chunk_blocks, sizeof(uint32_t));
+    memcpy(meta->tier_complexity, hdr + 28, TIER_POW_DIFFICULTY_TIERS);
+    memcpy(meta->NetworkName, hdr + 32, 64);
+    meta->NetworkName[63] = '\0';
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t)
+        deserialize_u32_be(hdr + 96 + 4 * t, &meta->target_bits[t], sizeof(uint32_t));
+    return *chunk_blocks != 0 && (uint64_t)*chunk_blocks * PKC_SNAPSHOT_RECORD_SIZE <= UINT32_MAX;
+}
+
+/* Reads a snapshot's metadata from its header alone, without touching the chunks. */
+static inline OpStatus_t pkc_snapshot_read_meta(const char *path, pkc_snapshot_meta_t *meta)
+{
+    if (!path || !meta) return OP_NULL_PTR;
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return OP_INVALID_INPUT;
+    uint8_t hdr[PKC_SNAPSHOT_HEADER_SIZE];
+    const ssize_t got = pkc_chain_store_pread(fd, hdr, sizeof(hdr), 0);
+    close(fd);
+    uint32_t chunk_blocks;
+    if (got != (ssize_t)sizeof(hdr) || !pkc_snapshot_parse_header(hdr, meta, &chunk_blocks)) return OP_INVALID_INPUT;
+    return OP_SUCCESS;
+}
+
+static inline void pkc_snapshot_decode_chunk(pkc_snapshot_job_t *job, uint32_t slot)
+{
+    pkc_snapshot_chunk_t *c = &job->chunks[slot];
+    const uint8_t *raw = c->payload;
+    if (c->codec == PKC_SNAPSHOT_CODEC_ZRLE) {
+        if (!pkc_snapshot_zrle_decode(c->payload, c->payload_len, job->raw[slot], c->raw_len)) {
+            c->status = OP_INVALID_INPUT;
+            return;
+        }
+        raw = job->raw[slot];
+    } else if (c->payload_len != c->raw_len) {
+        c->status = OP_INVALID_INPUT;
+        return;
+    }
+    uint8_t h[UINT256_SIZE];
+    pkc_snapshot_hash(raw, c->raw_len, h);
+    if (memcmp(h, c->hash, UINT256_SIZE) != 0) {
+        c->status = OP_INVALID_INPUT;
+        return;
+    }
+
+    // Same rules as pkc_chain_validate (genesis carries no tier), read off
+    // the wire bytes so a bad chunk is rejected before anything is decoded.
+    for (uint32_t i = 0; i < c->count; ++i) {
+        const block_view view = { raw + (size_t)i * PKC_SNAPSHOT_RECORD_SIZE, PKC_SNAPSHOT_RECORD_SIZE };
+        const uint64_t height = c->first + i;
+        if (block_view_height(&view) != height || (height > 0 && !tier_pow_chain_field(block_view_tier(&view)))) {
+            c->status = OP_INVALID_STATE;
+            return;
+        }
+    }
+    block *blocks = job->blocks[slot];
+    if (pkc_snapshot_deserialize_records(raw, blocks, c->count) != OP_SUCCESS) {
+        c->status = OP_INVALID_INPUT;
+        return;
+    }
+    if (job->cfg->require_pow) {
+        // Links inside the chunk and the solutions here; the link into it and
+        // the challenges need the blocks before it (pkc_snapshot_check_chunk).
+        for (uint32_t i = 0; i < c->count; ++i) {
+            if (i > 0 && (block_link_hash(&blocks[i - 1], &c->tail) != OP_SUCCESS ||
+                          memcmp(&blocks[i].prevHash, &c->tail, sizeof(uint256)) != 0)) {
+                c->status = OP_INVALID_INPUT;
+                return;
+            }
+            if (c->first + i > 0 && !pkc_block_pow_valid(&blocks[i])) {
+                c->status = OP_INVALID_INPUT;
+                return;
+            }
+        }
+        if (block_link_hash(&blocks[c->count - 1], &c->tail) != OP_SUCCESS) {
+            c->status = OP_INVALID_INPUT;
+            return;
+        }
+    }
+    c->status = OP_SUCCESS;
+}
+
+/* What a require_pow import checks the next chunk against, carried across chunks. */
+typedef struct {
+    uint256 tail;                               // block_link_hash of the last block checked
+    block ref[TIER_POW_DIFFICULTY_TIERS];       // newest block of each tier, genesis before the first
+} pkc_snapshot_links_t;
+
+/*
+ * The sequential half of a require_pow import: the chunk's first block
+ * links to the block before it, and every block's challenge is the one its
+ * tier's newest block before it issues (pkc_block_pow_follows).
+ */
+static inline OpStatus_t pkc_snapshot_check_chunk(pkc_snapshot_links_t *l, const pkc_snapshot_chunk_t *c,
+                                                  const block *blocks)
+{
+    if (c->first > 0 && memcmp(&blocks[0].prevHash, &l->tail, sizeof(uint256)) != 0) return OP_INVALID_INPUT;
+    for (uint32_t i = 0; i < c->count; ++i) {
+        const block *b = &blocks[i];
+        if (c->first + i == 0) {
+            for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) block_copy(&l->ref[t], b);
+            continue;
+        }
+        block *ref = &l->ref[tier_pow_difficulty_slot(b->tier)];
+        if (!pkc_block_pow_follows(b, ref)) return OP_INVALID_INPUT;
+        block_copy(ref, b);
+    }
+    l->tail = c->tail;
+    return OP_SUCCESS;
+}
+
+static inline void pkc_snapshot_decode_worker(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)cancel;
+    pkc_snapshot_job_t *job = (pkc_snapshot_job_t *)arg;
+    uint32_t slot;
+    while ((slot = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed)) < job->nchunks)
+        pkc_snapshot_decode_chunk(job, slot);
+}
+
+/*
+ * Reads a snapshot into `apply`. The header, frame list and trailer are
+ * checked before anything is applied; a chunk that then fails to decode
+ * or validate stops the import with the chunks before it applied.
+ */
+static inline OpStatus_t pkc_snapshot_import(const char *path, const pkc_snapshot_config_t *cfg,
+                                             pkc_snapshot_meta_t *meta_out, pkc_snapshot_apply_fn apply,
+                                             void *apply_ctx, pkc_snapshot_stats_t *stats)
+{
+    if (!path || !apply) return OP_NULL_PTR;
+    const pkc_snapshot_config_t def = {0};
+    if (!cfg) cfg = &def;
+    const uint64_t start = pkc_metrics_now_ns();
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return OP_INVALID_INPUT;
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || (uint64_t)sb.st_size < PKC_SNAPSHOT_HEADER_SIZE + PKC_SNAPSHOT_TRAILER_SIZE) {
+        close(fd);
+        return OP_INVALID_INPUT;
+    }
+    const uint64_t size = (uint64_t)sb.st_size;
+    const uint8_t *map = (const uint8_t *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return OP_INVALID_INPUT;
+
+    OpStatus_t st = OP_INVALID_INPUT;
+    pkc_snapshot_chunk_t *index = NULL;
+    uint8_t *hashes = NULL;
+    pkc_snapshot_job_t job;
+    memset(&job, 0, sizeof(job));
+    uint32_t window = 0;
+    pkc_snapshot_links_t *links = NULL;
+
+    // Header.
+    uint8_t h[UINT256_SIZE];
+    pkc_snapshot_meta_t meta;
+    uint32_t chunk_blocks;
+    if (!pkc_snapshot_parse_header(map, &meta, &chunk_blocks)) goto out;
+
+    // Frame list against the trailer.
+    const uint64_t nchunks = (meta.blocks + chunk_blocks - 1) / chunk_blocks;
+    const uint8_t *trailer = map + size - PKC_SNAPSHOT_TRAILER_SIZE;
+    uint64_t t_chunks, t_blocks;
+    deserialize_u64_be(trailer + 8, &t_chunks, sizeof(uint64_t));
+    deserialize_u64_be(trailer + 16, &t_blocks, sizeof(uint64_t));
+    if (memcmp(trailer, PKC_SNAPSHOT_END_MAGIC, PKC_SNAPSHOT_MAGIC_LEN) != 0 || t_chunks != nchunks ||
+        t_blocks != meta.blocks)
+        goto out;
+    index = (pkc_snapshot_chunk_t *)calloc(nchunks ? nchunks : 1, sizeof(*index));
+    hashes = (uint8_t *)malloc((size_t)(nchunks ? nchunks : 1) * UINT256_SIZE);
+    if (!index || !hashes) goto out;
+    uint64_t off = PKC_SNAPSHOT_HEADER_SIZE, next = 0;
+    for (uint64_t i = 0; i < nchunks; ++i) {
+        pkc_snapshot_chunk_t *c = &index[i];
+        if (off + PKC_SNAPSHOT_CHUNK_HEADER_SIZE > size - PKC_SNAPSHOT_TRAILER_SIZE ||
+            !pkc_snapshot_chunk_parse(map + off, c) || c->first != next ||
+            c->count != (meta.blocks - next < chunk_blocks ? meta.blocks - next : chunk_blocks))
+            goto out;
+        off += PKC_SNAPSHOT_CHUNK_HEADER_SIZE;
+        if (off + c->payload_len > size - PKC_SNAPSHOT_TRAILER_SIZE) goto out;
+        c->payload = map + off;
+        off += c->payload_len;
+        next += c->count;
+        memcpy(hashes + i * UINT256_SIZE, c->hash, UINT256_SIZE);
+    }
+    pkc_snapshot_hash(hashes, (size_t)nchunks * UINT256_SIZE, h);
+    if (off != size - PKC_SNAPSHOT_TRAILER_SIZE || memcmp(h, trailer + 32, UINT256_SIZE) != 0) goto out;
+
+    // Decode and validate in parallel windows, link-check and apply in order.
+    if (cfg->require_pow && !(links = (pkc_snapshot_links_t *)calloc(1, sizeof(*links)))) goto out;
+    window = pkc_snapshot_window(cfg);
+    job.cfg = cfg;
+    if (pkc_snapshot_alloc_slots(&job, window, chunk_blocks, false) != OP_SUCCESS) goto out;
+    st = OP_SUCCESS;
+    for (uint64_t c0 = 0; c0 < nchunks && st == OP_SUCCESS; c0 += window) {
+        job.nchunks = nchunks - c0 < window ? (uint32_t)(nchunks - c0) : window;
+        memcpy(job.chunks, &index[c0], job.nchunks * sizeof(*job.chunks));
+        atomic_store(&job.next, 0);
+        pkc_pool_fork_join(pkc_pool_default(), PKC_POOL_PRIO_VALIDATE, pkc_snapshot_threads(),
+                           pkc_snapshot_decode_worker, &job, NULL);
+        for (uint32_t i = 0; i < job.nchunks && st == OP_SUCCESS; ++i) {
+            const pkc_snapshot_chunk_t *c = &job.chunks[i];
+            st = c->status;
+            if (st == OP_SUCCESS && links) st = pkc_snapshot_check_chunk(links, c, job.blocks[i]);
+            if (st == OP_SUCCESS) st = apply(apply_ctx, c->first, job.blocks[i], c->count);
+        }
+    }
+    if (st == OP_SUCCESS && stats) {
+        stats->blocks = meta.blocks;
+        stats->chunks = nchunks;
+        stats->raw_bytes = meta.blocks * PKC_SNAPSHOT_RECORD_SIZE;
+        stats->file_bytes = size;
+        stats->elapsed_ns = pkc_metrics_now_ns() - start;
+    }
+    if (st == OP_SUCCESS && meta_out) *meta_out = meta;
+
+out:
+    if (window) pkc_snapshot_free_slots(&job, window);
+    free(links);
+    free(index);
+    free(hashes);
+    munmap((void *)map, size);
+    return st;
+}
+
+/* Apply hook that appends to an in-memory chain (same steps as the log replay). */
+static inline OpStatus_t pkc_snapshot_apply_chain(void *ctx, uint64_t first, const block *blocks, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i) {
+        OpStatus_t st = pkc_chain_store_load_block(ctx, first + i, &blocks[i]);
+        if (st != OP_SUCCESS) return st;
+    }
+    return OP_SUCCESS;
+}
+
+/* Apply hook that appends to a chain log. */
+static inline OpStatus_t pkc_snapshot_apply_store(void *ctx, uint64_t first, const block *blocks, uint32_t count)
+{
+    pkc_chain_store_t *s = (pkc_chain_store_t *)ctx;
+    if (first != s->records) return OP_INVALID_STATE;
+    return pkc_chain_store_append(s, blocks, count);
+}
+
+/*
+ * Whether the header's per-tier difficulty is within one retarget (plus
+ * rounding) of the challenge each tier's last block solved, the bound
+ * pkc_block_pow_follows puts on consecutive blocks.
+ */
+static inline bool pkc_snapshot_tiers_follow(const PKCertChain *chain, const pkc_snapshot_meta_t *meta)
+{
+    const double bound = tier_pow_difficulty_default()->cfg.max_step + 1.0;
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        const uint32_t bits = meta->target_bits[t];
+        if (bits && !tier_pow_target_bits_valid(bits)) return false;
+        const block *ref = &chain->blocks[tier_pow_chain_last_index(chain, &tier_pow_chain_fields[t])];
+        if (ref->height == 0) continue;
+        const tier_pow_challenge_t *c = &ref->tierPoWResult.challenge;
+        const double was = block_get_pow_version(ref) == TIER_POW_VERSION_TARGET
+                               ? tier_pow_target_complexity(tier_pow_challenge_get_target_bits(c))
+                               : (double)c->complexity;
+        const double now = bits ? tier_pow_target_complexity(bits) : (double)meta->tier_complexity[t];
+        if (fabs(now - was) > bound) return false;
+    }
+    return true;
+}
+
+/*
+ * Bootstraps an empty chain (index 0) from a snapshot, metadata included:
+ * the tiers' complexity fields, and in target mode the difficulty
+ * controller's targets for tiers it has not seen a solve for yet.
+ * A chain that already names its network only takes a snapshot of the
+ * same network. With `require_pow` the header's tier difficulty must
+ * also follow the tiers' last blocks (pkc_snapshot_tiers_follow). On
+ * failure the chain is left empty again, whatever chunks were applied
+ * before the bad one.
+ */
+static inline OpStatus_t pkc_snapshot_import_chain(const char *path, PKCertChain *chain,
+                                                   const pkc_snapshot_config_t *cfg, pkc_snapshot_stats_t *stats)
+{
+    if (!chain) return OP_NULL_PTR;
+    if (chain->index != 0) return OP_INVALID_STATE;
+    pkc_snapshot_meta_t meta;
+    OpStatus_t st = pkc_snapshot_read_meta(path, &meta);
+    if (st != OP_SUCCESS) return st;
+    if (chain->NetworkName[0] != '\0' && strncmp(chain->NetworkName, meta.NetworkName, sizeof(meta.NetworkName)) != 0)
+        return OP_INVALID_INPUT;
+
+    uint32_t last_index[TIER_POW_DIFFICULTY_TIERS];
+    for (uint32_t t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t)
+        last_index[t] = tier_pow_chain_last_index(chain, &tier_pow_chain_fields[t]);
+    st = pkc_snapshot_import(path, cfg, &meta, pkc_snapshot_apply_chain, chain, stats);
+    if (st == OP_SUCCESS && cfg && cfg->require_pow && !pkc_snapshot_tiers_follow(chain, &meta)) st = OP_INVALID_INPUT;
+    if (st != OP_SUCCESS) {
+        memset(chain->blocks, 0, (size_t)chain->index * sizeof(block));
+        chain->index = 0;
+        for (uint32_t t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t)
+            tier_pow_chain_set_last_index(chain, &tier_pow_chain_fields[t], last_index[t]);
+        return st;
+    }
+    memcpy(chain->NetworkName, meta.NetworkName, sizeof(chain->NetworkName));
+    chain->complexity = meta.complexity;
+    chain->next_challenge_id = meta.next_challenge_id;
+    tier_pow_difficulty_t *ctl = tier_pow_difficulty_default();
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        tier_pow_chain_set_complexity(chain, &tier_pow_chain_fields[t], meta.tier_complexity[t]);
+        if (meta.target_bits[t] != 0 && ctl->cfg.version == TIER_POW_VERSION_TARGET)
+            tier_pow_difficulty_resume_target(ctl, tier_pow_chain_fields[t].tier, meta.target_bits[t]);
+    }
+    return OP_SUCCESS;
+}
+
+#endif // PKC_CHAIN_SNAPSHOT_H
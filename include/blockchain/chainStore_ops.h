@@ -0,0 +1,831 @@
+#ifndef PKC_CHAIN_STORE_H
+#define PKC_CHAIN_STORE_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "blockchain/block.h"
+#include "blockchain/blockView_ops.h"
+#include "blockhain/PKCertChain.h"
+#include "blockchain/pkcertchain_ops.h"
+#include "blockchain/chainWriter_ops.h"
+#include "blockchain/chainIo_ops.h"
+#include "core/enums/OpStatus.h"
+#include "telemetry/metrics_ops.h"
+
+#ifndef PKC_CHAIN_STORE_INLINE
+#define PKC_CHAIN_STORE_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Append-only chain log with configurable durability.
+ *
+ * save_chain_state rewrites the whole state file per save. The log instead
+ * appends one fixed-size record per block to a single file that is
+ * preallocated in large steps (fallocate), so an append never changes the
+ * file size and fdatasync only has to flush data.
+ *
+ *   SYNC   every block is fdatasync'ed before it is acknowledged
+ *   GROUP  fdatasync once `group_blocks` are pending or the oldest pending
+ *          block is `group_interval_ns` old, whichever comes first
+ *   ASYNC  appends go to the page cache; fdatasync every
+ *          `async_interval_ns` (or PKC_CHAIN_STORE_PENDING_MAX blocks)
+ * In GROUP and ASYNC a block is acknowledged before it is durable; a
+ * crash loses at most the pending window.
+ *
+ * Record: generation (u32 BE) | block (BLOCK_SERIALIZED_SIZE,
+ * block_serialize, PoW results included) | hash256(generation | block).
+ * Each open bumps the generation in the header; recovery stops at the
+ * first record whose hash fails or whose generation goes backwards, so the
+ * zeroed preallocation and any stale records left past a torn tail are
+ * never replayed.
+ *
+ * A chain that already holds blocks when the log is opened (state file,
+ * snapshot) is reconciled with pkc_chain_store_open_chain: records past
+ * the chain's tip are replayed onto it, and the log is truncated at the
+ * first record that disagrees with a block the chain already has, so the
+ * writer's first persist continues right where the two agree.
+ *
+ * Commit latency (block reaches the store -> its fdatasync returns) is
+ * kept in a log-linear histogram for percentiles and also feeds the
+ * chain_commit_seconds metric.
+ *
+ * With `async_io` the log goes through pkc_io (io_uring, or pread/pwrite
+ * when the ring is unavailable): appends are encoded straight into
+ * registered buffers and submitted as WRITE_FIXED, and a due fdatasync is
+ * queued behind them with IOSQE_IO_DRAIN instead of being waited on. In
+ * GROUP and ASYNC the writer thread therefore only blocks when every
+ * buffer is in flight; SYNC still waits, but write and fdatasync go to
+ * the kernel in one call. Recovery reads the log in batches of
+ * READ_FIXED segments. A failed asynchronous write or sync is sticky:
+ * every later append, sync and close returns it, so a chain writer bound
+ * to the store drops the next batch and stops taking candidates
+ * (pkc_chain_writer_failed).
+ */
+
+#ifndef PKCERTCHAIN_CHAIN_LOG_FILE
+#define PKCERTCHAIN_CHAIN_LOG_FILE "chain.log"
+#endif
+
+#define PKC_CHAIN_STORE_MAGIC "PKCL"
+#define PKC_CHAIN_STORE_MAGIC_LEN 4
+#define PKC_CHAIN_STORE_VERSION 2
+#define PKC_CHAIN_STORE_HEADER_SIZE 128
+#define PKC_CHAIN_STORE_RECORD_SIZE (UINT32_SIZE + BLOCK_SERIALIZED_SIZE + UINT256_SIZE)
+
+#ifndef PKC_CHAIN_STORE_PREALLOC_RECORDS
+#define PKC_CHAIN_STORE_PREALLOC_RECORDS 65536
+#endif
+
+#ifndef PKC_CHAIN_STORE_PENDING_MAX
+#define PKC_CHAIN_STORE_PENDING_MAX 4096
+#endif
+
+#define PKC_CHAIN_STORE_SCAN_RECORDS 256
+
+typedef enum {
+    PKC_DURABILITY_SYNC = 0,
+    PKC_DURABILITY_GROUP,
+    PKC_DURABILITY_ASYNC,
+} pkc_durability_t;
+
+typedef struct {
+    pkc_durability_t mode;
+    uint32_t group_blocks;          // 0: 64
+    uint64_t group_interval_ns;     // 0: 10 ms
+    uint64_t async_interval_ns;     // 0: 1 s
+    uint32_t prealloc_records;      // 0: PKC_CHAIN_STORE_PREALLOC_RECORDS
+    bool async_io;                  // route appends, syncs and recovery through pkc_io
+    pkc_io_config_t io;             // used with async_io; buffers capped at 64
+} pkc_chain_store_config_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+} pkc_chain_store_latency_t;
+
+typedef struct {
+    int fd;
+    pkc_chain_store_config_t cfg;
+    uint32_t generation;
+    uint64_t records;               // appended
+    uint64_t synced;                // durable
+    uint64_t allocated;             // records the file has room for
+    uint64_t syncs;
+
+    uint64_t pending_ns[PKC_CHAIN_STORE_PENDING_MAX];  // append time of records [synced, records)
+
+    uint8_t *buf;
+    size_t buf_records;
+
+    uint64_t hist[PKC_METRICS_HIST_BUCKETS];
+    uint64_t hist_count;
+    uint64_t hist_max;
+
+    // async_io
+    bool io_enabled;
+    pkc_io_t io;
+    uint64_t io_free;               // bitmask of registered buffers not in flight
+    bool io_sync_inflight;
+    uint64_t io_sync_start;
+    OpStatus_t io_error;            // sticky
+} pkc_chain_store_t;
+
+#define PKC_CHAIN_STORE_IO_WRITE 1ULL
+#define PKC_CHAIN_STORE_IO_SYNC 2ULL
+#define PKC_CHAIN_STORE_IO_READ 3ULL
+#define PKC_CHAIN_STORE_IO_TAG(kind, v) (((kind) << 56) | (uint64_t)(v))
+
+/* ---------------- file helpers ---------------- */
+
+static inline OpStatus_t pkc_chain_store_pwrite(int fd, const uint8_t *p, size_t n, uint64_t off)
+{
+    while (n > 0) {
+        ssize_t w = pwrite(fd, p, n, (off_t)off);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return OP_INVALID_STATE;
+        }
+        p += w;
+        n -= (size_t)w;
+        off += (uint64_t)w;
+    }
+    return OP_SUCCESS;
+}
+
+static inline ssize_t pkc_chain_store_pread(int fd, uint8_t *p, size_t n, uint64_t off)
+{
+    size_t done = 0;
+    while (done < n) {
+        ssize_t r = pread(fd, p + done, n - done, (off_t)(off + done));
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (r == 0) break;
+        done += (size_t)r;
+    }
+    return (ssize_t)done;
+}
+
+PKC_CHAIN_STORE_INLINE uint64_t pkc_chain_store_offset(uint64_t record)
+{
+    return PKC_CHAIN_STORE_HEADER_SIZE + record * PKC_CHAIN_STORE_RECORD_SIZE;
+}
+
+/*
+ * Reserves room for `records` records. Raw syscall so no _GNU_SOURCE is
+ * needed; filesystems without fallocate get a plain size extension.
+ */
+static inline OpStatus_t pkc_chain_store_reserve(pkc_chain_store_t *s, uint64_t records)
+{
+    if (records <= s->allocated) return OP_SUCCESS;
+    const uint64_t step = s->cfg.prealloc_records;
+    const uint64_t target = ((records + step - 1) / step) * step;
+    const uint64_t len = pkc_chain_store_offset(target);
+    if (syscall(SYS_fallocate, s->fd, 0, (off_t)0, (off_t)len) != 0 && ftruncate(s->fd, (off_t)len) != 0)
+        return OP_INVALID_STATE;
+    s->allocated = target;
+    return OP_SUCCESS;
+}
+
+/* ---------------- records ---------------- */
+
+static inline OpStatus_t pkc_chain_store_encode(uint32_t generation, const block *blk, uint8_t *out)
+{
+    serialize_u32_be(generation, out);
+    memset(out + UINT32_SIZE, 0, BLOCK_SERIALIZED_SIZE);
+    OpStatus_t st = block_serialize(blk, out + UINT32_SIZE, BLOCK_SERIALIZED_SIZE);
+    if (st != OP_SUCCESS) return st;
+    uint256 h;
+    hash256_buffer(out, UINT32_SIZE + BLOCK_SERIALIZED_SIZE, &h);
+    return uint256_serialize_be(&h, out + UINT32_SIZE + BLOCK_SERIALIZED_SIZE, UINT256_SIZE);
+}
+
+/*
+ * Checks a record in place; false when its hash fails (torn write,
+ * preallocated zeros). On success `view` covers the serialized block.
+ */
+static inline bool pkc_chain_store_check(const uint8_t *rec, uint32_t *generation, block_view *view)
+{
+    uint256 h;
+    uint8_t hb[UINT256_SIZE];
+    hash256_buffer(rec, UINT32_SIZE + BLOCK_SERIALIZED_SIZE, &h);
+    if (uint256_serialize_be(&h, hb, UINT256_SIZE) != OP_SUCCESS) return false;
+    if (memcmp(hb, rec + UINT32_SIZE + BLOCK_SERIALIZED_SIZE, UINT256_SIZE) != 0) return false;
+    deserialize_u32_be(rec, generation, sizeof(uint32_t));
+    return block_view_init(view, rec + UINT32_SIZE, BLOCK_SERIALIZED_SIZE) == OP_SUCCESS;
+}
+
+/* Decodes a record; false when its hash fails. */
+static inline bool pkc_chain_store_decode(const uint8_t *rec, uint32_t *generation, block *out)
+{
+    block_view view;
+    return pkc_chain_store_check(rec, generation, &view) && block_view_to_block(&view, out) == OP_SUCCESS;
+}
+
+/* ---------------- durability ---------------- */
+
+static inline void pkc_chain_store_record_latency(pkc_chain_store_t *s, uint64_t ns)
+{
+    s->hist[pkc_metrics_hist_bucket(ns)]++;
+    s->hist_count++;
+    if (ns > s->hist_max) s->hist_max = ns;
+    pkc_metrics_observe_ns(PKC_HIST_CHAIN_COMMIT, ns);
+}
+
+/* Marks records up to `target` durable after an fdatasync that started at `start`. */
+static inline void pkc_chain_store_synced(pkc_chain_store_t *s, uint64_t target, uint64_t start)
+{
+    const uint64_t now = pkc_metrics_now_ns();
+    pkc_metrics_observe_ns(PKC_HIST_CHAIN_PERSIST, now - start);
+    pkc_metrics_count(PKC_CTR_CHAIN_PERSISTS, 1);
+
+    for (uint64_t r = s->synced; r < target; ++r)
+        pkc_chain_store_record_latency(s, now - s->pending_ns[r % PKC_CHAIN_STORE_PENDING_MAX]);
+    if (target > s->synced) s->synced = target;
+    s->syncs++;
+}
+
+/* ---------------- async I/O ---------------- */
+
+static inline void pkc_chain_store_io_complete(pkc_chain_store_t *s, const pkc_io_completion_t *c)
+{
+    const uint64_t kind = c->user_data >> 56;
+    const uint64_t value = c->user_data & ((1ULL << 56) - 1);
+    if (kind == PKC_CHAIN_STORE_IO_WRITE) {
+        // value: buffer index | length << 16
+        s->io_free |= 1ULL << (value & 0xFFFF);
+        if (c->res < 0 || (uint64_t)c->res != value >> 16) s->io_error = OP_INVALID_STATE;
+    } else if (kind == PKC_CHAIN_STORE_IO_SYNC) {
+        s->io_sync_inflight = false;
+        // Once a write has failed, a later fdatasync returning 0 does not
+        // make the records it drained behind durable.
+        if (c->res < 0) s->io_error = OP_INVALID_STATE;
+        else if (s->io_error == OP_SUCCESS) pkc_chain_store_synced(s, value, s->io_sync_start);
+    }
+}
+
+/*
+ * Submits whatever is queued and handles the completions that are ready;
+ * with `wait`, blocks until at least one has arrived (when any is pending).
+ */
+static inline OpStatus_t pkc_chain_store_io_pump(pkc_chain_store_t *s, bool wait)
+{
+    if (pkc_io_submit(&s->io, wait ? 1 : 0) != OP_SUCCESS) s->io_error = OP_INVALID_STATE;
+    pkc_io_completion_t done[PKC_IO_ENTRIES];
+    uint32_t n;
+    while ((n = pkc_io_reap(&s->io, done, PKC_IO_ENTRIES)) > 0) {
+        for (uint32_t i = 0; i < n; ++i) pkc_chain_store_io_complete(s, &done[i]);
+    }
+    return s->io_error;
+}
+
+/* Queues an fdatasync behind every write queued or in flight (one at a time). */
+static inline OpStatus_t pkc_chain_store_io_sync_start(pkc_chain_store_t *s)
+{
+    if (s->io_sync_inflight || s->synced == s->records) return s->io_error;
+    while (pkc_io_space(&s->io) == 0) {
+        if (pkc_chain_store_io_pump(s, true) != OP_SUCCESS) return s->io_error;
+    }
+    OpStatus_t st = pkc_io_queue(&s->io, PKC_IO_OP_FDATASYNC, s->fd, 0, 0, 0,
+                                 PKC_CHAIN_STORE_IO_TAG(PKC_CHAIN_STORE_IO_SYNC, s->records), PKC_IO_DRAIN);
+    if (st != OP_SUCCESS) return st;
+    s->io_sync_inflight = true;
+    s->io_sync_start = pkc_metrics_now_ns();
+    return OP_SUCCESS;
+}
+
+/* Blocks until everything appended so far is durable. */
+static inline OpStatus_t pkc_chain_store_io_sync(pkc_chain_store_t *s)
+{
+    while (s->synced < s->records && s->io_error == OP_SUCCESS) {
+        pkc_chain_store_io_sync_start(s);
+        pkc_chain_store_io_pump(s, true);
+    }
+    return s->io_error;
+}
+
+/* Index of a registered buffer not in flight, waiting for one if needed. */
+static inline OpStatus_t pkc_chain_store_io_buffer(pkc_chain_store_t *s, uint32_t *idx)
+{
+    while (s->io_free == 0 || pkc_io_space(&s->io) < 2) {
+        if (pkc_chain_store_io_pump(s, true) != OP_SUCCESS) return s->io_error;
+    }
+    *idx = (uint32_t)__builtin_ctzll(s->io_free);
+    s->io_free &= ~(1ULL << *idx);
+    return OP_SUCCESS;
+}
+
+/* ---------------- durability ---------------- */
+
+/* fdatasync everything appended so far. */
+static inline OpStatus_t pkc_chain_store_sync(pkc_chain_store_t *s)
+{
+    if (!s || s->fd < 0) return OP_NULL_PTR;
+    if (s->io_enabled) return pkc_chain_store_io_sync(s);
+    if (s->synced == s->records) return OP_SUCCESS;
+
+    const uint64_t start = pkc_metrics_now_ns();
+    if (fdatasync(s->fd) != 0) return OP_INVALID_STATE;
+    pkc_chain_store_synced(s, s->records, start);
+    return OP_SUCCESS;
+}
+
+/* Starts an fdatasync: inline on the blocking path, queued with async_io. */
+static inline OpStatus_t pkc_chain_store_sync_start(pkc_chain_store_t *s)
+{
+    return s->io_enabled ? pkc_chain_store_io_sync_start(s) : pkc_chain_store_sync(s);
+}
+
+/* Syncs when the mode's block or age threshold has been reached. */
+static inline OpStatus_t pkc_chain_store_sync_due(pkc_chain_store_t *s, uint64_t now)
+{
+    const uint64_t pending = s->records - s->synced;
+    if (pending == 0) return OP_SUCCESS;
+    if (pending >= PKC_CHAIN_STORE_PENDING_MAX) return pkc_chain_store_sync_start(s);
+
+    const uint64_t age = now - s->pending_ns[s->synced % PKC_CHAIN_STORE_PENDING_MAX];
+    switch (s->cfg.mode) {
+        case PKC_DURABILITY_SYNC:
+            return pkc_chain_store_sync_start(s);
+        case PKC_DURABILITY_GROUP:
+            if (pending >= s->cfg.group_blocks || age >= s->cfg.group_interval_ns) return pkc_chain_store_sync_start(s);
+            return OP_SUCCESS;
+        default:
+            return age >= s->cfg.async_interval_ns ? pkc_chain_store_sync_start(s) : OP_SUCCESS;
+    }
+}
+
+/*
+ * Async-I/O half of an append: waits for pending room, encodes up to `*k`
+ * records into a free registered buffer and queues their write. `*k` is
+ * lowered to what was queued.
+ */
+static inline OpStatus_t pkc_chain_store_io_write(pkc_chain_store_t *s, const block *blocks, uint32_t *k)
+{
+    while (s->records - s->synced >= PKC_CHAIN_STORE_PENDING_MAX) {
+        pkc_chain_store_io_sync_start(s);
+        if (pkc_chain_store_io_pump(s, true) != OP_SUCCESS) return s->io_error;
+    }
+    const uint64_t room = PKC_CHAIN_STORE_PENDING_MAX - (s->records - s->synced);
+    if (*k > room) *k = (uint32_t)room;
+    const uint32_t per_buffer = s->io.cfg.buffer_size / PKC_CHAIN_STORE_RECORD_SIZE;
+    if (*k > per_buffer) *k = per_buffer;
+
+    uint32_t idx = 0;
+    OpStatus_t st = pkc_chain_store_io_buffer(s, &idx);
+    if (st != OP_SUCCESS) return st;
+    uint8_t *out = pkc_io_buffer(&s->io, idx);
+    for (uint32_t i = 0; i < *k; ++i) {
+        st = pkc_chain_store_encode(s->generation, &blocks[i], out + (size_t)i * PKC_CHAIN_STORE_RECORD_SIZE);
+        if (st != OP_SUCCESS) {
+            s->io_free |= 1ULL << idx;
+            return st;
+        }
+    }
+    const uint32_t len = *k * PKC_CHAIN_STORE_RECORD_SIZE;
+    return pkc_io_queue(&s->io, PKC_IO_OP_WRITE, s->fd, idx, len, pkc_chain_store_offset(s->records),
+                        PKC_CHAIN_STORE_IO_TAG(PKC_CHAIN_STORE_IO_WRITE, idx | ((uint64_t)len << 16)), 0);
+}
+
+/*
+ * Appends `n` blocks. In SYNC mode each block is written and synced on
+ * its own; otherwise the run is written with one pwrite and synced when due.
+ * With async_io a run is one queued write (plus a queued fdatasync when
+ * due) and one submission; only SYNC waits for the result.
+ */
+static inline OpStatus_t pkc_chain_store_append(pkc_chain_store_t *s, const block *blocks, uint32_t n)
+{
+    if (!s || !blocks) return OP_NULL_PTR;
+    if (s->fd < 0) return OP_INVALID_STATE;
+    if (s->io_enabled && s->io_error != OP_SUCCESS) return s->io_error;
+    if (n == 0) return OP_SUCCESS;
+
+    OpStatus_t st = pkc_chain_store_reserve(s, s->records + n);
+    if (st != OP_SUCCESS) return st;
+
+    const uint32_t run = s->cfg.mode == PKC_DURABILITY_SYNC ? 1 : (uint32_t)s->buf_records;
+    for (uint32_t done = 0; done < n;) {
+        uint32_t k = n - done < run ? n - done : run;
+        if (s->io_enabled) {
+            st = pkc_chain_store_io_write(s, &blocks[done], &k);
+            if (st != OP_SUCCESS) return st;
+        } else {
+            const uint64_t room = PKC_CHAIN_STORE_PENDING_MAX - (s->records - s->synced);
+            if (k > room) k = (uint32_t)room;
+
+            for (uint32_t i = 0; i < k; ++i) {
+                st = pkc_chain_store_encode(s->generation, &blocks[done + i], s->buf + (size_t)i * PKC_CHAIN_STORE_RECORD_SIZE);
+                if (st != OP_SUCCESS) return st;
+            }
+            st = pkc_chain_store_pwrite(s->fd, s->buf, (size_t)k * PKC_CHAIN_STORE_RECORD_SIZE,
+                                        pkc_chain_store_offset(s->records));
+            if (st != OP_SUCCESS) return st;
+        }
+
+        const uint64_t now = pkc_metrics_now_ns();
+        for (uint32_t i = 0; i < k; ++i) s->pending_ns[(s->records + i) % PKC_CHAIN_STORE_PENDING_MAX] = now;
+        s->records += k;
+        done += k;
+
+        st = pkc_chain_store_sync_due(s, now);
+        if (st != OP_SUCCESS) return st;
+        if (s->io_enabled) {
+            st = pkc_chain_store_io_pump(s, false);
+            if (st == OP_SUCCESS && s->cfg.mode == PKC_DURABILITY_SYNC) st = pkc_chain_store_io_sync(s);
+            if (st != OP_SUCCESS) return st;
+        }
+    }
+    return OP_SUCCESS;
+}
+
+/* ---------------- open / recover / close ---------------- */
+
+typedef OpStatus_t (*pkc_chain_store_replay_fn)(void *ctx, uint64_t record, const block *blk);
+
+typedef struct {
+    uint32_t prev_generation;       // header generation: nothing valid is newer
+    uint32_t last_generation;
+    bool tail;
+    pkc_chain_store_replay_fn replay;
+    void *replay_ctx;
+} pkc_chain_store_scan_t;
+
+/* Validates and replays `k` consecutive records read into `seg`, stopping at the tail. */
+static inline OpStatus_t pkc_chain_store_scan_segment(pkc_chain_store_t *s, pkc_chain_store_scan_t *sc,
+                                                      const uint8_t *seg, uint64_t k)
+{
+    block blk;
+    for (uint64_t i = 0; i < k; ++i) {
+        uint32_t gen;
+        block_view view;
+        if (!pkc_chain_store_check(seg + i * PKC_CHAIN_STORE_RECORD_SIZE, &gen, &view) ||
+            gen < sc->last_generation || gen > sc->prev_generation) {
+            sc->tail = true;
+            return OP_SUCCESS;
+        }
+        // Without a replay hook the scan never materializes a block.
+        if (sc->replay) {
+            if (block_view_to_block(&view, &blk) != OP_SUCCESS) {
+                sc->tail = true;
+                return OP_SUCCESS;
+            }
+            OpStatus_t st = sc->replay(sc->replay_ctx, s->records, &blk);
+            if (st != OP_SUCCESS) return st;
+        }
+        sc->last_generation = gen;
+        s->records++;
+    }
+    return OP_SUCCESS;
+}
+
+/*
+ * One recovery step with async_io: READ_FIXED of the next segment into
+ * every registered buffer, submitted together, then validated in order.
+ */
+static inline OpStatus_t pkc_chain_store_io_scan(pkc_chain_store_t *s, pkc_chain_store_scan_t *sc)
+{
+    const uint32_t per_buffer = s->io.cfg.buffer_size / PKC_CHAIN_STORE_RECORD_SIZE;
+    int32_t got[64];
+    uint32_t segs = 0;
+    uint64_t next = s->records;
+    for (; segs < s->io.cfg.buffers && next < s->allocated; ++segs) {
+        uint64_t k = s->allocated - next;
+        if (k > per_buffer) k = per_buffer;
+        if (pkc_io_queue(&s->io, PKC_IO_OP_READ, s->fd, segs, (uint32_t)(k * PKC_CHAIN_STORE_RECORD_SIZE),
+                         pkc_chain_store_offset(next), PKC_CHAIN_STORE_IO_TAG(PKC_CHAIN_STORE_IO_READ, segs), 0) != OP_SUCCESS)
+            break;
+        next += k;
+    }
+    if (segs == 0) {
+        sc->tail = true;
+        return OP_SUCCESS;
+    }
+    if (pkc_io_submit(&s->io, segs) != OP_SUCCESS) return OP_INVALID_STATE;
+    pkc_io_completion_t done[64];
+    for (uint32_t have = 0; have < segs;) {
+        const uint32_t n = pkc_io_reap(&s->io, done, segs - have);
+        if (n == 0 && pkc_io_submit(&s->io, segs - have) != OP_SUCCESS) return OP_INVALID_STATE;
+        for (uint32_t i = 0; i < n; ++i) got[done[i].user_data & 0xFF] = done[i].res;
+        have += n;
+    }
+    for (uint32_t b = 0; b < segs && !sc->tail; ++b) {
+        if (got[b] < (int32_t)PKC_CHAIN_STORE_RECORD_SIZE) {
+            sc->tail = true;
+            break;
+        }
+        OpStatus_t st = pkc_chain_store_scan_segment(s, sc, pkc_io_buffer(&s->io, b),
+                                                     (uint64_t)got[b] / PKC_CHAIN_STORE_RECORD_SIZE);
+        if (st != OP_SUCCESS) return st;
+        // A short read ends the valid region even if its records decoded.
+        if ((uint32_t)got[b] / PKC_CHAIN_STORE_RECORD_SIZE < per_buffer && s->records < s->allocated) sc->tail = true;
+    }
+    return OP_SUCCESS;
+}
+
+/*
+ * Opens (or creates) the log at `path`. Existing records are scanned up to
+ * the valid tail and handed to `replay` (optional) in order; new appends
+ * continue after them.
+ */
+static inline OpStatus_t pkc_chain_store_open(pkc_chain_store_t *s, const char *path,
+                                              const pkc_chain_store_config_t *cfg,
+                                              pkc_chain_store_replay_fn replay, void *replay_ctx)
+{
+    if (!s || !path || path[0] == '\0') return OP_INVALID_INPUT;
+    memset(s, 0, sizeof(*s));
+    s->fd = -1;
+    if (cfg) s->cfg = *cfg;
+    if (s->cfg.group_blocks == 0) s->cfg.group_blocks = 64;
+    if (s->cfg.group_blocks > PKC_CHAIN_STORE_PENDING_MAX) s->cfg.group_blocks = PKC_CHAIN_STORE_PENDING_MAX;
+    if (s->cfg.group_interval_ns == 0) s->cfg.group_interval_ns = 10000000ULL;
+    if (s->cfg.async_interval_ns == 0) s->cfg.async_interval_ns = 1000000000ULL;
+    if (s->cfg.prealloc_records == 0) s->cfg.prealloc_records = PKC_CHAIN_STORE_PREALLOC_RECORDS;
+
+    s->buf_records = PKC_CHAIN_STORE_SCAN_RECORDS;
+    s->buf = (uint8_t *)malloc(s->buf_records * PKC_CHAIN_STORE_RECORD_SIZE);
+    if (!s->buf) return OP_INVALID_STATE;
+
+    if (s->cfg.async_io) {
+        pkc_io_config_t io_cfg = s->cfg.io;
+        if (io_cfg.buffers == 0) io_cfg.buffers = PKC_IO_BUFFERS;
+        if (io_cfg.buffers > 64) io_cfg.buffers = 64;
+        if (io_cfg.buffer_size < PKC_CHAIN_STORE_RECORD_SIZE) io_cfg.buffer_size = PKC_IO_BUFFER_SIZE;
+        // Every buffer in flight plus a sync must fit in the ring.
+        if (io_cfg.entries < io_cfg.buffers + 1) io_cfg.entries = io_cfg.buffers + 1;
+        OpStatus_t st = pkc_io_init(&s->io, &io_cfg);
+        if (st != OP_SUCCESS) {
+            free(s->buf);
+            s->buf = NULL;
+            return st;
+        }
+        s->io_enabled = true;
+        s->io_free = s->io.cfg.buffers == 64 ? ~0ULL : (1ULL << s->io.cfg.buffers) - 1;
+    }
+
+    s->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (s->fd < 0) {
+        if (s->io_enabled) pkc_io_destroy(&s->io);
+        s->io_enabled = false;
+        free(s->buf);
+        s->buf = NULL;
+        return OP_INVALID_INPUT;
+    }
+
+    OpStatus_t st = OP_SUCCESS;
+    uint8_t hdr[PKC_CHAIN_STORE_HEADER_SIZE];
+    const ssize_t got = pkc_chain_store_pread(s->fd, hdr, sizeof(hdr), 0);
+    uint32_t prev_generation = 0;
+    if (got == (ssize_t)sizeof(hdr)) {
+        if (memcmp(hdr, PKC_CHAIN_STORE_MAGIC, PKC_CHAIN_STORE_MAGIC_LEN) != 0 ||
+            hdr[PKC_CHAIN_STORE_MAGIC_LEN] != PKC_CHAIN_STORE_VERSION) {
+            st = OP_INVALID_INPUT;
+            goto fail;
+        }
+        deserialize_u32_be(hdr + PKC_CHAIN_STORE_MAGIC_LEN + 1, &prev_generation, sizeof(uint32_t));
+    } else if (got != 0) {
+        st = OP_INVALID_INPUT;
+        goto fail;
+    }
+
+    // Scan to the valid tail.
+    struct stat sb;
+    if (fstat(s->fd, &sb) != 0) {
+        st = OP_INVALID_STATE;
+        goto fail;
+    }
+    const uint64_t size = (uint64_t)sb.st_size;
+    s->allocated = size > PKC_CHAIN_STORE_HEADER_SIZE ? (size - PKC_CHAIN_STORE_HEADER_SIZE) / PKC_CHAIN_STORE_RECORD_SIZE : 0;
+    pkc_chain_store_scan_t sc = { prev_generation, 0, false, replay, replay_ctx };
+    while (!sc.tail && s->records < s->allocated) {
+        if (s->io_enabled) {
+            if ((st = pkc_chain_store_io_scan(s, &sc)) != OP_SUCCESS) goto fail;
+            continue;
+        }
+        uint64_t k = s->allocated - s->records;
+        if (k > s->buf_records) k = s->buf_records;
+        const ssize_t r = pkc_chain_store_pread(s->fd, s->buf, (size_t)k * PKC_CHAIN_STORE_RECORD_SIZE,
+                                                pkc_chain_store_offset(s->records));
+        if (r < (ssize_t)PKC_CHAIN_STORE_RECORD_SIZE) break;
+        if ((st = pkc_chain_store_scan_segment(s, &sc, s->buf, (uint64_t)r / PKC_CHAIN_STORE_RECORD_SIZE)) != OP_SUCCESS)
+            goto fail;
+    }
+    s->synced = s->records;
+
+    // New generation, durable before any record carries it.
+    s->generation = prev_generation + 1;
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, PKC_CHAIN_STORE_MAGIC, PKC_CHAIN_STORE_MAGIC_LEN);
+    hdr[PKC_CHAIN_STORE_MAGIC_LEN] = PKC_CHAIN_STORE_VERSION;
+    serialize_u32_be(s->generation, hdr + PKC_CHAIN_STORE_MAGIC_LEN + 1);
+    if ((st = pkc_chain_store_pwrite(s->fd, hdr, sizeof(hdr), 0)) != OP_SUCCESS) goto fail;
+    if ((st = pkc_chain_store_reserve(s, s->records + 1)) != OP_SUCCESS) goto fail;
+    if (fsync(s->fd) != 0) {
+        st = OP_INVALID_STATE;
+        goto fail;
+    }
+    return OP_SUCCESS;
+
+fail:
+    if (s->io_enabled) pkc_io_destroy(&s->io);
+    s->io_enabled = false;
+    close(s->fd);
+    s->fd = -1;
+    free(s->buf);
+    s->buf = NULL;
+    return st;
+}
+
+/* Syncs what is pending and closes the log. */
+static inline OpStatus_t pkc_chain_store_close(pkc_chain_store_t *s)
+{
+    if (!s || s->fd < 0) return OP_NULL_PTR;
+    OpStatus_t st = pkc_chain_store_sync(s);
+    if (s->io_enabled) {
+        // Nothing may still target the fd once it is closed.
+        while (s->io.inflight + s->io.queued > 0) {
+            const uint32_t before = s->io.inflight + s->io.queued;
+            if (pkc_chain_store_io_pump(s, true) != OP_SUCCESS) {
+                if (st == OP_SUCCESS) st = s->io_error;
+                if (s->io.inflight + s->io.queued == before) break;
+            }
+        }
+        pkc_io_destroy(&s->io);
+        s->io_enabled = false;
+    }
+    close(s->fd);
+    s->fd = -1;
+    free(s->buf);
+    s->buf = NULL;
+    return st;
+}
+
+/*
+ * Drops every record from `records` on: syncs what is in flight, shrinks
+ * the file to them and preallocates again, so the dropped records read
+ * back as zeros and the next append goes to `records`.
+ */
+static inline OpStatus_t pkc_chain_store_truncate(pkc_chain_store_t *s, uint64_t records)
+{
+    if (!s || s->fd < 0) return OP_NULL_PTR;
+    if (records > s->records) return OP_INVALID_INPUT;
+    OpStatus_t st = pkc_chain_store_sync(s);
+    if (st != OP_SUCCESS) return st;
+    if (ftruncate(s->fd, (off_t)pkc_chain_store_offset(records)) != 0) return OP_INVALID_STATE;
+    s->records = records;
+    s->synced = records;
+    s->allocated = records;
+    if ((st = pkc_chain_store_reserve(s, records + 1)) != OP_SUCCESS) return st;
+    return fsync(s->fd) == 0 ? OP_SUCCESS : OP_INVALID_STATE;
+}
+
+/* $HOME/.pkcertchain/<network>/chain.log, creating the directory. */
+static inline OpStatus_t pkc_chain_store_default_path(const char *network_name, char *out, size_t out_len)
+{
+    if (!network_name || network_name[0] == '\0' || !out) return OP_INVALID_INPUT;
+    const char *home = getenv("HOME");
+    if (!home || home[0] == '\0') return OP_INVALID_INPUT;
+    OpStatus_t st = ensure_wallet_dir(network_name);
+    if (st != OP_SUCCESS) return st;
+    const int n = snprintf(out, out_len, "%s/%s/%s/%s", home, PKCERTCHAIN_BASE_SUBDIR, network_name,
+                           PKCERTCHAIN_CHAIN_LOG_FILE);
+    return n > 0 && (size_t)n < out_len ? OP_SUCCESS : OP_INVALID_INPUT;
+}
+
+/* ---------------- chain binding ---------------- */
+
+/* Replay callback that rebuilds `ctx` (a PKCertChain) block by block. */
+static inline OpStatus_t pkc_chain_store_load_block(void *ctx, uint64_t record, const block *blk)
+{
+    PKCertChain *chain = (PKCertChain *)ctx;
+    if (record != chain->index || record >= PKC_CHAIN_CAPACITY(chain)) return OP_BUFFER_TOO_SMALL;
+    block_copy(&chain->blocks[chain->index], blk);
+    const tier_pow_chain_field_t *field = tier_pow_chain_field(blk->tier);
+    if (field) tier_pow_chain_set_last_index(chain, field, chain->index);
+    chain->index++;
+    return OP_SUCCESS;
+}
+
+typedef struct {
+    PKCertChain *chain;
+    uint64_t base;                  // chain->index at open
+    uint64_t diverged;              // first record that disagrees with the chain, UINT64_MAX if none
+} pkc_chain_store_reconcile_t;
+
+/*
+ * Replay callback for a chain that may already hold blocks: records below
+ * its tip must match them (height, cert hash, prevHash), records past it
+ * are loaded. Nothing is loaded after the first mismatch.
+ */
+static inline OpStatus_t pkc_chain_store_reconcile_block(void *ctx, uint64_t record, const block *blk)
+{
+    pkc_chain_store_reconcile_t *r = (pkc_chain_store_reconcile_t *)ctx;
+    if (r->diverged != UINT64_MAX) return OP_SUCCESS;
+    if (record >= r->base) return pkc_chain_store_load_block(r->chain, record, blk);
+    const block *have = &r->chain->blocks[record];
+    if (have->height != blk->height ||
+        memcmp(&have->CurrentCertHash, &blk->CurrentCertHash, sizeof(uint256)) != 0 ||
+        memcmp(&have->prevHash, &blk->prevHash, sizeof(uint256)) != 0)
+        r->diverged = record;
+    return OP_SUCCESS;
+}
+
+/*
+ * Opens the log for `chain` and reconciles the two: an empty chain is
+ * rebuilt from the log, a loaded one is extended by the records past its
+ * tip, and a log that disagrees with it is truncated at the first
+ * differing record. Afterwards the log never holds more than the chain.
+ */
+static inline OpStatus_t pkc_chain_store_open_chain(pkc_chain_store_t *s, const char *path,
+                                                    const pkc_chain_store_config_t *cfg, PKCertChain *chain)
+{
+    if (!chain) return OP_NULL_PTR;
+    pkc_chain_store_reconcile_t r = { chain, chain->index, UINT64_MAX };
+    OpStatus_t st = pkc_chain_store_open(s, path, cfg, pkc_chain_store_reconcile_block, &r);
+    if (st != OP_SUCCESS || r.diverged == UINT64_MAX) return st;
+    if ((st = pkc_chain_store_truncate(s, r.diverged)) != OP_SUCCESS) pkc_chain_store_close(s);
+    return st;
+}
+
+/*
+ * Chain writer persist hook: appends every block the log does not have
+ * yet (the first batch also brings in genesis and anything loaded before
+ * the writer started).
+ */
+static inline OpStatus_t pkc_chain_store_persist(void *ctx, const PKCertChain *chain, uint32_t first, uint32_t count)
+{
+    pkc_chain_store_t *s = (pkc_chain_store_t *)ctx;
+    const uint64_t end = (uint64_t)first + count;
+    if (s->records > end) return OP_INVALID_STATE;
+    return pkc_chain_store_append(s, &chain->blocks[s->records], (uint32_t)(end - s->records));
+}
+
+/* Chain writer flush hook. */
+static inline void pkc_chain_store_flush(void *ctx, bool force)
+{
+    pkc_chain_store_t *s = (pkc_chain_store_t *)ctx;
+    if (force) {
+        pkc_chain_store_sync(s);
+        return;
+    }
+    pkc_chain_store_sync_due(s, pkc_metrics_now_ns());
+    if (s->io_enabled) pkc_chain_store_io_pump(s, false);
+}
+
+/* Points a chain writer config at this store. */
+static inline void pkc_chain_store_bind(pkc_chain_store_t *s, pkc_chain_writer_config_t *cfg)
+{
+    cfg->persist = pkc_chain_store_persist;
+    cfg->persist_ctx = s;
+    cfg->flush = s->cfg.mode == PKC_DURABILITY_SYNC ? NULL : pkc_chain_store_flush;
+    cfg->flush_interval_ns = s->cfg.mode == PKC_DURABILITY_GROUP ? s->cfg.group_interval_ns : s->cfg.async_interval_ns;
+}
+
+/* ---------------- latency ---------------- */
+
+static inline uint64_t pkc_chain_store_percentile(const pkc_chain_store_t *s, double pct)
+{
+    if (s->hist_count == 0) return 0;
+    uint64_t rank = (uint64_t)((pct / 100.0) * (double)s->hist_count);
+    if (rank >= s->hist_count) rank = s->hist_count - 1;
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < PKC_METRICS_HIST_BUCKETS; ++b) {
+        seen += s->hist[b];
+        if (seen > rank) {
+            const uint64_t upper = pkc_metrics_hist_bucket_upper(b);
+            return upper < s->hist_max ? upper : s->hist_max;
+        }
+    }
+    return s->hist_max;
+}
+
+/* Commit latency percentiles since open (bucket upper bounds, <= 12.5% high, capped at max). */
+static inline OpStatus_t pkc_chain_store_latency(const pkc_chain_store_t *s, pkc_chain_store_latency_t *out)
+{
+    if (!s || !out) return OP_NULL_PTR;
+    out->count = s->hist_count;
+    out->p50_ns = pkc_chain_store_percentile(s, 50.0);
+    out->p90_ns = pkc_chain_store_percentile(s, 90.0);
+    out->p99_ns = pkc_chain_store_percentile(s, 99.0);
+    out->p999_ns = pkc_chain_store_percentile(s, 99.9);
+    out->max_ns = s->hist_max;
+    return OP_SUCCESS;
+}
+
+#endif // PKC_CHAIN_STORE_H
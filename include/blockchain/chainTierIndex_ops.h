@@ -0,0 +1,371 @@
+#ifndef PKC_CHAIN_TIER_INDEX_H
+#define PKC_CHAIN_TIER_INDEX_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blockchain/block.h"
+#include "blockchain/block_ops.h"
+#include "blockhain/PKCertChain.h"
+#include "Proofs/TierPoW/tierPoWChallenge_ops.h"
+#include "Proofs/TierPoW/tierPoWDifficulty_ops.h"
+#include "core/enums/OpStatus.h"
+#include "core/enums/Tier.h"
+
+#ifndef PKC_TIER_INDEX_INLINE
+#define PKC_TIER_INDEX_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Per-tier block lists.
+ *
+ * The chain keeps one last*BlockIndex field per tier, so anything past
+ * "the newest block of tier T" (the k newest, how many there are, how
+ * fast they were solved) means walking chain->blocks. The tier index
+ * keeps, per tier in tier_pow_chain_fields order:
+ *
+ *   index[]   chain indexes (= heights) of the tier's blocks, ascending,
+ *             append-only; the k newest are the last k entries
+ *   solve[]   per entry: timestamp, solve seconds and the complexity or
+ *             target the solve was made at
+ *   window    the last PKC_TIER_INDEX_WINDOW timed solves, with their sum
+ *   totals    solve count and seconds
+ *
+ * Lists are sized for the whole chain up front and never move, and a
+ * list's count is published with a release store after its entry, so a
+ * reader holding a chain tip may read entries below the tip while the
+ * writer appends (pkc_tier_index_last_k_below). The window and totals
+ * belong to whoever appends: the chain writer
+ * (pkc_chain_writer_config_t.tiers) or, on a quiescent chain,
+ * pkc_tier_index_sync. pkc_tier_index_truncate drops the entries past a
+ * fork point for the block tree; it needs the same ownership and no
+ * readers.
+ *
+ * pkc_tier_index_seed_difficulty replays the windows into a fresh
+ * difficulty controller, so a restarted node retargets from the chain's
+ * recent solves instead of from scratch; pkc_chain_writer_start does it
+ * once after its sync, and pkc_chain_retarget observes each block it
+ * commits from then on. Miners (PowManager_Run, PKCertChain_MineBlock)
+ * only read the index bound to their chain (pkc_tier_index_bind) for
+ * the tier's reference block and never sync it.
+ */
+
+#define PKC_TIER_INDEX_WINDOW TIER_POW_DIFFICULTY_WINDOW
+#define PKC_TIER_INDEX_NONE UINT32_MAX
+
+typedef struct {
+    double seconds;                 // tierPoWResult.time_taken, 0 without a timed solve
+    uint64_t timestamp;
+    uint32_t work;                  // complexity, or compact target bits for TIER_POW_VERSION_TARGET
+    uint8_t version;                // block_get_pow_version
+} pkc_tier_solve_t;
+
+typedef struct {
+    uint32_t *index;
+    pkc_tier_solve_t *solve;        // parallel to index
+    uint32_t count;                 // release-stored after index[count - 1]
+
+    pkc_tier_solve_t window[PKC_TIER_INDEX_WINDOW];
+    uint32_t window_head;           // next slot to overwrite
+    uint32_t window_count;
+    double window_seconds;
+
+    uint64_t solves;                // blocks carrying a timed TierPoW solve
+    double total_seconds;
+} pkc_tier_list_t;
+
+typedef struct {
+    pkc_tier_list_t tiers[TIER_POW_DIFFICULTY_TIERS];
+    const PKCertChain *chain;       // set by sync / build
+    uint32_t count;                 // chain blocks indexed, any tier
+    uint32_t capacity;              // entries per list
+} pkc_tier_index_t;
+
+/* ---------------- lifecycle ---------------- */
+
+static inline void pkc_tier_index_destroy(pkc_tier_index_t *ix)
+{
+    if (!ix) return;
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        free(ix->tiers[t].index);
+        free(ix->tiers[t].solve);
+    }
+    memset(ix, 0, sizeof(*ix));
+}
+
+static inline OpStatus_t pkc_tier_index_init(pkc_tier_index_t *ix, uint32_t capacity)
+{
+    if (!ix) return OP_NULL_PTR;
+    if (capacity == 0) return OP_INVALID_INPUT;
+    memset(ix, 0, sizeof(*ix));
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        ix->tiers[t].index = (uint32_t *)malloc((size_t)capacity * sizeof(uint32_t));
+        ix->tiers[t].solve = (pkc_tier_solve_t *)malloc((size_t)capacity * sizeof(pkc_tier_solve_t));
+        if (!ix->tiers[t].index || !ix->tiers[t].solve) {
+            pkc_tier_index_destroy(ix);
+            return OP_INVALID_STATE;
+        }
+    }
+    ix->capacity = capacity;
+    return OP_SUCCESS;
+}
+
+PKC_TIER_INDEX_INLINE const pkc_tier_list_t *pkc_tier_index_list(const pkc_tier_index_t *ix, Tier_t tier)
+{
+    const int slot = tier_pow_difficulty_slot(tier);
+    return slot < 0 ? NULL : &ix->tiers[slot];
+}
+
+/* ---------------- append ---------------- */
+
+PKC_TIER_INDEX_INLINE void pkc_tier_index_solve_of(const block *b, pkc_tier_solve_t *s)
+{
+    const TierPowResult *r = &b->tierPoWResult;
+    // genesis and imported blocks carry no timed solve
+    s->seconds = r->time_taken > 0.0 ? r->time_taken : 0.0;
+    s->timestamp = b->timestamp;
+    s->version = block_get_pow_version(b);
+    s->work = s->version == TIER_POW_VERSION_TARGET ? tier_pow_challenge_get_target_bits(&r->challenge)
+                                                    : tier_pow_challenge_get_complexity(&r->challenge);
+}
+
+PKC_TIER_INDEX_INLINE void pkc_tier_index_window_sum(pkc_tier_list_t *l)
+{
+    // summed afresh so the window never accumulates rounding
+    double sum = 0.0;
+    for (uint32_t i = 0; i < l->window_count; ++i) sum += l->window[i].seconds;
+    l->window_seconds = sum;
+}
+
+PKC_TIER_INDEX_INLINE void pkc_tier_index_add_solve(pkc_tier_list_t *l, const pkc_tier_solve_t *s)
+{
+    if (s->seconds == 0.0) return;
+    l->window[l->window_head] = *s;
+    l->window_head = (l->window_head + 1) % PKC_TIER_INDEX_WINDOW;
+    if (l->window_count < PKC_TIER_INDEX_WINDOW) l->window_count++;
+    pkc_tier_index_window_sum(l);
+    l->solves++;
+    l->total_seconds += s->seconds;
+}
+
+/*
+ * Indexes n blocks that follow the current count. Blocks of no known
+ * tier (genesis) only advance the count.
+ */
+static inline OpStatus_t pkc_tier_index_append(pkc_tier_index_t *ix, const block *blocks, uint32_t n)
+{
+    if (!ix || (!blocks && n)) return OP_NULL_PTR;
+    if (n > ix->capacity - ix->count) return OP_BUFFER_TOO_SMALL;
+    for (uint32_t i = 0; i < n; ++i) {
+        const block *b = &blocks[i];
+        const int slot = tier_pow_difficulty_slot(b->tier);
+        if (slot < 0) continue;
+        pkc_tier_list_t *l = &ix->tiers[slot];
+        l->index[l->count] = ix->count + i;
+        pkc_tier_index_solve_of(b, &l->solve[l->count]);
+        pkc_tier_index_add_solve(l, &l->solve[l->count]);
+        __atomic_store_n(&l->count, l->count + 1, __ATOMIC_RELEASE);
+    }
+    ix->count += n;
+    return OP_SUCCESS;
+}
+
+/*
+ * Forgets chain indexes `count` and up; the window is refilled from the
+ * newest timed entries left. Owner only, no readers.
+ */
+static inline OpStatus_t pkc_tier_index_truncate(pkc_tier_index_t *ix, uint32_t count)
+{
+    if (!ix) return OP_NULL_PTR;
+    if (count > ix->count) return OP_INVALID_STATE;
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        pkc_tier_list_t *l = &ix->tiers[t];
+        uint32_t n = l->count;
+        while (n > 0 && l->index[n - 1] >= count) {
+            if (l->solve[n - 1].seconds != 0.0) {
+                l->solves--;
+                l->total_seconds -= l->solve[n - 1].seconds;
+            }
+            n--;
+        }
+        if (n == l->count) continue;
+        __atomic_store_n(&l->count, n, __ATOMIC_RELEASE);
+
+        pkc_tier_solve_t newest[PKC_TIER_INDEX_WINDOW];
+        uint32_t k = 0;
+        for (uint32_t i = n; i > 0 && k < PKC_TIER_INDEX_WINDOW; --i) {
+            if (l->solve[i - 1].seconds != 0.0) newest[k++] = l->solve[i - 1];
+        }
+        for (uint32_t i = 0; i < k; ++i) l->window[i] = newest[k - 1 - i];
+        l->window_count = k;
+        l->window_head = k % PKC_TIER_INDEX_WINDOW;
+        pkc_tier_index_window_sum(l);
+        if (l->solves == 0) l->total_seconds = 0.0;
+    }
+    ix->count = count;
+    return OP_SUCCESS;
+}
+
+/* Indexes whatever chain->blocks has past the index's count. */
+static inline OpStatus_t pkc_tier_index_sync(pkc_tier_index_t *ix, const PKCertChain *chain)
+{
+    if (!ix || !chain) return OP_NULL_PTR;
+    if (ix->chain && ix->chain != chain) return OP_INVALID_INPUT;
+    if (chain->index < ix->count) return OP_INVALID_STATE;
+    ix->chain = chain;
+    return pkc_tier_index_append(ix, &chain->blocks[ix->count], chain->index - ix->count);
+}
+
+static inline OpStatus_t pkc_tier_index_build(pkc_tier_index_t *ix, const PKCertChain *chain)
+{
+    if (!ix || !chain) return OP_NULL_PTR;
+    const uint32_t capacity = ix->capacity;
+    uint32_t *lists[TIER_POW_DIFFICULTY_TIERS];
+    pkc_tier_solve_t *solves[TIER_POW_DIFFICULTY_TIERS];
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        lists[t] = ix->tiers[t].index;
+        solves[t] = ix->tiers[t].solve;
+    }
+    memset(ix, 0, sizeof(*ix));
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        ix->tiers[t].index = lists[t];
+        ix->tiers[t].solve = solves[t];
+    }
+    ix->capacity = capacity;
+    return pkc_tier_index_sync(ix, chain);
+}
+
+/* ---------------- lookups ---------------- */
+
+PKC_TIER_INDEX_INLINE uint32_t pkc_tier_index_count(const pkc_tier_index_t *ix, Tier_t tier)
+{
+    const pkc_tier_list_t *l = pkc_tier_index_list(ix, tier);
+    return l ? __atomic_load_n(&l->count, __ATOMIC_ACQUIRE) : 0;
+}
+
+/* Chain index of the k-th newest block of `tier` (k = 1 is the newest), PKC_TIER_INDEX_NONE if there is none. */
+PKC_TIER_INDEX_INLINE uint32_t pkc_tier_index_kth_last(const pkc_tier_index_t *ix, Tier_t tier, uint32_t k)
+{
+    const pkc_tier_list_t *l = pkc_tier_index_list(ix, tier);
+    if (!l || k == 0) return PKC_TIER_INDEX_NONE;
+    const uint32_t n = __atomic_load_n(&l->count, __ATOMIC_ACQUIRE);
+    return k <= n ? l->index[n - k] : PKC_TIER_INDEX_NONE;
+}
+
+PKC_TIER_INDEX_INLINE uint32_t pkc_tier_index_last(const pkc_tier_index_t *ix, Tier_t tier)
+{
+    return pkc_tier_index_kth_last(ix, tier, 1);
+}
+
+/*
+ * Points `out` at the chain indexes of the (up to) k newest blocks of
+ * `tier`, oldest first, and returns how many there are.
+ */
+PKC_TIER_INDEX_INLINE uint32_t pkc_tier_index_last_k(const pkc_tier_index_t *ix, Tier_t tier, uint32_t k,
+                                                     const uint32_t **out)
+{
+    const pkc_tier_list_t *l = pkc_tier_index_list(ix, tier);
+    const uint32_t n = l ? __atomic_load_n(&l->count, __ATOMIC_ACQUIRE) : 0;
+    if (k > n) k = n;
+    *out = l ? l->index + (n - k) : NULL;
+    return k;
+}
+
+/*
+ * last_k restricted to blocks below chain index `end`, for readers that
+ * hold a tip (end = tip->index) while the writer keeps appending. The
+ * cut is found by binary search over the list.
+ */
+static inline uint32_t pkc_tier_index_last_k_below(const pkc_tier_index_t *ix, Tier_t tier, uint32_t end,
+                                                   uint32_t k, const uint32_t **out)
+{
+    const pkc_tier_list_t *l = pkc_tier_index_list(ix, tier);
+    uint32_t lo = 0, hi = l ? __atomic_load_n(&l->count, __ATOMIC_ACQUIRE) : 0;
+    if (hi > 0 && l->index[hi - 1] >= end) {
+        while (lo < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            if (l->index[mid] < end) lo = mid + 1;
+            else hi = mid;
+        }
+    }
+    if (k > hi) k = hi;
+    *out = l ? l->index + (hi - k) : NULL;
+    return k;
+}
+
+/* ---------------- aggregates ---------------- */
+
+/* Mean TierPoW solve time over the tier's window; 0 with no solves. */
+PKC_TIER_INDEX_INLINE double pkc_tier_index_mean_solve_seconds(const pkc_tier_index_t *ix, Tier_t tier)
+{
+    const pkc_tier_list_t *l = pkc_tier_index_list(ix, tier);
+    return l && l->window_count ? l->window_seconds / l->window_count : 0.0;
+}
+
+/* Mean timestamp gap between consecutive blocks of the tier; 0 below two blocks. */
+PKC_TIER_INDEX_INLINE double pkc_tier_index_mean_interval_seconds(const pkc_tier_index_t *ix, Tier_t tier)
+{
+    const pkc_tier_list_t *l = pkc_tier_index_list(ix, tier);
+    if (!l || l->count < 2) return 0.0;
+    const uint64_t first = l->solve[0].timestamp, last = l->solve[l->count - 1].timestamp;
+    return last < first ? 0.0 : (double)(last - first) / (l->count - 1);
+}
+
+/*
+ * Replays each tier's window, oldest first, into the tiers of `ctl` that
+ * have no samples yet. Tiers the controller already tracks are left alone.
+ */
+static inline OpStatus_t pkc_tier_index_seed_difficulty(const pkc_tier_index_t *ix, tier_pow_difficulty_t *ctl)
+{
+    if (!ix || !ctl) return OP_NULL_PTR;
+    if (!ctl->ready) return OP_INVALID_STATE;
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        const pkc_tier_list_t *l = &ix->tiers[t];
+        pthread_mutex_lock(&ctl->lock);
+        const uint32_t tracked = ctl->tiers[t].count;
+        pthread_mutex_unlock(&ctl->lock);
+        if (tracked != 0 || l->window_count == 0) continue;
+        const Tier_t tier = tier_pow_chain_fields[t].tier;
+        const uint32_t oldest = (l->window_head + PKC_TIER_INDEX_WINDOW - l->window_count) % PKC_TIER_INDEX_WINDOW;
+        for (uint32_t i = 0; i < l->window_count; ++i) {
+            const pkc_tier_solve_t *s = &l->window[(oldest + i) % PKC_TIER_INDEX_WINDOW];
+            if (s->version == TIER_POW_VERSION_TARGET) {
+                uint32_t bits;
+                if (tier_pow_target_bits_valid(s->work))
+                    tier_pow_difficulty_observe_target(ctl, tier, s->work, s->seconds, &bits);
+            } else {
+                uint8_t complexity;
+                tier_pow_difficulty_observe(ctl, tier, (uint8_t)s->work, s->seconds, &complexity);
+            }
+        }
+    }
+    return OP_SUCCESS;
+}
+
+/* ---------------- binding ---------------- */
+
+/*
+ * Index the miners consult for their chain (pow_manager_reference_index),
+ * kept in sync by the chain writer. Bind one per process with
+ * pkc_tier_index_bind after building it; NULL unbinds.
+ */
+__attribute__((weak)) pkc_tier_index_t *pkc_tier_index_bound;
+
+PKC_TIER_INDEX_INLINE void pkc_tier_index_bind(pkc_tier_index_t *ix)
+{
+    pkc_tier_index_bound = ix;
+}
+
+/* The bound index if it was built over `chain`, else NULL. */
+PKC_TIER_INDEX_INLINE pkc_tier_index_t *pkc_tier_index_for(const PKCertChain *chain)
+{
+    pkc_tier_index_t *ix = pkc_tier_index_bound;
+    return ix && ix->chain == chain ? ix : NULL;
+}
+
+#endif // PKC_CHAIN_TIER_INDEX_H
@@ -0,0 +1,887 @@
+#ifndef PKC_CHAIN_WRITER_H
+#define PKC_CHAIN_WRITER_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <time.h>
+#include <math.h>
+
+#include "blockchain/block.h"
+#include "blockchain/blockView_ops.h"
+#include "blockhain/PKCertChain.h"
+#include "blockchain/pkcertchain_ops.h"
+#include "blockchain/chainColumns_ops.h"
+#include "blockchain/chainTierIndex_ops.h"
+#include "blockchain/certStatus_ops.h"
+#include "Proofs/TierPoW/tierPoWDifficulty_ops.h"
+#include "Proofs/TierPoW/tierPoWVerify_ops.h"
+#include "core/enums/OpStatus.h"
+#include "core/enums/Tier.h"
+#include "telemetry/metrics_ops.h"
+
+#ifndef PKC_CHAIN_WRITER_INLINE
+#define PKC_CHAIN_WRITER_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Single-writer chain commit path.
+ *
+ * Candidate blocks from any thread go into a bounded MPSC ring (per-slot
+ * sequence numbers, one CAS per producer). One writer thread drains it in
+ * batches: each candidate is validated against the current tip, appended
+ * to chain->blocks and the per-tier last-index fields, then the whole
+ * batch is handed to the persist hook once (group commit) before the side
+ * indexes move, the new tip is published and the submitters' tickets
+ * complete.
+ *
+ * A batch the persist hook refuses is not committed: chain->index and the
+ * per-tier fields go back to the published tip, its tickets carry the
+ * hook's error and the writer stops taking candidates (submit and every
+ * queued ticket return that error; pkc_chain_writer_failed) until it is
+ * stopped and restarted over a store that works again. The difficulty
+ * controller keeps the solves it observed for the dropped blocks.
+ *
+ * Readers never lock. The tip is an immutable pkc_chain_tip_t swapped in
+ * with one atomic store; old tips are reclaimed by epoch: a reader
+ * announces the global epoch in its slot before loading the tip, and a
+ * retired tip is freed once every announced epoch has moved past it.
+ * A thread's reader slot is released when the thread exits (or through
+ * pkc_chain_reader_release_self) and reused by the next registration.
+ * Committed slots of chain->blocks are never rewritten, so blocks below
+ * tip->index may be read directly inside a read section.
+ *
+ * Only the writer mutates blocks, index, last*BlockIndex and the per-tier
+ * complexities while it runs. The retarget is part of the append step
+ * (pkc_chain_retarget): the difficulty controller observes each block's
+ * own solve as it commits, so no caller-supplied complexity reaches the
+ * chain. With no writer, pkc_chain_apply is the same append step, in
+ * place.
+ */
+
+#ifndef PKC_CHAIN_WRITER_QUEUE
+#define PKC_CHAIN_WRITER_QUEUE 1024     // power of two
+#endif
+
+#ifndef PKC_CHAIN_WRITER_BATCH
+#define PKC_CHAIN_WRITER_BATCH 64
+#endif
+
+#define PKC_CHAIN_READERS_MAX 64
+#define PKC_CHAIN_RETIRED_MAX 64
+
+#define PKC_CHAIN_CAPACITY(chain) ((uint32_t)(sizeof((chain)->blocks) / sizeof((chain)->blocks[0])))
+
+typedef struct {
+    uint32_t index;                 // committed blocks
+    uint64_t height;                // height of the last block
+    uint256 cert_hash;              // its CurrentCertHash
+    uint256 hash;                   // its block_link_hash, the next block's prevHash
+    uint32_t last_index[TIER_POW_DIFFICULTY_TIERS];     // tier_pow_chain_fields order
+    uint8_t complexity[TIER_POW_DIFFICULTY_TIERS];      // likewise
+    uint64_t seq;                   // batches committed since start
+} pkc_chain_tip_t;
+
+typedef struct {
+    _Atomic(int) done;
+    OpStatus_t status;
+    uint64_t height;                // committed height on success
+} pkc_chain_ticket_t;
+
+/*
+ * Called once per batch with blocks [first, first + count) appended,
+ * before anything is published. The batch's tickets complete with its
+ * return value; anything but OP_SUCCESS drops the batch and fails the
+ * writer.
+ */
+typedef OpStatus_t (*pkc_chain_persist_fn)(void *ctx, const PKCertChain *chain, uint32_t first, uint32_t count);
+
+/*
+ * Deferred durability: called by an idle writer every `flush_interval_ns`,
+ * and with `force` by the writer thread before it exits.
+ */
+typedef void (*pkc_chain_flush_fn)(void *ctx, bool force);
+
+typedef struct {
+    pkc_chain_persist_fn persist;   // NULL: in memory only
+    void *persist_ctx;
+    pkc_chain_flush_fn flush;       // NULL: writer sleeps until work arrives
+    uint64_t flush_interval_ns;
+    bool require_pow;               // re-check each block's TierPoW solution
+    pkc_chain_columns_t *columns;   // optional hot-field columns, kept in step with the tip
+    pkc_tier_index_t *tiers;        // optional per-tier lists, likewise
+    pkc_cert_index_t *certs;        // optional certificate status index, likewise
+    uint64_t cert_filter_save_ns;   // with certs: save its filter beside the chain state at most this often
+} pkc_chain_writer_config_t;
+
+typedef struct {
+    _Atomic(uint64_t) seq;
+    pkc_chain_ticket_t *ticket;
+    block blk;
+} pkc_chain_slot_t;
+
+typedef struct __attribute__((aligned(64))) {
+    _Atomic(uint64_t) epoch;        // 0 when outside a read section
+    _Atomic(uint32_t) used;
+} pkc_chain_reader_slot_t;
+
+typedef struct {
+    pkc_chain_tip_t *tip;
+    uint64_t epoch;
+} pkc_chain_retired_t;
+
+typedef struct pkc_chain_writer {
+    PKCertChain *chain;
+    pkc_chain_writer_config_t cfg;
+    pkc_chain_slot_t *ring;
+    uint64_t generation;            // distinct per start, keys cached reader slots
+    struct pkc_chain_writer *live_next;
+
+    __attribute__((aligned(64))) _Atomic(uint64_t) tail;        // producers
+    __attribute__((aligned(64))) uint64_t head;                 // writer only
+
+    _Atomic(pkc_chain_tip_t *) tip;
+    _Atomic(uint64_t) epoch;
+    pkc_chain_reader_slot_t readers[PKC_CHAIN_READERS_MAX];
+    _Atomic(uint32_t) nreaders;     // high-water mark of claimed slots
+    pkc_chain_retired_t retired[PKC_CHAIN_RETIRED_MAX];
+    uint32_t nretired;
+
+    pthread_t tid;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;            // writer sleeps here
+    pthread_cond_t committed;       // ticket waiters sleep here
+    _Atomic(uint32_t) sleeping;
+    _Atomic(bool) running;
+    _Atomic(OpStatus_t) failed;     // persist error that stopped intake, OP_SUCCESS while healthy
+    _Atomic(size_t) queued;
+    uint32_t certs_saved;           // blocks the saved cert filter covers, writer only
+    uint64_t certs_saved_ns;
+} pkc_chain_writer_t;
+
+/* ---------------- tickets ---------------- */
+
+PKC_CHAIN_WRITER_INLINE void pkc_chain_ticket_init(pkc_chain_ticket_t *t)
+{
+    atomic_init(&t->done, 0);
+    t->status = OP_INVALID_STATE;
+    t->height = 0;
+}
+
+/* ---------------- append step ---------------- */
+
+/*
+ * Challenge a tier's next block is mined against: hash256 of its
+ * reference block (the tier's newest block below it, genesis before the
+ * first) over cert keys and id, prevHash, height, timestamp and tier, at
+ * `complexity`. challenge_id and reserved stay zero; target mode sets
+ * them through tier_pow_challenge_set_target_bits.
+ */
+static inline OpStatus_t generate_tier_pow_challenge(const block *blk, uint8_t complexity, tier_pow_challenge_t *pow)
+{
+    uint8_t buf[CERT_SIZE + UINT256_SIZE + UINT64_SIZE + UINT64_SIZE + 4 * UINT8_SIZE];
+    const size_t id_len = sizeof(blk->cert.id) < BLOCK_VIEW_CERT_ID_SIZE ? sizeof(blk->cert.id)
+                                                                         : BLOCK_VIEW_CERT_ID_SIZE;
+
+    if (!blk || !pow) return OP_NULL_PTR;
+    memset(buf, 0, sizeof(buf));
+
+    uint256_serialize_be(&blk->cert.pubSignKey, buf, UINT256_SIZE);
+    uint256_serialize_be(&blk->cert.pubEncKey, buf + UINT256_SIZE, UINT256_SIZE);
+    memcpy(buf + BLOCK_VIEW_CERT_ID_OFFSET, &blk->cert.id, id_len);
+
+    uint256_serialize_be(&blk->prevHash, buf + CERT_SIZE, UINT256_SIZE);
+    serialize_u64_be(blk->height, buf + CERT_SIZE + UINT256_SIZE);
+    serialize_u64_be(blk->timestamp, buf + CERT_SIZE + UINT256_SIZE + UINT64_SIZE);
+    serialize_u8(blk->tier, buf + CERT_SIZE + UINT256_SIZE + 2 * UINT64_SIZE);
+
+    tier_pow_challenge_init(pow);
+    hash256_buffer(buf, sizeof(buf), &pow->challenge);
+    pow->complexity = complexity;
+
+    return OP_SUCCESS;
+}
+
+/*
+ * TierPoW check of a block: its solution against the stored challenge
+ * bound to block.reserved, so the PoW version and certificate op cannot
+ * be changed on a mined block. Says nothing about where the challenge
+ * came from; pkc_block_pow_issued does.
+ */
+static inline bool pkc_block_pow_valid(const block *blk)
+{
+    return isValidBoundTierChallenge(&blk->tierPoWResult.challenge, &blk->tierPoWResult.solve, blk->reserved,
+                                     sizeof(blk->reserved));
+}
+
+/*
+ * True when `blk`'s stored challenge is the one `ref` issues
+ * (generate_tier_pow_challenge) at `complexity`, or at the compact target
+ * `bits` when non-zero, so a block cannot pick its own challenge or
+ * difficulty.
+ */
+static inline bool pkc_block_pow_issued(const block *blk, const block *ref, uint8_t complexity, uint32_t bits)
+{
+    tier_pow_challenge_t want;
+    generate_tier_pow_challenge(ref, complexity, &want);
+    if (bits && tier_pow_challenge_set_target_bits(&want, bits) != OP_SUCCESS) return false;
+    const tier_pow_challenge_t *have = &blk->tierPoWResult.challenge;
+    return memcmp(&have->challenge, &want.challenge, sizeof(uint256)) == 0 && have->complexity == want.complexity &&
+           memcmp(have->reserved, want.reserved, sizeof(want.reserved)) == 0;
+}
+
+/*
+ * pkc_block_pow_issued away from the live chain (snapshot import, the
+ * block tree), where the controller state that set the difficulty is not
+ * at hand: the challenge must be the one `ref` issues at the block's own
+ * difficulty, and when `ref` is an earlier block of the same tier (not
+ * genesis) that difficulty may only have moved by the controller's
+ * max_step, plus one for the rounding of the chain field. The solution is
+ * checked apart (pkc_block_pow_valid).
+ */
+static inline bool pkc_block_pow_follows(const block *blk, const block *ref)
+{
+    const tier_pow_challenge_t *c = &blk->tierPoWResult.challenge;
+    const uint32_t bits =
+        block_get_pow_version(blk) == TIER_POW_VERSION_TARGET ? tier_pow_challenge_get_target_bits(c) : 0;
+    if (bits && !tier_pow_target_bits_valid(bits)) return false;
+    if (ref->height > 0 && ref->tier == blk->tier) {
+        const tier_pow_challenge_t *p = &ref->tierPoWResult.challenge;
+        const double was = block_get_pow_version(ref) == TIER_POW_VERSION_TARGET
+                               ? tier_pow_target_complexity(tier_pow_challenge_get_target_bits(p))
+                               : (double)p->complexity;
+        const double now = bits ? tier_pow_target_complexity(bits) : (double)c->complexity;
+        if (fabs(now - was) > tier_pow_difficulty_default()->cfg.max_step + 1.0) return false;
+    }
+    return pkc_block_pow_issued(blk, ref, c->complexity, bits);
+}
+
+/*
+ * Checks a candidate against the chain as it stands: room left, height
+ * equal to the next index and a known tier. With `require_pow` it must
+ * also extend the last block (prevHash is its block_link_hash) and carry
+ * a solution to the exact challenge the chain issues its tier: from the
+ * tier's last block, at the tier's complexity field, or in target mode at
+ * the controller's target for it (tier_pow_difficulty_target_bits). A
+ * revocation or a superseding issue must also be signed by a key with
+ * authority over its certificate (pkc_cert_block_authorised).
+ */
+static inline OpStatus_t pkc_chain_validate(const PKCertChain *chain, const block *blk, bool require_pow)
+{
+    if (!chain || !blk) return OP_NULL_PTR;
+    if (chain->index >= PKC_CHAIN_CAPACITY(chain)) return OP_BUFFER_TOO_SMALL;
+    if (blk->height != chain->index) return OP_INVALID_STATE;
+    const tier_pow_chain_field_t *field = tier_pow_chain_field(blk->tier);
+    if (!field) return OP_INVALID_INPUT;
+    if (!require_pow) return OP_SUCCESS;
+
+    if (chain->index == 0) return OP_INVALID_STATE;
+    uint256 link;
+    if (block_link_hash(&chain->blocks[chain->index - 1], &link) != OP_SUCCESS ||
+        memcmp(&blk->prevHash, &link, sizeof(uint256)) != 0)
+        return OP_INVALID_INPUT;
+    tier_pow_difficulty_t *ctl = tier_pow_difficulty_default();
+    const uint8_t complexity = tier_pow_chain_complexity(chain, field);
+    const uint32_t bits = ctl->cfg.version == TIER_POW_VERSION_TARGET
+                              ? tier_pow_difficulty_target_bits(ctl, blk->tier, complexity) : 0;
+    if (block_get_pow_version(blk) != ctl->cfg.version ||
+        !pkc_block_pow_issued(blk, &chain->blocks[tier_pow_chain_last_index(chain, field)], complexity, bits) ||
+        !pkc_block_pow_valid(blk) || !pkc_cert_block_authorised(chain, blk))
+        return OP_INVALID_INPUT;
+    return OP_SUCCESS;
+}
+
+/*
+ * Retargets `blk`'s tier once it has committed: the difficulty controller
+ * observes the block's own solve (the complexity or target its challenge
+ * carries and tierPoWResult.time_taken) and its answer, at most max_step
+ * from where the controller stood, becomes the tier's complexity field.
+ * Blocks without a timed solve leave it alone. Commit side only, in chain
+ * order.
+ */
+static inline void pkc_chain_retarget(PKCertChain *chain, const block *blk)
+{
+    const tier_pow_chain_field_t *field = tier_pow_chain_field(blk->tier);
+    const double seconds = blk->tierPoWResult.time_taken;
+    if (!field || !(seconds > 0.0)) return;
+
+    tier_pow_difficulty_t *ctl = tier_pow_difficulty_default();
+    const tier_pow_challenge_t *c = &blk->tierPoWResult.challenge;
+    uint8_t next;
+    if (block_get_pow_version(blk) == TIER_POW_VERSION_TARGET) {
+        // the chain field keeps the nearest whole complexity; the exact
+        // target lives in the controller (tier_pow_difficulty_target_bits)
+        uint32_t bits;
+        if (tier_pow_difficulty_observe_target(ctl, blk->tier, tier_pow_challenge_get_target_bits(c), seconds,
+                                               &bits) != OP_SUCCESS)
+            return;
+        const double x = tier_pow_target_complexity(bits);
+        next = x < 1.0 ? 1 : (x > 255.0 ? 255 : (uint8_t)lround(x));
+    } else if (tier_pow_difficulty_observe(ctl, blk->tier, c->complexity, seconds, &next) != OP_SUCCESS) {
+        return;
+    }
+    tier_pow_chain_set_complexity(chain, field, next);
+}
+
+/* Validates and appends one block, moving its tier's last index and complexity. */
+static inline OpStatus_t pkc_chain_apply(PKCertChain *chain, const block *blk, bool require_pow)
+{
+    OpStatus_t st = pkc_chain_validate(chain, blk, require_pow);
+    if (st != OP_SUCCESS) return st;
+
+    const uint64_t start = pkc_metrics_now_ns();
+    block_copy(&chain->blocks[chain->index], blk);
+    tier_pow_chain_set_last_index(chain, tier_pow_chain_field(blk->tier), chain->index);
+    pkc_chain_retarget(chain, blk);
+    chain->index++;
+    pkc_metrics_observe_ns(PKC_HIST_CHAIN_APPEND, pkc_metrics_now_ns() - start);
+    pkc_metrics_count(PKC_CTR_CHAIN_APPENDS, 1);
+    return OP_SUCCESS;
+}
+
+/* Persist hook that rewrites the chain state file under chain->NetworkName. */
+static inline OpStatus_t pkc_chain_persist_state(void *ctx, const PKCertChain *chain, uint32_t first, uint32_t count)
+{
+    (void)ctx;
+    (void)first;
+    (void)count;
+    return save_chain_state(chain->NetworkName, chain);
+}
+
+/* ---------------- tip and epochs ---------------- */
+
+static inline pkc_chain_tip_t *pkc_chain_tip_build(const PKCertChain *chain, uint64_t seq)
+{
+    pkc_chain_tip_t *tip = (pkc_chain_tip_t *)calloc(1, sizeof(*tip));
+    if (!tip) return NULL;
+    tip->index = chain->index;
+    tip->seq = seq;
+    if (chain->index > 0) {
+        const block *last = &chain->blocks[chain->index - 1];
+        tip->height = last->height;
+        tip->cert_hash = last->CurrentCertHash;
+        block_link_hash(last, &tip->hash);
+    }
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        tip->last_index[t] = tier_pow_chain_last_index(chain, &tier_pow_chain_fields[t]);
+        tip->complexity[t] = tier_pow_chain_complexity(chain, &tier_pow_chain_fields[t]);
+    }
+    return tip;
+}
+
+/* Frees retired tips no reader can still hold. Writer only. */
+static inline void pkc_chain_reclaim(pkc_chain_writer_t *w)
+{
+    uint64_t oldest = UINT64_MAX;
+    const uint32_t n = atomic_load(&w->nreaders);
+    for (uint32_t r = 0; r < n; ++r) {
+        const uint64_t e = atomic_load(&w->readers[r].epoch);
+        if (e != 0 && e < oldest) oldest = e;
+    }
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < w->nretired; ++i) {
+        if (w->retired[i].epoch <= oldest) {
+            free(w->retired[i].tip);
+        } else {
+            w->retired[kept++] = w->retired[i];
+        }
+    }
+    w->nretired = kept;
+}
+
+/*
+ * Swaps in a new tip. The old one is retired at the epoch after the swap:
+ * readers that announce that epoch or later loaded the new tip.
+ */
+static inline void pkc_chain_publish(pkc_chain_writer_t *w, pkc_chain_tip_t *tip)
+{
+    while (w->nretired == PKC_CHAIN_RETIRED_MAX) {
+        pkc_chain_reclaim(w);
+        if (w->nretired == PKC_CHAIN_RETIRED_MAX) sched_yield();
+    }
+    pkc_chain_tip_t *old = atomic_exchange(&w->tip, tip);
+    const uint64_t epoch = atomic_fetch_add(&w->epoch, 1) + 1;
+    if (old) w->retired[w->nretired++] = (pkc_chain_retired_t){ old, epoch };
+    pkc_chain_reclaim(w);
+}
+
+/* ---------------- readers ---------------- */
+
+__attribute__((weak)) _Atomic(uint64_t) pkc_chain_writer_generations;
+
+// Running writers, so an exiting thread can find the one its slot belongs to.
+__attribute__((weak)) pthread_mutex_t pkc_chain_writers_lock = PTHREAD_MUTEX_INITIALIZER;
+__attribute__((weak)) pkc_chain_writer_t *pkc_chain_writers_live;
+__attribute__((weak)) pthread_key_t pkc_chain_reader_key;
+__attribute__((weak)) pthread_once_t pkc_chain_reader_key_once = PTHREAD_ONCE_INIT;
+
+// Reader slot of the calling thread, cached for the last writer it used.
+__attribute__((weak)) __thread uint64_t pkc_chain_tls_generation;
+__attribute__((weak)) __thread uint32_t pkc_chain_tls_reader;
+
+/* Claims a free reader slot. OP_BUFFER_TOO_SMALL when all are taken. */
+static inline OpStatus_t pkc_chain_reader_register(pkc_chain_writer_t *w, uint32_t *out_slot)
+{
+    if (!w || !out_slot) return OP_NULL_PTR;
+    for (uint32_t slot = 0; slot < PKC_CHAIN_READERS_MAX; ++slot) {
+        uint32_t expected = 0;
+        if (atomic_load_explicit(&w->readers[slot].used, memory_order_relaxed) ||
+            !atomic_compare_exchange_strong(&w->readers[slot].used, &expected, 1)) continue;
+        atomic_store(&w->readers[slot].epoch, 0);
+        // reclaim scans [0, nreaders)
+        uint32_t n = atomic_load(&w->nreaders);
+        while (n <= slot && !atomic_compare_exchange_weak(&w->nreaders, &n, slot + 1)) {}
+        *out_slot = slot;
+        return OP_SUCCESS;
+    }
+    return OP_BUFFER_TOO_SMALL;
+}
+
+/* Returns a slot claimed with pkc_chain_reader_register. Outside a read section. */
+static inline void pkc_chain_reader_unregister(pkc_chain_writer_t *w, uint32_t slot)
+{
+    if (!w || slot >= PKC_CHAIN_READERS_MAX) return;
+    atomic_store(&w->readers[slot].epoch, 0);
+    atomic_store_explicit(&w->readers[slot].used, 0, memory_order_release);
+}
+
+/*
+ * Releases the calling thread's cached slot if its writer is still
+ * running. Runs automatically at thread exit.
+ */
+static inline void pkc_chain_reader_release_self(void)
+{
+    if (pkc_chain_tls_generation == 0) return;
+    pthread_mutex_lock(&pkc_chain_writers_lock);
+    for (pkc_chain_writer_t *w = pkc_chain_writers_live; w; w = w->live_next) {
+        if (w->generation == pkc_chain_tls_generation) {
+            pkc_chain_reader_unregister(w, pkc_chain_tls_reader);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pkc_chain_writers_lock);
+    pkc_chain_tls_generation = 0;
+}
+
+static inline void pkc_chain_reader_exit(void *unused)
+{
+    (void)unused;
+    pkc_chain_reader_release_self();
+}
+
+static inline void pkc_chain_reader_key_create(void)
+{
+    pthread_key_create(&pkc_chain_reader_key, pkc_chain_reader_exit);
+}
+
+/* Slot for the calling thread, registered on first use. */
+static inline OpStatus_t pkc_chain_reader_self(pkc_chain_writer_t *w, uint32_t *out_slot)
+{
+    if (!w || !out_slot) return OP_NULL_PTR;
+    if (pkc_chain_tls_generation != w->generation) {
+        pkc_chain_reader_release_self();
+        OpStatus_t st = pkc_chain_reader_register(w, &pkc_chain_tls_reader);
+        if (st != OP_SUCCESS) return st;
+        pkc_chain_tls_generation = w->generation;
+        pthread_once(&pkc_chain_reader_key_once, pkc_chain_reader_key_create);
+        pthread_setspecific(pkc_chain_reader_key, (void *)1);
+    }
+    *out_slot = pkc_chain_tls_reader;
+    return OP_SUCCESS;
+}
+
+/*
+ * Opens a read section and returns the current tip, valid until
+ * pkc_chain_read_end. Sections do not nest.
+ */
+PKC_CHAIN_WRITER_INLINE const pkc_chain_tip_t *pkc_chain_read_begin(pkc_chain_writer_t *w, uint32_t slot)
+{
+    atomic_store(&w->readers[slot].epoch, atomic_load(&w->epoch));
+    return atomic_load(&w->tip);
+}
+
+PKC_CHAIN_WRITER_INLINE void pkc_chain_read_end(pkc_chain_writer_t *w, uint32_t slot)
+{
+    atomic_store_explicit(&w->readers[slot].epoch, 0, memory_order_release);
+}
+
+/* Committed block `i` under `tip`, NULL past the tip. Inside a read section. */
+PKC_CHAIN_WRITER_INLINE const block *pkc_chain_read_block(const pkc_chain_writer_t *w, const pkc_chain_tip_t *tip,
+                                                          uint32_t i)
+{
+    return i < tip->index ? &w->chain->blocks[i] : NULL;
+}
+
+/* Copy of the current tip for callers that do not want a section. */
+static inline OpStatus_t pkc_chain_tip_copy(pkc_chain_writer_t *w, pkc_chain_tip_t *out)
+{
+    if (!w || !out) return OP_NULL_PTR;
+    uint32_t slot;
+    OpStatus_t st = pkc_chain_reader_self(w, &slot);
+    if (st != OP_SUCCESS) return st;
+    *out = *pkc_chain_read_begin(w, slot);
+    pkc_chain_read_end(w, slot);
+    return OP_SUCCESS;
+}
+
+/* ---------------- MPSC intake ---------------- */
+
+/*
+ * Queues a candidate. `ticket` (optional) completes once the block is
+ * committed or rejected. OP_BUFFER_TOO_SMALL when the ring is full,
+ * OP_INVALID_STATE when the writer is not running, the persist error once
+ * a batch failed to persist.
+ */
+static inline OpStatus_t pkc_chain_submit(pkc_chain_writer_t *w, const block *blk, pkc_chain_ticket_t *ticket)
+{
+    if (!w || !blk) return OP_NULL_PTR;
+    if (!atomic_load_explicit(&w->running, memory_order_acquire)) return OP_INVALID_STATE;
+    const OpStatus_t failed = atomic_load_explicit(&w->failed, memory_order_acquire);
+    if (failed != OP_SUCCESS) return failed;
+    if (ticket) pkc_chain_ticket_init(ticket);
+
+    uint64_t pos = atomic_load_explicit(&w->tail, memory_order_relaxed);
+    pkc_chain_slot_t *slot;
+    for (;;) {
+        slot = &w->ring[pos & (PKC_CHAIN_WRITER_QUEUE - 1)];
+        const uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        const int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&w->tail, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return OP_BUFFER_TOO_SMALL;
+        } else {
+            pos = atomic_load_explicit(&w->tail, memory_order_relaxed);
+        }
+    }
+    block_copy(&slot->blk, blk);
+    slot->ticket = ticket;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    atomic_fetch_add_explicit(&w->queued, 1, memory_order_relaxed);
+
+    // Dekker pair with the writer: slot published, then read `sleeping`.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load(&w->sleeping)) {
+        pthread_mutex_lock(&w->lock);
+        pthread_cond_signal(&w->wake);
+        pthread_mutex_unlock(&w->lock);
+    }
+    return OP_SUCCESS;
+}
+
+PKC_CHAIN_WRITER_INLINE pkc_chain_slot_t *pkc_chain_peek(pkc_chain_writer_t *w)
+{
+    pkc_chain_slot_t *slot = &w->ring[w->head & (PKC_CHAIN_WRITER_QUEUE - 1)];
+    return atomic_load_explicit(&slot->seq, memory_order_acquire) == w->head + 1 ? slot : NULL;
+}
+
+PKC_CHAIN_WRITER_INLINE void pkc_chain_release_slot(pkc_chain_writer_t *w, pkc_chain_slot_t *slot)
+{
+    atomic_store_explicit(&slot->seq, w->head + PKC_CHAIN_WRITER_QUEUE, memory_order_release);
+    w->head++;
+    atomic_fetch_sub_explicit(&w->queued, 1, memory_order_relaxed);
+}
+
+/* Blocks until `ticket` completes and returns its status. */
+static inline OpStatus_t pkc_chain_ticket_wait(pkc_chain_writer_t *w, pkc_chain_ticket_t *ticket)
+{
+    if (!w || !ticket) return OP_NULL_PTR;
+    if (!atomic_load_explicit(&ticket->done, memory_order_acquire)) {
+        pthread_mutex_lock(&w->lock);
+        while (!atomic_load_explicit(&ticket->done, memory_order_acquire))
+            pthread_cond_wait(&w->committed, &w->lock);
+        pthread_mutex_unlock(&w->lock);
+    }
+    return ticket->status;
+}
+
+/* submit + wait. */
+static inline OpStatus_t pkc_chain_append(pkc_chain_writer_t *w, const block *blk, uint64_t *out_height)
+{
+    pkc_chain_ticket_t ticket;
+    OpStatus_t st = pkc_chain_submit(w, blk, &ticket);
+    if (st != OP_SUCCESS) return st;
+    st = pkc_chain_ticket_wait(w, &ticket);
+    if (st == OP_SUCCESS && out_height) *out_height = ticket.height;
+    return st;
+}
+
+/* ---------------- writer thread ---------------- */
+
+/* Commits up to PKC_CHAIN_WRITER_BATCH queued candidates; returns how many were taken. */
+static inline uint32_t pkc_chain_commit_batch(pkc_chain_writer_t *w)
+{
+    pkc_chain_ticket_t *tickets[PKC_CHAIN_WRITER_BATCH];
+    OpStatus_t status[PKC_CHAIN_WRITER_BATCH];
+    uint32_t taken = 0;
+    const uint32_t first = w->chain->index;
+    const OpStatus_t failed = atomic_load_explicit(&w->failed, memory_order_relaxed);
+    uint32_t last_index[TIER_POW_DIFFICULTY_TIERS];
+    uint8_t complexity[TIER_POW_DIFFICULTY_TIERS];
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        last_index[t] = tier_pow_chain_last_index(w->chain, &tier_pow_chain_fields[t]);
+        complexity[t] = tier_pow_chain_complexity(w->chain, &tier_pow_chain_fields[t]);
+    }
+
+    pkc_chain_slot_t *slot;
+    while (taken < PKC_CHAIN_WRITER_BATCH && (slot = pkc_chain_peek(w)) != NULL) {
+        status[taken] = failed != OP_SUCCESS ? failed : pkc_chain_apply(w->chain, &slot->blk, w->cfg.require_pow);
+        tickets[taken] = slot->ticket;
+        pkc_chain_release_slot(w, slot);
+        taken++;
+    }
+    if (taken == 0) return 0;
+
+    uint32_t appended = w->chain->index - first;
+    pkc_metrics_count(PKC_CTR_CHAIN_COMMIT_BATCHES, 1);
+    if (appended < taken) pkc_metrics_count(PKC_CTR_CHAIN_REJECTS, taken - appended);
+    OpStatus_t persisted = OP_SUCCESS;
+    if (appended > 0 && w->cfg.persist)
+        persisted = w->cfg.persist(w->cfg.persist_ctx, w->chain, first, appended);
+    if (persisted != OP_SUCCESS) {
+        // not durable, so not committed: back to the published tip, and no more intake
+        w->chain->index = first;
+        for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+            tier_pow_chain_set_last_index(w->chain, &tier_pow_chain_fields[t], last_index[t]);
+            tier_pow_chain_set_complexity(w->chain, &tier_pow_chain_fields[t], complexity[t]);
+        }
+        atomic_store_explicit(&w->failed, persisted, memory_order_release);
+        pkc_metrics_count(PKC_CTR_CHAIN_REJECTS, appended);
+        appended = 0;
+    }
+
+    if (appended > 0 && w->cfg.columns) pkc_columns_sync(w->cfg.columns, w->chain);
+    if (appended > 0 && w->cfg.tiers) pkc_tier_index_sync(w->cfg.tiers, w->chain);
+    if (appended > 0 && w->cfg.certs) pkc_cert_index_sync(w->cfg.certs, w->chain);
+    pkc_chain_tip_t *prev = atomic_load_explicit(&w->tip, memory_order_relaxed);
+    if (appended > 0) {
+        pkc_chain_tip_t *tip = pkc_chain_tip_build(w->chain, prev ? prev->seq + 1 : 1);
+        if (tip) pkc_chain_publish(w, tip);
+    }
+
+    uint64_t height = first;
+    pthread_mutex_lock(&w->lock);
+    for (uint32_t i = 0; i < taken; ++i) {
+        if (!tickets[i]) {
+            if (status[i] == OP_SUCCESS) height++;
+            continue;
+        }
+        tickets[i]->status = status[i] == OP_SUCCESS ? persisted : status[i];
+        tickets[i]->height = tickets[i]->status == OP_SUCCESS ? height++ : 0;
+        atomic_store_explicit(&tickets[i]->done, 1, memory_order_release);
+    }
+    pthread_cond_broadcast(&w->committed);
+    pthread_mutex_unlock(&w->lock);
+    return taken;
+}
+
+/*
+ * Saves the cert index's filter (pkc_cert_filter_save) once
+ * cert_filter_save_ns has passed since the last save, or with `force`,
+ * if blocks were applied since. Runs on the writer thread, beside the
+ * persist and flush hooks, so the filter is not moving underneath it.
+ */
+static inline void pkc_chain_writer_save_certs(pkc_chain_writer_t *w, bool force)
+{
+    if (!w->cfg.certs || !w->cfg.cert_filter_save_ns || w->cfg.certs->count == w->certs_saved) return;
+    const uint64_t now = pkc_metrics_now_ns();
+    if (!force && now - w->certs_saved_ns < w->cfg.cert_filter_save_ns) return;
+    if (pkc_cert_filter_save(&w->cfg.certs->filter, w->chain->NetworkName, w->chain) != OP_SUCCESS) return;
+    w->certs_saved = w->cfg.certs->count;
+    w->certs_saved_ns = now;
+}
+
+static inline void *pkc_chain_writer_main(void *arg)
+{
+    pkc_chain_writer_t *w = (pkc_chain_writer_t *)arg;
+    for (;;) {
+        if (pkc_chain_commit_batch(w) > 0) {
+            pkc_chain_writer_save_certs(w, false);
+            continue;
+        }
+        if (!atomic_load_explicit(&w->running, memory_order_acquire)) break;
+
+        uint64_t interval = w->cfg.flush ? w->cfg.flush_interval_ns : 0;
+        if (w->cfg.certs && w->cfg.cert_filter_save_ns && (!interval || w->cfg.cert_filter_save_ns < interval))
+            interval = w->cfg.cert_filter_save_ns;
+        const bool timed = interval != 0;
+        bool timed_out = false;
+        struct timespec deadline;
+        if (timed) {
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            const uint64_t ns = (uint64_t)deadline.tv_nsec + interval;
+            deadline.tv_sec += (time_t)(ns / 1000000000ULL);
+            deadline.tv_nsec = (long)(ns % 1000000000ULL);
+        }
+
+        pthread_mutex_lock(&w->lock);
+        atomic_store(&w->sleeping, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        while (!pkc_chain_peek(w) && atomic_load_explicit(&w->running, memory_order_acquire) && !timed_out) {
+            if (timed) timed_out = pthread_cond_timedwait(&w->wake, &w->lock, &deadline) == ETIMEDOUT;
+            else pthread_cond_wait(&w->wake, &w->lock);
+        }
+        atomic_store(&w->sleeping, 0);
+        pthread_mutex_unlock(&w->lock);
+        if (timed_out && w->cfg.flush) w->cfg.flush(w->cfg.persist_ctx, false);
+        if (timed_out) pkc_chain_writer_save_certs(w, false);
+    }
+    // On this thread: asynchronous I/O it submitted must complete before it exits.
+    if (w->cfg.flush) w->cfg.flush(w->cfg.persist_ctx, true);
+    pkc_chain_writer_save_certs(w, true);
+    return NULL;
+}
+
+static inline void pkc_chain_writer_stop(pkc_chain_writer_t *w);
+
+/*
+ * Starts the writer over `chain`, which it owns from here on. `cfg` may be
+ * NULL (in memory, no PoW re-check).
+ */
+static inline OpStatus_t pkc_chain_writer_start(pkc_chain_writer_t *w, PKCertChain *chain,
+                                                const pkc_chain_writer_config_t *cfg)
+{
+    if (!w || !chain) return OP_NULL_PTR;
+    memset(w, 0, sizeof(*w));
+    w->chain = chain;
+    w->generation = atomic_fetch_add(&pkc_chain_writer_generations, 1) + 1;
+    if (cfg) w->cfg = *cfg;
+    if (w->cfg.columns) {
+        // columns must cover the whole chain, starting from what is already there
+        if (w->cfg.columns->capacity < PKC_CHAIN_CAPACITY(chain)) return OP_BUFFER_TOO_SMALL;
+        OpStatus_t st = pkc_columns_sync(w->cfg.columns, chain);
+        if (st != OP_SUCCESS) return st;
+    }
+    if (w->cfg.tiers) {
+        if (w->cfg.tiers->capacity < PKC_CHAIN_CAPACITY(chain)) return OP_BUFFER_TOO_SMALL;
+        OpStatus_t st = pkc_tier_index_sync(w->cfg.tiers, chain);
+        if (st != OP_SUCCESS) return st;
+        // before any miner runs: a fresh controller retargets from the chain's recent solves
+        pkc_tier_index_seed_difficulty(w->cfg.tiers, tier_pow_difficulty_default());
+    }
+    if (w->cfg.certs) {
+        if (w->cfg.certs->capacity < PKC_CHAIN_CAPACITY(chain)) return OP_BUFFER_TOO_SMALL;
+        OpStatus_t st = pkc_cert_index_sync(w->cfg.certs, chain);
+        if (st != OP_SUCCESS) return st;
+        w->certs_saved_ns = pkc_metrics_now_ns();
+    }
+
+    w->ring = (pkc_chain_slot_t *)calloc(PKC_CHAIN_WRITER_QUEUE, sizeof(*w->ring));
+    if (!w->ring) return OP_INVALID_STATE;
+    for (uint64_t i = 0; i < PKC_CHAIN_WRITER_QUEUE; ++i) atomic_init(&w->ring[i].seq, i);
+
+    atomic_init(&w->epoch, 1);
+    pkc_chain_tip_t *tip = pkc_chain_tip_build(chain, 0);
+    if (!tip) {
+        free(w->ring);
+        w->ring = NULL;
+        return OP_INVALID_STATE;
+    }
+    atomic_init(&w->tip, tip);
+
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&w->wake, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_cond_init(&w->committed, NULL);
+    atomic_store(&w->running, true);
+    if (pthread_create(&w->tid, NULL, pkc_chain_writer_main, w) != 0) {
+        atomic_store(&w->running, false);
+        pthread_cond_destroy(&w->committed);
+        pthread_cond_destroy(&w->wake);
+        pthread_mutex_destroy(&w->lock);
+        free(tip);
+        free(w->ring);
+        w->ring = NULL;
+        return OP_INVALID_STATE;
+    }
+
+    pthread_mutex_lock(&pkc_chain_writers_lock);
+    w->live_next = pkc_chain_writers_live;
+    pkc_chain_writers_live = w;
+    pthread_mutex_unlock(&pkc_chain_writers_lock);
+    return OP_SUCCESS;
+}
+
+/*
+ * Stops intake, commits what is already queued and joins the writer.
+ * Producers must have stopped submitting and readers left their sections.
+ */
+static inline void pkc_chain_writer_stop(pkc_chain_writer_t *w)
+{
+    if (!w || !w->ring) return;
+    pthread_mutex_lock(&pkc_chain_writers_lock);
+    for (pkc_chain_writer_t **p = &pkc_chain_writers_live; *p; p = &(*p)->live_next) {
+        if (*p == w) {
+            *p = w->live_next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pkc_chain_writers_lock);
+
+    pthread_mutex_lock(&w->lock);
+    atomic_store_explicit(&w->running, false, memory_order_release);
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->tid, NULL);
+    // Candidates published between the writer's last peek and its exit.
+    bool late = false;
+    while (pkc_chain_commit_batch(w) > 0) late = true;
+    if (late && w->cfg.flush) w->cfg.flush(w->cfg.persist_ctx, true);
+    if (late) pkc_chain_writer_save_certs(w, true);
+
+    for (uint32_t i = 0; i < w->nretired; ++i) free(w->retired[i].tip);
+    w->nretired = 0;
+    free(atomic_load(&w->tip));
+    atomic_store(&w->tip, NULL);
+    pthread_cond_destroy(&w->committed);
+    pthread_cond_destroy(&w->wake);
+    pthread_mutex_destroy(&w->lock);
+    free(w->ring);
+    w->ring = NULL;
+}
+
+PKC_CHAIN_WRITER_INLINE bool pkc_chain_writer_running(const pkc_chain_writer_t *w)
+{
+    return w && atomic_load_explicit(&w->running, memory_order_acquire);
+}
+
+/* The persist error that stopped intake, OP_SUCCESS while the writer is healthy. */
+PKC_CHAIN_WRITER_INLINE OpStatus_t pkc_chain_writer_failed(pkc_chain_writer_t *w)
+{
+    return w ? atomic_load_explicit(&w->failed, memory_order_acquire) : OP_NULL_PTR;
+}
+
+/* Candidates waiting for the writer (chain_writer_queued gauge). */
+PKC_CHAIN_WRITER_INLINE size_t pkc_chain_writer_queued(pkc_chain_writer_t *w)
+{
+    return w ? atomic_load_explicit(&w->queued, memory_order_relaxed) : 0;
+}
+
+/* Last index of `tier` under `tip`, 0 for an unknown tier. */
+PKC_CHAIN_WRITER_INLINE uint32_t pkc_chain_tip_last_index(const pkc_chain_tip_t *tip, Tier_t tier)
+{
+    const int slot = tier_pow_difficulty_slot(tier);
+    return slot < 0 ? 0 : tip->last_index[slot];
+}
+
+/* Complexity of `tier` under `tip`, 0 for an unknown tier. */
+PKC_CHAIN_WRITER_INLINE uint8_t pkc_chain_tip_complexity(const pkc_chain_tip_t *tip, Tier_t tier)
+{
+    const int slot = tier_pow_difficulty_slot(tier);
+    return slot < 0 ? 0 : tip->complexity[slot];
+}
+
+#endif // PKC_CHAIN_WRITER_H
@@ -14,6 +14,7 @@
 #include <string.h>
 #include "blockchain/block.h"
 #include "blockhain/PKCertChain.h"
+#include "blockchain/blockBulk_ops.h"
 
 #include "crypto/SignUtils.h"
 #include "crypto/EncUtils.h"
@@ -28,6 +29,7 @@
 #include "protocol/proofs/TierPoW/tierPoWVerify.h"
 #include "protocol/proofs/TierPoW/tierPoWSession.h"
 #include "protocol/proofs/TierPoW/tierPoWQueue.h"
+#include "telemetry/metrics_ops.h"
 
 PKCERTCHAIN_INLINE OpStatus_t Gensis_Block(PKCertChain *chain)
 {
@@ -128,13 +130,11 @@ PKCERTCHAIN_INLINE OpStatus_t save_chain_state(const char *network_name, const P
     serialize_u32_be(index, buf + off);
     off += UINT32_SIZE;
 
-    for (uint32_t i = 0; i < index; ++i) {
-        if (block_serialize(&chain->blocks[i], buf + off, BLOCK_SIZE) != OP_SUCCESS) {
-            free(buf);
-            return OP_INVALID_INPUT;
-        }
-        off += BLOCK_SIZE;
+    if (blocks_serialize(chain->blocks, index, buf + off, blocks_len) != OP_SUCCESS) {
+        free(buf);
+        return OP_INVALID_INPUT;
     }
+    off += blocks_len;
 
     if (off != payload_len) {
         free(buf);
@@ -148,8 +148,13 @@ PKCERTCHAIN_INLINE OpStatus_t save_chain_state(const char *network_name, const P
         return OP_INVALID_INPUT;
     }
 
+    uint64_t persist_start = pkc_metrics_now_ns();
     st = save_file_0600(state_path, buf, total_len);
     free(buf);
+    if (st == OP_SUCCESS) {
+        pkc_metrics_observe_ns(PKC_HIST_CHAIN_PERSIST, pkc_metrics_now_ns() - persist_start);
+        pkc_metrics_count(PKC_CTR_CHAIN_PERSISTS, 1);
+    }
     return st;
 }
 
@@ -231,12 +236,9 @@ PKCERTCHAIN_INLINE OpStatus_t load_chain_state(const char *network_name, PKCertC
     }
 
     out_chain->index = index;
-    for (uint32_t i = 0; i < index; ++i) {
-        if (block_deserialize(buf + off, BLOCK_SIZE, &out_chain->blocks[i]) != OP_SUCCESS) {
-            free(buf);
-            return OP_INVALID_INPUT;
-        }
-        off += BLOCK_SIZE;
+    if (blocks_deserialize(buf + off, payload_len - off, out_chain->blocks, index) != OP_SUCCESS) {
+        free(buf);
+        return OP_INVALID_INPUT;
     }
 
     free(buf);
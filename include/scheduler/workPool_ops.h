@@ -0,0 +1,537 @@
+#ifndef PKC_WORK_POOL_H
+#define PKC_WORK_POOL_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "core/enums/OpStatus.h"
+#include "telemetry/metrics_ops.h"
+
+#ifndef PKC_POOL_INLINE
+#define PKC_POOL_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Process-wide work-stealing pool for PoW mining, MiniPoW verification
+ * and chain validation, so those kernels share one set of threads instead
+ * of each spawning its own.
+ *
+ * Every worker owns one deque per priority class. A worker pushes and pops
+ * its own deques at the tail (LIFO, cache-warm); thieves and the worker
+ * itself take from the head of other queues (FIFO). Threads outside the
+ * pool submit into a shared injection queue per class. A worker always
+ * looks for the highest class first across its own deque, the injection
+ * queue and its victims, so queued verification runs before mining.
+ * Classes are not preemptive by themselves: a long mining kernel calls
+ * pkc_pool_yield between chunks, which runs any queued higher-class work
+ * on its thread before it resumes.
+ *
+ * Victims on the worker's own NUMA node (from /sys/devices/system/node)
+ * are tried before remote ones. With `pin` set, worker i is bound to the
+ * i-th CPU of the process affinity mask.
+ *
+ * Cancellation is cooperative: a task carries an optional token; tasks
+ * whose token is cancelled before they start are skipped, and running
+ * kernels poll pkc_pool_cancelled between chunks. Fork/join goes through
+ * a pkc_pool_group_t: pkc_pool_wait runs queued tasks of the group's class
+ * or higher while it waits, so waiting inside a worker cannot deadlock.
+ *
+ * Deques are small mutex-guarded rings. A full deque runs the task inline.
+ */
+
+#define PKC_POOL_MAX_WORKERS 256
+#define PKC_POOL_MAX_CPUS 1024
+#define PKC_POOL_MAX_NODES 64
+#define PKC_POOL_MASK_WORDS (PKC_POOL_MAX_CPUS / (8 * sizeof(unsigned long)))
+#define PKC_POOL_MASK_BITS (8 * sizeof(unsigned long))
+
+#ifndef PKC_POOL_DEQUE_CAPACITY
+#define PKC_POOL_DEQUE_CAPACITY 1024 // power of two
+#endif
+
+#ifndef PKC_POOL_IDLE_SPINS
+#define PKC_POOL_IDLE_SPINS 64
+#endif
+
+typedef enum {
+    PKC_POOL_PRIO_VERIFY = 0,       // MiniPoW / TierPoW verification
+    PKC_POOL_PRIO_VALIDATE,         // chain validation
+    PKC_POOL_PRIO_MINE,             // TierPoW search, benchmarks
+    PKC_POOL_PRIO_COUNT,
+} pkc_pool_prio_t;
+
+typedef struct {
+    _Atomic(int) cancelled;
+} pkc_pool_cancel_t;
+
+typedef struct {
+    _Atomic(uint32_t) pending;
+    pkc_pool_prio_t prio;
+} pkc_pool_group_t;
+
+typedef void (*pkc_pool_fn)(void *arg, const pkc_pool_cancel_t *cancel);
+
+typedef struct {
+    pkc_pool_fn fn;
+    void *arg;
+    const pkc_pool_cancel_t *cancel;
+    pkc_pool_group_t *group;
+    pkc_pool_prio_t prio;
+} pkc_pool_task_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pkc_pool_task_t tasks[PKC_POOL_DEQUE_CAPACITY];
+    uint32_t head;                  // steal end
+    uint32_t tail;                  // owner end
+} pkc_pool_deque_t;
+
+typedef struct {
+    uint32_t threads;               // 0: CPUs in the affinity mask
+    bool pin;
+} pkc_pool_config_t;
+
+struct pkc_pool;
+
+typedef struct __attribute__((aligned(64))) {
+    pkc_pool_deque_t q[PKC_POOL_PRIO_COUNT];
+    struct pkc_pool *pool;
+    pthread_t tid;
+    uint32_t index;
+    int cpu;                        // -1 when not pinned
+    int node;
+    uint32_t *victims;              // other workers, same node first
+    _Atomic(uint64_t) executed;
+    _Atomic(uint64_t) stolen;
+} pkc_pool_worker_t;
+
+typedef struct pkc_pool {
+    pkc_pool_config_t cfg;
+    pkc_pool_worker_t *workers;
+    uint32_t nworkers;
+    uint32_t *victim_table;
+    pkc_pool_deque_t inject[PKC_POOL_PRIO_COUNT];
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t wake;
+    _Atomic(uint32_t) sleepers;
+    _Atomic(uint64_t) queued;
+    _Atomic(uint64_t) queued_class[PKC_POOL_PRIO_COUNT];
+    _Atomic(bool) running;
+    uint32_t nodes;
+} pkc_pool_t;
+
+// Worker the calling thread belongs to, NULL outside any pool.
+__attribute__((weak)) __thread pkc_pool_worker_t *pkc_pool_tls_worker;
+
+/* ---------------- cancellation / groups ---------------- */
+
+PKC_POOL_INLINE void pkc_pool_cancel_init(pkc_pool_cancel_t *tok)
+{
+    atomic_init(&tok->cancelled, 0);
+}
+
+PKC_POOL_INLINE void pkc_pool_cancel(pkc_pool_cancel_t *tok)
+{
+    atomic_store_explicit(&tok->cancelled, 1, memory_order_release);
+}
+
+PKC_POOL_INLINE bool pkc_pool_cancelled(const pkc_pool_cancel_t *tok)
+{
+    return tok && atomic_load_explicit(&((pkc_pool_cancel_t *)tok)->cancelled, memory_order_acquire);
+}
+
+PKC_POOL_INLINE void pkc_pool_group_init(pkc_pool_group_t *g, pkc_pool_prio_t prio)
+{
+    atomic_init(&g->pending, 0);
+    g->prio = prio;
+}
+
+/* ---------------- deques ---------------- */
+
+static inline void pkc_pool_deque_init(pkc_pool_deque_t *d)
+{
+    pthread_mutex_init(&d->lock, NULL);
+    d->head = d->tail = 0;
+}
+
+PKC_POOL_INLINE bool pkc_pool_deque_push(pkc_pool_deque_t *d, const pkc_pool_task_t *t)
+{
+    pthread_mutex_lock(&d->lock);
+    bool ok = d->tail - d->head < PKC_POOL_DEQUE_CAPACITY;
+    if (ok) {
+        d->tasks[d->tail & (PKC_POOL_DEQUE_CAPACITY - 1)] = *t;
+        __atomic_store_n(&d->tail, d->tail + 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+PKC_POOL_INLINE bool pkc_pool_deque_pop_tail(pkc_pool_deque_t *d, pkc_pool_task_t *out)
+{
+    if (__atomic_load_n(&d->tail, __ATOMIC_RELAXED) == __atomic_load_n(&d->head, __ATOMIC_RELAXED)) return false;
+    pthread_mutex_lock(&d->lock);
+    bool ok = d->tail != d->head;
+    if (ok) {
+        __atomic_store_n(&d->tail, d->tail - 1, __ATOMIC_RELAXED);
+        *out = d->tasks[d->tail & (PKC_POOL_DEQUE_CAPACITY - 1)];
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+PKC_POOL_INLINE bool pkc_pool_deque_pop_head(pkc_pool_deque_t *d, pkc_pool_task_t *out)
+{
+    if (__atomic_load_n(&d->tail, __ATOMIC_RELAXED) == __atomic_load_n(&d->head, __ATOMIC_RELAXED)) return false;
+    pthread_mutex_lock(&d->lock);
+    bool ok = d->tail != d->head;
+    if (ok) {
+        *out = d->tasks[d->head & (PKC_POOL_DEQUE_CAPACITY - 1)];
+        __atomic_store_n(&d->head, d->head + 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+/* ---------------- topology ---------------- */
+
+/* Parses a sysfs cpulist ("0-3,8,10-11") into cpu -> node. */
+static inline void pkc_pool_parse_cpulist(const char *s, int node, int *cpu_node)
+{
+    while (*s) {
+        char *end;
+        long a = strtol(s, &end, 10);
+        if (end == s) break;
+        long b = a;
+        if (*end == '-') b = strtol(end + 1, &end, 10);
+        for (long c = a; c <= b && c < PKC_POOL_MAX_CPUS; ++c) {
+            if (c >= 0) cpu_node[c] = node;
+        }
+        s = (*end == ',') ? end + 1 : end;
+        if (*s == '\n') break;
+    }
+}
+
+static inline uint32_t pkc_pool_read_topology(int *cpu_node)
+{
+    for (int c = 0; c < PKC_POOL_MAX_CPUS; ++c) cpu_node[c] = 0;
+    uint32_t nodes = 0;
+    for (int n = 0; n < PKC_POOL_MAX_NODES; ++n) {
+        char path[64], buf[512];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", n);
+        FILE *f = fopen(path, "r");
+        if (!f) continue;
+        if (fgets(buf, sizeof(buf), f)) pkc_pool_parse_cpulist(buf, n, cpu_node);
+        fclose(f);
+        nodes = (uint32_t)n + 1;
+    }
+    return nodes ? nodes : 1;
+}
+
+/* ---------------- scheduling ---------------- */
+
+PKC_POOL_INLINE void pkc_pool_run_task(const pkc_pool_task_t *t)
+{
+    if (!pkc_pool_cancelled(t->cancel)) t->fn(t->arg, t->cancel);
+    if (t->group) atomic_fetch_sub_explicit(&t->group->pending, 1, memory_order_acq_rel);
+}
+
+/*
+ * Finds the next task of class <= max_prio for `self` (NULL: a thread
+ * outside the pool): own tail, injection queue, then victims' heads.
+ */
+static inline bool pkc_pool_find(pkc_pool_t *pool, pkc_pool_worker_t *self, pkc_pool_prio_t max_prio,
+                                 pkc_pool_task_t *out)
+{
+    for (int p = 0; p <= (int)max_prio; ++p) {
+        if (self && pkc_pool_deque_pop_tail(&self->q[p], out)) goto found;
+        if (pkc_pool_deque_pop_head(&pool->inject[p], out)) goto found;
+        for (uint32_t v = 0; v + (self ? 1 : 0) < pool->nworkers; ++v) {
+            pkc_pool_worker_t *victim = self ? &pool->workers[self->victims[v]] : &pool->workers[v];
+            if (pkc_pool_deque_pop_head(&victim->q[p], out)) {
+                if (self) atomic_fetch_add_explicit(&self->stolen, 1, memory_order_relaxed);
+                pkc_metrics_count(PKC_CTR_POOL_STEALS, 1);
+                goto found;
+            }
+        }
+    }
+    return false;
+found:
+    atomic_fetch_sub_explicit(&pool->queued, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&pool->queued_class[out->prio], 1, memory_order_relaxed);
+    return true;
+}
+
+static inline void *pkc_pool_worker_main(void *arg)
+{
+    pkc_pool_worker_t *self = (pkc_pool_worker_t *)arg;
+    pkc_pool_t *pool = self->pool;
+    pkc_pool_tls_worker = self;
+
+    if (self->cpu >= 0) {
+        // Raw syscall: pid 0 is the calling thread, and no _GNU_SOURCE needed.
+        unsigned long mask[PKC_POOL_MASK_WORDS] = {0};
+        mask[self->cpu / PKC_POOL_MASK_BITS] |= 1UL << (self->cpu % PKC_POOL_MASK_BITS);
+        syscall(SYS_sched_setaffinity, 0, sizeof(mask), mask);
+    }
+
+    pkc_pool_task_t task;
+    uint32_t idle = 0;
+    while (atomic_load_explicit(&pool->running, memory_order_acquire)) {
+        if (pkc_pool_find(pool, self, PKC_POOL_PRIO_COUNT - 1, &task)) {
+            pkc_pool_run_task(&task);
+            atomic_fetch_add_explicit(&self->executed, 1, memory_order_relaxed);
+            idle = 0;
+            continue;
+        }
+        if (++idle < PKC_POOL_IDLE_SPINS) {
+            sched_yield();
+            continue;
+        }
+        // Dekker pair with pkc_pool_submit: sleepers++ then read queued.
+        pthread_mutex_lock(&pool->sleep_lock);
+        atomic_fetch_add(&pool->sleepers, 1);
+        while (atomic_load(&pool->queued) == 0 && atomic_load_explicit(&pool->running, memory_order_acquire)) {
+            pthread_cond_wait(&pool->wake, &pool->sleep_lock);
+        }
+        atomic_fetch_sub(&pool->sleepers, 1);
+        pthread_mutex_unlock(&pool->sleep_lock);
+        idle = 0;
+    }
+    pkc_pool_tls_worker = NULL;
+    return NULL;
+}
+
+static inline void pkc_pool_destroy(pkc_pool_t *pool);
+
+static inline OpStatus_t pkc_pool_init(pkc_pool_t *pool, const pkc_pool_config_t *cfg)
+{
+    if (!pool) return OP_NULL_PTR;
+    memset(pool, 0, sizeof(*pool));
+    if (cfg) pool->cfg = *cfg;
+
+    unsigned long allowed[PKC_POOL_MASK_WORDS] = {0};
+    int cpus[PKC_POOL_MAX_CPUS], ncpus = 0;
+    if (syscall(SYS_sched_getaffinity, 0, sizeof(allowed), allowed) > 0) {
+        for (int c = 0; c < PKC_POOL_MAX_CPUS; ++c) {
+            if (allowed[c / PKC_POOL_MASK_BITS] & (1UL << (c % PKC_POOL_MASK_BITS))) cpus[ncpus++] = c;
+        }
+    }
+    if (ncpus == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        for (int c = 0; c < n && c < PKC_POOL_MAX_CPUS; ++c) cpus[ncpus++] = c;
+        if (ncpus == 0) cpus[ncpus++] = 0;
+    }
+
+    uint32_t n = pool->cfg.threads ? pool->cfg.threads : (uint32_t)ncpus;
+    if (n > PKC_POOL_MAX_WORKERS) n = PKC_POOL_MAX_WORKERS;
+    if (n == 0) return OP_INVALID_INPUT;
+
+    static int cpu_node[PKC_POOL_MAX_CPUS];
+    pool->nodes = pkc_pool_read_topology(cpu_node);
+
+    pool->workers = (pkc_pool_worker_t *)aligned_alloc(64, sizeof(pkc_pool_worker_t) * n);
+    pool->victim_table = (uint32_t *)calloc((size_t)n * n, sizeof(uint32_t));
+    if (!pool->workers || !pool->victim_table) {
+        free(pool->workers);
+        free(pool->victim_table);
+        return OP_INVALID_STATE;
+    }
+    memset(pool->workers, 0, sizeof(pkc_pool_worker_t) * n);
+    pool->nworkers = n;
+
+    for (int p = 0; p < PKC_POOL_PRIO_COUNT; ++p) pkc_pool_deque_init(&pool->inject[p]);
+    pthread_mutex_init(&pool->sleep_lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        pkc_pool_worker_t *w = &pool->workers[i];
+        for (int p = 0; p < PKC_POOL_PRIO_COUNT; ++p) pkc_pool_deque_init(&w->q[p]);
+        w->pool = pool;
+        w->index = i;
+        const int cpu = cpus[i % (uint32_t)ncpus];
+        w->cpu = pool->cfg.pin ? cpu : -1;
+        w->node = cpu < PKC_POOL_MAX_CPUS ? cpu_node[cpu] : 0;
+        w->victims = pool->victim_table + (size_t)i * n;
+    }
+
+    // Victim order: same node first, each list rotated to start after self.
+    for (uint32_t i = 0; i < n; ++i) {
+        pkc_pool_worker_t *w = &pool->workers[i];
+        uint32_t k = 0;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (uint32_t step = 1; step < n; ++step) {
+                const uint32_t v = (i + step) % n;
+                if ((pool->workers[v].node == w->node) == (pass == 0)) w->victims[k++] = v;
+            }
+        }
+    }
+
+    atomic_store_explicit(&pool->running, true, memory_order_release);
+    for (uint32_t i = 0; i < n; ++i) {
+        if (pthread_create(&pool->workers[i].tid, NULL, pkc_pool_worker_main, &pool->workers[i]) != 0) {
+            pool->nworkers = i;
+            pkc_pool_destroy(pool);
+            return OP_INVALID_STATE;
+        }
+    }
+    return OP_SUCCESS;
+}
+
+/* Stops and joins the workers; tasks still queued are dropped. */
+static inline void pkc_pool_destroy(pkc_pool_t *pool)
+{
+    if (!pool || !pool->workers) return;
+    atomic_store_explicit(&pool->running, false, memory_order_release);
+    pthread_mutex_lock(&pool->sleep_lock);
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->sleep_lock);
+    for (uint32_t i = 0; i < pool->nworkers; ++i) pthread_join(pool->workers[i].tid, NULL);
+    free(pool->workers);
+    free(pool->victim_table);
+    memset(pool, 0, sizeof(*pool));
+}
+
+/*
+ * Queues fn(arg, cancel) in class `prio`. A worker of this pool pushes
+ * onto its own deque; anyone else goes through the injection queue. If
+ * the queue is full the task runs on the calling thread.
+ */
+static inline void pkc_pool_submit(pkc_pool_t *pool, pkc_pool_prio_t prio, pkc_pool_fn fn, void *arg,
+                                   const pkc_pool_cancel_t *cancel, pkc_pool_group_t *group)
+{
+    pkc_pool_task_t t = { fn, arg, cancel, group, prio };
+    if (group) atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+    pkc_metrics_count(PKC_CTR_POOL_TASKS, 1);
+
+    pkc_pool_worker_t *self = pkc_pool_tls_worker;
+    pkc_pool_deque_t *d = (self && self->pool == pool) ? &self->q[prio] : &pool->inject[prio];
+    if (!pkc_pool_deque_push(d, &t)) {
+        pkc_pool_run_task(&t);
+        return;
+    }
+    atomic_fetch_add_explicit(&pool->queued_class[prio], 1, memory_order_relaxed);
+    atomic_fetch_add(&pool->queued, 1);
+    if (atomic_load(&pool->sleepers) > 0) {
+        pthread_mutex_lock(&pool->sleep_lock);
+        pthread_cond_signal(&pool->wake);
+        pthread_mutex_unlock(&pool->sleep_lock);
+    }
+}
+
+/* Waits for the group, running queued tasks of its class or higher meanwhile. */
+static inline void pkc_pool_wait(pkc_pool_t *pool, pkc_pool_group_t *group)
+{
+    pkc_pool_worker_t *self = pkc_pool_tls_worker;
+    if (self && self->pool != pool) self = NULL;
+    pkc_pool_task_t task;
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) != 0) {
+        if (pkc_pool_find(pool, self, group->prio, &task)) pkc_pool_run_task(&task);
+        else sched_yield();
+    }
+}
+
+/*
+ * Preemption point for long kernels of class `prio`: runs queued tasks of
+ * strictly higher classes on the calling thread, then returns how many
+ * ran. Costs a relaxed load per higher class when there is nothing to do.
+ */
+static inline uint32_t pkc_pool_yield(pkc_pool_t *pool, pkc_pool_prio_t prio)
+{
+    if (!pool) return 0;
+    bool pending = false;
+    for (int p = 0; p < (int)prio && !pending; ++p) {
+        pending = atomic_load_explicit(&pool->queued_class[p], memory_order_relaxed) != 0;
+    }
+    if (!pending) return 0;
+
+    pkc_pool_worker_t *self = pkc_pool_tls_worker;
+    if (self && self->pool != pool) self = NULL;
+    pkc_pool_task_t task;
+    uint32_t ran = 0;
+    while (pkc_pool_find(pool, self, (pkc_pool_prio_t)(prio - 1), &task)) {
+        pkc_pool_run_task(&task);
+        if (self) atomic_fetch_add_explicit(&self->executed, 1, memory_order_relaxed);
+        ran++;
+    }
+    if (ran) pkc_metrics_count(PKC_CTR_POOL_PREEMPTIONS, ran);
+    return ran;
+}
+
+/*
+ * Runs fn(arg, cancel) `n` times, n - 1 on the pool and one on the calling
+ * thread, and returns when all have finished. Without a pool (NULL) all
+ * n run on the calling thread.
+ */
+static inline void pkc_pool_fork_join(pkc_pool_t *pool, pkc_pool_prio_t prio, uint32_t n, pkc_pool_fn fn, void *arg,
+                                      const pkc_pool_cancel_t *cancel)
+{
+    if (n == 0) return;
+    if (!pool) {
+        for (uint32_t i = 0; i < n && !pkc_pool_cancelled(cancel); ++i) fn(arg, cancel);
+        return;
+    }
+    pkc_pool_group_t group;
+    pkc_pool_group_init(&group, prio);
+    for (uint32_t i = 1; i < n; ++i) pkc_pool_submit(pool, prio, fn, arg, cancel, &group);
+    if (!pkc_pool_cancelled(cancel)) fn(arg, cancel);
+    pkc_pool_wait(pool, &group);
+}
+
+PKC_POOL_INLINE uint32_t pkc_pool_workers(const pkc_pool_t *pool)
+{
+    return pool ? pool->nworkers : 0;
+}
+
+PKC_POOL_INLINE uint64_t pkc_pool_queued(pkc_pool_t *pool)
+{
+    return pool ? atomic_load_explicit(&pool->queued, memory_order_relaxed) : 0;
+}
+
+/* ---------------- process-wide pool ---------------- */
+
+__attribute__((weak)) pkc_pool_t pkc_pool_global;
+__attribute__((weak)) pkc_pool_config_t pkc_pool_global_config;
+__attribute__((weak)) pthread_once_t pkc_pool_global_once = PTHREAD_ONCE_INIT;
+__attribute__((weak)) _Atomic(bool) pkc_pool_global_started;
+
+static inline void pkc_pool_global_start(void)
+{
+    if (pkc_pool_init(&pkc_pool_global, &pkc_pool_global_config) == OP_SUCCESS) {
+        atomic_store_explicit(&pkc_pool_global_started, true, memory_order_release);
+    }
+}
+
+/*
+ * Sets the config the shared pool starts with. OP_INVALID_STATE once it
+ * has started (first pkc_pool_default call).
+ */
+static inline OpStatus_t pkc_pool_default_configure(const pkc_pool_config_t *cfg)
+{
+    if (!cfg) return OP_NULL_PTR;
+    if (atomic_load_explicit(&pkc_pool_global_started, memory_order_acquire)) return OP_INVALID_STATE;
+    pkc_pool_global_config = *cfg;
+    return OP_SUCCESS;
+}
+
+/* Shared pool, started on first use; NULL if it could not start. */
+PKC_POOL_INLINE pkc_pool_t *pkc_pool_default(void)
+{
+    if (__builtin_expect(!atomic_load_explicit(&pkc_pool_global_started, memory_order_acquire), 0)) {
+        pthread_once(&pkc_pool_global_once, pkc_pool_global_start);
+        if (!atomic_load_explicit(&pkc_pool_global_started, memory_order_acquire)) return NULL;
+    }
+    return &pkc_pool_global;
+}
+
+#endif // PKC_WORK_POOL_H
@@ -0,0 +1,153 @@
+#ifndef PKC_CLOCK_H
+#define PKC_CLOCK_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define PKC_CLOCK_HAVE_TSC 1
+#else
+#define PKC_CLOCK_HAVE_TSC 0
+#endif
+
+#ifndef PKC_CLOCK_INLINE
+#define PKC_CLOCK_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Nanosecond monotonic clock for the timing-sensitive paths.
+ *
+ * Backend is the invariant TSC when the CPU advertises it (CPUID
+ * 0x80000007 EDX[8]) and the kernel itself uses it as clocksource, so we
+ * never trust a TSC Linux has already rejected. The tick rate is
+ * calibrated once against CLOCK_MONOTONIC_RAW; conversion is a 128-bit
+ * multiply by a 32.32 fixed-point ns-per-tick factor. Everything else
+ * falls back to clock_gettime(CLOCK_MONOTONIC) in full nanoseconds.
+ *
+ * Define PKC_CLOCK_FORCE_FALLBACK to always use clock_gettime.
+ */
+
+#ifndef PKC_CLOCK_CALIBRATION_NS
+#define PKC_CLOCK_CALIBRATION_NS 20000000ULL // 20 ms busy-wait, once per process
+#endif
+
+typedef enum {
+    PKC_CLOCK_BACKEND_CLOCK_GETTIME = 0,
+    PKC_CLOCK_BACKEND_TSC = 1,
+} pkc_clock_backend_t;
+
+typedef struct {
+    _Atomic(int) ready;
+    pkc_clock_backend_t backend;
+    uint64_t base_tsc;
+    uint64_t base_ns;
+    uint64_t mult;      // ns per tick, 32.32 fixed point
+    uint64_t tsc_hz;
+} pkc_clock_state_t;
+
+__attribute__((weak)) pkc_clock_state_t pkc_clock_state;
+__attribute__((weak)) pthread_once_t pkc_clock_once = PTHREAD_ONCE_INIT;
+
+PKC_CLOCK_INLINE uint64_t pkc_clock_gettime_ns(clockid_t id)
+{
+    struct timespec ts;
+    if (clock_gettime(id, &ts) == 0) {
+        return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    }
+    return 0;
+}
+
+#if PKC_CLOCK_HAVE_TSC
+PKC_CLOCK_INLINE uint64_t pkc_clock_rdtsc(void)
+{
+    // lfence keeps earlier loads from drifting past the read.
+    _mm_lfence();
+    return __rdtsc();
+}
+#endif
+
+static inline bool pkc_clock_tsc_trusted(void)
+{
+#if PKC_CLOCK_HAVE_TSC && !defined(PKC_CLOCK_FORCE_FALLBACK)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) || eax < 0x80000007u) return false;
+    if (!__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) return false;
+
+    FILE *f = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+    if (!f) return false;
+    char src[32] = {0};
+    bool ok = fgets(src, sizeof(src), f) != NULL && strncmp(src, "tsc", 3) == 0;
+    fclose(f);
+    return ok;
+#else
+    return false;
+#endif
+}
+
+static inline void pkc_clock_calibrate(void)
+{
+    pkc_clock_state_t *st = &pkc_clock_state;
+    st->backend = PKC_CLOCK_BACKEND_CLOCK_GETTIME;
+
+#if PKC_CLOCK_HAVE_TSC
+    if (pkc_clock_tsc_trusted()) {
+        uint64_t t0 = pkc_clock_gettime_ns(CLOCK_MONOTONIC_RAW);
+        uint64_t c0 = pkc_clock_rdtsc();
+        uint64_t t1;
+        do {
+            t1 = pkc_clock_gettime_ns(CLOCK_MONOTONIC_RAW);
+        } while (t1 - t0 < PKC_CLOCK_CALIBRATION_NS);
+        uint64_t c1 = pkc_clock_rdtsc();
+
+        if (c1 > c0 && t1 > t0) {
+            st->tsc_hz = (uint64_t)(((unsigned __int128)(c1 - c0) * 1000000000ULL) / (t1 - t0));
+            st->mult = (uint64_t)((((unsigned __int128)(t1 - t0)) << 32) / (c1 - c0));
+            st->base_ns = pkc_clock_gettime_ns(CLOCK_MONOTONIC);
+            st->base_tsc = pkc_clock_rdtsc();
+            if (st->mult != 0) st->backend = PKC_CLOCK_BACKEND_TSC;
+        }
+    }
+#endif
+
+    atomic_store_explicit(&st->ready, 1, memory_order_release);
+}
+
+PKC_CLOCK_INLINE void pkc_clock_init(void)
+{
+    if (__builtin_expect(!atomic_load_explicit(&pkc_clock_state.ready, memory_order_acquire), 0)) {
+        pthread_once(&pkc_clock_once, pkc_clock_calibrate);
+    }
+}
+
+/*
+ * Monotonic nanoseconds. Only differences are meaningful; the TSC backend
+ * is anchored to CLOCK_MONOTONIC at calibration time.
+ */
+PKC_CLOCK_INLINE uint64_t pkc_clock_now_ns(void)
+{
+    pkc_clock_init();
+#if PKC_CLOCK_HAVE_TSC
+    if (pkc_clock_state.backend == PKC_CLOCK_BACKEND_TSC) {
+        uint64_t d = pkc_clock_rdtsc() - pkc_clock_state.base_tsc;
+        return pkc_clock_state.base_ns + (uint64_t)(((unsigned __int128)d * pkc_clock_state.mult) >> 32);
+    }
+#endif
+    return pkc_clock_gettime_ns(CLOCK_MONOTONIC);
+}
+
+PKC_CLOCK_INLINE pkc_clock_backend_t pkc_clock_backend(void)
+{
+    pkc_clock_init();
+    return pkc_clock_state.backend;
+}
+
+#endif // PKC_CLOCK_H
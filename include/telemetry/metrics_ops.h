@@ -0,0 +1,613 @@
+#ifndef PKC_METRICS_H
+#define PKC_METRICS_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "core/enums/OpStatus.h"
+#include "core/enums/Tier.h"
+#include "telemetry/clock_ops.h"
+
+#ifndef PKC_METRICS_INLINE
+#define PKC_METRICS_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Metrics registry for the chain and PoW hot paths.
+ *
+ * Writers never lock: every thread is bound to one cache-line aligned shard
+ * on first use and only issues relaxed atomic adds into it. Readers
+ * (BlockchainAdapter::tick) sum the shards into a pkc_metrics_snapshot_t.
+ *
+ * Latency histograms are HDR-style log-linear: values below 8 ns get their
+ * own bucket, above that each power-of-two octave is split into 8 linear
+ * sub-buckets (<= 12.5% relative error). Values are recorded in nanoseconds.
+ *
+ * Build with -DPKC_METRICS_DISABLE to compile every recording call out.
+ */
+
+#ifndef PKC_METRICS_MAX_SHARDS
+#define PKC_METRICS_MAX_SHARDS 32
+#endif
+
+#define PKC_METRICS_HIST_SUB_BITS 3
+#define PKC_METRICS_HIST_SUB_COUNT (1u << PKC_METRICS_HIST_SUB_BITS)
+#define PKC_METRICS_HIST_OCTAVES 44 // top octave ends at 2^44 ns (~4.9 h)
+#define PKC_METRICS_HIST_BUCKETS ((PKC_METRICS_HIST_OCTAVES - PKC_METRICS_HIST_SUB_BITS + 1) * PKC_METRICS_HIST_SUB_COUNT)
+
+#ifndef PKC_METRICS_TICK_INTERVAL_NS
+#define PKC_METRICS_TICK_INTERVAL_NS 1000000000ULL
+#endif
+
+#define PKC_METRICS_TIER_SLOTS 4
+
+typedef enum {
+    PKC_CTR_TIER_POW_HASHES_MCU = 0,
+    PKC_CTR_TIER_POW_HASHES_EDGE,
+    PKC_CTR_TIER_POW_HASHES_DESKTOP,
+    PKC_CTR_TIER_POW_HASHES_SERVER,
+    PKC_CTR_TIER_POW_SOLVES,
+    PKC_CTR_MINI_POW_ITERATIONS,
+    PKC_CTR_MINI_POW_SESSIONS,
+    PKC_CTR_CHAIN_APPENDS,
+    PKC_CTR_CHAIN_PERSISTS,
+    PKC_CTR_MINI_POW_MATRIX_CACHE_HITS,
+    PKC_CTR_MINI_POW_MATRIX_CACHE_MISSES,
+    PKC_CTR_MINI_POW_MATRIX_CACHE_EVICTIONS,
+    PKC_CTR_TIER_POW_REFUSED,
+    PKC_CTR_POOL_TASKS,
+    PKC_CTR_POOL_STEALS,
+    PKC_CTR_CHAIN_REJECTS,
+    PKC_CTR_CHAIN_COMMIT_BATCHES,
+    PKC_CTR_CHAIN_REORGS,
+    PKC_CTR_CHAIN_REORG_BLOCKS,
+    PKC_CTR_POOL_PREEMPTIONS,
+    PKC_CTR_COUNT
+} pkc_metric_counter_t;
+
+typedef enum {
+    PKC_HIST_TIER_POW_SOLVE_MCU = 0,
+    PKC_HIST_TIER_POW_SOLVE_EDGE,
+    PKC_HIST_TIER_POW_SOLVE_DESKTOP,
+    PKC_HIST_TIER_POW_SOLVE_SERVER,
+    PKC_HIST_TIER_POW_VERIFY,
+    PKC_HIST_MINI_POW_ITERATION,
+    PKC_HIST_MINI_POW_VERIFY,
+    PKC_HIST_CHAIN_APPEND,
+    PKC_HIST_CHAIN_PERSIST,
+    PKC_HIST_CHAIN_COMMIT,
+    PKC_HIST_COUNT
+} pkc_metric_hist_t;
+
+typedef enum {
+    PKC_GAUGE_MINI_POW_SEND_QUEUE = 0,
+    PKC_GAUGE_MINI_POW_RECEIVE_QUEUE,
+    PKC_GAUGE_TIER_POW_QUEUE,
+    PKC_GAUGE_TIER_POW_HASHRATE_MCU,
+    PKC_GAUGE_TIER_POW_HASHRATE_EDGE,
+    PKC_GAUGE_TIER_POW_HASHRATE_DESKTOP,
+    PKC_GAUGE_TIER_POW_HASHRATE_SERVER,
+    PKC_GAUGE_TIER_POW_BENCH_HASHRATE,
+    PKC_GAUGE_TIER_POW_BENCH_THREADS,
+    PKC_GAUGE_POOL_QUEUED,
+    PKC_GAUGE_CHAIN_WRITER_QUEUED,
+    PKC_GAUGE_COUNT
+} pkc_metric_gauge_t;
+
+// Queues whose `count` field is sampled on tick instead of on every add/take.
+#define PKC_METRICS_WATCHED_QUEUES 3
+
+typedef struct __attribute__((aligned(64))) {
+    _Atomic(uint64_t) counters[PKC_CTR_COUNT];
+    _Atomic(uint64_t) hist_sum[PKC_HIST_COUNT];
+    _Atomic(uint64_t) hist_buckets[PKC_HIST_COUNT][PKC_METRICS_HIST_BUCKETS];
+} pkc_metrics_shard_t;
+
+typedef struct {
+    pkc_metrics_shard_t shards[PKC_METRICS_MAX_SHARDS];
+    _Atomic(uint32_t) shards_used;
+    _Atomic(int64_t) gauges[PKC_GAUGE_COUNT];
+    const volatile size_t *watched_queue[PKC_METRICS_WATCHED_QUEUES];
+} pkc_metrics_registry_t;
+
+typedef struct {
+    uint64_t taken_ns;
+    uint64_t counters[PKC_CTR_COUNT];
+    uint64_t hist_count[PKC_HIST_COUNT];
+    uint64_t hist_sum[PKC_HIST_COUNT];
+    uint64_t hist_buckets[PKC_HIST_COUNT][PKC_METRICS_HIST_BUCKETS];
+    int64_t gauges[PKC_GAUGE_COUNT];
+} pkc_metrics_snapshot_t;
+
+// Process-wide registry. Weak so every translation unit shares one instance.
+__attribute__((weak)) pkc_metrics_registry_t pkc_metrics_global;
+// 1-based shard of the calling thread, 0 until first use.
+__attribute__((weak)) __thread uint32_t pkc_metrics_tls_shard;
+
+PKC_METRICS_INLINE uint64_t pkc_metrics_now_ns(void)
+{
+    return pkc_clock_now_ns();
+}
+
+PKC_METRICS_INLINE uint32_t pkc_metrics_hist_bucket(uint64_t ns)
+{
+    if (ns < PKC_METRICS_HIST_SUB_COUNT) return (uint32_t)ns;
+    uint32_t msb = 63u - (uint32_t)__builtin_clzll(ns);
+    uint32_t e = msb - PKC_METRICS_HIST_SUB_BITS;
+    uint32_t idx = e * PKC_METRICS_HIST_SUB_COUNT + (uint32_t)(ns >> e);
+    return idx < PKC_METRICS_HIST_BUCKETS ? idx : PKC_METRICS_HIST_BUCKETS - 1;
+}
+
+// Exclusive upper bound (ns) of a bucket.
+PKC_METRICS_INLINE uint64_t pkc_metrics_hist_bucket_upper(uint32_t idx)
+{
+    if (idx < PKC_METRICS_HIST_SUB_COUNT) return (uint64_t)idx + 1;
+    uint32_t e = idx / PKC_METRICS_HIST_SUB_COUNT - 1;
+    uint64_t m = (uint64_t)(idx % PKC_METRICS_HIST_SUB_COUNT) + PKC_METRICS_HIST_SUB_COUNT;
+    return (m + 1) << e;
+}
+
+PKC_METRICS_INLINE pkc_metrics_shard_t *pkc_metrics_shard(void)
+{
+    uint32_t s = pkc_metrics_tls_shard;
+    if (__builtin_expect(s == 0, 0)) {
+        uint32_t n = atomic_fetch_add_explicit(&pkc_metrics_global.shards_used, 1, memory_order_relaxed);
+        // More threads than shards: wrap around, the atomic adds keep sharing safe.
+        s = (n % PKC_METRICS_MAX_SHARDS) + 1;
+        pkc_metrics_tls_shard = s;
+    }
+    return &pkc_metrics_global.shards[s - 1];
+}
+
+// Maps a tier onto the per-tier counter/histogram/gauge slot (0..3), -1 if none.
+PKC_METRICS_INLINE int pkc_metrics_tier_slot(Tier_t tier)
+{
+    switch (tier) {
+        case TIER_MCU: return 0;
+        case TIER_EDGE: return 1;
+        case TIER_DESKTOP: return 2;
+        case TIER_SERVER: return 3;
+        default: return -1;
+    }
+}
+
+#ifndef PKC_METRICS_DISABLE
+
+PKC_METRICS_INLINE void pkc_metrics_count(pkc_metric_counter_t ctr, uint64_t n)
+{
+    atomic_fetch_add_explicit(&pkc_metrics_shard()->counters[ctr], n, memory_order_relaxed);
+}
+
+PKC_METRICS_INLINE void pkc_metrics_observe_ns(pkc_metric_hist_t hist, uint64_t ns)
+{
+    pkc_metrics_shard_t *sh = pkc_metrics_shard();
+    atomic_fetch_add_explicit(&sh->hist_buckets[hist][pkc_metrics_hist_bucket(ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&sh->hist_sum[hist], ns, memory_order_relaxed);
+}
+
+PKC_METRICS_INLINE void pkc_metrics_gauge_set(pkc_metric_gauge_t gauge, int64_t value)
+{
+    atomic_store_explicit(&pkc_metrics_global.gauges[gauge], value, memory_order_relaxed);
+}
+
+#else
+
+PKC_METRICS_INLINE void pkc_metrics_count(pkc_metric_counter_t ctr, uint64_t n) { (void)ctr; (void)n; }
+PKC_METRICS_INLINE void pkc_metrics_observe_ns(pkc_metric_hist_t hist, uint64_t ns) { (void)hist; (void)ns; }
+PKC_METRICS_INLINE void pkc_metrics_gauge_set(pkc_metric_gauge_t gauge, int64_t value) { (void)gauge; (void)value; }
+
+#endif // PKC_METRICS_DISABLE
+
+PKC_METRICS_INLINE void pkc_metrics_count_tier_hashes(Tier_t tier, uint64_t hashes)
+{
+    int slot = pkc_metrics_tier_slot(tier);
+    if (slot < 0) return;
+    pkc_metrics_count((pkc_metric_counter_t)(PKC_CTR_TIER_POW_HASHES_MCU + slot), hashes);
+}
+
+PKC_METRICS_INLINE void pkc_metrics_observe_tier_solve_ns(Tier_t tier, uint64_t ns)
+{
+    int slot = pkc_metrics_tier_slot(tier);
+    if (slot < 0) return;
+    pkc_metrics_observe_ns((pkc_metric_hist_t)(PKC_HIST_TIER_POW_SOLVE_MCU + slot), ns);
+}
+
+/*
+ * Registers the `count` field of a queue to be sampled on tick.
+ * `which` is PKC_GAUGE_MINI_POW_SEND_QUEUE, _RECEIVE_QUEUE or PKC_GAUGE_TIER_POW_QUEUE.
+ * Pass NULL to stop watching.
+ */
+static inline OpStatus_t pkc_metrics_watch_queue(pkc_metrics_registry_t *reg,
+                                                 pkc_metric_gauge_t which,
+                                                 const volatile size_t *count)
+{
+    if (!reg) return OP_NULL_PTR;
+    if ((int)which < 0 || (int)which >= PKC_METRICS_WATCHED_QUEUES) return OP_INVALID_INPUT;
+    reg->watched_queue[which] = count;
+    return OP_SUCCESS;
+}
+
+/*
+ * Sums all shards into `snap`, samples the watched queues and derives the
+ * per-tier TierPoW hash rate from the previous snapshot held in `snap`.
+ * Only shards that have been handed out are visited.
+ */
+static inline OpStatus_t pkc_metrics_aggregate(pkc_metrics_registry_t *reg, pkc_metrics_snapshot_t *snap)
+{
+    if (!reg || !snap) return OP_NULL_PTR;
+
+    const uint64_t now = pkc_metrics_now_ns();
+    const uint64_t prev_ns = snap->taken_ns;
+    uint64_t prev_hashes[PKC_METRICS_TIER_SLOTS];
+    for (int t = 0; t < PKC_METRICS_TIER_SLOTS; ++t) {
+        prev_hashes[t] = snap->counters[PKC_CTR_TIER_POW_HASHES_MCU + t];
+    }
+
+    memset(snap->counters, 0, sizeof(snap->counters));
+    memset(snap->hist_count, 0, sizeof(snap->hist_count));
+    memset(snap->hist_sum, 0, sizeof(snap->hist_sum));
+    memset(snap->hist_buckets, 0, sizeof(snap->hist_buckets));
+
+    uint32_t used = atomic_load_explicit(&reg->shards_used, memory_order_relaxed);
+    if (used > PKC_METRICS_MAX_SHARDS) used = PKC_METRICS_MAX_SHARDS;
+
+    for (uint32_t s = 0; s < used; ++s) {
+        pkc_metrics_shard_t *sh = &reg->shards[s];
+        for (int c = 0; c < PKC_CTR_COUNT; ++c) {
+            snap->counters[c] += atomic_load_explicit(&sh->counters[c], memory_order_relaxed);
+        }
+        for (int h = 0; h < PKC_HIST_COUNT; ++h) {
+            snap->hist_sum[h] += atomic_load_explicit(&sh->hist_sum[h], memory_order_relaxed);
+            for (uint32_t b = 0; b < PKC_METRICS_HIST_BUCKETS; ++b) {
+                uint64_t v = atomic_load_explicit(&sh->hist_buckets[h][b], memory_order_relaxed);
+                snap->hist_buckets[h][b] += v;
+                snap->hist_count[h] += v;
+            }
+        }
+    }
+
+    for (int q = 0; q < PKC_METRICS_WATCHED_QUEUES; ++q) {
+        if (reg->watched_queue[q]) {
+            atomic_store_explicit(&reg->gauges[q], (int64_t)*reg->watched_queue[q], memory_order_relaxed);
+        }
+    }
+
+    if (prev_ns != 0 && now > prev_ns) {
+        const double dt = (double)(now - prev_ns) / 1e9;
+        for (int t = 0; t < PKC_METRICS_TIER_SLOTS; ++t) {
+            uint64_t cur = snap->counters[PKC_CTR_TIER_POW_HASHES_MCU + t];
+            double rate = cur >= prev_hashes[t] ? (double)(cur - prev_hashes[t]) / dt : 0.0;
+            atomic_store_explicit(&reg->gauges[PKC_GAUGE_TIER_POW_HASHRATE_MCU + t], (int64_t)rate, memory_order_relaxed);
+        }
+    }
+
+    for (int g = 0; g < PKC_GAUGE_COUNT; ++g) {
+        snap->gauges[g] = atomic_load_explicit(&reg->gauges[g], memory_order_relaxed);
+    }
+    snap->taken_ns = now;
+    return OP_SUCCESS;
+}
+
+/*
+ * Approximate percentile (0..100) of a histogram in a snapshot, in ns.
+ * Returns the upper bound of the bucket holding the requested rank.
+ */
+static inline uint64_t pkc_metrics_snapshot_percentile(const pkc_metrics_snapshot_t *snap,
+                                                       pkc_metric_hist_t hist,
+                                                       double pct)
+{
+    if (!snap || snap->hist_count[hist] == 0) return 0;
+    uint64_t rank = (uint64_t)((pct / 100.0) * (double)snap->hist_count[hist]);
+    if (rank >= snap->hist_count[hist]) rank = snap->hist_count[hist] - 1;
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < PKC_METRICS_HIST_BUCKETS; ++b) {
+        seen += snap->hist_buckets[hist][b];
+        if (seen > rank) return pkc_metrics_hist_bucket_upper(b);
+    }
+    return pkc_metrics_hist_bucket_upper(PKC_METRICS_HIST_BUCKETS - 1);
+}
+
+static const char *const pkc_metrics_counter_names[PKC_CTR_COUNT] = {
+    "tier_pow_hashes_total{tier=\"mcu\"}",
+    "tier_pow_hashes_total{tier=\"edge\"}",
+    "tier_pow_hashes_total{tier=\"desktop\"}",
+    "tier_pow_hashes_total{tier=\"server\"}",
+    "tier_pow_solves_total",
+    "mini_pow_iterations_total",
+    "mini_pow_sessions_total",
+    "chain_appends_total",
+    "chain_persists_total",
+    "mini_pow_matrix_cache_hits_total",
+    "mini_pow_matrix_cache_misses_total",
+    "mini_pow_matrix_cache_evictions_total",
+    "tier_pow_refused_total",
+    "pool_tasks_total",
+    "pool_steals_total",
+    "chain_rejects_total",
+    "chain_commit_batches_total",
+    "chain_reorgs_total",
+    "chain_reorg_blocks_total",
+    "pool_preemptions_total",
+};
+
+/* HELP text per counter; only the first entry of a family is emitted. */
+static const char *const pkc_metrics_counter_help[PKC_CTR_COUNT] = {
+    "TierPoW hashes computed, by tier.", "", "", "",
+    "TierPoW solutions found.",
+    "MiniPoW iterations acknowledged.",
+    "MiniPoW sessions started.",
+    "Blocks appended to the chain.",
+    "Chain state persists.",
+    "MiniPoW matrix cache hits.",
+    "MiniPoW matrix cache misses.",
+    "MiniPoW matrix cache evictions.",
+    "TierPoW solves refused for exceeding the time budget.",
+    "Tasks run by the work pool.",
+    "Tasks stolen between work-pool workers.",
+    "Blocks rejected by the chain writer.",
+    "Batches committed by the chain writer.",
+    "Chain reorganisations.",
+    "Blocks replaced by chain reorganisations.",
+    "Higher-class tasks run by mining kernels between chunks.",
+};
+
+static const char *const pkc_metrics_hist_names[PKC_HIST_COUNT] = {
+    "tier_pow_solve_seconds", "tier_pow_solve_seconds", "tier_pow_solve_seconds", "tier_pow_solve_seconds",
+    "tier_pow_verify_seconds",
+    "mini_pow_iteration_seconds",
+    "mini_pow_verify_seconds",
+    "chain_append_seconds",
+    "chain_persist_seconds",
+    "chain_commit_seconds",
+};
+
+static const char *const pkc_metrics_hist_labels[PKC_HIST_COUNT] = {
+    "tier=\"mcu\",", "tier=\"edge\",", "tier=\"desktop\",", "tier=\"server\",",
+    "", "", "", "", "", "",
+};
+
+static const char *const pkc_metrics_hist_help[PKC_HIST_COUNT] = {
+    "TierPoW solve time, by tier.", "", "", "",
+    "TierPoW verification time.",
+    "MiniPoW iteration time.",
+    "MiniPoW verification time.",
+    "Chain append time.",
+    "Chain persist time.",
+    "Chain writer batch commit time.",
+};
+
+static const char *const pkc_metrics_gauge_names[PKC_GAUGE_COUNT] = {
+    "queue_depth{queue=\"mini_pow_send\"}",
+    "queue_depth{queue=\"mini_pow_receive\"}",
+    "queue_depth{queue=\"tier_pow\"}",
+    "tier_pow_hashrate{tier=\"mcu\"}",
+    "tier_pow_hashrate{tier=\"edge\"}",
+    "tier_pow_hashrate{tier=\"desktop\"}",
+    "tier_pow_hashrate{tier=\"server\"}",
+    "tier_pow_bench_hashrate",
+    "tier_pow_bench_threads",
+    "pool_queued_tasks",
+    "queue_depth{queue=\"chain_writer\"}",
+};
+
+static const char *const pkc_metrics_gauge_help[PKC_GAUGE_COUNT] = {
+    "Queued items, by queue.", "", "",
+    "TierPoW hashes per second over the last tick, by tier.", "", "", "",
+    "TierPoW hashes per second measured by the self-benchmark.",
+    "Threads used by the TierPoW self-benchmark.",
+    "Tasks queued on the work pool.",
+    "", // queue_depth, announced with the MiniPoW queues
+};
+
+// Gauges in exposition order: a family's samples must be contiguous.
+static const int pkc_metrics_gauge_order[PKC_GAUGE_COUNT] = {
+    PKC_GAUGE_MINI_POW_SEND_QUEUE, PKC_GAUGE_MINI_POW_RECEIVE_QUEUE, PKC_GAUGE_TIER_POW_QUEUE,
+    PKC_GAUGE_CHAIN_WRITER_QUEUED, PKC_GAUGE_TIER_POW_HASHRATE_MCU, PKC_GAUGE_TIER_POW_HASHRATE_EDGE,
+    PKC_GAUGE_TIER_POW_HASHRATE_DESKTOP, PKC_GAUGE_TIER_POW_HASHRATE_SERVER, PKC_GAUGE_TIER_POW_BENCH_HASHRATE,
+    PKC_GAUGE_TIER_POW_BENCH_THREADS, PKC_GAUGE_POOL_QUEUED,
+};
+
+// Whether `name` opens a new family after `prev` (NULL for the first sample).
+PKC_METRICS_INLINE bool pkc_metrics_family_starts(const char *name, const char *prev)
+{
+    const size_t fl = strcspn(name, "{");
+    return !prev || strcspn(prev, "{") != fl || strncmp(prev, name, fl) != 0;
+}
+
+#define PKC_METRICS_PREFIX "pkcertchain_"
+#define PKC_METRICS_EXPORT_BUF 131072
+
+/*
+ * Renders a snapshot in the Prometheus text exposition format (v0.0.4).
+ * Each family gets its # HELP and # TYPE lines before its first sample.
+ * Histogram buckets are collapsed to octave boundaries (le = 2^k ns) and
+ * every octave is emitted, so the bucket set is the same on every scrape.
+ */
+static inline OpStatus_t pkc_metrics_format_prometheus(const pkc_metrics_snapshot_t *snap,
+                                                       char *out, size_t cap, size_t *out_len)
+{
+    if (!snap || !out || !out_len) return OP_NULL_PTR;
+
+    size_t off = 0;
+    int n;
+#define PKC_METRICS_EMIT(...)                                         \
+    do {                                                              \
+        n = snprintf(out + off, cap - off, __VA_ARGS__);              \
+        if (n < 0 || (size_t)n >= cap - off) return OP_BUFFER_TOO_SMALL; \
+        off += (size_t)n;                                             \
+    } while (0)
+#define PKC_METRICS_EMIT_FAMILY(name, help, type)                                                   \
+    do {                                                                                            \
+        const int fl = (int)strcspn(name, "{");                                                     \
+        PKC_METRICS_EMIT("# HELP " PKC_METRICS_PREFIX "%.*s %s\n", fl, name, help);                 \
+        PKC_METRICS_EMIT("# TYPE " PKC_METRICS_PREFIX "%.*s %s\n", fl, name, type);                 \
+    } while (0)
+
+    for (int c = 0; c < PKC_CTR_COUNT; ++c) {
+        const char *name = pkc_metrics_counter_names[c];
+        if (pkc_metrics_family_starts(name, c ? pkc_metrics_counter_names[c - 1] : NULL))
+            PKC_METRICS_EMIT_FAMILY(name, pkc_metrics_counter_help[c], "counter");
+        PKC_METRICS_EMIT(PKC_METRICS_PREFIX "%s %llu\n", name, (unsigned long long)snap->counters[c]);
+    }
+    for (int i = 0; i < PKC_GAUGE_COUNT; ++i) {
+        const int g = pkc_metrics_gauge_order[i];
+        const char *name = pkc_metrics_gauge_names[g];
+        if (pkc_metrics_family_starts(name, i ? pkc_metrics_gauge_names[pkc_metrics_gauge_order[i - 1]] : NULL))
+            PKC_METRICS_EMIT_FAMILY(name, pkc_metrics_gauge_help[g], "gauge");
+        PKC_METRICS_EMIT(PKC_METRICS_PREFIX "%s %lld\n", name, (long long)snap->gauges[g]);
+    }
+    for (int h = 0; h < PKC_HIST_COUNT; ++h) {
+        const char *name = pkc_metrics_hist_names[h];
+        const char *lbl = pkc_metrics_hist_labels[h];
+        if (pkc_metrics_family_starts(name, h ? pkc_metrics_hist_names[h - 1] : NULL))
+            PKC_METRICS_EMIT_FAMILY(name, pkc_metrics_hist_help[h], "histogram");
+        uint64_t cum = 0;
+        uint32_t b = 0;
+        for (uint32_t k = PKC_METRICS_HIST_SUB_BITS + 1; k <= PKC_METRICS_HIST_OCTAVES; ++k) {
+            const uint64_t le_ns = 1ULL << k;
+            while (b < PKC_METRICS_HIST_BUCKETS && pkc_metrics_hist_bucket_upper(b) <= le_ns) {
+                cum += snap->hist_buckets[h][b++];
+            }
+            PKC_METRICS_EMIT(PKC_METRICS_PREFIX "%s_bucket{%sle=\"%.12g\"} %llu\n",
+                             name, lbl, (double)le_ns / 1e9, (unsigned long long)cum);
+        }
+        PKC_METRICS_EMIT(PKC_METRICS_PREFIX "%s_bucket{%sle=\"+Inf\"} %llu\n",
+                         name, lbl, (unsigned long long)snap->hist_count[h]);
+        PKC_METRICS_EMIT(PKC_METRICS_PREFIX "%s_sum{%.*s} %.9f\n", name,
+                         (int)(strlen(lbl) ? strlen(lbl) - 1 : 0), lbl, (double)snap->hist_sum[h] / 1e9);
+        PKC_METRICS_EMIT(PKC_METRICS_PREFIX "%s_count{%.*s} %llu\n", name,
+                         (int)(strlen(lbl) ? strlen(lbl) - 1 : 0), lbl, (unsigned long long)snap->hist_count[h]);
+    }
+#undef PKC_METRICS_EMIT_FAMILY
+#undef PKC_METRICS_EMIT
+
+    *out_len = off;
+    return OP_SUCCESS;
+}
+
+/*
+ * Writes the exposition to `path` via a temp file + rename, so a scraper
+ * (e.g. node_exporter's textfile collector) never sees a partial file.
+ */
+static inline OpStatus_t pkc_metrics_export_file(const pkc_metrics_snapshot_t *snap, const char *path)
+{
+    if (!snap || !path || path[0] == '\0') return OP_INVALID_INPUT;
+
+    char tmp_path[512];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) return OP_INVALID_INPUT;
+
+    char *buf = (char *)malloc(PKC_METRICS_EXPORT_BUF);
+    if (!buf) return OP_INVALID_INPUT;
+    size_t len = 0;
+    OpStatus_t st = pkc_metrics_format_prometheus(snap, buf, PKC_METRICS_EXPORT_BUF, &len);
+    if (st != OP_SUCCESS) {
+        free(buf);
+        return st;
+    }
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        free(buf);
+        return OP_INVALID_INPUT;
+    }
+    size_t done = 0;
+    while (done < len) {
+        ssize_t w = write(fd, buf + done, len - done);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        done += (size_t)w;
+    }
+    close(fd);
+    free(buf);
+    if (done != len || rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+        return OP_INVALID_INPUT;
+    }
+    return OP_SUCCESS;
+}
+
+/*
+ * Opens a non-blocking loopback listener for Prometheus scrapes.
+ * Returns the fd in `out_fd`; serve it from tick with pkc_metrics_serve_pending.
+ */
+static inline OpStatus_t pkc_metrics_listen_loopback(uint16_t port, int *out_fd)
+{
+    if (!out_fd) return OP_NULL_PTR;
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return OP_INVALID_STATE;
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 8) != 0) {
+        close(fd);
+        return OP_INVALID_STATE;
+    }
+    *out_fd = fd;
+    return OP_SUCCESS;
+}
+
+/*
+ * Answers every scrape already waiting on `listen_fd` with a minimal
+ * HTTP/1.0 response. Never blocks: returns once accept() would block.
+ */
+static inline OpStatus_t pkc_metrics_serve_pending(int listen_fd, const pkc_metrics_snapshot_t *snap)
+{
+    if (listen_fd < 0 || !snap) return OP_INVALID_INPUT;
+
+    char *buf = NULL;
+    size_t len = 0;
+    static const char hdr[] = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n";
+
+    for (;;) {
+        int cfd = accept(listen_fd, NULL, NULL);
+        if (cfd < 0) break;
+
+        // Bound how long a slow client can hold up tick().
+        struct timeval tv = { .tv_sec = 0, .tv_usec = 20000 };
+        setsockopt(cfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(cfd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+        if (!buf) {
+            buf = (char *)malloc(PKC_METRICS_EXPORT_BUF);
+            if (!buf || pkc_metrics_format_prometheus(snap, buf, PKC_METRICS_EXPORT_BUF, &len) != OP_SUCCESS) {
+                close(cfd);
+                break;
+            }
+        }
+        // The request itself is not parsed; any GET gets the exposition.
+        char req[512];
+        (void)!read(cfd, req, sizeof(req));
+        (void)!write(cfd, hdr, sizeof(hdr) - 1);
+        (void)!write(cfd, buf, len);
+        close(cfd);
+    }
+    free(buf);
+    return OP_SUCCESS;
+}
+
+#endif // PKC_METRICS_H
@@ -0,0 +1,394 @@
+#ifndef PKC_TRACE_H
+#define PKC_TRACE_H
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "core/enums/OpStatus.h"
+
+#ifndef PKC_TRACE_INLINE
+#define PKC_TRACE_INLINE static inline __attribute__((always_inline))
+#endif
+
+/*
+ * Structured event tracing for the PoW hot paths.
+ *
+ * Producers claim a slot of a bounded ring with one CAS on the head, fill
+ * the fixed-size event and publish it with a single release store of the
+ * slot sequence. No locks, no syscalls, no formatting. When the ring is full
+ * the event is dropped and counted, the producer never waits.
+ *
+ * A background thread drains published slots in order and appends them to
+ * a binary file (host byte order, it never leaves the box). Text output is
+ * opt-in: either the drainer formats directly (PKC_TRACE_SINK_TEXT) or a
+ * binary file is converted afterwards with pkc_trace_dump_text.
+ */
+
+#define PKC_TRACE_MAGIC "PKTR"
+#define PKC_TRACE_MAGIC_LEN 4
+#define PKC_TRACE_VERSION 1
+
+#ifndef PKC_TRACE_DEFAULT_CAPACITY
+#define PKC_TRACE_DEFAULT_CAPACITY 8192 // events, power of two
+#endif
+
+#ifndef PKC_TRACE_DRAIN_IDLE_NS
+#define PKC_TRACE_DRAIN_IDLE_NS 1000000L // drainer back-off when the ring is empty
+#endif
+
+typedef enum {
+    PKC_TRACE_MINI_POW_ITERATION = 1,
+    PKC_TRACE_MINI_POW_FINALIZE = 2,
+} pkc_trace_kind_t;
+
+typedef enum {
+    PKC_TRACE_SINK_BINARY = 0,
+    PKC_TRACE_SINK_TEXT = 1,
+} pkc_trace_sink_t;
+
+// 40 bytes, written verbatim to the binary sink.
+typedef struct __attribute__((aligned(8))) {
+    uint64_t start_time;
+    uint64_t receive_time;
+    uint64_t duration;
+    uint32_t session_id;
+    uint32_t challenge_id;
+    uint32_t iteration;
+    uint16_t kind;
+    uint16_t reserved;
+} pkc_trace_event_t;
+
+typedef struct __attribute__((aligned(64))) {
+    _Atomic(uint64_t) seq;
+    pkc_trace_event_t ev;
+} pkc_trace_slot_t;
+
+typedef struct {
+    pkc_trace_slot_t *slots;
+    uint64_t mask;
+    __attribute__((aligned(64))) _Atomic(uint64_t) head; // next slot to claim
+    __attribute__((aligned(64))) uint64_t tail;          // next slot to drain, drainer only
+    _Atomic(uint64_t) dropped;
+    _Atomic(bool) running;
+    pkc_trace_sink_t sink;
+    int fd;
+    pthread_t drainer;
+} pkc_trace_recorder_t;
+
+// Active process-wide recorder, NULL when tracing is off. Weak: one per process.
+__attribute__((weak)) _Atomic(pkc_trace_recorder_t *) pkc_trace_active;
+
+// Producers currently inside a recorder; pkc_trace_stop waits for zero.
+__attribute__((weak)) _Atomic(uint32_t) pkc_trace_writers;
+
+PKC_TRACE_INLINE bool pkc_trace_emit(pkc_trace_recorder_t *rec, const pkc_trace_event_t *ev)
+{
+    uint64_t pos = atomic_load_explicit(&rec->head, memory_order_relaxed);
+    pkc_trace_slot_t *slot;
+
+    for (;;) {
+        slot = &rec->slots[pos & rec->mask];
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            // Slot is free for `pos`; claim it (only contended between producers).
+            if (atomic_compare_exchange_weak_explicit(&rec->head, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // Drainer is a full lap behind: drop rather than wait.
+            atomic_fetch_add_explicit(&rec->dropped, 1, memory_order_relaxed);
+            return false;
+        } else {
+            pos = atomic_load_explicit(&rec->head, memory_order_relaxed);
+        }
+    }
+
+    slot->ev = *ev;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+/*
+ * Pins the active recorder for one emit. The first load keeps the disabled
+ * path to one relaxed load; the seq_cst increment/reload pairs with the
+ * store/wait in pkc_trace_stop so a pinned recorder is never freed under us.
+ */
+PKC_TRACE_INLINE pkc_trace_recorder_t *pkc_trace_enter(void)
+{
+    if (__builtin_expect(atomic_load_explicit(&pkc_trace_active, memory_order_relaxed) == NULL, 1)) return NULL;
+
+    atomic_fetch_add(&pkc_trace_writers, 1);
+    pkc_trace_recorder_t *rec = atomic_load(&pkc_trace_active);
+    if (!rec) atomic_fetch_sub_explicit(&pkc_trace_writers, 1, memory_order_release);
+    return rec;
+}
+
+PKC_TRACE_INLINE void pkc_trace_leave(void)
+{
+    atomic_fetch_sub_explicit(&pkc_trace_writers, 1, memory_order_release);
+}
+
+/*
+ * Records one MiniPoW iteration if tracing is active. Costs one relaxed
+ * load when it is not.
+ */
+PKC_TRACE_INLINE void pkc_trace_mini_pow_iteration(uint32_t session_id, uint32_t challenge_id,
+                                                   uint32_t iteration, uint64_t start_time,
+                                                   uint64_t receive_time, uint64_t duration)
+{
+    pkc_trace_recorder_t *rec = pkc_trace_enter();
+    if (__builtin_expect(rec == NULL, 1)) return;
+
+    pkc_trace_event_t ev = {
+        .start_time = start_time,
+        .receive_time = receive_time,
+        .duration = duration,
+        .session_id = session_id,
+        .challenge_id = challenge_id,
+        .iteration = iteration,
+        .kind = PKC_TRACE_MINI_POW_ITERATION,
+        .reserved = 0,
+    };
+    pkc_trace_emit(rec, &ev);
+    pkc_trace_leave();
+}
+
+/*
+ * Records the end of a MiniPoW session: `iterations` answered, the verify
+ * window [start_time, end_time] and the assigned tier (in `reserved`).
+ */
+PKC_TRACE_INLINE void pkc_trace_mini_pow_finalize(uint32_t session_id, uint32_t challenge_id,
+                                                  uint32_t iterations, uint64_t start_time,
+                                                  uint64_t end_time, uint16_t tier)
+{
+    pkc_trace_recorder_t *rec = pkc_trace_enter();
+    if (__builtin_expect(rec == NULL, 1)) return;
+
+    pkc_trace_event_t ev = {
+        .start_time = start_time,
+        .receive_time = end_time,
+        .duration = end_time > start_time ? end_time - start_time : 0,
+        .session_id = session_id,
+        .challenge_id = challenge_id,
+        .iteration = iterations,
+        .kind = PKC_TRACE_MINI_POW_FINALIZE,
+        .reserved = tier,
+    };
+    pkc_trace_emit(rec, &ev);
+    pkc_trace_leave();
+}
+
+static inline int pkc_trace_format_event(const pkc_trace_event_t *ev, char *out, size_t cap)
+{
+    const char *kind = ev->kind == PKC_TRACE_MINI_POW_ITERATION ? "mini_pow_iteration"
+                     : ev->kind == PKC_TRACE_MINI_POW_FINALIZE ? "mini_pow_finalize"
+                     : "unknown";
+    if (ev->kind == PKC_TRACE_MINI_POW_FINALIZE) {
+        return snprintf(out, cap, "%s session=%u challenge=%u iterations=%u start=%llu end=%llu duration=%llu tier=%u\n",
+                        kind, ev->session_id, ev->challenge_id, ev->iteration,
+                        (unsigned long long)ev->start_time,
+                        (unsigned long long)ev->receive_time,
+                        (unsigned long long)ev->duration, (unsigned)ev->reserved);
+    }
+    return snprintf(out, cap, "%s session=%u challenge=%u iteration=%u start=%llu receive=%llu duration=%llu\n",
+                    kind, ev->session_id, ev->challenge_id, ev->iteration,
+                    (unsigned long long)ev->start_time,
+                    (unsigned long long)ev->receive_time,
+                    (unsigned long long)ev->duration);
+}
+
+static inline bool pkc_trace_write_all(int fd, const void *buf, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    while (len > 0) {
+        ssize_t w = write(fd, p, len);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += w;
+        len -= (size_t)w;
+    }
+    return true;
+}
+
+/*
+ * Drains every published event. Returns the number of events written.
+ * Only ever called from the drainer thread (or after it has stopped).
+ */
+static inline size_t pkc_trace_drain(pkc_trace_recorder_t *rec)
+{
+    char out[8192];
+    size_t used = 0;
+    size_t drained = 0;
+
+    for (;;) {
+        pkc_trace_slot_t *slot = &rec->slots[rec->tail & rec->mask];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != rec->tail + 1) break;
+
+        if (rec->sink == PKC_TRACE_SINK_TEXT) {
+            char line[256];
+            int n = pkc_trace_format_event(&slot->ev, line, sizeof(line));
+            if (n > 0) {
+                if (used + (size_t)n > sizeof(out)) {
+                    pkc_trace_write_all(rec->fd, out, used);
+                    used = 0;
+                }
+                memcpy(out + used, line, (size_t)n);
+                used += (size_t)n;
+            }
+        } else {
+            if (used + sizeof(pkc_trace_event_t) > sizeof(out)) {
+                pkc_trace_write_all(rec->fd, out, used);
+                used = 0;
+            }
+            memcpy(out + used, &slot->ev, sizeof(pkc_trace_event_t));
+            used += sizeof(pkc_trace_event_t);
+        }
+
+        // Hand the slot back to producers one lap ahead.
+        atomic_store_explicit(&slot->seq, rec->tail + rec->mask + 1, memory_order_release);
+        rec->tail++;
+        drained++;
+    }
+
+    if (used > 0) pkc_trace_write_all(rec->fd, out, used);
+    return drained;
+}
+
+static inline void *pkc_trace_drainer_main(void *arg)
+{
+    pkc_trace_recorder_t *rec = (pkc_trace_recorder_t *)arg;
+    const struct timespec idle = { 0, PKC_TRACE_DRAIN_IDLE_NS };
+
+    while (atomic_load_explicit(&rec->running, memory_order_acquire)) {
+        if (pkc_trace_drain(rec) == 0) nanosleep(&idle, NULL);
+    }
+    pkc_trace_drain(rec);
+    return NULL;
+}
+
+/*
+ * Opens `path`, allocates a ring of `capacity` events (rounded up to a power
+ * of two, 0 = default), starts the drainer and makes the recorder active.
+ */
+static inline OpStatus_t pkc_trace_start(pkc_trace_recorder_t *rec, const char *path,
+                                         size_t capacity, pkc_trace_sink_t sink)
+{
+    if (!rec || !path || path[0] == '\0') return OP_INVALID_INPUT;
+    if (atomic_load_explicit(&pkc_trace_active, memory_order_acquire) != NULL) return OP_INVALID_STATE;
+
+    size_t cap = capacity ? capacity : PKC_TRACE_DEFAULT_CAPACITY;
+    size_t pow2 = 1;
+    while (pow2 < cap) pow2 <<= 1;
+
+    memset(rec, 0, sizeof(*rec));
+    rec->slots = (pkc_trace_slot_t *)aligned_alloc(64, pow2 * sizeof(pkc_trace_slot_t));
+    if (!rec->slots) return OP_INVALID_INPUT;
+    for (size_t i = 0; i < pow2; ++i) {
+        atomic_store_explicit(&rec->slots[i].seq, (uint64_t)i, memory_order_relaxed);
+    }
+    rec->mask = pow2 - 1;
+    rec->sink = sink;
+
+    rec->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (rec->fd < 0) {
+        free(rec->slots);
+        rec->slots = NULL;
+        return OP_INVALID_INPUT;
+    }
+
+    if (sink == PKC_TRACE_SINK_BINARY) {
+        uint8_t hdr[PKC_TRACE_MAGIC_LEN + 4];
+        memcpy(hdr, PKC_TRACE_MAGIC, PKC_TRACE_MAGIC_LEN);
+        hdr[PKC_TRACE_MAGIC_LEN] = PKC_TRACE_VERSION;
+        hdr[PKC_TRACE_MAGIC_LEN + 1] = (uint8_t)sizeof(pkc_trace_event_t);
+        hdr[PKC_TRACE_MAGIC_LEN + 2] = 0;
+        hdr[PKC_TRACE_MAGIC_LEN + 3] = 0;
+        pkc_trace_write_all(rec->fd, hdr, sizeof(hdr));
+    }
+
+    atomic_store_explicit(&rec->running, true, memory_order_release);
+    if (pthread_create(&rec->drainer, NULL, pkc_trace_drainer_main, rec) != 0) {
+        close(rec->fd);
+        free(rec->slots);
+        rec->slots = NULL;
+        return OP_INVALID_STATE;
+    }
+
+    atomic_store_explicit(&pkc_trace_active, rec, memory_order_release);
+    return OP_SUCCESS;
+}
+
+/*
+ * Deactivates the recorder, waits for producers still inside an emit,
+ * joins the drainer after a final drain and closes the file. Emits never
+ * block, so the wait is bounded by one event copy per producer.
+ */
+static inline OpStatus_t pkc_trace_stop(pkc_trace_recorder_t *rec)
+{
+    if (!rec || !rec->slots) return OP_INVALID_INPUT;
+
+    pkc_trace_recorder_t *expected = rec;
+    atomic_compare_exchange_strong(&pkc_trace_active, &expected, (pkc_trace_recorder_t *)NULL);
+    while (atomic_load(&pkc_trace_writers) != 0) sched_yield();
+
+    atomic_store_explicit(&rec->running, false, memory_order_release);
+    pthread_join(rec->drainer, NULL);
+
+    fdatasync(rec->fd);
+    close(rec->fd);
+    free(rec->slots);
+    rec->slots = NULL;
+    return OP_SUCCESS;
+}
+
+PKC_TRACE_INLINE uint64_t pkc_trace_dropped(const pkc_trace_recorder_t *rec)
+{
+    return rec ? atomic_load_explicit(&rec->dropped, memory_order_relaxed) : 0;
+}
+
+/*
+ * Opt-in text dumper: converts a binary trace file to one line per event.
+ */
+static inline OpStatus_t pkc_trace_dump_text(const char *bin_path, FILE *out)
+{
+    if (!bin_path || !out) return OP_NULL_PTR;
+
+    FILE *in = fopen(bin_path, "rb");
+    if (!in) return OP_INVALID_INPUT;
+
+    uint8_t hdr[PKC_TRACE_MAGIC_LEN + 4];
+    if (fread(hdr, 1, sizeof(hdr), in) != sizeof(hdr) ||
+        memcmp(hdr, PKC_TRACE_MAGIC, PKC_TRACE_MAGIC_LEN) != 0 ||
+        hdr[PKC_TRACE_MAGIC_LEN] != PKC_TRACE_VERSION ||
+        hdr[PKC_TRACE_MAGIC_LEN + 1] != sizeof(pkc_trace_event_t)) {
+        fclose(in);
+        return OP_INVALID_INPUT;
+    }
+
+    pkc_trace_event_t ev;
+    char line[256];
+    while (fread(&ev, sizeof(ev), 1, in) == 1) {
+        int n = pkc_trace_format_event(&ev, line, sizeof(line));
+        if (n > 0) fwrite(line, 1, (size_t)n, out);
+    }
+
+    fclose(in);
+    return OP_SUCCESS;
+}
+
+#endif // PKC_TRACE_H
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blockchain/blockBulk_ops.h"
+#include "telemetry/metrics_ops.h"
+
+/*
+ * Bulk block (de)serialization: the vector kernel (when built with SSSE3 or
+ * AVX2) against the block_serialize / block_deserialize loop, byte for byte
+ * and field for field, single-threaded and split over the work pool.
+ */
+
+#define BULK_BLOCKS 200000
+#define BULK_ROUNDS 5
+
+static uint64_t rng_state = 0x243F6A8885A308D3ULL;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void make_block(block *b, uint64_t height)
+{
+    block_init(b);
+    uint64_t words[4 + 4 + 4 + 4 + 8];
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); ++i) words[i] = rng_next();
+    memcpy(&b->cert.pubSignKey, &words[0], UINT256_SIZE);
+    memcpy(&b->cert.pubEncKey, &words[4], UINT256_SIZE);
+    memcpy(&b->CurrentCertHash, &words[8], UINT256_SIZE);
+    memcpy(&b->prevHash, &words[12], UINT256_SIZE);
+    memcpy(&b->SignedByVerifier, &words[16], 2 * UINT256_SIZE);
+    const uint64_t id = rng_next();
+    memcpy(&b->cert.id, &id, sizeof(b->cert.id) < sizeof(id) ? sizeof(b->cert.id) : sizeof(id));
+    b->height = height;
+    b->timestamp = rng_next();
+    b->tier = (Tier_t)(TIER_MCU + height % 4);
+    block_set_pow_version(b, (uint8_t)(height & 1));
+}
+
+static double best_ms(uint64_t *ns, int n)
+{
+    uint64_t best = ns[0];
+    for (int i = 1; i < n; ++i) if (ns[i] < best) best = ns[i];
+    return best / 1e6;
+}
+
+int main() {
+    printf("Initializing bulk block serialization benchmark...\n");
+    int rc = 0;
+
+    block *blocks = calloc(BULK_BLOCKS, sizeof(block));
+    block *scalar = calloc(BULK_BLOCKS, sizeof(block));
+    block *bulk = calloc(BULK_BLOCKS, sizeof(block));
+    uint8_t *want = calloc(BULK_BLOCKS, BLOCK_SIZE);
+    uint8_t *got = calloc(BULK_BLOCKS, BLOCK_SIZE);
+    if (!blocks || !scalar || !bulk || !want || !got) return 1;
+    for (uint32_t i = 0; i < BULK_BLOCKS; ++i) make_block(&blocks[i], i);
+
+    printf("Kernel: %s, pool workers: %u\n",
+           blocks_bulk_simd() ? BLOCKS_BULK_ISA : "scalar",
+           pkc_pool_workers(pkc_pool_default()));
+
+    // --- Reference vs bulk, small and odd sizes through the sequential path ---
+    const size_t sizes[] = {0, 1, 3, 100, BLOCKS_BULK_CHUNK + 7};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        const size_t n = sizes[s];
+        memset(want, 0xCC, n * BLOCK_SIZE + 1);
+        memset(got, 0xCC, n * BLOCK_SIZE + 1);
+        if (blocks_serialize_scalar(blocks, n, want) != OP_SUCCESS ||
+            blocks_serialize(blocks, n, got, n * BLOCK_SIZE) != OP_SUCCESS ||
+            memcmp(want, got, n * BLOCK_SIZE + 1) != 0) {
+            printf("Error: bulk serialize of %zu blocks differs\n", n);
+            rc = 1;
+        }
+    }
+    if (blocks_serialize(blocks, 2, got, 2 * BLOCK_SIZE - 1) != OP_BUFFER_TOO_SMALL) rc = 1;
+    if (blocks_deserialize(got, BLOCK_SIZE, bulk, 2) != OP_BUFFER_TOO_SMALL) rc = 1;
+
+    // --- Timings over the whole array (the large calls fork onto the pool) ---
+    uint64_t ser_scalar[BULK_ROUNDS], ser_bulk[BULK_ROUNDS], de_scalar[BULK_ROUNDS], de_bulk[BULK_ROUNDS];
+    for (int r = 0; r < BULK_ROUNDS; ++r) {
+        uint64_t t0 = pkc_metrics_now_ns();
+        blocks_serialize_scalar(blocks, BULK_BLOCKS, want);
+        ser_scalar[r] = pkc_metrics_now_ns() - t0;
+
+        t0 = pkc_metrics_now_ns();
+        if (blocks_serialize(blocks, BULK_BLOCKS, got, (size_t)BULK_BLOCKS * BLOCK_SIZE) != OP_SUCCESS) rc = 1;
+        ser_bulk[r] = pkc_metrics_now_ns() - t0;
+
+        t0 = pkc_metrics_now_ns();
+        blocks_deserialize_scalar(want, scalar, BULK_BLOCKS);
+        de_scalar[r] = pkc_metrics_now_ns() - t0;
+
+        t0 = pkc_metrics_now_ns();
+        if (blocks_deserialize(want, (size_t)BULK_BLOCKS * BLOCK_SIZE, bulk, BULK_BLOCKS) != OP_SUCCESS) rc = 1;
+        de_bulk[r] = pkc_metrics_now_ns() - t0;
+    }
+    if (memcmp(want, got, (size_t)BULK_BLOCKS * BLOCK_SIZE) != 0) {
+        printf("Error: bulk serialize of %u blocks differs from block_serialize\n", BULK_BLOCKS);
+        rc = 1;
+    }
+    if (memcmp(scalar, bulk, (size_t)BULK_BLOCKS * sizeof(block)) != 0) {
+        printf("Error: bulk deserialize of %u blocks differs from block_deserialize\n", BULK_BLOCKS);
+        rc = 1;
+    }
+    for (uint32_t i = 0; i < BULK_BLOCKS; i += 4999) {
+        if (bulk[i].height != blocks[i].height || bulk[i].timestamp != blocks[i].timestamp ||
+            memcmp(&bulk[i].SignedByVerifier, &blocks[i].SignedByVerifier, 2 * UINT256_SIZE) != 0)
+            rc = 1;
+    }
+
+    const double mb = (double)BULK_BLOCKS * BLOCK_SIZE / 1e6;
+    printf("%-12s %10s %10s %8s\n", "", "scalar ms", "bulk ms", "speedup");
+    printf("%-12s %10.2f %10.2f %7.2fx  (%.0f MB/s)\n", "serialize", best_ms(ser_scalar, BULK_ROUNDS),
+           best_ms(ser_bulk, BULK_ROUNDS), best_ms(ser_scalar, BULK_ROUNDS) / best_ms(ser_bulk, BULK_ROUNDS),
+           mb / (best_ms(ser_bulk, BULK_ROUNDS) / 1e3));
+    printf("%-12s %10.2f %10.2f %7.2fx  (%.0f MB/s)\n", "deserialize", best_ms(de_scalar, BULK_ROUNDS),
+           best_ms(de_bulk, BULK_ROUNDS), best_ms(de_scalar, BULK_ROUNDS) / best_ms(de_bulk, BULK_ROUNDS),
+           mb / (best_ms(de_bulk, BULK_ROUNDS) / 1e3));
+
+    free(got);
+    free(want);
+    free(bulk);
+    free(scalar);
+    free(blocks);
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
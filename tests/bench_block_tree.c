@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blockchain/blockTree_ops.h"
+#include "telemetry/metrics_ops.h"
+
+/*
+ * Block tree: side branches, best-tip moves and 1000-block reorgs on a
+ * long chain, with the columns and tier index kept in step against a
+ * rebuild of both from genesis. Then a tree attached to a PKCertChain
+ * that holds a revocation, where a short branch of heavier blocks must win
+ * over a longer light one, leaving the chain's tier fields as that branch
+ * has them, and blocks for the same certificate compete by exact integer
+ * work.
+ */
+
+#define TREE_BASE 100000u
+#define TREE_REORG_DEPTH 1000u
+#define TREE_ROUNDS 10
+
+static uint64_t rng_state = 0x853C49E6748FEA9BULL;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/* Block `height` of branch `branch` on top of `parent` (NULL for genesis). */
+static void make_block(block *b, uint64_t height, uint64_t branch, const block *parent, uint8_t complexity)
+{
+    block_init(b);
+    b->height = height;
+    b->timestamp = 1700000000ULL + height * 5;
+    const uint64_t key[2] = {height, branch};
+    hash256_buffer((const uint8_t *)key, sizeof(key), &b->CurrentCertHash);
+    if (!parent) {
+        b->tier = TIER_INVALID;
+        return;
+    }
+    block_link_hash(parent, &b->prevHash);
+    b->tier = (Tier_t)(TIER_MCU + rng_next() % 4);
+    b->tierPoWResult.tier = b->tier;
+    b->tierPoWResult.time_taken = 0.5 + (double)(rng_next() % 2000) / 1000.0;
+    tier_pow_challenge_set_complexity(&b->tierPoWResult.challenge, complexity);
+    block_set_pow_version(b, TIER_POW_VERSION_LEADING_ZERO);
+}
+
+/* Best branch is linked and the side stores agree with a rebuild from genesis. */
+static int check_stores(const pkc_block_tree_t *t, const pkc_chain_columns_t *cols, const pkc_tier_index_t *tiers,
+                        pkc_tier_index_t *fresh, uint32_t from)
+{
+    if (cols->count != t->height) return 1;
+    for (uint32_t h = from ? from : 1; h < t->height; ++h) {
+        const block *blk = pkc_tree_active_block(t, h);
+        if (memcmp(&blk->prevHash, &t->nodes[t->active[h - 1]].hash, sizeof(uint256)) != 0 ||
+            memcmp(&cols->prev_hash[h], &blk->prevHash, sizeof(uint256)) != 0 ||
+            memcmp(&cols->cert_hash[h], &blk->CurrentCertHash, sizeof(uint256)) != 0)
+            return 1;
+    }
+    // the columns check links against the same block_link_hash the tree keys by
+    if (pkc_columns_first_broken_link(cols, from, t->height) != PKC_COLUMNS_NONE) return 1;
+    if (tiers->count != t->height) return 1;
+    for (int s = 0; s < TIER_POW_DIFFICULTY_TIERS; ++s) {
+        const pkc_tier_list_t *a = &tiers->tiers[s], *b = &fresh->tiers[s];
+        const double dw = a->window_seconds - b->window_seconds, dt = a->total_seconds - b->total_seconds;
+        if (a->count != b->count || a->solves != b->solves || a->window_count != b->window_count ||
+            dw > 1e-9 || dw < -1e-9 || dt > 1e-6 || dt < -1e-6 ||
+            memcmp(a->index, b->index, a->count * sizeof(uint32_t)) != 0)
+            return 1;
+    }
+    return 0;
+}
+
+int main() {
+    printf("Initializing block tree benchmark...\n");
+    int rc = 0;
+
+    const uint32_t capacity = TREE_BASE + TREE_ROUNDS * 2 + 16;
+    pkc_chain_columns_t cols;
+    pkc_tier_index_t tiers, fresh;
+    if (pkc_columns_init(&cols, capacity) != OP_SUCCESS || pkc_tier_index_init(&tiers, capacity) != OP_SUCCESS ||
+        pkc_tier_index_init(&fresh, capacity) != OP_SUCCESS)
+        return 1;
+    pkc_tree_config_t cfg;
+    pkc_tree_config_default(&cfg);
+    cfg.columns = &cols;
+    cfg.tiers = &tiers;
+    pkc_block_tree_t tree;
+    if (pkc_tree_init(&tree, &cfg) != OP_SUCCESS) return 1;
+
+    // --- A long best branch ---
+    block b, prev;
+    pkc_tree_result_t res;
+    uint64_t t0 = pkc_metrics_now_ns();
+    make_block(&prev, 0, 0, NULL, 0);
+    if (pkc_tree_add(&tree, &prev, &res) != OP_SUCCESS || res.outcome != PKC_TREE_EXTENDED) rc = 1;
+    for (uint32_t h = 1; h < TREE_BASE; ++h) {
+        make_block(&b, h, 0, &prev, 8);
+        if (pkc_tree_add(&tree, &b, &res) != OP_SUCCESS || res.outcome != PKC_TREE_EXTENDED) rc = 1;
+        prev = b;
+    }
+    printf("Best branch of %u blocks built in %.2f ms\n", tree.height, (pkc_metrics_now_ns() - t0) / 1e6);
+    uint256 first_tip;
+    block_link_hash(&b, &first_tip);
+
+    // --- Rejections ---
+    if (pkc_tree_add(&tree, &b, &res) != OP_SUCCESS || res.outcome != PKC_TREE_DUPLICATE) rc = 1;
+    block unknown, orphan;
+    make_block(&unknown, TREE_BASE, 99, &b, 8);
+    make_block(&orphan, TREE_BASE + 1, 99, &unknown, 8);
+    if (pkc_tree_add(&tree, &orphan, NULL) != OP_INVALID_STATE) rc = 1;
+    make_block(&orphan, TREE_BASE + 5, 98, &b, 8);
+    if (pkc_tree_add(&tree, &orphan, NULL) != OP_INVALID_INPUT) rc = 1;
+
+    // --- 1000-block reorgs: a side branch from tip - 1000 that ends one block longer ---
+    uint64_t reorg_ns[TREE_ROUNDS], rebuild_ns[TREE_ROUNDS];
+    for (int r = 0; r < TREE_ROUNDS; ++r) {
+        const uint32_t fork = tree.height - 1 - TREE_REORG_DEPTH;
+        prev = *pkc_tree_active_block(&tree, fork);
+        for (uint32_t i = 1; i <= TREE_REORG_DEPTH; ++i) {
+            make_block(&b, fork + i, (uint64_t)r + 1, &prev, 8);
+            // equal work up to the old tip's height: the incumbent keeps it
+            if (pkc_tree_add(&tree, &b, &res) != OP_SUCCESS || res.outcome != PKC_TREE_SIDE) rc = 1;
+            prev = b;
+        }
+        make_block(&b, fork + TREE_REORG_DEPTH + 1, (uint64_t)r + 1, &prev, 8);
+        t0 = pkc_metrics_now_ns();
+        if (pkc_tree_add(&tree, &b, &res) != OP_SUCCESS) rc = 1;
+        reorg_ns[r] = pkc_metrics_now_ns() - t0;
+        if (res.outcome != PKC_TREE_REORG || res.fork_height != fork || res.disconnected != TREE_REORG_DEPTH ||
+            res.connected != TREE_REORG_DEPTH + 1 || pkc_tree_best(&tree) != pkc_tree_node(&tree, res.node)) {
+            printf("Error: round %d did not reorganize %u blocks\n", r, TREE_REORG_DEPTH);
+            rc = 1;
+        }
+
+        // What an append-only store would redo: both side stores from genesis.
+        t0 = pkc_metrics_now_ns();
+        pkc_tier_index_truncate(&fresh, 0);
+        for (uint32_t h = 0; h < tree.height; ++h) pkc_tier_index_append(&fresh, pkc_tree_active_block(&tree, h), 1);
+        pkc_chain_columns_t again;
+        pkc_columns_init(&again, capacity);
+        for (uint32_t h = 0; h < tree.height; ++h) pkc_columns_append(&again, pkc_tree_active_block(&tree, h), 1);
+        rebuild_ns[r] = pkc_metrics_now_ns() - t0;
+        pkc_columns_destroy(&again);
+
+        if (check_stores(&tree, &cols, &tiers, &fresh, fork)) {
+            printf("Error: side stores differ after round %d\n", r);
+            rc = 1;
+        }
+    }
+    uint64_t reorg_best = reorg_ns[0], rebuild_best = rebuild_ns[0];
+    for (int r = 1; r < TREE_ROUNDS; ++r) {
+        if (reorg_ns[r] < reorg_best) reorg_best = reorg_ns[r];
+        if (rebuild_ns[r] < rebuild_best) rebuild_best = rebuild_ns[r];
+    }
+    printf("%u-block reorg on a %u-block branch (%u nodes): %.1f us, rebuilding the indexes instead %.1f us (%.0fx)\n",
+           TREE_REORG_DEPTH, tree.height, tree.count, reorg_best / 1e3, rebuild_best / 1e3,
+           (double)rebuild_best / (reorg_best ? reorg_best : 1));
+
+    // --- The original branch grows until it outweighs the last side branch ---
+    {
+        const uint32_t id = pkc_tree_find(&tree, &first_tip);
+        if (id == PKC_TREE_NONE || pkc_tree_node(&tree, id)->active) rc = 1;
+        prev = pkc_tree_node(&tree, id)->blk;
+        uint32_t extended = 0;
+        while (rc == 0) {
+            make_block(&b, prev.height + 1, 0, &prev, 8);
+            if (pkc_tree_add(&tree, &b, &res) != OP_SUCCESS) rc = 1;
+            prev = b;
+            extended++;
+            if (res.outcome == PKC_TREE_REORG) break;
+        }
+        pkc_tier_index_truncate(&fresh, 0);
+        for (uint32_t h = 0; h < tree.height; ++h) pkc_tier_index_append(&fresh, pkc_tree_active_block(&tree, h), 1);
+        printf("Original branch back on top after %u more blocks, reorg of %u\n", extended, res.disconnected);
+        if (check_stores(&tree, &cols, &tiers, &fresh, (uint32_t)res.fork_height)) rc = 1;
+    }
+    pkc_tree_destroy(&tree);
+    pkc_tier_index_destroy(&fresh);
+    pkc_tier_index_destroy(&tiers);
+    pkc_columns_destroy(&cols);
+
+    // --- Attached chain: a short heavy branch beats a long light one ---
+    PKCertChain *chain = calloc(1, sizeof(PKCertChain));
+    if (!chain) return 1;
+    const uint32_t chain_cap = PKC_CHAIN_CAPACITY(chain);
+    make_block(&chain->blocks[0], 0, 0, NULL, 0);
+    chain->index = 1;
+    for (uint32_t h = 1; h < 60 && h < chain_cap; ++h) {
+        make_block(&chain->blocks[h], h, 0, &chain->blocks[h - 1], 8);
+        if (h == 20) {
+            // revokes block 19's certificate: same cert, its own block
+            chain->blocks[h].cert = chain->blocks[h - 1].cert;
+            chain->blocks[h].CurrentCertHash = chain->blocks[h - 1].CurrentCertHash;
+            block_set_cert_op(&chain->blocks[h], BLOCK_CERT_OP_REVOKE);
+        }
+        tier_pow_chain_set_last_index(chain, tier_pow_chain_field(chain->blocks[h].tier), h);
+        chain->index = h + 1;
+    }
+    for (int s = 0; s < TIER_POW_DIFFICULTY_TIERS; ++s) tier_pow_chain_set_complexity(chain, &tier_pow_chain_fields[s], 9);
+    pkc_block_tree_t attached;
+    pkc_tree_init(&attached, NULL);
+    pkc_chain_writer_t w;
+    if (pkc_chain_writer_start(&w, chain, NULL) != OP_SUCCESS) return 1;
+    if (pkc_tree_attach(&attached, chain) != OP_INVALID_STATE) rc = 1;     // the writer owns it
+    pkc_chain_writer_stop(&w);
+    if (pkc_tree_attach(&attached, chain) != OP_SUCCESS || attached.height != chain->index) rc = 1;
+    if (attached.nodes[attached.best].complexity[0] != 9) rc = 1;   // the tip keeps the chain's fields
+
+    const uint32_t fork = chain->index / 2;
+    prev = chain->blocks[fork];
+    const uint32_t light = chain->index - 1 - fork;
+    for (uint32_t i = 1; i <= 3; ++i) {
+        make_block(&b, fork + i, 7, &prev, 20);        // 2^20 each against 2^8 per light block
+        if (pkc_tree_add(&attached, &b, &res) != OP_SUCCESS) rc = 1;
+        // the first heavy block already outweighs the light suffix, the rest extend it
+        if (res.outcome != (i == 1 ? PKC_TREE_REORG : PKC_TREE_EXTENDED) || (i == 1 && res.disconnected != light))
+            rc = 1;
+        prev = b;
+    }
+    if (chain->index != fork + 4) {
+        printf("Error: heavy branch did not take over (index %u)\n", chain->index);
+        rc = 1;
+    }
+    for (uint32_t h = 0; h < chain->index; ++h) {
+        if (memcmp(&chain->blocks[h].CurrentCertHash, &pkc_tree_active_block(&attached, h)->CurrentCertHash,
+                   sizeof(uint256)) != 0)
+            rc = 1;
+    }
+    for (int s = 0; s < TIER_POW_DIFFICULTY_TIERS; ++s) {
+        const tier_pow_chain_field_t *f = &tier_pow_chain_fields[s];
+        uint32_t want = 0;
+        for (uint32_t h = chain->index; h > 0; --h) {
+            if (chain->blocks[h - 1].tier == f->tier) {
+                want = h - 1;
+                break;
+            }
+        }
+        if (tier_pow_chain_last_index(chain, f) != want) rc = 1;
+        // restored from the new branch: what its newest block of the tier solved at
+        if (want && tier_pow_chain_complexity(chain, f) !=
+                        tier_pow_challenge_get_complexity(&chain->blocks[want].tierPoWResult.challenge))
+            rc = 1;
+    }
+    for (uint64_t h = prev.height + 1; h < chain_cap; ++h) {
+        make_block(&b, h, 7, &prev, 8);
+        if (pkc_tree_add(&attached, &b, NULL) != OP_SUCCESS) rc = 1;
+        prev = b;
+    }
+    make_block(&b, chain_cap, 7, &prev, 8);
+    if (pkc_tree_add(&attached, &b, NULL) != OP_BUFFER_TOO_SMALL) rc = 1;
+
+    // --- Competing blocks for the tip's certificate, target mode against 2^8 ---
+    block rival = prev;
+    rival.timestamp++;
+    block_set_pow_version(&rival, TIER_POW_VERSION_TARGET);
+    tier_pow_challenge_set_target_bits(&rival.tierPoWResult.challenge, tier_pow_target_from_complexity(8.0));
+    if (pkc_tree_add(&attached, &rival, &res) != OP_SUCCESS || res.outcome != PKC_TREE_SIDE) {
+        printf("Error: equal-work rival for the same certificate was not kept as a side block\n");
+        rc = 1;
+    }
+    rival.timestamp++;
+    tier_pow_challenge_set_target_bits(&rival.tierPoWResult.challenge, tier_pow_target_from_complexity(9.0));
+    if (pkc_tree_add(&attached, &rival, &res) != OP_SUCCESS || res.outcome != PKC_TREE_REORG ||
+        res.disconnected != 1 || chain->blocks[chain_cap - 1].timestamp != rival.timestamp ||
+        tier_pow_chain_complexity(chain, tier_pow_chain_field(rival.tier)) != 9)
+        rc = 1;
+    printf("Attached chain: %u blocks after the heavy branch filled it\n", chain->index);
+    pkc_tree_destroy(&attached);
+    free(chain);
+
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
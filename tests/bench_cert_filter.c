@@ -0,0 +1,256 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "blockchain/certFilter_ops.h"
+#include "blockchain/certStatus_ops.h"
+#include "blockchain/chainWriter_ops.h"
+#include "telemetry/metrics_ops.h"
+
+/*
+ * Certificate membership filter against a scan of chain->blocks: false
+ * positives and negative-check cost at a few target rates over a million
+ * certificates, batch appends against a one-shot build, and the filter
+ * saved next to the chain state, loaded back and synced forward, both
+ * directly and as saved by the chain writer beside its persist hook and
+ * reopened with the status index.
+ */
+
+#define FILTER_BLOCKS (1u << 20)
+#define FILTER_QUERIES (1u << 20)
+#define FILTER_PROBE_SET (1u << 14)     // probe keys reused so the filter, not the probes, is what misses
+#define FILTER_SCANS 8
+#define FILTER_NETWORK "filterbench"
+
+static uint64_t rng_state = 0x2545F4914F6CDD1DULL;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void random_bytes(void *out, size_t n)
+{
+    for (size_t i = 0; i < n; i += 8) {
+        const uint64_t w = rng_next();
+        memcpy((uint8_t *)out + i, &w, n - i < 8 ? n - i : 8);
+    }
+}
+
+static void make_block(block *b, uint64_t h)
+{
+    block_init(b);
+    b->height = h;
+    b->tier = h ? TIER_EDGE : TIER_INVALID;
+    b->timestamp = 1700000000ULL + h * 5;
+    random_bytes(&b->CurrentCertHash, sizeof(b->CurrentCertHash));
+    if (h == 0) return;
+    random_bytes(&b->cert.pubSignKey, sizeof(b->cert.pubSignKey));
+    random_bytes(&b->cert.pubEncKey, sizeof(b->cert.pubEncKey));
+    random_bytes(&b->cert.id, sizeof(b->cert.id));
+}
+
+/* What a lookup without the filter does for a key that is not there. */
+static bool scan_sign_key(const block *blocks, uint32_t n, const uint256 *key)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        if (memcmp(&blocks[i].cert.pubSignKey, key, sizeof(*key)) == 0) return true;
+    }
+    return false;
+}
+
+static bool same_filter(const pkc_cert_filter_t *a, const pkc_cert_filter_t *b)
+{
+    return a->blocks == b->blocks && a->count == b->count && a->items == b->items &&
+           memcmp(a->words, b->words, (size_t)a->blocks * PKC_CERT_FILTER_WORDS * sizeof(uint32_t)) == 0;
+}
+
+static OpStatus_t count_batches(void *ctx, const PKCertChain *chain, uint32_t first, uint32_t count)
+{
+    (void)chain;
+    (void)first;
+    (void)count;
+    ++*(uint32_t *)ctx;
+    return OP_SUCCESS;
+}
+
+int main() {
+    printf("Initializing certificate filter benchmark...\n");
+    int rc = 0;
+
+    block *blocks = calloc(FILTER_BLOCKS, sizeof(block));
+    uint256 *keys = calloc(FILTER_PROBE_SET, sizeof(uint256));
+    ipv6_t *ids = calloc(FILTER_PROBE_SET, sizeof(ipv6_t));
+    if (!blocks || !keys || !ids) return 1;
+    for (uint32_t h = 0; h < FILTER_BLOCKS; ++h) make_block(&blocks[h], h);
+    random_bytes(keys, FILTER_PROBE_SET * sizeof(uint256));
+    random_bytes(ids, FILTER_PROBE_SET * sizeof(ipv6_t));
+
+    // --- False positives and negative cost per target rate ---
+    const double targets[] = {0.01, 0.001, 0.0001};
+    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); ++t) {
+        pkc_cert_filter_t f;
+        if (pkc_cert_filter_init(&f, FILTER_BLOCKS, targets[t]) != OP_SUCCESS) return 1;
+        uint64_t t0 = pkc_metrics_now_ns();
+        pkc_cert_filter_append(&f, blocks, FILTER_BLOCKS);
+        const double build_ms = (pkc_metrics_now_ns() - t0) / 1e6;
+
+        uint32_t missed = 0;
+        for (uint32_t h = 1; h < FILTER_BLOCKS; ++h) {
+            const certificate *c = &blocks[h].cert;
+            missed += !pkc_cert_filter_has_sign_key(&f, &c->pubSignKey) || !pkc_cert_filter_has_enc_key(&f, &c->pubEncKey) ||
+                      !pkc_cert_filter_has_id(&f, &c->id);
+        }
+
+        uint32_t sign = 0, enc = 0, id = 0;
+        t0 = pkc_metrics_now_ns();
+        for (uint32_t q = 0; q < FILTER_QUERIES; ++q) sign += pkc_cert_filter_has_sign_key(&f, &keys[q % FILTER_PROBE_SET]);
+        const double sign_ns = (double)(pkc_metrics_now_ns() - t0) / FILTER_QUERIES;
+        for (uint32_t q = 0; q < FILTER_QUERIES; ++q) enc += pkc_cert_filter_has_enc_key(&f, &keys[q % FILTER_PROBE_SET]);
+        t0 = pkc_metrics_now_ns();
+        for (uint32_t q = 0; q < FILTER_QUERIES; ++q) id += pkc_cert_filter_has_id(&f, &ids[q % FILTER_PROBE_SET]);
+        const double id_ns = (double)(pkc_metrics_now_ns() - t0) / FILTER_QUERIES;
+
+        const double fp = (double)(sign + enc + id) / (3.0 * FILTER_QUERIES);
+        printf("Target %.4f%%: %.2f bits/cert, built in %.1f ms, false positives %.4f%% (expected %.4f%%), "
+               "negative %.1f ns (key) / %.1f ns (id), %u missed\n",
+               100.0 * targets[t], (double)f.blocks * 256 / FILTER_BLOCKS, build_ms, 100.0 * fp,
+               100.0 * pkc_cert_filter_expected_fpr(f.items, f.blocks), sign_ns, id_ns, missed);
+        if (missed || fp > targets[t] * 2 + 3.0 / FILTER_PROBE_SET) rc = 1;
+        pkc_cert_filter_destroy(&f);
+    }
+
+    pkc_cert_filter_t f;
+    if (pkc_cert_filter_init(&f, FILTER_BLOCKS, 0) != OP_SUCCESS) return 1;
+    pkc_cert_filter_append(&f, blocks, FILTER_BLOCKS);
+    uint64_t t0 = pkc_metrics_now_ns();
+    uint32_t found = 0;
+    for (uint32_t q = 0; q < FILTER_SCANS; ++q) found += scan_sign_key(blocks, FILTER_BLOCKS, &keys[q]);
+    const double scan_ns = (double)(pkc_metrics_now_ns() - t0) / FILTER_SCANS;
+    printf("Scan of chain->blocks for an absent key: %.2f ms\n", scan_ns / 1e6);
+    if (found) rc = 1;
+
+    // Appending in batches lands on the same bits as one pass.
+    pkc_cert_filter_t batched;
+    if (pkc_cert_filter_init(&batched, FILTER_BLOCKS, 0) != OP_SUCCESS) return 1;
+    for (uint32_t at = 0; at < FILTER_BLOCKS;) {
+        uint32_t n = (uint32_t)(1 + rng_next() % 4096);
+        if (n > FILTER_BLOCKS - at) n = FILTER_BLOCKS - at;
+        pkc_cert_filter_append(&batched, blocks + at, n);
+        at += n;
+    }
+    if (!same_filter(&f, &batched)) rc = 1;
+    pkc_cert_filter_destroy(&batched);
+    pkc_cert_filter_destroy(&f);
+    if (pkc_cert_filter_init(&f, 16, 0.5) != OP_INVALID_INPUT || pkc_cert_filter_init(&f, 0, 0) != OP_INVALID_INPUT) rc = 1;
+
+    // --- Saved next to the chain state, loaded and synced forward ---
+    char home[] = "/tmp/pkc_filter_XXXXXX";
+    if (!mkdtemp(home)) return 1;
+    char dir[256], path[512];
+    snprintf(dir, sizeof(dir), "%s/%s", home, PKCERTCHAIN_BASE_SUBDIR);
+    mkdir(dir, 0700);
+    snprintf(dir, sizeof(dir), "%s/%s/%s", home, PKCERTCHAIN_BASE_SUBDIR, FILTER_NETWORK);
+    mkdir(dir, 0700);
+    setenv("HOME", home, 1);
+
+    PKCertChain *chain = calloc(1, sizeof(PKCertChain));
+    PKCertChain *other = calloc(1, sizeof(PKCertChain));
+    if (!chain || !other) return 1;
+    const uint32_t capacity = PKC_CHAIN_CAPACITY(chain);
+    strncpy(chain->NetworkName, FILTER_NETWORK, sizeof(chain->NetworkName) - 1);
+    for (uint32_t h = 0; h < capacity; ++h) {
+        block_copy(&chain->blocks[h], &blocks[h]);
+        make_block(&other->blocks[h], h);
+    }
+    chain->index = other->index = capacity / 2;
+
+    pkc_cert_filter_t saved, loaded, fresh;
+    if (pkc_cert_filter_init(&saved, capacity, 0.001) != OP_SUCCESS) return 1;
+    if (pkc_cert_filter_sync(&saved, chain) != OP_SUCCESS) rc = 1;
+    if (pkc_cert_filter_save(&saved, FILTER_NETWORK, chain) != OP_SUCCESS) rc = 1;
+    memset(&loaded, 0, sizeof(loaded));
+    if (pkc_cert_filter_load(&loaded, FILTER_NETWORK, chain) != OP_SUCCESS || !same_filter(&saved, &loaded) ||
+        loaded.capacity != capacity || loaded.fpr != 0.001)
+        rc = 1;
+    pkc_cert_filter_t wrong = {0};
+    if (pkc_cert_filter_load(&wrong, FILTER_NETWORK, other) != OP_INVALID_STATE || wrong.words) rc = 1;
+
+    chain->index = capacity;
+    if (pkc_cert_filter_sync(&loaded, chain) != OP_SUCCESS) rc = 1;
+    if (pkc_cert_filter_init(&fresh, capacity, 0.001) != OP_SUCCESS || pkc_cert_filter_build(&fresh, chain) != OP_SUCCESS) rc = 1;
+    printf("Saved at %u blocks, loaded and synced to %u: %s\n", saved.count, loaded.count,
+           same_filter(&loaded, &fresh) ? "matches a rebuild" : "DIFFERS from a rebuild");
+    if (!same_filter(&loaded, &fresh)) rc = 1;
+
+    // A flipped byte is caught by the file hash.
+    snprintf(path, sizeof(path), "%s/%s", dir, PKC_CERT_FILTER_FILE);
+    FILE *fp = fopen(path, "r+b");
+    if (!fp) return 1;
+    fseek(fp, PKC_CERT_FILTER_HEADER_SIZE + 5, SEEK_SET);
+    fputc(0x5A ^ fgetc(fp), fp);
+    fclose(fp);
+    chain->index = capacity / 2;
+    if (pkc_cert_filter_load(&wrong, FILTER_NETWORK, chain) != OP_INVALID_INPUT) rc = 1;
+    pkc_cert_filter_destroy(&fresh);
+    pkc_cert_filter_destroy(&loaded);
+    pkc_cert_filter_destroy(&saved);
+
+    // --- The writer saves the status index's filter beside its persist hook ---
+    pkc_cert_index_t certs;
+    if (pkc_cert_index_init(&certs, capacity, 0.001) != OP_SUCCESS) return 1;
+    chain->index = 1;
+    uint32_t batches = 0;
+    pkc_chain_writer_config_t wcfg = { .persist = count_batches, .persist_ctx = &batches, .certs = &certs,
+                                       .cert_filter_save_ns = 1000000 };
+    pkc_chain_writer_t w;
+    if (pkc_chain_writer_start(&w, chain, &wcfg) != OP_SUCCESS) return 1;
+    for (uint32_t h = 1; h < capacity / 2; ++h) {
+        if (pkc_chain_append(&w, &blocks[h], NULL) != OP_SUCCESS) rc = 1;
+    }
+    pkc_chain_writer_stop(&w);
+    memset(&loaded, 0, sizeof(loaded));
+    const OpStatus_t st = pkc_cert_filter_load(&loaded, FILTER_NETWORK, chain);
+    printf("Writer: %u blocks committed in %u persisted batches, filter on disk covers %u\n", chain->index, batches,
+           loaded.count);
+    if (st != OP_SUCCESS || batches == 0 || loaded.count != chain->index || !same_filter(&loaded, &certs.filter))
+        rc = 1;
+    pkc_cert_filter_destroy(&loaded);
+
+    // Reopened from the saved filter and synced past it: same as a build.
+    chain->index = capacity;
+    pkc_cert_index_t reopened, built;
+    if (pkc_cert_index_init(&reopened, capacity, 0.001) != OP_SUCCESS ||
+        pkc_cert_index_init(&built, capacity, 0.001) != OP_SUCCESS)
+        return 1;
+    const OpStatus_t opened = pkc_cert_index_load(&reopened, chain);
+    if (pkc_cert_index_build(&built, chain) != OP_SUCCESS) rc = 1;
+    const bool same_index = reopened.count == built.count && reopened.nkeys == built.nkeys &&
+                            same_filter(&reopened.filter, &built.filter) &&
+                            memcmp(reopened.keys, built.keys, ((size_t)built.key_mask + 1) * sizeof(*built.keys)) == 0;
+    printf("Index reopened at %u blocks from the saved filter: %s\n", reopened.count,
+           same_index ? "matches a build" : "DIFFERS from a build");
+    if (opened != OP_SUCCESS || !same_index) rc = 1;
+    pkc_cert_index_destroy(&built);
+    pkc_cert_index_destroy(&reopened);
+    pkc_cert_index_destroy(&certs);
+
+    unlink(path);
+    rmdir(dir);
+    snprintf(dir, sizeof(dir), "%s/%s", home, PKCERTCHAIN_BASE_SUBDIR);
+    rmdir(dir);
+    rmdir(home);
+
+    free(other);
+    free(chain);
+    free(ids);
+    free(keys);
+    free(blocks);
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
@@ -0,0 +1,341 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "blockchain/certStatus_ops.h"
+#include "blockchain/chainWriter_ops.h"
+#include "telemetry/metrics_ops.h"
+
+/*
+ * Certificate status lookups against a forward scan of the block array:
+ * keys that were never issued, current keys, keys superseded by a later
+ * issue for the same id and revoked keys, over a million certificates.
+ * Ends with the chain writer keeping the index in step with its tip
+ * while another thread queries it, mined revocations and superseding
+ * issues that only validate when signed by a key with authority over the
+ * certificate, and a revocation whose op cannot be flipped without
+ * breaking its TierPoW.
+ */
+
+#define CERT_BLOCKS (1u << 20)
+#define CERT_IDS (CERT_BLOCKS / 4)
+#define CERT_REVOKE_EVERY 64
+#define CERT_QUERIES (1u << 20)
+#define CERT_SCANS 32
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void random_key(uint256 *key)
+{
+    uint64_t w[4] = {rng_next(), rng_next(), rng_next(), rng_next()};
+    memcpy(key, w, sizeof(w));
+}
+
+static void make_id(ipv6_t *id, uint64_t n)
+{
+    uint8_t b[16] = {0x20, 0x01, 0x0d, 0xb8};
+    memcpy(b + 8, &n, sizeof(n));
+    ipv6_init(id, b);
+}
+
+/*
+ * Block h issues a fresh key for id h % CERT_IDS, except every
+ * CERT_REVOKE_EVERY-th block, which revokes the key issued 17 blocks back.
+ */
+static void make_block(block *blocks, uint64_t h)
+{
+    block *b = &blocks[h];
+    block_init(b);
+    b->height = h;
+    b->timestamp = 1700000000ULL + h * 5;
+    b->tier = h ? TIER_EDGE : TIER_INVALID;
+    if (h == 0) return;
+    if (h % CERT_REVOKE_EVERY == 0) {
+        b->cert = blocks[h - 17].cert;
+        block_set_cert_op(b, BLOCK_CERT_OP_REVOKE);
+        return;
+    }
+    random_key(&b->cert.pubSignKey);
+    random_key(&b->cert.pubEncKey);
+    make_id(&b->cert.id, h % CERT_IDS);
+    block_set_cert_op(b, BLOCK_CERT_OP_ISSUE);
+}
+
+/* Links `b` to the chain's last block and solves the challenge the chain issues its tier. */
+static void mine_next(const PKCertChain *chain, block *b)
+{
+    const tier_pow_chain_field_t *field = tier_pow_chain_field(b->tier);
+    block_link_hash(&chain->blocks[chain->index - 1], &b->prevHash);
+    generate_tier_pow_challenge(&chain->blocks[tier_pow_chain_last_index(chain, field)],
+                                tier_pow_chain_complexity(chain, field), &b->tierPoWResult.challenge);
+    tier_pow_challenge_t bound;
+    tier_pow_challenge_bind(&b->tierPoWResult.challenge, b->reserved, sizeof(b->reserved), &bound);
+    tier_pow_solve_t *solve = &b->tierPoWResult.solve;
+    tier_pow_solve_challenge(&bound, &solve);
+}
+
+/* What a node without the index has to do: replay every block for the key. */
+static pkc_cert_status_t scan_status(const block *blocks, uint32_t n, const uint256 *key, pkc_cert_info_t *info)
+{
+    pkc_cert_status_t status = PKC_CERT_UNKNOWN;
+    ipv6_t id = {0};
+    uint64_t height = 0, changed = 0;
+    static const uint256 zero;
+    for (uint32_t i = 0; i < n; ++i) {
+        const block *b = &blocks[i];
+        const bool revoke = block_get_cert_op(b) == BLOCK_CERT_OP_REVOKE;
+        if (memcmp(&b->cert.pubSignKey, key, sizeof(*key)) == 0) {
+            if (status == PKC_CERT_REVOKED) continue;
+            if (revoke) {
+                if (status == PKC_CERT_UNKNOWN) {
+                    id = b->cert.id;
+                    height = b->height;
+                }
+                status = PKC_CERT_REVOKED;
+                changed = b->height;
+            } else {
+                status = PKC_CERT_CURRENT;
+                id = b->cert.id;
+                height = b->height;
+                changed = 0;
+            }
+        } else if (status == PKC_CERT_CURRENT && !revoke && memcmp(&b->cert.id, &id, sizeof(id)) == 0 &&
+                   memcmp(&b->cert.pubSignKey, &zero, sizeof(zero)) != 0) {
+            status = PKC_CERT_SUPERSEDED;
+            changed = b->height;
+        }
+    }
+    if (info && status != PKC_CERT_UNKNOWN) {
+        info->status = status;
+        info->id = id;
+        info->height = height;
+        info->changed = changed;
+    }
+    return status;
+}
+
+static bool same_info(const pkc_cert_info_t *a, const pkc_cert_info_t *b)
+{
+    return a->status == b->status && a->height == b->height && a->changed == b->changed &&
+           memcmp(&a->id, &b->id, sizeof(a->id)) == 0;
+}
+
+typedef struct {
+    const pkc_cert_index_t *ix;
+    const uint256 *key;             // stays current for the whole run
+    volatile int stop;
+    uint64_t queries;
+    uint64_t wrong;
+} reader_arg_t;
+
+static void *reader_main(void *p)
+{
+    reader_arg_t *a = (reader_arg_t *)p;
+    while (!__atomic_load_n(&a->stop, __ATOMIC_ACQUIRE)) {
+        pkc_cert_info_t info;
+        if (pkc_cert_status(a->ix, a->key, &info) != PKC_CERT_CURRENT || info.height != 1) a->wrong++;
+        a->queries++;
+    }
+    return NULL;
+}
+
+int main() {
+    printf("Initializing certificate status benchmark...\n");
+    int rc = 0;
+
+    block *blocks = calloc(CERT_BLOCKS, sizeof(block));
+    uint256 *probe = calloc(CERT_QUERIES, sizeof(uint256));
+    if (!blocks || !probe) return 1;
+    for (uint32_t h = 0; h < CERT_BLOCKS; ++h) make_block(blocks, h);
+
+    pkc_cert_index_t ix;
+    if (pkc_cert_index_init(&ix, CERT_BLOCKS, 0) != OP_SUCCESS) return 1;
+    uint64_t t0 = pkc_metrics_now_ns();
+    if (pkc_cert_index_append(&ix, blocks, CERT_BLOCKS) != OP_SUCCESS) return 1;
+    printf("Cert index over %u blocks: %u keys, %u ids, built in %.2f ms\n", CERT_BLOCKS, ix.nkeys, ix.nids,
+           (pkc_metrics_now_ns() - t0) / 1e6);
+
+    // --- Index agrees with a replay of the chain ---
+    uint32_t seen[4] = {0};
+    for (uint32_t q = 0; q < CERT_SCANS; ++q) {
+        uint256 key;
+        if (q % 4 == 0) random_key(&key);
+        else key = blocks[1 + rng_next() % (CERT_BLOCKS - 1)].cert.pubSignKey;
+        if (q == 1) key = blocks[CERT_BLOCKS - 1].cert.pubSignKey;          // newest: current
+        if (q == 2) key = blocks[CERT_REVOKE_EVERY - 17].cert.pubSignKey;    // revoked
+        pkc_cert_info_t want = {0}, got = {0};
+        const pkc_cert_status_t ws = scan_status(blocks, CERT_BLOCKS, &key, &want);
+        const pkc_cert_status_t gs = pkc_cert_status(&ix, &key, &got);
+        seen[ws]++;
+        if (ws != gs || (ws != PKC_CERT_UNKNOWN && !same_info(&want, &got))) {
+            printf("Error: status mismatch for query %u (scan %d, index %d)\n", q, ws, gs);
+            rc = 1;
+        }
+    }
+    printf("Checked %u keys against a replay: %u unknown, %u current, %u superseded, %u revoked\n", CERT_SCANS,
+           seen[PKC_CERT_UNKNOWN], seen[PKC_CERT_CURRENT], seen[PKC_CERT_SUPERSEDED], seen[PKC_CERT_REVOKED]);
+    if (!seen[PKC_CERT_UNKNOWN] || !seen[PKC_CERT_CURRENT] || !seen[PKC_CERT_SUPERSEDED] || !seen[PKC_CERT_REVOKED])
+        rc = 1;
+
+    // Latest block per id: the newest issue, and its key while that is current.
+    for (uint32_t q = 0; q < 64; ++q) {
+        const uint64_t n = (rng_next() % CERT_IDS) | 1;        // ids on revocation heights are never issued
+        ipv6_t id;
+        make_id(&id, n);
+        uint32_t last = 0;
+        for (uint32_t h = CERT_BLOCKS - 1; h > 0 && !last; --h) {
+            if (block_get_cert_op(&blocks[h]) == BLOCK_CERT_OP_ISSUE && h % CERT_IDS == n) last = h;
+        }
+        uint64_t height = 0;
+        uint256 current;
+        if (!pkc_cert_latest(&ix, &id, &height, &current) || height < last) rc = 1;
+        const bool live = pkc_cert_status(&ix, &blocks[last].cert.pubSignKey, NULL) == PKC_CERT_CURRENT;
+        const uint256 zero = {0};
+        if (memcmp(&current, live ? &blocks[last].cert.pubSignKey : &zero, sizeof(current)) != 0) rc = 1;
+    }
+
+    // --- Unknown keys: the filter front ---
+    for (uint32_t q = 0; q < CERT_QUERIES; ++q) random_key(&probe[q]);
+    uint32_t passed = 0;
+    uint64_t sink = 0;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < CERT_QUERIES; ++q) passed += pkc_cert_maybe_known(&ix, &probe[q]);
+    double bloom_ns = (double)(pkc_metrics_now_ns() - t0) / CERT_QUERIES;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < CERT_QUERIES; ++q) sink += pkc_cert_status(&ix, &probe[q], NULL);
+    double unknown_ns = (double)(pkc_metrics_now_ns() - t0) / CERT_QUERIES;
+    if (sink != 0) rc = 1;
+    printf("Unknown keys: %.1f ns/filter check, %.1f ns/status, filter passed %.3f%%\n", bloom_ns, unknown_ns,
+           100.0 * passed / CERT_QUERIES);
+
+    // --- Known keys ---
+    for (uint32_t q = 0; q < CERT_QUERIES; ++q) probe[q] = blocks[1 + rng_next() % (CERT_BLOCKS - 1)].cert.pubSignKey;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < CERT_QUERIES; ++q) {
+        const pkc_cert_status_t s = pkc_cert_status(&ix, &probe[q], NULL);
+        if (s == PKC_CERT_UNKNOWN) rc = 1;
+        sink += s;
+    }
+    double known_ns = (double)(pkc_metrics_now_ns() - t0) / CERT_QUERIES;
+
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < CERT_SCANS; ++q) sink += scan_status(blocks, CERT_BLOCKS, &probe[q], NULL);
+    double scan_ns = (double)(pkc_metrics_now_ns() - t0) / CERT_SCANS;
+    printf("Known keys: %.1f ns/status, replay %.2f ms/key (%.0fx)\n", known_ns, scan_ns / 1e6,
+           known_ns > 0 ? scan_ns / known_ns : 0.0);
+    if (sink == 0) rc = 1;
+
+    // Capacity is fixed up front.
+    if (pkc_cert_index_init(&(pkc_cert_index_t){0}, 0, 0) != OP_INVALID_INPUT) rc = 1;
+    pkc_cert_index_t small;
+    if (pkc_cert_index_init(&small, 4, 0) != OP_SUCCESS) return 1;
+    if (pkc_cert_index_append(&small, blocks + 1, 4) != OP_SUCCESS) rc = 1;
+    if (pkc_cert_index_append(&small, blocks + 5, 1) != OP_BUFFER_TOO_SMALL) rc = 1;
+    pkc_cert_index_destroy(&small);
+    pkc_cert_index_destroy(&ix);
+
+    // --- Writer keeps the index in step with its tip ---
+    PKCertChain *chain = calloc(1, sizeof(PKCertChain));
+    if (!chain) return 1;
+    make_block(chain->blocks, 0);
+    chain->index = 1;
+    const uint32_t capacity = PKC_CHAIN_CAPACITY(chain);
+    pkc_cert_index_t certs;
+    if (pkc_cert_index_init(&certs, capacity, 0) != OP_SUCCESS) return 1;
+    pkc_chain_writer_config_t wcfg = { .certs = &certs };
+    pkc_chain_writer_t w;
+    if (pkc_chain_writer_start(&w, chain, &wcfg) != OP_SUCCESS) return 1;
+
+    // block 1's id is never reused below `capacity`, so its key stays current
+    if (pkc_chain_append(&w, &blocks[1], NULL) != OP_SUCCESS) rc = 1;
+    reader_arg_t reader = { .ix = &certs, .key = &blocks[1].cert.pubSignKey };
+    pthread_t th;
+    pthread_create(&th, NULL, reader_main, &reader);
+    for (uint32_t h = 2; h < capacity; ++h) {
+        if (pkc_chain_append(&w, &blocks[h], NULL) != OP_SUCCESS) rc = 1;
+        pkc_chain_tip_t tip = {0};
+        pkc_chain_tip_copy(&w, &tip);
+        const pkc_cert_status_t s = pkc_cert_status(&certs, &blocks[h].cert.pubSignKey, NULL);
+        if (tip.index > h && s != PKC_CERT_CURRENT && s != PKC_CERT_REVOKED) rc = 1;
+    }
+    pkc_chain_writer_stop(&w);
+    __atomic_store_n(&reader.stop, 1, __ATOMIC_RELEASE);
+    pthread_join(th, NULL);
+    printf("Writer: %u blocks committed, %u indexed, %u keys; reader made %lu queries, %lu wrong\n", chain->index,
+           certs.count, certs.nkeys, (unsigned long)reader.queries, (unsigned long)reader.wrong);
+    if (certs.count != chain->index || reader.wrong) rc = 1;
+
+    // A rebuild lands in the same place.
+    pkc_cert_index_t again;
+    if (pkc_cert_index_init(&again, capacity, 0) != OP_SUCCESS || pkc_cert_index_build(&again, chain) != OP_SUCCESS) rc = 1;
+    if (again.nkeys != certs.nkeys || again.nids != certs.nids ||
+        memcmp(again.keys, certs.keys, ((size_t)certs.key_mask + 1) * sizeof(*certs.keys)) != 0)
+        rc = 1;
+    pkc_cert_index_destroy(&again);
+    pkc_cert_index_destroy(&certs);
+
+    // --- Revocations and superseding issues need authority; the op is bound into the TierPoW ---
+    uint256 network_priv, owner_priv, stranger_priv, stranger_pub;
+    GenerateSignKeys(&network_priv, &chain->blocks[0].cert.pubSignKey, chain->NetworkName);
+    GenerateSignKeys(&owner_priv, &chain->blocks[50].cert.pubSignKey, chain->NetworkName);     // id 50's key
+    GenerateSignKeys(&stranger_priv, &stranger_pub, chain->NetworkName);
+    chain->index = CERT_REVOKE_EVERY;
+    tier_pow_chain_set_complexity(chain, tier_pow_chain_field(TIER_EDGE), 6);
+
+    block revoke = blocks[CERT_REVOKE_EVERY];
+    mine_next(chain, &revoke);
+    const OpStatus_t unsigned_revoke = pkc_chain_validate(chain, &revoke, true);
+    cert_sign(&revoke.cert, &stranger_priv, &revoke.SignedByVerifier);
+    const OpStatus_t stranger_revoke = pkc_chain_validate(chain, &revoke, true);
+    cert_sign(&revoke.cert, &network_priv, &revoke.SignedByVerifier);
+    const OpStatus_t as_mined = pkc_chain_validate(chain, &revoke, true);
+    block_set_cert_op(&revoke, BLOCK_CERT_OP_ISSUE);
+    const OpStatus_t flipped = pkc_chain_validate(chain, &revoke, true);
+    printf("Mined revocation: unsigned %s, by a stranger %s, by the network key %s, flipped to issue %s\n",
+           unsigned_revoke == OP_INVALID_INPUT ? "rejected" : "ACCEPTED",
+           stranger_revoke == OP_INVALID_INPUT ? "rejected" : "ACCEPTED",
+           as_mined == OP_SUCCESS ? "valid" : "INVALID", flipped == OP_INVALID_INPUT ? "rejected" : "ACCEPTED");
+    if (unsigned_revoke != OP_INVALID_INPUT || stranger_revoke != OP_INVALID_INPUT || as_mined != OP_SUCCESS ||
+        flipped != OP_INVALID_INPUT)
+        rc = 1;
+
+    block supersede;
+    make_block(&supersede, 0);
+    supersede.height = CERT_REVOKE_EVERY;
+    supersede.tier = TIER_EDGE;
+    random_key(&supersede.cert.pubSignKey);
+    make_id(&supersede.cert.id, 50);
+    block_set_cert_op(&supersede, BLOCK_CERT_OP_ISSUE);
+    mine_next(chain, &supersede);
+    const OpStatus_t unsigned_supersede = pkc_chain_validate(chain, &supersede, true);
+    cert_sign(&supersede.cert, &stranger_priv, &supersede.SignedByVerifier);
+    const OpStatus_t stranger_supersede = pkc_chain_validate(chain, &supersede, true);
+    cert_sign(&supersede.cert, &owner_priv, &supersede.SignedByVerifier);
+    const OpStatus_t owner_supersede = pkc_chain_validate(chain, &supersede, true);
+    block fresh = supersede;
+    make_id(&fresh.cert.id, CERT_IDS - 1);
+    uint512_zero(&fresh.SignedByVerifier);
+    const OpStatus_t fresh_id = pkc_chain_validate(chain, &fresh, true);
+    printf("Superseding issue: unsigned %s, by a stranger %s, by the current key %s; new id unsigned %s\n",
+           unsigned_supersede == OP_INVALID_INPUT ? "rejected" : "ACCEPTED",
+           stranger_supersede == OP_INVALID_INPUT ? "rejected" : "ACCEPTED",
+           owner_supersede == OP_SUCCESS ? "valid" : "INVALID", fresh_id == OP_SUCCESS ? "valid" : "INVALID");
+    if (unsigned_supersede != OP_INVALID_INPUT || stranger_supersede != OP_INVALID_INPUT ||
+        owner_supersede != OP_SUCCESS || fresh_id != OP_SUCCESS)
+        rc = 1;
+
+    free(chain);
+    free(probe);
+    free(blocks);
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
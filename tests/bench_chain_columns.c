@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blockchain/chainColumns_ops.h"
+#include "blockchain/chainWriter_ops.h"
+#include "telemetry/metrics_ops.h"
+
+/*
+ * Hot-field columns against scans of the block array: all heights of one
+ * tier, last block of a tier, linkage and cert hash lookups; then the
+ * writer keeping the columns in step with its tip.
+ */
+
+#define SCAN_BLOCKS (1u << 18)
+#define SCAN_ROUNDS 5
+#define LAST_QUERIES 4096
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/* Tiers skewed like a real network: few servers, many MCUs and edges. */
+static Tier_t pick_tier(void)
+{
+    const uint64_t r = rng_next() % 100;
+    return r < 40 ? TIER_MCU : r < 75 ? TIER_EDGE : r < 95 ? TIER_DESKTOP : TIER_SERVER;
+}
+
+static void make_block(block *b, uint64_t height, const block *prev)
+{
+    block_init(b);
+    b->height = height;
+    b->tier = height ? pick_tier() : TIER_INVALID;
+    b->timestamp = height * 5;
+    hash256_buffer((const uint8_t *)&height, sizeof(height), &b->CurrentCertHash);
+    if (prev) block_link_hash(prev, &b->prevHash);
+}
+
+static uint64_t best(const uint64_t *ns, int n)
+{
+    uint64_t b = ns[0];
+    for (int i = 1; i < n; ++i) if (ns[i] < b) b = ns[i];
+    return b;
+}
+
+int main() {
+    printf("Initializing chain columns benchmark...\n");
+    int rc = 0;
+
+    block *blocks = calloc(SCAN_BLOCKS, sizeof(block));
+    uint64_t *want = calloc(SCAN_BLOCKS, sizeof(uint64_t));
+    uint64_t *got = calloc(SCAN_BLOCKS, sizeof(uint64_t));
+    uint32_t *ends = calloc(LAST_QUERIES, sizeof(uint32_t));
+    if (!blocks || !want || !got || !ends) return 1;
+    for (uint32_t i = 0; i < SCAN_BLOCKS; ++i) make_block(&blocks[i], i, i ? &blocks[i - 1] : NULL);
+    for (uint32_t q = 0; q < LAST_QUERIES; ++q) ends[q] = (uint32_t)(rng_next() % SCAN_BLOCKS) + 1;
+
+    pkc_chain_columns_t cols;
+    if (pkc_columns_init(&cols, SCAN_BLOCKS) != OP_SUCCESS) return 1;
+    uint64_t t0 = pkc_metrics_now_ns();
+    if (pkc_columns_append(&cols, blocks, SCAN_BLOCKS) != OP_SUCCESS) return 1;
+    printf("Columns over %u blocks (%zu B/block in the array): built in %.2f ms, scan width %d\n", SCAN_BLOCKS,
+           sizeof(block), (pkc_metrics_now_ns() - t0) / 1e6, PKC_COLUMNS_WIDTH);
+
+    printf("%-26s %12s %12s %9s\n", "query", "blocks us", "columns us", "speedup");
+
+    // --- All heights of one tier ---
+    uint64_t a[SCAN_ROUNDS], c[SCAN_ROUNDS];
+    uint32_t nwant = 0, ngot = 0;
+    for (int r = 0; r < SCAN_ROUNDS; ++r) {
+        t0 = pkc_metrics_now_ns();
+        nwant = 0;
+        for (uint32_t i = 0; i < SCAN_BLOCKS; ++i)
+            if (blocks[i].tier == TIER_EDGE) want[nwant++] = blocks[i].height;
+        a[r] = pkc_metrics_now_ns() - t0;
+        t0 = pkc_metrics_now_ns();
+        ngot = pkc_columns_find_tier(&cols, 0, SCAN_BLOCKS, TIER_EDGE, got, SCAN_BLOCKS);
+        c[r] = pkc_metrics_now_ns() - t0;
+    }
+    if (nwant != ngot || memcmp(want, got, nwant * sizeof(uint64_t)) != 0) rc = 1;
+    printf("%-26s %12.1f %12.1f %8.1fx  (%u matches)\n", "find all TIER_EDGE", best(a, SCAN_ROUNDS) / 1e3,
+           best(c, SCAN_ROUNDS) / 1e3, (double)best(a, SCAN_ROUNDS) / best(c, SCAN_ROUNDS), ngot);
+
+    // --- Count of the rarest tier ---
+    uint32_t cwant = 0, cgot = 0;
+    for (int r = 0; r < SCAN_ROUNDS; ++r) {
+        t0 = pkc_metrics_now_ns();
+        cwant = 0;
+        for (uint32_t i = 0; i < SCAN_BLOCKS; ++i) cwant += blocks[i].tier == TIER_SERVER;
+        a[r] = pkc_metrics_now_ns() - t0;
+        t0 = pkc_metrics_now_ns();
+        cgot = pkc_columns_count_tier(&cols, 0, SCAN_BLOCKS, TIER_SERVER);
+        c[r] = pkc_metrics_now_ns() - t0;
+    }
+    if (cwant != cgot) rc = 1;
+    printf("%-26s %12.1f %12.1f %8.1fx  (%u blocks)\n", "count TIER_SERVER", best(a, SCAN_ROUNDS) / 1e3,
+           best(c, SCAN_ROUNDS) / 1e3, (double)best(a, SCAN_ROUNDS) / best(c, SCAN_ROUNDS), cgot);
+
+    // --- Last block of a tier below random ends (all tiers) ---
+    uint64_t sum_a = 0, sum_c = 0;
+    for (int r = 0; r < SCAN_ROUNDS; ++r) {
+        t0 = pkc_metrics_now_ns();
+        sum_a = 0;
+        for (uint32_t q = 0; q < LAST_QUERIES; ++q) {
+            const Tier_t tier = (Tier_t)(TIER_MCU + q % 4);
+            uint32_t i = ends[q];
+            while (i > 0 && blocks[i - 1].tier != tier) --i;
+            sum_a += i ? i - 1 : PKC_COLUMNS_NONE;
+        }
+        a[r] = pkc_metrics_now_ns() - t0;
+        t0 = pkc_metrics_now_ns();
+        sum_c = 0;
+        for (uint32_t q = 0; q < LAST_QUERIES; ++q) sum_c += pkc_columns_last_of_tier(&cols, ends[q], (Tier_t)(TIER_MCU + q % 4));
+        c[r] = pkc_metrics_now_ns() - t0;
+    }
+    if (sum_a != sum_c) rc = 1;
+    printf("%-26s %12.1f %12.1f %8.1fx  (%u queries)\n", "last of tier", best(a, SCAN_ROUNDS) / 1e3,
+           best(c, SCAN_ROUNDS) / 1e3, (double)best(a, SCAN_ROUNDS) / best(c, SCAN_ROUNDS), LAST_QUERIES);
+
+    // --- Linkage over the whole chain, then one broken link ---
+    uint32_t bad_a = 0, bad_c = 0;
+    for (int r = 0; r < SCAN_ROUNDS; ++r) {
+        t0 = pkc_metrics_now_ns();
+        bad_a = PKC_COLUMNS_NONE;
+        for (uint32_t i = 1; i < SCAN_BLOCKS && bad_a == PKC_COLUMNS_NONE; ++i) {
+            uint256 link;
+            block_link_hash(&blocks[i - 1], &link);
+            if (memcmp(&blocks[i].prevHash, &link, sizeof(uint256)) != 0) bad_a = i;
+        }
+        a[r] = pkc_metrics_now_ns() - t0;
+        t0 = pkc_metrics_now_ns();
+        bad_c = pkc_columns_first_broken_link(&cols, 0, SCAN_BLOCKS);
+        c[r] = pkc_metrics_now_ns() - t0;
+    }
+    if (bad_a != PKC_COLUMNS_NONE || bad_c != PKC_COLUMNS_NONE) rc = 1;
+    printf("%-26s %12.1f %12.1f %8.1fx\n", "linkage check", best(a, SCAN_ROUNDS) / 1e3, best(c, SCAN_ROUNDS) / 1e3,
+           (double)best(a, SCAN_ROUNDS) / best(c, SCAN_ROUNDS));
+    cols.prev_hash[SCAN_BLOCKS / 3].w[0] ^= 1;
+    if (pkc_columns_first_broken_link(&cols, 0, SCAN_BLOCKS) != SCAN_BLOCKS / 3) rc = 1;
+    cols.prev_hash[SCAN_BLOCKS / 3].w[0] ^= 1;
+
+    // --- Cert hash lookup of an early block ---
+    const uint256 needle = blocks[SCAN_BLOCKS / 10].CurrentCertHash;
+    uint32_t at_a = 0, at_c = 0;
+    for (int r = 0; r < SCAN_ROUNDS; ++r) {
+        t0 = pkc_metrics_now_ns();
+        at_a = PKC_COLUMNS_NONE;
+        for (uint32_t i = SCAN_BLOCKS; i > 0; --i)
+            if (memcmp(&blocks[i - 1].CurrentCertHash, &needle, sizeof(uint256)) == 0) { at_a = i - 1; break; }
+        a[r] = pkc_metrics_now_ns() - t0;
+        t0 = pkc_metrics_now_ns();
+        at_c = pkc_columns_find_cert_hash(&cols, SCAN_BLOCKS, &needle);
+        c[r] = pkc_metrics_now_ns() - t0;
+    }
+    if (at_a != SCAN_BLOCKS / 10 || at_c != at_a) rc = 1;
+    printf("%-26s %12.1f %12.1f %8.1fx\n", "cert hash lookup", best(a, SCAN_ROUNDS) / 1e3, best(c, SCAN_ROUNDS) / 1e3,
+           (double)best(a, SCAN_ROUNDS) / best(c, SCAN_ROUNDS));
+
+    // --- Edges of the scan: empty range, unaligned tails, no match ---
+    if (pkc_columns_find_tier(&cols, 5, 5, TIER_MCU, got, 1) != 0) rc = 1;
+    if (pkc_columns_last_of_tier(&cols, 1, TIER_MCU) != PKC_COLUMNS_NONE) rc = 1;     // genesis has no tier
+    for (uint32_t end = 1; end < 100; ++end) {
+        uint32_t want_last = PKC_COLUMNS_NONE;
+        for (uint32_t i = 0; i < end; ++i) if (blocks[i].tier == TIER_SERVER) want_last = i;
+        if (pkc_columns_last_of_tier(&cols, end, TIER_SERVER) != want_last) rc = 1;
+        if (pkc_columns_count_tier(&cols, 3, end, TIER_DESKTOP) != pkc_columns_find_tier(&cols, 3, end, TIER_DESKTOP, got, 0))
+            rc = 1;
+    }
+    pkc_columns_destroy(&cols);
+
+    // --- Writer keeps columns in step with its tip ---
+    PKCertChain *chain = calloc(1, sizeof(PKCertChain));
+    if (!chain) return 1;
+    make_block(&chain->blocks[0], 0, NULL);
+    chain->index = 1;
+    const uint32_t capacity = PKC_CHAIN_CAPACITY(chain);
+    pkc_chain_columns_t live;
+    if (pkc_columns_init(&live, capacity) != OP_SUCCESS) return 1;
+    pkc_chain_writer_config_t wcfg = { .columns = &live };
+    pkc_chain_writer_t w;
+    if (pkc_chain_writer_start(&w, chain, &wcfg) != OP_SUCCESS) return 1;
+    block b;
+    for (uint32_t h = 1; h < capacity; ++h) {
+        make_block(&b, h, &chain->blocks[h - 1]);
+        b.tier = blocks[h].tier;
+        if (pkc_chain_append(&w, &b, NULL) != OP_SUCCESS) rc = 1;
+        pkc_chain_tip_t tip = {0};
+        pkc_chain_tip_copy(&w, &tip);
+        if (live.count < tip.index) rc = 1;
+    }
+    pkc_chain_writer_stop(&w);
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        const tier_pow_chain_field_t *f = &tier_pow_chain_fields[t];
+        const uint32_t last = pkc_columns_last_of_tier(&live, live.count, f->tier);
+        if (last != PKC_COLUMNS_NONE && last != tier_pow_chain_last_index(chain, f)) rc = 1;
+    }
+    printf("Writer: %u blocks committed, %u mirrored, links %s\n", chain->index, live.count,
+           pkc_columns_first_broken_link(&live, 0, live.count) == PKC_COLUMNS_NONE ? "intact" : "BROKEN");
+    if (live.count != chain->index || pkc_columns_first_broken_link(&live, 0, live.count) != PKC_COLUMNS_NONE) rc = 1;
+    pkc_columns_destroy(&live);
+
+    free(chain);
+    free(ends);
+    free(got);
+    free(want);
+    free(blocks);
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "blockchain/chainSnapshot_ops.h"
+
+/*
+ * Chain snapshots: 1M-block export and bootstrap (decode + validate only,
+ * and into a chain log), export from a running writer while producers keep
+ * appending, the zero-run codec, rejection of damaged files, per-tier
+ * difficulty carried in the header, and a require_pow bootstrap that must
+ * refuse a bad solve, a challenge the chain did not issue, a header easing
+ * a tier's difficulty or another network.
+ */
+
+#define BIG_BLOCKS 1000000ULL
+
+static void make_block(block *b, uint64_t height)
+{
+    block_init(b);
+    b->height = height;
+    b->tier = (Tier_t)(TIER_MCU + height % 4);
+    b->timestamp = height * 11;
+    hash256_buffer((const uint8_t *)&height, sizeof(height), &b->CurrentCertHash);
+}
+
+/* Links `b` to `prev` and solves the challenge `ref` issues at `complexity`. */
+static void mine_block(block *b, const block *prev, const block *ref, uint8_t complexity)
+{
+    block_link_hash(prev, &b->prevHash);
+    generate_tier_pow_challenge(ref, complexity, &b->tierPoWResult.challenge);
+    tier_pow_challenge_t bound;
+    tier_pow_challenge_bind(&b->tierPoWResult.challenge, b->reserved, sizeof(b->reserved), &bound);
+    tier_pow_solve_t *solve = &b->tierPoWResult.solve;
+    tier_pow_solve_challenge(&bound, &solve);
+}
+
+static OpStatus_t synth_read(void *ctx, uint64_t first, uint32_t count, block *scratch, const block **out)
+{
+    (void)ctx;
+    for (uint32_t i = 0; i < count; ++i) make_block(&scratch[i], first + i);
+    *out = scratch;
+    return OP_SUCCESS;
+}
+
+typedef struct {
+    uint64_t seen;
+    uint32_t bad;
+} verify_t;
+
+static OpStatus_t verify_apply(void *ctx, uint64_t first, const block *blocks, uint32_t count)
+{
+    verify_t *v = (verify_t *)ctx;
+    if (first != v->seen) v->bad++;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint64_t h = first + i;
+        uint256 want;
+        hash256_buffer((const uint8_t *)&h, sizeof(h), &want);
+        if (blocks[i].timestamp != h * 11 || memcmp(&blocks[i].CurrentCertHash, &want, sizeof(want)) != 0) v->bad++;
+    }
+    v->seen += count;
+    return OP_SUCCESS;
+}
+
+typedef struct {
+    pkc_chain_writer_t *w;
+    _Atomic(bool) *stop;
+    uint32_t committed;
+} producer_t;
+
+static void *producer(void *arg)
+{
+    producer_t *p = (producer_t *)arg;
+    pkc_chain_tip_t tip = {0};
+    block b;
+    while (!atomic_load(p->stop)) {
+        if (pkc_chain_tip_copy(p->w, &tip) != OP_SUCCESS || tip.index >= PKC_CHAIN_CAPACITY(p->w->chain)) break;
+        make_block(&b, tip.index);
+        if (pkc_chain_append(p->w, &b, NULL) == OP_SUCCESS) p->committed++;
+    }
+    return NULL;
+}
+
+static int flip_and_import(const char *src, const char *dst, uint64_t offset, uint64_t truncate_to)
+{
+    char cmd[600];
+    snprintf(cmd, sizeof(cmd), "cp %s %s", src, dst);
+    if (system(cmd) != 0) return -1;
+    if (truncate_to) {
+        if (truncate(dst, (off_t)truncate_to) != 0) return -1;
+    } else {
+        int fd = open(dst, O_RDWR);
+        uint8_t byte;
+        pread(fd, &byte, 1, (off_t)offset);
+        byte ^= 0x5A;
+        pwrite(fd, &byte, 1, (off_t)offset);
+        close(fd);
+    }
+    verify_t v = {0};
+    return pkc_snapshot_import(dst, NULL, NULL, verify_apply, &v, NULL);
+}
+
+int main() {
+    printf("Initializing chain snapshot benchmark...\n");
+    int rc = 0;
+
+    char dir[] = "/tmp/pkc_snapshot_XXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    char path[256], log_path[256], bad_path[256];
+    snprintf(path, sizeof(path), "%s/big.snap", dir);
+    snprintf(log_path, sizeof(log_path), "%s/chain.log", dir);
+    snprintf(bad_path, sizeof(bad_path), "%s/bad.snap", dir);
+
+    // --- Codec ---
+    uint8_t raw[4096], enc[4096], dec[4096];
+    for (size_t i = 0; i < sizeof(raw); ++i) raw[i] = (i % 300) < 200 ? 0 : (uint8_t)(i * 7 + 1);
+    size_t n = pkc_snapshot_zrle_encode(raw, sizeof(raw), enc);
+    if (n == 0 || !pkc_snapshot_zrle_decode(enc, n, dec, sizeof(dec)) || memcmp(raw, dec, sizeof(raw)) != 0) rc = 1;
+    for (size_t i = 0; i < sizeof(raw); ++i) raw[i] = (uint8_t)(i * 131 + 7) | 1;
+    if (pkc_snapshot_zrle_encode(raw, sizeof(raw), enc) != 0) rc = 1;      // incompressible: stored raw
+    printf("Codec: sparse 4096 -> %zu bytes, dense stored raw\n", n);
+
+    // --- 1M blocks: export, bootstrap into memory (decode + validate), bootstrap into a log ---
+    printf("Pool workers: %u\n", pkc_snapshot_threads());
+    pkc_snapshot_meta_t meta = {0};
+    snprintf(meta.NetworkName, sizeof(meta.NetworkName), "bench");
+    meta.complexity = 7;
+    meta.next_challenge_id = 99;
+    meta.blocks = BIG_BLOCKS;
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) meta.tier_complexity[t] = (uint8_t)(11 + t);
+    meta.target_bits[TIER_POW_DIFFICULTY_TIERS - 1] = tier_pow_target_from_complexity(20.5);
+    pkc_snapshot_stats_t ex = {0}, im = {0};
+    if (pkc_snapshot_export(path, &meta, synth_read, NULL, NULL, &ex) != OP_SUCCESS) return 1;
+    printf("Export  %llu blocks, %llu chunks: %.2f s, %.1f MB raw -> %.1f MB file\n", (unsigned long long)ex.blocks,
+           (unsigned long long)ex.chunks, ex.elapsed_ns / 1e9, ex.raw_bytes / 1e6, ex.file_bytes / 1e6);
+
+    verify_t v = {0};
+    pkc_snapshot_meta_t got;
+    if (pkc_snapshot_import(path, NULL, &got, verify_apply, &v, &im) != OP_SUCCESS) rc = 1;
+    printf("Import  decode + validate: %.2f s (%.0f blocks/s)\n", im.elapsed_ns / 1e9,
+           im.blocks * 1e9 / (double)im.elapsed_ns);
+    if (v.seen != BIG_BLOCKS || v.bad != 0 || got.complexity != 7 || got.next_challenge_id != 99 ||
+        strcmp(got.NetworkName, "bench") != 0 ||
+        memcmp(got.tier_complexity, meta.tier_complexity, sizeof(meta.tier_complexity)) != 0 ||
+        memcmp(got.target_bits, meta.target_bits, sizeof(meta.target_bits)) != 0)
+        rc = 1;
+
+    pkc_snapshot_config_t one = { .window_chunks = 2 };
+    pkc_snapshot_stats_t im1 = {0};
+    memset(&v, 0, sizeof(v));
+    pkc_snapshot_import(path, &one, NULL, verify_apply, &v, &im1);
+    printf("Import  window of 2 chunks: %.2f s\n", im1.elapsed_ns / 1e9);
+    if (v.seen != BIG_BLOCKS || v.bad != 0) rc = 1;
+
+    pkc_chain_store_t store;
+    pkc_chain_store_config_t scfg = { .mode = PKC_DURABILITY_ASYNC, .prealloc_records = 1 << 20 };
+    if (pkc_chain_store_open(&store, log_path, &scfg, NULL, NULL) != OP_SUCCESS) return 1;
+    pkc_snapshot_stats_t is = {0};
+    if (pkc_snapshot_import(path, NULL, NULL, pkc_snapshot_apply_store, &store, &is) != OP_SUCCESS) rc = 1;
+    const uint64_t t0 = pkc_metrics_now_ns();
+    pkc_chain_store_close(&store);
+    printf("Bootstrap into chain log: %.2f s import + %.2f s final sync, %llu records\n", is.elapsed_ns / 1e9,
+           (pkc_metrics_now_ns() - t0) / 1e9, (unsigned long long)store.records);
+    if (store.records != BIG_BLOCKS) rc = 1;
+    unlink(log_path);
+
+    // --- Damage: flipped payload byte, flipped header, truncated file ---
+    const int flipped = flip_and_import(path, bad_path, PKC_SNAPSHOT_HEADER_SIZE + PKC_SNAPSHOT_CHUNK_HEADER_SIZE + 10, 0);
+    const int header = flip_and_import(path, bad_path, 40, 0);
+    const int truncated = flip_and_import(path, bad_path, 0, ex.file_bytes - 100);
+    printf("Damaged payload: %s, header: %s, truncated: %s\n", flipped == OP_INVALID_INPUT ? "rejected" : "ACCEPTED",
+           header == OP_INVALID_INPUT ? "rejected" : "ACCEPTED", truncated == OP_INVALID_INPUT ? "rejected" : "ACCEPTED");
+    if (flipped != OP_INVALID_INPUT || header != OP_INVALID_INPUT || truncated != OP_INVALID_INPUT) rc = 1;
+    unlink(bad_path);
+
+    // --- Export from a running writer; appends continue meanwhile ---
+    PKCertChain *chain = calloc(1, sizeof(PKCertChain));
+    PKCertChain *boot = calloc(1, sizeof(PKCertChain));
+    if (!chain || !boot) return 1;
+    make_block(&chain->blocks[0], 0);
+    chain->index = 1;
+    snprintf(chain->NetworkName, sizeof(chain->NetworkName), "live");
+    chain->MCUComplexity = 9;
+    chain->EdgeComplexity = 17;
+    pkc_chain_writer_t w;
+    if (pkc_chain_writer_start(&w, chain, NULL) != OP_SUCCESS) return 1;
+    const uint32_t capacity = PKC_CHAIN_CAPACITY(chain);
+    block b;
+    for (uint32_t h = 1; h < capacity / 2; ++h) {
+        make_block(&b, h);
+        pkc_chain_append(&w, &b, NULL);
+    }
+    _Atomic(bool) stop = false;
+    producer_t p = { .w = &w, .stop = &stop };
+    pthread_t tid;
+    pthread_create(&tid, NULL, producer, &p);
+    snprintf(path, sizeof(path), "%s/live.snap", dir);
+    pkc_snapshot_config_t small = { .chunk_blocks = 8 };
+    pkc_snapshot_stats_t live = {0};
+    if (pkc_snapshot_export_writer(path, &w, &small, &live) != OP_SUCCESS) rc = 1;
+    atomic_store(&stop, true);
+    pthread_join(tid, NULL);
+    pkc_chain_writer_stop(&w);
+
+    if (pkc_snapshot_import_chain(path, boot, &small, NULL) != OP_SUCCESS) rc = 1;
+    printf("Live export: %llu blocks captured, %u appended during/after export, bootstrapped chain index %u\n",
+           (unsigned long long)live.blocks, p.committed, boot->index);
+    if (boot->index != live.blocks || live.blocks < capacity / 2 || strcmp(boot->NetworkName, "live") != 0 ||
+        boot->MCUComplexity != 9 || boot->EdgeComplexity != 17)
+        rc = 1;
+    for (uint32_t i = 0; i < boot->index; ++i) {
+        if (boot->blocks[i].height != i || boot->blocks[i].timestamp != chain->blocks[i].timestamp) rc = 1;
+    }
+    if (boot->index > 4 && boot->lastEdgeBlockIndex == 0) rc = 1;
+
+    // --- require_pow: a bad solve, a foreign challenge or another network leaves the chain empty ---
+    PKCertChain *mined = calloc(1, sizeof(PKCertChain));
+    PKCertChain *pow_boot = calloc(1, sizeof(PKCertChain));
+    if (!mined || !pow_boot) return 1;
+    snprintf(mined->NetworkName, sizeof(mined->NetworkName), "pow");
+    const block *tier_ref[TIER_POW_DIFFICULTY_TIERS];
+    make_block(&mined->blocks[0], 0);
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) tier_ref[t] = &mined->blocks[0];
+    for (uint32_t h = 1; h < 64; ++h) {
+        block *mb = &mined->blocks[h];
+        make_block(mb, h);
+        const int slot = tier_pow_difficulty_slot(mb->tier);
+        if (slot < 0) return 1;
+        mine_block(mb, &mined->blocks[h - 1], tier_ref[slot], 6);
+        tier_ref[slot] = mb;
+    }
+    mined->index = 64;
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) tier_pow_chain_set_complexity(mined, &tier_pow_chain_fields[t], 6);
+    snprintf(path, sizeof(path), "%s/pow.snap", dir);
+    pkc_snapshot_config_t pow_cfg = { .chunk_blocks = 8, .require_pow = true };
+    if (pkc_snapshot_export_chain(path, mined, &pow_cfg, NULL) != OP_SUCCESS) rc = 1;
+    const OpStatus_t pow_good = pkc_snapshot_import_chain(path, pow_boot, &pow_cfg, NULL);
+    const uint32_t pow_good_index = pow_boot->index;
+    const bool pow_carried = pow_boot->blocks[37].tierPoWResult.solve.nonce == mined->blocks[37].tierPoWResult.solve.nonce &&
+                             pow_boot->EdgeComplexity == 6 && pow_boot->ServerComplexity == 6;
+
+    memset(pow_boot, 0, sizeof(*pow_boot));
+    snprintf(pow_boot->NetworkName, sizeof(pow_boot->NetworkName), "other");
+    const OpStatus_t pow_other = pkc_snapshot_import_chain(path, pow_boot, &pow_cfg, NULL);
+    const uint32_t pow_other_index = pow_boot->index;
+
+    // A header that would have the node issue far easier challenges than the chain's last blocks solved.
+    mined->EdgeComplexity = 1;
+    if (pkc_snapshot_export_chain(path, mined, &pow_cfg, NULL) != OP_SUCCESS) rc = 1;
+    memset(pow_boot, 0, sizeof(*pow_boot));
+    const OpStatus_t pow_easy = pkc_snapshot_import_chain(path, pow_boot, &pow_cfg, NULL);
+    const uint32_t pow_easy_index = pow_boot->index;
+    mined->EdgeComplexity = 6;
+
+    tier_pow_solve_t *bad = &mined->blocks[37].tierPoWResult.solve;
+    const uint64_t good_nonce = bad->nonce;
+    while (pkc_block_pow_valid(&mined->blocks[37])) bad->nonce++;
+    if (pkc_snapshot_export_chain(path, mined, &pow_cfg, NULL) != OP_SUCCESS) rc = 1;
+    memset(pow_boot, 0, sizeof(*pow_boot));
+    const OpStatus_t pow_bad = pkc_snapshot_import_chain(path, pow_boot, &pow_cfg, NULL);
+    const uint32_t pow_bad_index = pow_boot->index;
+    bad->nonce = good_nonce;
+
+    // The tip solved against a challenge of its own choosing, at a lower difficulty.
+    block *forged = &mined->blocks[63];
+    tier_pow_challenge_set_challenge(&forged->tierPoWResult.challenge, &forged->CurrentCertHash);
+    tier_pow_challenge_set_complexity(&forged->tierPoWResult.challenge, 2);
+    tier_pow_challenge_t forged_bound;
+    tier_pow_challenge_bind(&forged->tierPoWResult.challenge, forged->reserved, sizeof(forged->reserved),
+                            &forged_bound);
+    tier_pow_solve_t *forged_solve = &forged->tierPoWResult.solve;
+    tier_pow_solve_challenge(&forged_bound, &forged_solve);
+    if (!pkc_block_pow_valid(forged)) rc = 1;
+    if (pkc_snapshot_export_chain(path, mined, &pow_cfg, NULL) != OP_SUCCESS) rc = 1;
+    memset(pow_boot, 0, sizeof(*pow_boot));
+    const OpStatus_t pow_forged = pkc_snapshot_import_chain(path, pow_boot, &pow_cfg, NULL);
+    printf("require_pow: valid %s (%u blocks), eased header %s (chain index %u), bad solve at 37 %s (chain index %u), "
+           "own challenge at 63 %s (chain index %u), other network %s\n",
+           pow_good == OP_SUCCESS ? "accepted" : "REJECTED", pow_good_index,
+           pow_easy == OP_INVALID_INPUT ? "rejected" : "ACCEPTED", pow_easy_index,
+           pow_bad == OP_INVALID_INPUT ? "rejected" : "ACCEPTED", pow_bad_index,
+           pow_forged == OP_INVALID_INPUT ? "rejected" : "ACCEPTED", pow_boot->index,
+           pow_other == OP_INVALID_INPUT ? "rejected" : "ACCEPTED");
+    if (pow_good != OP_SUCCESS || pow_good_index != 64 || !pow_carried || pow_easy != OP_INVALID_INPUT ||
+        pow_easy_index != 0 ||
+        pow_bad != OP_INVALID_INPUT || pow_bad_index != 0 || pow_forged != OP_INVALID_INPUT ||
+        pow_boot->index != 0 || pow_boot->lastEdgeBlockIndex != 0 ||
+        pow_other != OP_INVALID_INPUT || pow_other_index != 0)
+        rc = 1;
+
+    free(pow_boot);
+    free(mined);
+    free(boot);
+    free(chain);
+    char cmd[300];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+    if (system(cmd) != 0) rc = 1;
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
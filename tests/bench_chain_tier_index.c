@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blockchain/chainTierIndex_ops.h"
+#include "blockchain/chainWriter_ops.h"
+#include "telemetry/metrics_ops.h"
+
+/*
+ * Per-tier block lists against backward scans of the block array: the
+ * k newest blocks of a tier, the same cut below an older tip, the solve
+ * window, a difficulty controller seeded from the index against one fed
+ * live, and the chain writer keeping the lists in step with its tip.
+ */
+
+#define INDEX_BLOCKS (1u << 18)
+#define INDEX_QUERIES 4096
+#define INDEX_K 16
+
+static uint64_t rng_state = 0xC2B2AE3D27D4EB4FULL;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/* Tiers skewed like a real network: few servers, many MCUs and edges. */
+static Tier_t pick_tier(void)
+{
+    const uint64_t r = rng_next() % 100;
+    return r < 40 ? TIER_MCU : r < 75 ? TIER_EDGE : r < 95 ? TIER_DESKTOP : TIER_SERVER;
+}
+
+static void make_block(block *b, uint64_t height)
+{
+    block_init(b);
+    b->height = height;
+    b->tier = height ? pick_tier() : TIER_INVALID;
+    b->timestamp = 1700000000ULL + height * 5;
+    if (height) {
+        b->tierPoWResult.tier = b->tier;
+        b->tierPoWResult.time_taken = 0.5 + (double)(rng_next() % 4000) / 1000.0;
+        tier_pow_challenge_set_complexity(&b->tierPoWResult.challenge, (uint8_t)(8 + height % 5));
+        block_set_pow_version(b, TIER_POW_VERSION_LEADING_ZERO);
+    }
+}
+
+/* k newest blocks of `tier` below `end`, oldest first, by walking back. */
+static uint32_t scan_last_k(const block *blocks, uint32_t end, Tier_t tier, uint32_t k, uint32_t *out)
+{
+    uint32_t n = 0;
+    for (uint32_t i = end; i > 0 && n < k; --i) {
+        if (blocks[i - 1].tier == tier) out[k - 1 - n++] = i - 1;
+    }
+    memmove(out, out + (k - n), n * sizeof(uint32_t));
+    return n;
+}
+
+int main() {
+    printf("Initializing chain tier index benchmark...\n");
+    int rc = 0;
+
+    block *blocks = calloc(INDEX_BLOCKS, sizeof(block));
+    uint32_t *ends = calloc(INDEX_QUERIES, sizeof(uint32_t));
+    if (!blocks || !ends) return 1;
+    for (uint32_t i = 0; i < INDEX_BLOCKS; ++i) make_block(&blocks[i], i);
+    for (uint32_t q = 0; q < INDEX_QUERIES; ++q) ends[q] = (uint32_t)(rng_next() % INDEX_BLOCKS) + 1;
+
+    pkc_tier_index_t ix;
+    if (pkc_tier_index_init(&ix, INDEX_BLOCKS) != OP_SUCCESS) return 1;
+    uint64_t t0 = pkc_metrics_now_ns();
+    if (pkc_tier_index_append(&ix, blocks, INDEX_BLOCKS) != OP_SUCCESS) return 1;
+    printf("Tier index over %u blocks: built in %.2f ms\n", INDEX_BLOCKS, (pkc_metrics_now_ns() - t0) / 1e6);
+
+    // --- Lists agree with the blocks ---
+    uint32_t total = 0;
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        const Tier_t tier = tier_pow_chain_fields[t].tier;
+        const pkc_tier_list_t *l = pkc_tier_index_list(&ix, tier);
+        for (uint32_t i = 0; i < l->count; ++i) {
+            if (blocks[l->index[i]].tier != tier || (i && l->index[i] <= l->index[i - 1])) rc = 1;
+        }
+        total += l->count;
+        if (l->solves != l->count) rc = 1;
+    }
+    if (total != INDEX_BLOCKS - 1 || ix.count != INDEX_BLOCKS) rc = 1;     // genesis has no tier
+
+    printf("%-28s %12s %12s %9s\n", "query", "blocks us", "index us", "speedup");
+
+    // --- k newest of a tier at the head ---
+    uint32_t want[INDEX_K];
+    const uint32_t *got;
+    uint64_t sum_s = 0, sum_i = 0;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < INDEX_QUERIES; ++q) {
+        const uint32_t n = scan_last_k(blocks, INDEX_BLOCKS, TIER_SERVER, INDEX_K, want);
+        sum_s += want[0] + n;
+    }
+    const uint64_t head_s = pkc_metrics_now_ns() - t0;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < INDEX_QUERIES; ++q) {
+        const uint32_t n = pkc_tier_index_last_k(&ix, TIER_SERVER, INDEX_K, &got);
+        sum_i += got[0] + n;
+    }
+    const uint64_t head_i = pkc_metrics_now_ns() - t0;
+    printf("%-28s %12.1f %12.1f %8.1fx\n", "last 16 server blocks", head_s / 1e3, head_i / 1e3,
+           (double)head_s / (head_i ? head_i : 1));
+    if (sum_s != sum_i) rc = 1;
+
+    // --- The same below random older tips ---
+    sum_s = sum_i = 0;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < INDEX_QUERIES; ++q) {
+        const uint32_t n = scan_last_k(blocks, ends[q], (Tier_t)(TIER_MCU + q % 4), INDEX_K, want);
+        for (uint32_t i = 0; i < n; ++i) sum_s += want[i];
+    }
+    const uint64_t below_s = pkc_metrics_now_ns() - t0;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < INDEX_QUERIES; ++q) {
+        const uint32_t n = pkc_tier_index_last_k_below(&ix, (Tier_t)(TIER_MCU + q % 4), ends[q], INDEX_K, &got);
+        for (uint32_t i = 0; i < n; ++i) sum_i += got[i];
+    }
+    const uint64_t below_i = pkc_metrics_now_ns() - t0;
+    printf("%-28s %12.1f %12.1f %8.1fx\n", "last 16 of tier below tip", below_s / 1e3, below_i / 1e3,
+           (double)below_s / (below_i ? below_i : 1));
+    if (sum_s != sum_i) rc = 1;
+
+    // --- Window mean solve time ---
+    double mean_s = 0.0, mean_i = 0.0;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < INDEX_QUERIES; ++q) {
+        const Tier_t tier = (Tier_t)(TIER_MCU + q % 4);
+        double sum = 0.0;
+        uint32_t n = 0;
+        for (uint32_t i = INDEX_BLOCKS; i > 0 && n < PKC_TIER_INDEX_WINDOW; --i) {
+            if (blocks[i - 1].tier != tier) continue;
+            sum += blocks[i - 1].tierPoWResult.time_taken;
+            n++;
+        }
+        mean_s += sum / n;
+    }
+    const uint64_t mean_sn = pkc_metrics_now_ns() - t0;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t q = 0; q < INDEX_QUERIES; ++q) mean_i += pkc_tier_index_mean_solve_seconds(&ix, (Tier_t)(TIER_MCU + q % 4));
+    const uint64_t mean_in = pkc_metrics_now_ns() - t0;
+    printf("%-28s %12.1f %12.1f %8.1fx\n", "mean solve, last 32 of tier", mean_sn / 1e3, mean_in / 1e3,
+           (double)mean_sn / (mean_in ? mean_in : 1));
+    if (mean_s - mean_i > 1e-6 || mean_i - mean_s > 1e-6) rc = 1;
+
+    // --- Edges ---
+    if (pkc_tier_index_kth_last(&ix, TIER_MCU, 0) != PKC_TIER_INDEX_NONE) rc = 1;
+    if (pkc_tier_index_kth_last(&ix, TIER_INVALID, 1) != PKC_TIER_INDEX_NONE) rc = 1;
+    if (pkc_tier_index_last_k_below(&ix, TIER_MCU, 1, INDEX_K, &got) != 0) rc = 1;
+    if (pkc_tier_index_append(&ix, blocks, 1) != OP_BUFFER_TOO_SMALL) rc = 1;
+    if (pkc_tier_index_kth_last(&ix, TIER_EDGE, 2) >= pkc_tier_index_last(&ix, TIER_EDGE)) rc = 1;
+
+    // --- Seeded controller matches one fed the same solves live ---
+    tier_pow_difficulty_t live, seeded;
+    tier_pow_difficulty_init(&live, NULL);
+    tier_pow_difficulty_init(&seeded, NULL);
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        const Tier_t tier = tier_pow_chain_fields[t].tier;
+        const uint32_t *last;
+        const uint32_t n = pkc_tier_index_last_k(&ix, tier, PKC_TIER_INDEX_WINDOW, &last);
+        for (uint32_t i = 0; i < n; ++i) {
+            const block *b = &blocks[last[i]];
+            uint8_t next;
+            tier_pow_difficulty_observe(&live, tier, tier_pow_challenge_get_complexity(&b->tierPoWResult.challenge),
+                                        b->tierPoWResult.time_taken, &next);
+        }
+    }
+    if (pkc_tier_index_seed_difficulty(&ix, &seeded) != OP_SUCCESS) rc = 1;
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        if (seeded.tiers[t].count != live.tiers[t].count || seeded.tiers[t].applied != live.tiers[t].applied ||
+            seeded.tiers[t].state != live.tiers[t].state) {
+            printf("Error: seeded controller differs for tier slot %d\n", t);
+            rc = 1;
+        }
+    }
+    printf("Seeded controller: complexity MCU %u, EDGE %u, DESKTOP %u, SERVER %u\n", seeded.tiers[0].applied,
+           seeded.tiers[1].applied, seeded.tiers[2].applied, seeded.tiers[3].applied);
+    pkc_tier_index_destroy(&ix);
+
+    // --- Writer keeps the lists in step with its tip ---
+    PKCertChain *chain = calloc(1, sizeof(PKCertChain));
+    if (!chain) return 1;
+    make_block(&chain->blocks[0], 0);
+    chain->index = 1;
+    const uint32_t capacity = PKC_CHAIN_CAPACITY(chain);
+    pkc_tier_index_t tiers;
+    if (pkc_tier_index_init(&tiers, capacity) != OP_SUCCESS) return 1;
+    pkc_chain_writer_config_t wcfg = { .tiers = &tiers };
+    pkc_chain_writer_t w;
+    if (pkc_chain_writer_start(&w, chain, &wcfg) != OP_SUCCESS) return 1;
+    for (uint32_t h = 1; h < capacity; ++h) {
+        if (pkc_chain_append(&w, &blocks[h], NULL) != OP_SUCCESS) rc = 1;
+        pkc_chain_tip_t tip = {0};
+        pkc_chain_tip_copy(&w, &tip);
+        for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+            const uint32_t n = pkc_tier_index_last_k_below(&tiers, tier_pow_chain_fields[t].tier, tip.index, 1, &got);
+            if (n && got[0] != tip.last_index[t]) rc = 1;
+        }
+    }
+    pkc_chain_writer_stop(&w);
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        const tier_pow_chain_field_t *f = &tier_pow_chain_fields[t];
+        const uint32_t last = pkc_tier_index_last(&tiers, f->tier);
+        if (last != PKC_TIER_INDEX_NONE && last != tier_pow_chain_last_index(chain, f)) rc = 1;
+    }
+    printf("Writer: %u blocks committed, %u indexed\n", chain->index, tiers.count);
+    if (tiers.count != chain->index) rc = 1;
+
+    // A rebuild from the chain lands in the same place.
+    pkc_tier_index_t again;
+    if (pkc_tier_index_init(&again, capacity) != OP_SUCCESS || pkc_tier_index_build(&again, chain) != OP_SUCCESS) rc = 1;
+    for (int t = 0; t < TIER_POW_DIFFICULTY_TIERS; ++t) {
+        if (again.tiers[t].count != tiers.tiers[t].count || again.tiers[t].window_seconds != tiers.tiers[t].window_seconds ||
+            memcmp(again.tiers[t].index, tiers.tiers[t].index, tiers.tiers[t].count * sizeof(uint32_t)) != 0)
+            rc = 1;
+    }
+    pkc_tier_index_destroy(&again);
+    pkc_tier_index_destroy(&tiers);
+
+    free(chain);
+    free(ends);
+    free(blocks);
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
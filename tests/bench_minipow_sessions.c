@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Proofs/MiniPoW/miniPoWSessionTable_ops.h"
+
+/*
+ * Join-storm load benchmark for the MiniPoW session table.
+ *
+ * 500 nodes (PKC_BENCH_NODES) arrive every 200 us of virtual time. Each
+ * node is an in-process stand-in miner that takes its challenges off the
+ * shared send queue and ACKs after a tier-specific compute time (+-10%
+ * jitter) instead of multiplying the matrices, so the whole run measures
+ * the verifier side: scheduling, ACK routing, expiry and classification.
+ * Every 50th node goes silent after 100 ACKs to exercise expiry.
+ *
+ * Virtual time drives the protocol; wall time is what the table costs.
+ */
+
+#define BENCH_NODES_DEFAULT 500
+#define BENCH_ARRIVAL_NS 200000ULL
+#define BENCH_STALL_EVERY 50
+#define BENCH_STALL_AFTER 100
+#define BENCH_SESSION_BASE 10000u
+#define BENCH_INBOX_MAX MINI_POW_WINDOW_MAX
+
+typedef struct {
+    uint32_t session_id;
+    Tier_t tier;
+    uint64_t compute_ns;
+    uint64_t arrive_ns;
+    uint64_t busy_until;
+    uint32_t busy_challenge;
+    bool joined;
+    bool busy;
+    bool stalls;
+    bool finished;
+    uint32_t acks;
+    uint32_t inbox[BENCH_INBOX_MAX];
+    uint32_t inbox_head;
+    uint32_t inbox_len;
+} bench_miner_t;
+
+static uint64_t bench_rng = 0x2545F4914F6CDD1DULL;
+
+static uint64_t bench_next(void)
+{
+    bench_rng ^= bench_rng << 13;
+    bench_rng ^= bench_rng >> 7;
+    bench_rng ^= bench_rng << 17;
+    return bench_rng;
+}
+
+static uint64_t bench_wall_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Stand-in miners never look at the vectors, so only the ids are filled. */
+static OpStatus_t bench_build(void *ctx, const mini_pow_session_slot_t *slot, uint32_t iteration,
+                              uint32_t challenge_id, mini_pow_challenge_t *out)
+{
+    (void)ctx;
+    out->challenge_id = challenge_id;
+    out->session_id = slot->session_id;
+    out->iteration = iteration;
+    return OP_SUCCESS;
+}
+
+int main() {
+    uint32_t nodes = BENCH_NODES_DEFAULT;
+    const char *nodes_env = getenv("PKC_BENCH_NODES");
+    if (nodes_env) nodes = (uint32_t)strtoul(nodes_env, NULL, 10);
+    if (nodes == 0) return 1;
+
+    printf("MiniPoW session table: %u joining nodes\n", nodes);
+
+    mini_pow_session_table_config_t cfg;
+    mini_pow_session_table_config_default(&cfg);
+    mini_pow_session_table_t table;
+    if (mini_pow_session_table_init(&table, &cfg) != OP_SUCCESS) {
+        printf("Failed to initialise session table\n");
+        return 1;
+    }
+
+    mini_pow_classify_config_t classifyCfg;
+    mini_pow_classify_config_default(&classifyCfg);
+
+    static const uint64_t tier_ns[4] = { 50000ULL, 20000ULL, 6000ULL, 2000ULL }; // MCU..SERVER
+    bench_miner_t *miners = calloc(nodes, sizeof(bench_miner_t));
+    mini_pow_challenge_queue_t *sendQueue = calloc(1, sizeof(mini_pow_challenge_queue_t));
+    if (!miners || !sendQueue) return 1;
+    mini_pow_challenge_queue_init(sendQueue);
+
+    for (uint32_t n = 0; n < nodes; ++n) {
+        miners[n].session_id = BENCH_SESSION_BASE + n;
+        miners[n].tier = (Tier_t)(TIER_MCU + (n % 4));
+        miners[n].compute_ns = tier_ns[n % 4];
+        miners[n].arrive_ns = (uint64_t)n * BENCH_ARRIVAL_NS;
+        miners[n].stalls = (n % BENCH_STALL_EVERY) == BENCH_STALL_EVERY - 1;
+    }
+
+    uint64_t now = 0, next_expiry = 0, wall_table = 0;
+    uint32_t done = 0, joined = 0, correct = 0, classified = 0, expired = 0, peak_active = 0;
+    uint64_t steps = 0;
+    const uint64_t wall_start = bench_wall_ns();
+
+    while (done < nodes) {
+        steps++;
+
+        // Arrivals (retry later when the table refuses)
+        for (uint32_t n = joined; n < nodes && miners[n].arrive_ns <= now; ++n) {
+            if (miners[n].joined) continue;
+            uint64_t t0 = bench_wall_ns();
+            OpStatus_t st = mini_pow_session_table_open(&table, miners[n].session_id, 0, NULL, 0, now, &miners[n], NULL);
+            wall_table += bench_wall_ns() - t0;
+            if (st != OP_SUCCESS) break;
+            miners[n].joined = true;
+            joined = n + 1;
+        }
+        if (table.active > peak_active) peak_active = table.active;
+
+        // Verifier: interleave sends across sessions
+        uint64_t t0 = bench_wall_ns();
+        mini_pow_session_table_pump(&table, now, sendQueue, bench_build, NULL);
+        wall_table += bench_wall_ns() - t0;
+
+        // Wire: deliver everything queued to the miners' inboxes
+        for (size_t i = 0; i < MINI_POW_CHALLENGE_QUEUE_MAX && sendQueue->count > 0; ++i) {
+            if (!sendQueue->entries[i].used) continue;
+            const mini_pow_challenge_t *ch = &sendQueue->entries[i].challenge;
+            bench_miner_t *m = &miners[ch->session_id - BENCH_SESSION_BASE];
+            if (m->inbox_len < BENCH_INBOX_MAX) {
+                m->inbox[(m->inbox_head + m->inbox_len++) % BENCH_INBOX_MAX] = ch->challenge_id;
+            }
+            sendQueue->entries[i].used = false;
+            sendQueue->count--;
+        }
+
+        // Miners: finish work due by now, start the next item
+        uint64_t next_event = UINT64_MAX;
+        for (uint32_t n = 0; n < joined; ++n) {
+            bench_miner_t *m = &miners[n];
+            if (m->finished) continue;
+            if (m->busy && m->busy_until <= now) {
+                m->busy = false;
+                bool silent = m->stalls && m->acks >= BENCH_STALL_AFTER;
+                if (!silent) {
+                    t0 = bench_wall_ns();
+                    mini_pow_session_table_ack(&table, m->session_id, m->busy_challenge, m->busy_until);
+                    wall_table += bench_wall_ns() - t0;
+                    m->acks++;
+                }
+            }
+            if (!m->busy && m->inbox_len > 0) {
+                m->busy_challenge = m->inbox[m->inbox_head];
+                m->inbox_head = (m->inbox_head + 1) % BENCH_INBOX_MAX;
+                m->inbox_len--;
+                uint64_t jitter = m->compute_ns / 10;
+                m->busy_until = now + m->compute_ns - jitter + bench_next() % (2 * jitter + 1);
+                m->busy = true;
+            }
+            if (m->busy && m->busy_until < next_event) next_event = m->busy_until;
+
+            mini_pow_session_slot_t *s = mini_pow_session_table_find(&table, m->session_id);
+            if (s && s->state == MINI_POW_SESSION_COMPLETE) {
+                mini_pow_classification_t cls;
+                t0 = bench_wall_ns();
+                if (mini_pow_session_table_classify(&table, m->session_id, &classifyCfg, &cls) == OP_SUCCESS) {
+                    classified++;
+                    if (cls.tier == m->tier) correct++;
+                }
+                mini_pow_session_table_close(&table, m->session_id, sendQueue, NULL);
+                wall_table += bench_wall_ns() - t0;
+                m->finished = true;
+                done++;
+            }
+        }
+
+        // Expiry sweep every virtual millisecond
+        if (now >= next_expiry) {
+            uint32_t ids[64];
+            t0 = bench_wall_ns();
+            uint32_t n = mini_pow_session_table_expire(&table, now, sendQueue, NULL, ids, 64);
+            wall_table += bench_wall_ns() - t0;
+            for (uint32_t k = 0; k < n; ++k) {
+                miners[ids[k] - BENCH_SESSION_BASE].finished = true;
+                done++;
+                expired++;
+            }
+            // A full buffer means more may be due: sweep again next step.
+            next_expiry = n == 64 ? now : now + 1000000ULL;
+        }
+
+        if (joined < nodes && miners[joined].arrive_ns < next_event) next_event = miners[joined].arrive_ns;
+        if (next_expiry < next_event) next_event = next_expiry;
+        now = next_event > now ? next_event : now + 1000;
+    }
+
+    const uint64_t wall_total = bench_wall_ns() - wall_start;
+
+    printf("\n--- bench_minipow_sessions ---\n");
+    printf("Nodes: %u, classified: %u, tier correct: %u, expired: %u\n", nodes, classified, correct, expired);
+    printf("Peak concurrent sessions: %u (capacity %u, window %u)\n", peak_active, cfg.capacity, cfg.window);
+    printf("Table memory: %.1f MB of %.1f MB budget\n",
+           (double)mini_pow_session_table_bytes(&table) / (1024.0 * 1024.0),
+           (double)cfg.memory_budget / (1024.0 * 1024.0));
+    printf("Virtual onboarding time: %.3f s (%.1f nodes/s)\n", (double)now / 1e9, nodes / ((double)now / 1e9));
+    printf("Wall time: %.3f s total, %.3f s in the session table (%llu steps)\n",
+           (double)wall_total / 1e9, (double)wall_table / 1e9, (unsigned long long)steps);
+    printf("------------------------------\n");
+
+    int rc = (classified + expired == nodes && correct == classified) ? 0 : 1;
+    mini_pow_session_table_destroy(&table);
+    free(sendQueue);
+    free(miners);
+    return rc;
+}
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Proofs/MiniPoW/miniPoWMatrix_ops.h"
+#include "Proofs/MiniPoW/miniPoWVerify_ops.h"
+#include "Proofs/MiniPoW/miniPoWVerifyParallel_ops.h"
+
+/*
+ * Serial vs parallel exact verification on a valid submission and on
+ * submissions corrupted in the first and in the last cell.
+ * PKC_BENCH_THREADS overrides the worker count (default: online CPUs).
+ */
+
+static uint64_t bench_wall_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main() {
+    uint32_t threads = mini_pow_verify_default_threads();
+    const char *threads_env = getenv("PKC_BENCH_THREADS");
+    if (threads_env) threads = (uint32_t)strtoul(threads_env, NULL, 10);
+
+    mini_pow_Matrix *matrices = calloc(1, sizeof(mini_pow_Matrix));
+    SolvedMatricPoW *solved = calloc(1, sizeof(SolvedMatricPoW));
+    if (!matrices || !solved) return 1;
+
+    certificate dummy_cert;
+    memset(&dummy_cert, 0, sizeof(dummy_cert));
+    uint256 dummy_hash;
+    memset(&dummy_hash, 0, sizeof(dummy_hash));
+    if (construct_mini_pow_matrices(&dummy_cert, &dummy_hash, 7, 4242, matrices) != OP_SUCCESS) {
+        printf("Failed to generate matrices natively!\n");
+        return 1;
+    }
+
+    // Honest solution, row by row with the same kernel.
+    uint32_t acc[MINI_POW_MATRIX_N];
+    for (uint32_t r = 0; r < MINI_POW_MATRIX_N; ++r) {
+        mini_pow_verify_row(matrices, solved, r, acc);
+        memcpy(solved->Matrix[r], acc, sizeof(acc));
+    }
+
+    static const struct { const char *name; uint32_t row, col; } cases[] = {
+        { "valid", MINI_POW_MATRIX_N, 0 },
+        { "early-corrupt", 0, 0 },
+        { "late-corrupt", MINI_POW_MATRIX_N - 1, MINI_POW_MATRIX_N - 1 },
+    };
+
+    printf("MiniPoW verify: N=%u, %u threads\n\n", MINI_POW_MATRIX_N, threads);
+    printf("%-14s %12s %12s %8s  %s\n", "case", "serial ms", "parallel ms", "rows", "result");
+
+    int rc = 0;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+        const bool corrupt = cases[c].row < MINI_POW_MATRIX_N;
+        if (corrupt) solved->Matrix[cases[c].row][cases[c].col] ^= 0x1u;
+
+        uint64_t t0 = bench_wall_ns();
+        bool serial_ok = mini_pow_verify(solved, matrices);
+        uint64_t t1 = bench_wall_ns();
+        mini_pow_verify_report_t report;
+        bool parallel_ok = mini_pow_verify_parallel(solved, matrices, threads, &report);
+        uint64_t t2 = bench_wall_ns();
+
+        printf("%-14s %12.3f %12.3f %8u  %s", cases[c].name, (double)(t1 - t0) / 1e6, (double)(t2 - t1) / 1e6,
+               report.rows_checked, parallel_ok ? "accepted" : "rejected");
+        if (!parallel_ok) printf(" at (%u, %u)", report.row, report.col);
+        printf("\n");
+
+        if (serial_ok != !corrupt || parallel_ok != !corrupt) rc = 1;
+        if (corrupt && (report.row != cases[c].row || report.col != cases[c].col)) rc = 1;
+
+        if (corrupt) solved->Matrix[cases[c].row][cases[c].col] ^= 0x1u;
+    }
+
+    free(solved);
+    free(matrices);
+    printf("\n%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Proofs/TierPoW/tierPoWBench_ops.h"
+#include "Proofs/TierPoW/tierPoWVerify_ops.h"
+
+/*
+ * Startup hashrate self-benchmark: local TierPoW hashes/sec on one thread
+ * and on every online CPU, the expected solve time at each tier's genesis
+ * complexity, a check of the estimate against real solves, and refusal of
+ * a search the budget cannot cover.
+ */
+
+int main() {
+    tier_pow_hashrate_t single, all;
+    memset(&single, 0, sizeof(single));
+    memset(&all, 0, sizeof(all));
+    if (tier_pow_bench_run(1, 0, &single) != OP_SUCCESS || tier_pow_bench_run(0, 0, &all) != OP_SUCCESS) {
+        printf("Benchmark failed\n");
+        return 1;
+    }
+    printf("TierPoW hashrate: %.0f H/s on 1 thread, %.0f H/s on %u threads (%.0f H/s each)\n\n",
+           single.hashes_per_sec, all.hashes_per_sec, all.threads, all.per_thread);
+
+    static const struct { const char *name; uint8_t complexity; } tiers[] = {
+        { "MCU", 10 }, { "EDGE", 20 }, { "DESKTOP", 30 }, { "SERVER", 40 }, { "runaway", 100 },
+    };
+    printf("%-8s %10s %16s  %s\n", "tier", "complexity", "expected s", "budget");
+    int rc = 0;
+    for (size_t t = 0; t < sizeof(tiers) / sizeof(tiers[0]); ++t) {
+        tier_pow_challenge_t pow;
+        tier_pow_challenge_init(&pow);
+        tier_pow_challenge_set_complexity(&pow, tiers[t].complexity);
+        double expected;
+        OpStatus_t st = tier_pow_budget_check(&single, &pow, 1, &expected);
+        printf("%-8s %10u %16.4g  %s\n", tiers[t].name, tiers[t].complexity, expected,
+               st == OP_SUCCESS ? "ok" : "refused");
+        if (tiers[t].complexity == 100 && st != OP_INVALID_STATE) rc = 1;
+    }
+
+    // Estimate vs measured at a complexity that solves in well under a second.
+    const uint8_t c = 12;
+    const int rounds = 32;
+    tier_pow_challenge_t pow;
+    tier_pow_challenge_init(&pow);
+    tier_pow_challenge_set_complexity(&pow, c);
+    const double estimate = tier_pow_expected_solve_seconds(&single, &pow, 1);
+    uint64_t t0 = pkc_clock_now_ns();
+    for (int r = 0; r < rounds; ++r) {
+        uint8_t seed[UINT64_SIZE];
+        serialize_u64_be(0xBE0C4000u + r, seed);
+        hash256_buffer(seed, sizeof(seed), &pow.challenge);
+        tier_pow_solve_t solve;
+        tier_pow_solve_init(&solve);
+        tier_pow_solve_t *ptr = &solve;
+        tier_pow_solve_challenge(&pow, &ptr);
+        if (!ptr || !isValidTierChallenge(&pow, &solve)) rc = 1;
+    }
+    const double measured = (double)(pkc_clock_now_ns() - t0) / 1e9 / rounds;
+    printf("\nComplexity %u: estimated %.3f ms, measured %.3f ms per solve (%d solves)\n",
+           c, estimate * 1e3, measured * 1e3, rounds);
+    if (measured > estimate * 3.0 || measured < estimate / 3.0) rc = 1;
+
+    printf("\n%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
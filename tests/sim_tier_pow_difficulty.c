@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "Proofs/TierPoW/tierPoWDifficulty_ops.h"
+
+/*
+ * Synthetic-trace simulation of the per-tier difficulty controller.
+ *
+ * Each tier mines with a fixed hashrate H; a solve at complexity c takes an
+ * exponential time with mean 2^(c+2) / H. At block 200 every hashrate
+ * quadruples, and 2% of solves are replaced by 50x outliers (stalled or
+ * lucky miners). Both estimators run on the same traces, and the median
+ * estimator once more in 256-bit target mode, where complexity is
+ * fractional.
+ *
+ * Reported per tier: blocks until the complexity is within one bit of
+ * c* = log2(target * H) - 2 (before and after the step), how many times it
+ * changed after converging, and the stdev of the complexity from then on.
+ */
+
+#define SIM_BLOCKS 400
+#define SIM_STEP_AT 200
+#define SIM_STEP_FACTOR 4.0
+#define SIM_OUTLIER_EVERY 50
+#define SIM_OUTLIER_FACTOR 50.0
+
+static uint64_t sim_rng;
+
+static double sim_uniform(void)
+{
+    sim_rng ^= sim_rng << 13;
+    sim_rng ^= sim_rng >> 7;
+    sim_rng ^= sim_rng << 17;
+    return ((sim_rng >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+typedef struct {
+    int converge;               // blocks to converge from genesis, -1 never
+    int reconverge;             // blocks to converge after the step, -1 never
+    uint32_t changes;           // complexity changes after converging
+    double stdev;
+} sim_result_t;
+
+static double sim_ideal(double target, double hashrate)
+{
+    return log2(target * hashrate) - 2.0;
+}
+
+static sim_result_t sim_run(tier_pow_estimator_t estimator, uint8_t version, Tier_t tier, uint8_t genesis,
+                            double hashrate)
+{
+    tier_pow_difficulty_config_t cfg;
+    tier_pow_difficulty_config_default(&cfg);
+    cfg.estimator = estimator;
+    cfg.version = version;
+    tier_pow_difficulty_t ctl;
+    tier_pow_difficulty_init(&ctl, &cfg);
+
+    sim_rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)tier;
+    sim_result_t r = { -1, -1, 0, 0.0 };
+    uint8_t c = genesis;
+    uint32_t bits = tier_pow_difficulty_target_bits(&ctl, tier, genesis);
+    double cx = version == TIER_POW_VERSION_TARGET ? tier_pow_target_complexity(bits) : genesis, prev = cx;
+    double sum = 0.0, sum_sq = 0.0;
+    uint32_t settled = 0;
+
+    for (int b = 0; b < SIM_BLOCKS; ++b) {
+        const double h = b < SIM_STEP_AT ? hashrate : hashrate * SIM_STEP_FACTOR;
+        const double ideal = sim_ideal(cfg.target_seconds[0], h);
+        const bool near = fabs(cx - ideal) <= 1.0;
+
+        if (b < SIM_STEP_AT && r.converge < 0 && near) r.converge = b;
+        if (b >= SIM_STEP_AT && r.reconverge < 0 && near) r.reconverge = b - SIM_STEP_AT;
+        const bool converged = b < SIM_STEP_AT ? r.converge >= 0 : r.reconverge >= 0;
+        if (converged) {
+            if (cx != prev) r.changes++;
+            sum += cx - ideal;
+            sum_sq += (cx - ideal) * (cx - ideal);
+            settled++;
+        }
+        prev = cx;
+
+        double seconds = -log(sim_uniform()) * exp2(cx + 2.0) / h;
+        if (b % SIM_OUTLIER_EVERY == SIM_OUTLIER_EVERY - 1) seconds *= SIM_OUTLIER_FACTOR;
+        if (version == TIER_POW_VERSION_TARGET) {
+            tier_pow_difficulty_observe_target(&ctl, tier, bits, seconds, &bits);
+            cx = tier_pow_target_complexity(bits);
+        } else {
+            tier_pow_difficulty_observe(&ctl, tier, c, seconds, &c);
+            cx = c;
+        }
+    }
+    if (settled > 1) {
+        const double mean = sum / settled;
+        r.stdev = sqrt(sum_sq / settled - mean * mean);
+    }
+    return r;
+}
+
+int main() {
+    static const struct { Tier_t tier; const char *name; uint8_t genesis; double hashrate; } tiers[] = {
+        { TIER_MCU, "MCU", 10, 1e3 },
+        { TIER_EDGE, "EDGE", 20, 1e5 },
+        { TIER_DESKTOP, "DESKTOP", 30, 1e7 },
+        { TIER_SERVER, "SERVER", 40, 1e9 },
+    };
+    static const struct { tier_pow_estimator_t estimator; uint8_t version; const char *name; } estimators[] = {
+        { TIER_POW_ESTIMATOR_EWMA, TIER_POW_VERSION_LEADING_ZERO, "ewma" },
+        { TIER_POW_ESTIMATOR_MEDIAN, TIER_POW_VERSION_LEADING_ZERO, "median" },
+        { TIER_POW_ESTIMATOR_MEDIAN, TIER_POW_VERSION_TARGET, "target" },
+    };
+
+    printf("TierPoW difficulty: %d blocks, x%.0f hashrate at block %d, 1/%d solves x%.0f\n\n",
+           SIM_BLOCKS, SIM_STEP_FACTOR, SIM_STEP_AT, SIM_OUTLIER_EVERY, SIM_OUTLIER_FACTOR);
+    printf("%-8s %-8s %6s %10s %12s %8s %8s\n", "est", "tier", "c*", "converge", "reconverge", "changes", "stdev");
+
+    int rc = 0;
+    for (size_t e = 0; e < sizeof(estimators) / sizeof(estimators[0]); ++e) {
+        for (size_t t = 0; t < sizeof(tiers) / sizeof(tiers[0]); ++t) {
+            sim_result_t r = sim_run(estimators[e].estimator, estimators[e].version, tiers[t].tier, tiers[t].genesis, tiers[t].hashrate);
+            printf("%-8s %-8s %6.1f %10d %12d %8u %8.2f\n", estimators[e].name, tiers[t].name,
+                   sim_ideal(TIER_POW_TARGET_SECONDS_DEFAULT, tiers[t].hashrate), r.converge, r.reconverge,
+                   r.changes, r.stdev);
+            if (r.converge < 0 || r.reconverge < 0) rc = 1;
+        }
+    }
+
+    printf("\n%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blockchain/blockView_ops.h"
+#include "blockchain/certificate_ops.h"
+#include "telemetry/metrics_ops.h"
+
+/*
+ * Block views against block_deserialize: every accessor, raw-byte hashing,
+ * a full record with the PoW sections, a short buffer, and the cost of reading one field from N serialized
+ * blocks through a view versus a full decode.
+ */
+
+#define VIEW_BLOCKS 100000
+
+static void make_block(block *b, uint64_t height)
+{
+    block_init(b);
+    b->height = height;
+    b->timestamp = 1700000000ULL + height * 13;
+    b->tier = (Tier_t)(TIER_MCU + height % 4);
+    for (int w = 0; w < 4; ++w) {
+        b->cert.pubSignKey.w[w] = height * 0x9E3779B97F4A7C15ULL + w;
+        b->cert.pubEncKey.w[w] = ~height + (uint64_t)w * 7;
+        b->prevHash.w[w] = height ^ ((uint64_t)w << 40);
+    }
+    hash256_buffer((const uint8_t *)&height, sizeof(height), &b->CurrentCertHash);
+    block_set_pow_version(b, (uint8_t)(1 + height % 3));
+}
+
+int main() {
+    printf("Initializing block view test...\n");
+    int rc = 0;
+
+    uint8_t *wire = calloc(VIEW_BLOCKS, BLOCK_SIZE);
+    if (!wire) return 1;
+    block b;
+    for (uint32_t i = 0; i < VIEW_BLOCKS; ++i) {
+        make_block(&b, i);
+        if (block_serialize(&b, wire + (size_t)i * BLOCK_SIZE, BLOCK_SIZE) != OP_SUCCESS) return 1;
+    }
+
+    // --- Accessors agree with a full decode ---
+    for (uint32_t i = 0; i < VIEW_BLOCKS; i += 997) {
+        block_view v;
+        block d;
+        if (block_view_init(&v, wire + (size_t)i * BLOCK_SIZE, BLOCK_SIZE) != OP_SUCCESS ||
+            block_deserialize(wire + (size_t)i * BLOCK_SIZE, BLOCK_SIZE, &d) != OP_SUCCESS) {
+            rc = 1;
+            break;
+        }
+        uint256 sign, enc, prev, cert_hash;
+        block_view_pub_sign_key(&v, &sign);
+        block_view_pub_enc_key(&v, &enc);
+        block_view_prev_hash(&v, &prev);
+        block_view_cert_hash(&v, &cert_hash);
+        if (block_view_height(&v) != d.height || block_view_timestamp(&v) != d.timestamp ||
+            block_view_tier(&v) != d.tier || block_view_pow_version(&v) != block_get_pow_version(&d) ||
+            memcmp(&sign, &d.cert.pubSignKey, sizeof(uint256)) != 0 ||
+            memcmp(&enc, &d.cert.pubEncKey, sizeof(uint256)) != 0 || memcmp(&prev, &d.prevHash, sizeof(uint256)) != 0 ||
+            memcmp(&cert_hash, &d.CurrentCertHash, sizeof(uint256)) != 0 ||
+            !block_view_key_equals(block_view_pub_sign_key_raw(&v), &d.cert.pubSignKey) ||
+            block_view_key_equals(block_view_pub_enc_key_raw(&v), &d.cert.pubSignKey)) {
+            printf("Error: view of block %u differs from block_deserialize\n", i);
+            rc = 1;
+            break;
+        }
+
+        // Raw hashing matches hashing after block_serialize / hash_certificate.
+        uint8_t again[BLOCK_SIZE];
+        memset(again, 0, sizeof(again));
+        block_serialize(&d, again, sizeof(again));
+        uint256 hv, hs, cv, cs;
+        block_view_hash(&v, &hv);
+        hash256_buffer(again, BLOCK_SIZE, &hs);
+        block_view_cert_digest(&v, &cv);
+        hash_certificate(&d.cert, &cs);
+        if (memcmp(&hv, &hs, sizeof(hv)) != 0 || memcmp(&cv, &cs, sizeof(cv)) != 0) {
+            printf("Error: raw hash of block %u differs\n", i);
+            rc = 1;
+            break;
+        }
+        if (block_view_has_pow(&v) || block_view_mini_pow_raw(&v) || block_view_tier_pow_raw(&v)) rc = 1;
+    }
+
+    // --- Full record: PoW sections present, head accessors unchanged ---
+    uint8_t full[BLOCK_SERIALIZED_SIZE];
+    memset(full, 0, sizeof(full));
+    make_block(&b, 42);
+    block_view fv;
+    if (block_serialize(&b, full, sizeof(full)) != OP_SUCCESS || block_view_init(&fv, full, sizeof(full)) != OP_SUCCESS ||
+        !block_view_has_pow(&fv) || block_view_mini_pow_raw(&fv) != full + BLOCK_VIEW_MINI_POW_OFFSET ||
+        block_view_tier_pow_raw(&fv) != full + BLOCK_VIEW_TIER_POW_OFFSET || block_view_height(&fv) != 42 ||
+        block_view_pow_version(&fv) != (BLOCK_VIEW_RESERVED_OFFSET < BLOCK_SIZE ? block_get_pow_version(&b) : 0)) {
+        printf("Error: view of a full record\n");
+        rc = 1;
+    }
+
+    block_view shortv;
+    if (block_view_init(&shortv, wire, BLOCK_SIZE - 1) != OP_BUFFER_TOO_SMALL) rc = 1;
+    if (block_view_init(NULL, wire, BLOCK_SIZE) != OP_NULL_PTR) rc = 1;
+
+    // --- One field from every block: view vs full decode ---
+    uint64_t sum_view = 0, sum_decode = 0;
+    uint64_t t0 = pkc_metrics_now_ns();
+    for (uint32_t i = 0; i < VIEW_BLOCKS; ++i) {
+        block_view v;
+        block_view_init(&v, wire + (size_t)i * BLOCK_SIZE, BLOCK_SIZE);
+        sum_view += block_view_height(&v) + block_view_tier(&v);
+    }
+    const uint64_t view_ns = pkc_metrics_now_ns() - t0;
+    t0 = pkc_metrics_now_ns();
+    for (uint32_t i = 0; i < VIEW_BLOCKS; ++i) {
+        block d;
+        block_deserialize(wire + (size_t)i * BLOCK_SIZE, BLOCK_SIZE, &d);
+        sum_decode += d.height + d.tier;
+    }
+    const uint64_t decode_ns = pkc_metrics_now_ns() - t0;
+    printf("Height + tier of %u blocks: view %.2f ms, block_deserialize %.2f ms\n", VIEW_BLOCKS, view_ns / 1e6,
+           decode_ns / 1e6);
+    if (sum_view != sum_decode) rc = 1;
+
+    free(wire);
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "blockchain/chainWriter_ops.h"
+
+/*
+ * Chain writer: group-committed batches, rejection of stale and
+ * over-capacity candidates, racing producers and lock-free readers that
+ * must always see a consistent tip, a failed persist leaving nothing
+ * committed, and require_pow refusing blocks that do not solve the
+ * chain's own challenge.
+ */
+
+#define PRODUCERS 4
+#define READERS 2
+
+static const Tier_t tiers[] = {TIER_MCU, TIER_SERVER, TIER_DESKTOP, TIER_EDGE};
+
+typedef struct {
+    uint32_t calls;
+    uint32_t blocks;
+    uint32_t max_batch;
+} persist_log_t;
+
+static OpStatus_t count_persist(void *ctx, const PKCertChain *chain, uint32_t first, uint32_t count)
+{
+    persist_log_t *log = (persist_log_t *)ctx;
+    log->calls++;
+    log->blocks += count;
+    if (count > log->max_batch) log->max_batch = count;
+    return first + count <= chain->index ? OP_SUCCESS : OP_INVALID_STATE;
+}
+
+// Stands in for a store whose disk fails once the chain reaches `fail_at` blocks.
+static OpStatus_t failing_persist(void *ctx, const PKCertChain *chain, uint32_t first, uint32_t count)
+{
+    (void)chain;
+    return first + count > *(const uint32_t *)ctx ? OP_INVALID_STATE : OP_SUCCESS;
+}
+
+static void make_block(block *b, uint64_t height, Tier_t tier)
+{
+    block_init(b);
+    b->height = height;
+    b->tier = tier;
+    b->timestamp = height * 7;
+    hash256_buffer((const uint8_t *)&height, sizeof(height), &b->CurrentCertHash);
+}
+
+/* Solves a block's stored challenge, bound to its reserved bytes. */
+static void mine(block *b)
+{
+    tier_pow_challenge_t bound;
+    tier_pow_challenge_bind(&b->tierPoWResult.challenge, b->reserved, sizeof(b->reserved), &bound);
+    tier_pow_solve_t *solve = &b->tierPoWResult.solve;
+    tier_pow_solve_challenge(&bound, &solve);
+}
+
+static void reset_chain(PKCertChain *chain)
+{
+    memset(chain, 0, sizeof(*chain));
+    chain->index = 1;       // genesis
+}
+
+typedef struct {
+    pkc_chain_writer_t *w;
+    uint32_t id;
+    uint32_t committed;
+    uint32_t rejected;
+} producer_t;
+
+// Mines "on top of" the tip it last read; losers of a race get OP_INVALID_STATE.
+static void *producer(void *arg)
+{
+    producer_t *p = (producer_t *)arg;
+    pkc_chain_tip_t tip = {0};
+    block b;
+    for (;;) {
+        if (pkc_chain_tip_copy(p->w, &tip) != OP_SUCCESS) return (void *)1;
+        if (tip.index >= PKC_CHAIN_CAPACITY(p->w->chain)) break;
+        make_block(&b, tip.index, tiers[(p->id + tip.index) % 4]);
+        OpStatus_t st = pkc_chain_append(p->w, &b, NULL);
+        if (st == OP_SUCCESS) p->committed++;
+        else if (st == OP_INVALID_STATE) p->rejected++;
+        else if (st != OP_BUFFER_TOO_SMALL) return (void *)1;
+    }
+    return NULL;
+}
+
+typedef struct {
+    pkc_chain_writer_t *w;
+    _Atomic(bool) *stop;
+    uint64_t reads;
+    uint32_t errors;
+} reader_t;
+
+static void *reader(void *arg)
+{
+    reader_t *r = (reader_t *)arg;
+    uint32_t slot;
+    if (pkc_chain_reader_self(r->w, &slot) != OP_SUCCESS) {
+        r->errors++;
+        return NULL;
+    }
+    uint32_t last = 0;
+    while (!atomic_load(r->stop)) {
+        const pkc_chain_tip_t *tip = pkc_chain_read_begin(r->w, slot);
+        const block *top = pkc_chain_read_block(r->w, tip, tip->index - 1);
+        if (tip->index < last || !top || top->height != tip->height ||
+            memcmp(&top->CurrentCertHash, &tip->cert_hash, sizeof(uint256)) != 0)
+            r->errors++;
+        for (int t = 0; t < 4; ++t) {
+            const uint32_t li = pkc_chain_tip_last_index(tip, tiers[t]);
+            if (li != 0 && (li >= tip->index || r->w->chain->blocks[li].tier != tiers[t])) r->errors++;
+        }
+        last = tip->index;
+        pkc_chain_read_end(r->w, slot);
+        r->reads++;
+    }
+    return NULL;
+}
+
+static void *short_lived_reader(void *arg)
+{
+    pkc_chain_tip_t tip;
+    return pkc_chain_tip_copy((pkc_chain_writer_t *)arg, &tip) == OP_SUCCESS ? NULL : (void *)1;
+}
+
+int main() {
+    printf("Initializing chain writer test...\n");
+    int rc = 0;
+
+    PKCertChain *chain = calloc(1, sizeof(PKCertChain));
+    if (!chain) return 1;
+    const uint32_t capacity = PKC_CHAIN_CAPACITY(chain);
+
+    // --- One producer, pipelined: tickets complete in group-committed batches ---
+    reset_chain(chain);
+    persist_log_t log = {0};
+    pkc_chain_writer_config_t cfg = { .persist = count_persist, .persist_ctx = &log, .require_pow = false };
+    pkc_chain_writer_t w;
+    if (pkc_chain_writer_start(&w, chain, &cfg) != OP_SUCCESS) return 1;
+
+    pkc_chain_ticket_t *tickets = calloc(capacity, sizeof(*tickets));
+    block b;
+    for (uint32_t h = 1; h < capacity - 1; ++h) {
+        make_block(&b, h, tiers[h % 4]);
+        if (pkc_chain_submit(&w, &b, &tickets[h]) != OP_SUCCESS) rc = 1;
+    }
+    for (uint32_t h = 1; h < capacity - 1; ++h) {
+        if (pkc_chain_ticket_wait(&w, &tickets[h]) != OP_SUCCESS || tickets[h].height != h) rc = 1;
+    }
+    make_block(&b, 5, TIER_MCU);
+    OpStatus_t stale = pkc_chain_append(&w, &b, NULL);
+    make_block(&b, capacity - 1, tiers[(capacity - 1) % 4]);
+    if (pkc_chain_append(&w, &b, NULL) != OP_SUCCESS) rc = 1;
+    make_block(&b, capacity, TIER_MCU);
+    OpStatus_t full = pkc_chain_append(&w, &b, NULL);
+
+    pkc_chain_tip_t tip = {0};
+    pkc_chain_tip_copy(&w, &tip);
+    printf("Pipelined: %u blocks in %u persist batches (largest %u), tip %u\n", log.blocks, log.calls,
+           log.max_batch, tip.index);
+    printf("Over capacity: %s, stale height: %s\n", full == OP_BUFFER_TOO_SMALL ? "rejected" : "ACCEPTED",
+           stale == OP_INVALID_STATE ? "rejected" : "ACCEPTED");
+    if (log.blocks != capacity - 1 || tip.index != capacity || full != OP_BUFFER_TOO_SMALL ||
+        stale != OP_INVALID_STATE)
+        rc = 1;
+    for (int t = 0; t < 4; ++t) {
+        const uint32_t li = pkc_chain_tip_last_index(&tip, tiers[t]);
+        if (chain->blocks[li].tier != tiers[t] || li + 4 < capacity) rc = 1;
+    }
+    pkc_chain_writer_stop(&w);
+    free(tickets);
+
+    // --- Racing producers with readers on the side ---
+    reset_chain(chain);
+    if (pkc_chain_writer_start(&w, chain, NULL) != OP_SUCCESS) return 1;
+    _Atomic(bool) stop = false;
+    producer_t producers[PRODUCERS];
+    reader_t readers[READERS];
+    pthread_t ptid[PRODUCERS], rtid[READERS];
+    for (int i = 0; i < READERS; ++i) {
+        readers[i] = (reader_t){ .w = &w, .stop = &stop };
+        pthread_create(&rtid[i], NULL, reader, &readers[i]);
+    }
+    for (int i = 0; i < PRODUCERS; ++i) {
+        producers[i] = (producer_t){ .w = &w, .id = (uint32_t)i };
+        pthread_create(&ptid[i], NULL, producer, &producers[i]);
+    }
+    uint32_t committed = 0, rejected = 0;
+    for (int i = 0; i < PRODUCERS; ++i) {
+        void *ret;
+        pthread_join(ptid[i], &ret);
+        if (ret) rc = 1;
+        committed += producers[i].committed;
+        rejected += producers[i].rejected;
+    }
+    atomic_store(&stop, true);
+    uint64_t reads = 0;
+    uint32_t errors = 0;
+    for (int i = 0; i < READERS; ++i) {
+        pthread_join(rtid[i], NULL);
+        reads += readers[i].reads;
+        errors += readers[i].errors;
+    }
+    pkc_chain_writer_stop(&w);
+
+    for (uint32_t i = 1; i < chain->index; ++i) {
+        if (chain->blocks[i].height != i) rc = 1;
+    }
+    printf("Racing producers: %u committed, %u stale rejected, chain index %u\n", committed, rejected, chain->index);
+    printf("Readers: %llu lock-free reads, %u inconsistent\n", (unsigned long long)reads, errors);
+    if (committed != capacity - 1 || chain->index != capacity || errors != 0) rc = 1;
+
+    // --- Reader slots come back when their threads exit ---
+    reset_chain(chain);
+    if (pkc_chain_writer_start(&w, chain, NULL) != OP_SUCCESS) return 1;
+    uint32_t slot_failures = 0;
+    for (int i = 0; i < 4 * PKC_CHAIN_READERS_MAX; ++i) {
+        pthread_t tid;
+        void *ret;
+        pthread_create(&tid, NULL, short_lived_reader, &w);
+        pthread_join(tid, &ret);
+        if (ret) slot_failures++;
+    }
+    printf("Short-lived readers: %d threads, %u without a slot, %u slots ever used\n",
+           4 * PKC_CHAIN_READERS_MAX, slot_failures, atomic_load(&w.nreaders));
+    if (slot_failures != 0 || atomic_load(&w.nreaders) > 2) rc = 1;
+
+    // --- The retarget comes from the committed block's own solve, and only then ---
+    tier_pow_difficulty_t expect;
+    tier_pow_difficulty_init(&expect, &tier_pow_difficulty_default()->cfg);
+    uint8_t expected = 0;
+    OpStatus_t mined = OP_SUCCESS;
+    for (uint64_t h = 1; h <= 3; ++h) {
+        tier_pow_difficulty_observe(&expect, TIER_EDGE, 12, 0.25, &expected);
+        make_block(&b, h, TIER_EDGE);
+        b.tierPoWResult.challenge.complexity = 12;
+        b.tierPoWResult.time_taken = 0.25;
+        if (pkc_chain_append(&w, &b, NULL) != OP_SUCCESS) mined = OP_INVALID_STATE;
+    }
+    make_block(&b, 3, TIER_EDGE);
+    b.tierPoWResult.challenge.complexity = 12;
+    b.tierPoWResult.time_taken = 1000.0;
+    OpStatus_t lost = pkc_chain_append(&w, &b, NULL);
+    pkc_chain_tip_copy(&w, &tip);
+    printf("Retarget: edge complexity %u after three solves (expected %u), loser %s\n",
+           pkc_chain_tip_complexity(&tip, TIER_EDGE), expected, lost == OP_INVALID_STATE ? "rejected" : "ACCEPTED");
+    if (mined != OP_SUCCESS || lost != OP_INVALID_STATE || pkc_chain_tip_complexity(&tip, TIER_EDGE) != expected ||
+        expected == 12) rc = 1;
+    pkc_chain_writer_stop(&w);
+    if (chain->EdgeComplexity != expected) rc = 1;
+
+    // --- A batch that fails to persist is not committed, and intake stops ---
+    reset_chain(chain);
+    uint32_t fail_at = 3;
+    pkc_chain_writer_config_t failing = { .persist = failing_persist, .persist_ctx = &fail_at };
+    if (pkc_chain_writer_start(&w, chain, &failing) != OP_SUCCESS) return 1;
+    OpStatus_t durable = OP_SUCCESS;
+    for (uint64_t h = 1; h < fail_at; ++h) {
+        make_block(&b, h, TIER_SERVER);
+        if (pkc_chain_append(&w, &b, NULL) != OP_SUCCESS) durable = OP_INVALID_STATE;
+    }
+    make_block(&b, fail_at, TIER_EDGE);
+    const OpStatus_t lost_write = pkc_chain_append(&w, &b, NULL);
+    const OpStatus_t after = pkc_chain_submit(&w, &b, NULL);
+    pkc_chain_tip_copy(&w, &tip);
+    const OpStatus_t failed = pkc_chain_writer_failed(&w);
+    pkc_chain_writer_stop(&w);
+    printf("Persist failure: ticket %s, tip %u, chain index %u, later submit %s\n",
+           lost_write == OP_INVALID_STATE ? "failed" : "COMMITTED", tip.index, chain->index,
+           after == OP_INVALID_STATE ? "refused" : "ACCEPTED");
+    if (durable != OP_SUCCESS || lost_write != OP_INVALID_STATE || after != OP_INVALID_STATE ||
+        failed != OP_INVALID_STATE || tip.index != fail_at || chain->index != fail_at ||
+        chain->lastEdgeBlockIndex != 0 || chain->lastServerBlockIndex != fail_at - 1)
+        rc = 1;
+
+    // --- Without a writer, pkc_chain_apply is the same step in place ---
+    reset_chain(chain);
+    make_block(&b, 1, TIER_EDGE);
+    if (pkc_chain_apply(chain, &b, false) != OP_SUCCESS || chain->index != 2 || chain->lastEdgeBlockIndex != 1) rc = 1;
+
+    // --- require_pow: the chain's own link, challenge and difficulty only ---
+    reset_chain(chain);
+    chain->EdgeComplexity = 6;
+    block good;
+    make_block(&good, 1, TIER_EDGE);
+    block_link_hash(&chain->blocks[0], &good.prevHash);
+    generate_tier_pow_challenge(&chain->blocks[0], 6, &good.tierPoWResult.challenge);
+    mine(&good);
+    block unlinked = good, easier = good, own = good;
+    unlinked.prevHash.w[0] ^= 1;
+    generate_tier_pow_challenge(&chain->blocks[0], 2, &easier.tierPoWResult.challenge);
+    mine(&easier);
+    tier_pow_challenge_set_challenge(&own.tierPoWResult.challenge, &own.CurrentCertHash);
+    mine(&own);
+    const OpStatus_t pow_unlinked = pkc_chain_validate(chain, &unlinked, true);
+    const OpStatus_t pow_easier = pkc_chain_validate(chain, &easier, true);
+    const OpStatus_t pow_own = pkc_chain_validate(chain, &own, true);
+    const OpStatus_t pow_good = pkc_chain_apply(chain, &good, true);
+    printf("require_pow: issued %s, bad link %s, lower complexity %s, own challenge %s\n",
+           pow_good == OP_SUCCESS ? "accepted" : "REJECTED",
+           pow_unlinked == OP_INVALID_INPUT ? "rejected" : "ACCEPTED",
+           pow_easier == OP_INVALID_INPUT ? "rejected" : "ACCEPTED",
+           pow_own == OP_INVALID_INPUT ? "rejected" : "ACCEPTED");
+    if (pow_good != OP_SUCCESS || pow_unlinked != OP_INVALID_INPUT || pow_easier != OP_INVALID_INPUT ||
+        pow_own != OP_INVALID_INPUT)
+        rc = 1;
+
+    free(chain);
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
@@ -12,10 +12,17 @@ int main() {
     printf("Initializing MiniPoW Manager framework...\n");
     
     uint32_t sessionID = 101;
+
+    // Optional per-iteration trace: PKC_TRACE_FILE=<path> dumps it as text at the end.
+    const char *trace_path = getenv("PKC_TRACE_FILE");
+    pkc_trace_recorder_t trace;
+    bool tracing = trace_path && pkc_trace_start(&trace, trace_path, 0, PKC_TRACE_SINK_BINARY) == OP_SUCCESS;
     
     // 1. Manager state initialization
     MiniPoWManagerTracker manager;
     minipow_manager_tracker_init(&manager, sessionID);
+    mini_pow_timing_t timing;
+    mini_pow_timing_init(&timing);
     
     // 2. Queues for asynchronous simulation
     mini_pow_challenge_queue_t sendQueue;
@@ -38,6 +45,22 @@ int main() {
         return 1;
     }
     
+    // RTT baseline: the miner ACKs these probes without computing anything.
+    mini_pow_rtt_baseline_t rtt;
+    mini_pow_rtt_baseline_init(&rtt);
+    for (uint32_t p = 0; p < 8; ++p) {
+        mini_pow_rtt_probe_send(&rtt);
+        MiniPoW_ACK probe = { .sessionID = sessionID, .challengeID = 0, .ACK = true };
+        if (probe.ACK) mini_pow_rtt_probe_ack(&rtt);
+    }
+
+    mini_pow_classify_config_t classifyCfg;
+    mini_pow_classify_config_default(&classifyCfg);
+    const char *cfg_path = getenv("PKC_MINIPOW_CLASSIFY_CFG");
+    if (cfg_path && mini_pow_classify_config_load(cfg_path, &classifyCfg) != OP_SUCCESS) {
+        printf("Ignoring invalid classifier config %s\n", cfg_path);
+    }
+
     printf("Starting Session %u (Iterations: %u)\n", sessionID, MINI_POW_MATRIX_N);
     
     for (uint32_t i = 0; i < MINI_POW_MATRIX_N; ++i) {
@@ -74,7 +97,7 @@ int main() {
                 // --- MANAGER ---
                 // Process the ACK and track duration
                 if (ack.ACK && ack.sessionID == sessionID && ack.challengeID == challengeID) {
-                    minipow_manager_receive_ack(&manager);
+                    minipow_manager_receive_ack(&manager, &timing);
                 }
             } else {
                 // Final iteration: Return entire solved matrix (no simple ACK)
@@ -85,15 +108,25 @@ int main() {
                 memcpy(solvedMatrix->Matrix, receiverSolve->resultMatrix, sizeof(solvedMatrix->Matrix));
                 
                 // --- MANAGER ---
-                minipow_manager_receive_ack(&manager); // Log final duration
+                minipow_manager_receive_ack(&manager, &timing); // Log final duration
                 
-                mini_pow_result result = minipow_manager_finalize(&manager, solvedMatrix, matrices);
+                mini_pow_classification_t cls;
+                mini_pow_result result = minipow_manager_finalize_ex(&manager, &timing, &rtt, &classifyCfg,
+                                                                     solvedMatrix, matrices, &cls);
                 
                 printf("\n--- mini_pow_result ---\n");
                 printf("Session ID: %u\n", result.sessionid);
                 printf("Challenge ID: %u\n", result.challengeid);
                 printf("Is Valid: %s\n", result.isValid ? "true" : "false");
                 printf("Tier: %d\n", result.tier);
+                printf("Iteration ns: min %llu, median %llu, p99 %llu (clock: %s)\n",
+                       (unsigned long long)timing.min_ns, (unsigned long long)timing.median_ns,
+                       (unsigned long long)timing.p99_ns,
+                       pkc_clock_backend() == PKC_CLOCK_BACKEND_TSC ? "tsc" : "clock_gettime");
+                printf("Classifier: estimate %llu ns, CI [%llu, %llu], confidence %.2f, rtt %llu ns, rejected %u\n",
+                       (unsigned long long)cls.estimate_ns, (unsigned long long)cls.ci_low_ns,
+                       (unsigned long long)cls.ci_high_ns, cls.confidence,
+                       (unsigned long long)cls.rtt_baseline_ns, cls.samples_rejected);
 
                 // printf("\nMatrix A (%dx%d):\n", MINI_POW_MATRIX_N, MINI_POW_MATRIX_N);
                 // for(size_t r=0; r<MINI_POW_MATRIX_N; ++r) {
@@ -130,6 +163,12 @@ int main() {
     
     free(receiverSolve);
     free(matrices);
+
+    if (tracing) {
+        pkc_trace_stop(&trace);
+        printf("\n--- trace (%llu dropped) ---\n", (unsigned long long)pkc_trace_dropped(&trace));
+        pkc_trace_dump_text(trace_path, stdout);
+    }
     
     return 0;
 }
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Proofs/MiniPoW/miniPoWManager_ops.h"
+#include "protocol/proofs/mini_pow/mini_pow_challenge_queue_t.h"
+#include "protocol/proofs/mini_pow/mini_pow_challenge_receive_queue_t.h"
+#include "protocol/proofs/mini_pow/mini_pow_Solve_t.h"
+#include "protocol/proofs/mini_pow/mini_pow_Matrix_t.h"
+
+/*
+ * Same session as test_minipow_manager.c but pipelined: the manager keeps
+ * up to PKC_MINIPOW_WINDOW (default MINI_POW_WINDOW_DEFAULT) challenges in
+ * flight and the miner drains them in order.
+ */
+int main() {
+    printf("Initializing pipelined MiniPoW session...\n");
+
+    uint32_t sessionID = 202;
+    uint32_t baseChallengeID = 1000;
+    uint32_t windowSize = MINI_POW_WINDOW_DEFAULT;
+    const char *window_env = getenv("PKC_MINIPOW_WINDOW");
+    if (window_env) windowSize = (uint32_t)strtoul(window_env, NULL, 10);
+
+    MiniPoWManagerTracker manager;
+    minipow_manager_tracker_init(&manager, sessionID);
+    mini_pow_timing_t timing;
+    mini_pow_timing_init(&timing);
+    mini_pow_window_t window;
+    if (minipow_manager_window_begin(&manager, &window, baseChallengeID, windowSize) != OP_SUCCESS) {
+        printf("Invalid window size %u (max %u)\n", windowSize, MINI_POW_WINDOW_MAX);
+        return 1;
+    }
+
+    mini_pow_challenge_queue_t sendQueue;
+    mini_pow_challenge_queue_init(&sendQueue);
+
+    mini_pow_solve_t *receiverSolve = calloc(1, sizeof(mini_pow_solve_t));
+    mini_pow_solve_init(receiverSolve);
+
+    mini_pow_Matrix *matrices = calloc(1, sizeof(mini_pow_Matrix));
+    certificate dummy_cert;
+    memset(&dummy_cert, 0, sizeof(dummy_cert));
+    uint256 dummy_hash;
+    memset(&dummy_hash, 0, sizeof(dummy_hash));
+
+    if (construct_mini_pow_matrices(&dummy_cert, &dummy_hash, sessionID, 12345, matrices) != OP_SUCCESS) {
+        printf("Failed to generate matrices natively!\n");
+        return 1;
+    }
+
+    printf("Starting Session %u (Iterations: %u, window: %u)\n", sessionID, MINI_POW_MATRIX_N, windowSize);
+
+    uint64_t session_start = mini_pow_tracker_get_current_ns();
+    uint32_t maxInFlight = 0;
+    int rc = 0;
+
+    while (!mini_pow_window_done(&window)) {
+        // --- SENDER (Manager): top the window up ---
+        while (mini_pow_window_can_send(&window)) {
+            uint32_t i, challengeID;
+            if (minipow_manager_window_send(&manager, &window, &i, &challengeID) != OP_SUCCESS) break;
+
+            mini_pow_challenge_t challenge;
+            mini_pow_challenge_init(&challenge);
+            challenge.challenge_id = challengeID;
+            challenge.session_id = sessionID;
+            challenge.iteration = i;
+            for (size_t k = 0; k < MINI_POW_MATRIX_N; ++k) {
+                challenge.columnOfA[k] = matrices->A[k][i];
+                challenge.rowOfB[k] = matrices->B[i][k];
+            }
+            if (mini_pow_challenge_queue_add(&sendQueue, &challenge) != OP_SUCCESS) {
+                printf("Error: send queue full at iteration %u\n", i);
+                rc = 1;
+                goto done;
+            }
+        }
+        if (mini_pow_window_in_flight(&window) > maxInFlight) maxInFlight = mini_pow_window_in_flight(&window);
+
+        // --- RECEIVER (Miner): oldest outstanding challenge first ---
+        uint32_t challengeID = mini_pow_window_challenge_id(&window, window.acked);
+        mini_pow_challenge_t receivedChallenge;
+        if (mini_pow_challenge_queue_take(&sendQueue, challengeID, &receivedChallenge) != OP_SUCCESS) {
+            printf("Error: Challenge %u not found in queue.\n", challengeID);
+            rc = 1;
+            break;
+        }
+        mini_pow_solve_update(receiverSolve, &receivedChallenge);
+
+        MiniPoW_ACK ack = { .sessionID = sessionID, .challengeID = challengeID, .ACK = true };
+
+        // --- MANAGER ---
+        if (!ack.ACK || ack.sessionID != sessionID ||
+            minipow_manager_window_ack(&manager, &window, &timing, ack.challengeID) != OP_SUCCESS) {
+            printf("Error: ACK for challenge %u rejected.\n", challengeID);
+            rc = 1;
+            break;
+        }
+    }
+
+    if (rc == 0) {
+        uint64_t session_ns = mini_pow_tracker_get_current_ns() - session_start;
+
+        SolvedMatricPoW *solvedMatrix = calloc(1, sizeof(SolvedMatricPoW));
+        solved_matric_pow_init(solvedMatrix);
+        solvedMatrix->session_id = sessionID;
+        solvedMatrix->challenge_id = mini_pow_window_challenge_id(&window, MINI_POW_MATRIX_N - 1);
+        memcpy(solvedMatrix->Matrix, receiverSolve->resultMatrix, sizeof(solvedMatrix->Matrix));
+
+        // Service times already exclude the wire, so no RTT baseline here.
+        mini_pow_classification_t cls;
+        mini_pow_result result = minipow_manager_finalize_ex(&manager, &timing, NULL, NULL,
+                                                             solvedMatrix, matrices, &cls);
+
+        printf("\n--- mini_pow_result (pipelined) ---\n");
+        printf("Session ID: %u\n", result.sessionid);
+        printf("Challenge ID: %u\n", result.challengeid);
+        printf("Is Valid: %s\n", result.isValid ? "true" : "false");
+        printf("Tier: %d\n", result.tier);
+        printf("Max in flight: %u, samples: %u, session %.3f ms\n",
+               maxInFlight, timing.count, (double)session_ns / 1e6);
+        printf("Service ns: min %llu, median %llu, p99 %llu\n",
+               (unsigned long long)timing.min_ns, (unsigned long long)timing.median_ns,
+               (unsigned long long)timing.p99_ns);
+        printf("-----------------------\n");
+
+        if (!result.isValid || timing.count != MINI_POW_MATRIX_N - 1) rc = 1;
+        free(solvedMatrix);
+    }
+
+done:
+    free(receiverSolve);
+    free(matrices);
+    return rc;
+}
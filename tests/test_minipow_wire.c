@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Proofs/MiniPoW/miniPoWManager_ops.h"
+#include "Proofs/MiniPoW/miniPoWMatrix_ops.h"
+#include "Proofs/MiniPoW/miniPoWSolve_ops.h"
+#include "Proofs/MiniPoW/miniPoWWire_ops.h"
+
+/*
+ * Compact transport round trip: seed-only challenges, Merkle commitment
+ * of the solved matrix, Fiat-Shamir spot checks.
+ */
+int main() {
+    printf("Initializing compact MiniPoW wire test...\n");
+
+    uint32_t sessionID = 303;
+    uint32_t challengeID = 12345;
+    int rc = 0;
+
+    mini_pow_Matrix *matrices = calloc(1, sizeof(mini_pow_Matrix));
+    mini_pow_solve_t *solve = calloc(1, sizeof(mini_pow_solve_t));
+    mini_pow_merkle_tree_t *tree = calloc(1, sizeof(mini_pow_merkle_tree_t));
+    mini_pow_row_opening_t *openings = calloc(MINI_POW_SPOT_CHECKS, sizeof(mini_pow_row_opening_t));
+    if (!matrices || !solve || !tree || !openings) return 1;
+
+    certificate dummy_cert;
+    memset(&dummy_cert, 0, sizeof(dummy_cert));
+    uint256 dummy_hash;
+    memset(&dummy_hash, 0, sizeof(dummy_hash));
+    if (construct_mini_pow_matrices(&dummy_cert, &dummy_hash, sessionID, challengeID, matrices) != OP_SUCCESS) {
+        printf("Failed to generate matrices natively!\n");
+        return 1;
+    }
+    mini_pow_solve_init(solve);
+
+    // --- Challenges: 48 bytes on the wire instead of ~4 KB ---
+    uint8_t wire_buf[MINI_POW_CHALLENGE_WIRE_SIZE];
+    for (uint32_t i = 0; i < MINI_POW_MATRIX_N; ++i) {
+        mini_pow_challenge_wire_t wire, received;
+        mini_pow_challenge_wire_pack(&wire, &matrices->seed, sessionID, challengeID + i, i);
+        mini_pow_challenge_wire_serialize(&wire, wire_buf, sizeof(wire_buf));
+        if (mini_pow_challenge_wire_deserialize(wire_buf, sizeof(wire_buf), &received) != OP_SUCCESS) {
+            printf("Error: challenge %u failed to deserialize\n", i);
+            rc = 1;
+            break;
+        }
+
+        mini_pow_challenge_t challenge;
+        mini_pow_challenge_expand(&received, &challenge);
+        if (i == 0 || i == MINI_POW_MATRIX_N - 1) {
+            for (uint32_t k = 0; k < MINI_POW_MATRIX_N; ++k) {
+                if (challenge.columnOfA[k] != matrices->A[k][i] || challenge.rowOfB[k] != matrices->B[i][k]) {
+                    printf("Error: expanded challenge %u differs from the matrices at k=%u\n", i, k);
+                    rc = 1;
+                    break;
+                }
+            }
+        }
+        mini_pow_solve_update(solve, &challenge);
+    }
+
+    // --- Miner commits, verifier picks rows, miner opens them ---
+    mini_pow_merkle_build(tree, (const uint32_t (*)[MINI_POW_MATRIX_N])solve->resultMatrix);
+    mini_pow_solved_commit_t commit, commit_rx;
+    uint8_t commit_buf[MINI_POW_COMMIT_WIRE_SIZE];
+    mini_pow_solved_commit(&commit, tree, sessionID, challengeID);
+    mini_pow_solved_commit_serialize(&commit, commit_buf, sizeof(commit_buf));
+    mini_pow_solved_commit_deserialize(commit_buf, sizeof(commit_buf), &commit_rx);
+
+    mini_pow_spot_check_t check;
+    mini_pow_spot_check_begin(&check, &matrices->seed, &commit_rx, MINI_POW_SPOT_CHECKS);
+
+    uint8_t *open_buf = malloc(MINI_POW_OPENING_WIRE_SIZE);
+    for (uint32_t j = 0; j < check.count; ++j) {
+        mini_pow_row_opening_t op = {0};
+        mini_pow_merkle_open(tree, (const uint32_t (*)[MINI_POW_MATRIX_N])solve->resultMatrix, check.rows[j], &op);
+        mini_pow_row_opening_serialize(&op, open_buf, MINI_POW_OPENING_WIRE_SIZE);
+        mini_pow_row_opening_deserialize(open_buf, MINI_POW_OPENING_WIRE_SIZE, &openings[j]);
+    }
+
+    bool valid = mini_pow_spot_check_verify(&check, openings, check.count);
+    printf("Honest miner: %s (%u rows, %zu bytes per opening)\n", valid ? "accepted" : "rejected",
+           check.count, (size_t)MINI_POW_OPENING_WIRE_SIZE);
+    if (!valid) rc = 1;
+
+    // A tampered opening no longer matches the root.
+    openings[0].values[7] ^= 1u;
+    valid = mini_pow_spot_check_verify(&check, openings, check.count);
+    printf("Tampered opening: %s\n", valid ? "accepted" : "rejected");
+    if (valid) rc = 1;
+
+    // A miner that commits to a wrong matrix fails the recomputation.
+    for (uint32_t r = 0; r < MINI_POW_MATRIX_N; ++r) solve->resultMatrix[r][r] += 1;
+    mini_pow_merkle_build(tree, (const uint32_t (*)[MINI_POW_MATRIX_N])solve->resultMatrix);
+    mini_pow_solved_commit(&commit, tree, sessionID, challengeID);
+    mini_pow_spot_check_begin(&check, &matrices->seed, &commit, MINI_POW_SPOT_CHECKS);
+    for (uint32_t j = 0; j < check.count; ++j) {
+        mini_pow_merkle_open(tree, (const uint32_t (*)[MINI_POW_MATRIX_N])solve->resultMatrix, check.rows[j], &openings[j]);
+    }
+    valid = mini_pow_spot_check_verify(&check, openings, check.count);
+    printf("Wrong matrix: %s\n", valid ? "accepted" : "rejected");
+    if (valid) rc = 1;
+
+    free(open_buf);
+    free(openings);
+    free(tree);
+    free(solve);
+    free(matrices);
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
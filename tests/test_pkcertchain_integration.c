@@ -9,6 +9,8 @@
 #include "protocol/proofs/mini_pow/MiniPoW_ACK.h"
 #include "system/utilities.h"
 #include "crypto/SeedUtil.h"
+#include "Proofs/MiniPoW/miniPoWArena_ops.h"
+#include "Proofs/MiniPoW/miniPoWMatrixCache_ops.h"
 
 int main() {
     printf("--- PKCertChain & MiniPoW Integration Simulation ---\n\n");
@@ -31,6 +33,22 @@ int main() {
     
     MiniPoWManagerTracker manager;
     minipow_manager_tracker_init(&manager, current_session_id);
+    mini_pow_timing_t timing;
+
+    // Session working sets come from a prefaulted arena instead of calloc.
+    mini_pow_arena_t arena;
+    if (mini_pow_arena_init(&arena, 1) != OP_SUCCESS) {
+        printf("Failed to map the MiniPoW session arena.\n");
+        return 1;
+    }
+    printf("MiniPoW arena ready (%s pages).\n", mini_pow_arena_huge(&arena) ? "huge" : "THP-advised");
+
+    // Challenge sending and final verification share one generated matrix pair.
+    mini_pow_matrix_cache_t matrixCache;
+    if (mini_pow_matrix_cache_init(&matrixCache, sizeof(mini_pow_Matrix), &arena) != OP_SUCCESS) {
+        printf("Failed to initialise the MiniPoW matrix cache.\n");
+        return 1;
+    }
 
     for (int node_idx = 1; node_idx <= 3; ++node_idx) {
         printf("\n======================================================\n");
@@ -73,18 +91,23 @@ int main() {
         
         // MiniPow Matrix generation
         printf("Generating Constraints Matrices (CSPRNG)...\n");
-        mini_pow_Matrix *matrices = calloc(1, sizeof(mini_pow_Matrix));
-        if (construct_mini_pow_matrices(&cert, &active_block_hash, current_session_id, challengeID, matrices) != OP_SUCCESS) {
+        const mini_pow_Matrix *matrices = NULL;
+        if (mini_pow_matrix_cache_acquire(&matrixCache, &cert, &active_block_hash, current_session_id, challengeID, &matrices) != OP_SUCCESS) {
             printf("Matrix generation failed.\n");
             return 1;
         }
         
+        mini_pow_timing_init(&timing);
+
         // Setup Queues and Miner Solvers
         mini_pow_challenge_queue_t sendQueue;
         mini_pow_challenge_queue_init(&sendQueue);
         
-        mini_pow_solve_t receiverSolve;
-        mini_pow_solve_init(&receiverSolve);
+        mini_pow_solve_t *receiverSolve = mini_pow_arena_solve(&arena);
+        if (!receiverSolve) {
+            printf("Session arena exhausted.\n");
+            return 1;
+        }
         
         printf("Starting Miner Work Loop...\n");
         
@@ -108,28 +131,32 @@ int main() {
             // Miner Receives
             mini_pow_challenge_t rx_ch;
             if (mini_pow_challenge_queue_take(&sendQueue, challengeID, &rx_ch) == OP_SUCCESS) {
-                mini_pow_solve_update(&receiverSolve, &rx_ch);
+                mini_pow_solve_update(receiverSolve, &rx_ch);
                 
                 // Miner explicit ACK
                 MiniPoW_ACK ack = { .sessionID = current_session_id, .challengeID = challengeID, .ACK = true };
                 
                 // Manager explicitly receives
                 if (ack.ACK && ack.sessionID == current_session_id && ack.challengeID == challengeID) {
-                    minipow_manager_receive_ack(&manager);
+                    minipow_manager_receive_ack(&manager, &timing);
                 }
             } else {
                  printf("Queue fetch miss!\n");
             }
         }
         
-        SolvedMatricPoW *solvedMatrix = calloc(1, sizeof(SolvedMatricPoW));
-        solved_matric_pow_init(solvedMatrix);
+        // Matrix is fully overwritten below, so the slab is not zeroed.
+        SolvedMatricPoW *solvedMatrix = mini_pow_arena_solved(&arena);
+        if (!solvedMatrix) {
+            printf("Session arena exhausted.\n");
+            return 1;
+        }
         solvedMatrix->session_id = current_session_id;
         solvedMatrix->challenge_id = challengeID;
-        memcpy(solvedMatrix->Matrix, receiverSolve.resultMatrix, sizeof(solvedMatrix->Matrix));
+        memcpy(solvedMatrix->Matrix, receiverSolve->resultMatrix, sizeof(solvedMatrix->Matrix));
         
         // pkcertchain verification pipeline
-        mini_pow_result result = minipow_manager_finalize(&manager, solvedMatrix, matrices);
+        mini_pow_result result = minipow_manager_finalize(&manager, &timing, solvedMatrix, matrices);
         
         printf("\n--- Validation & Result for Node %d ---\n", node_idx);
         printf("Is Valid: %s\n", result.isValid ? "true" : "false");
@@ -138,7 +165,7 @@ int main() {
         
         // Blockchain State mapping locally
         if (result.isValid) {
-            double elapsed = manager.timeTracker.cumulative_duration / 1000000.0;
+            double elapsed = manager.timeTracker.cumulative_duration / 1000000000.0;
             if (chain.avg_solve_time_seconds > 0) {
                 chain.avg_solve_time_seconds = (chain.avg_solve_time_seconds + elapsed) / 2.0;
             } else {
@@ -147,10 +174,16 @@ int main() {
         }
         printf("Updated Chain Avg Solve Time: %.6f seconds\n", chain.avg_solve_time_seconds);
         
-        // Clean up matrices for iteration
-        free(solvedMatrix);
-        free(matrices);
+        // Hand the slabs back for the next session
+        mini_pow_arena_free(&arena, MINI_POW_SLAB_SOLVED, solvedMatrix);
+        mini_pow_arena_free(&arena, MINI_POW_SLAB_SOLVE, receiverSolve);
+        mini_pow_matrix_cache_release(&matrixCache, matrices);
     }
+    printf("Matrix cache: %llu hits, %llu misses, %llu evictions, %llu invalidations\n",
+           (unsigned long long)matrixCache.hits, (unsigned long long)matrixCache.misses,
+           (unsigned long long)matrixCache.evictions, (unsigned long long)matrixCache.invalidations);
+    mini_pow_matrix_cache_destroy(&matrixCache);
+    mini_pow_arena_destroy(&arena);
     
     printf("\n======================================================\n");
     printf("Integration Simulation Completed Successfully.\n");
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "Proofs/TierPoW/tierPoWChallenge_ops.h"
+#include "Proofs/TierPoW/tierPoWSolve_ops.h"
+#include "Proofs/TierPoW/tierPoWVerify_ops.h"
+#include "Proofs/TierPoW/tierPoWDifficulty_ops.h"
+
+/*
+ * 256-bit target mode: compact encoding, the limb compare kernel against
+ * a byte-wise reference, and a solve/verify round trip at a fractional
+ * complexity. Leading-zero challenges must behave exactly as before.
+ */
+
+static int reference_less(const uint256 *hash, uint32_t bits)
+{
+    uint8_t h[UINT256_SIZE], t[UINT256_SIZE];
+    uint256_serialize_be(hash, h, UINT256_SIZE);
+    memset(t, 0, sizeof(t));
+    uint8_t e, m[3];
+    tier_pow_target_bits_unpack(bits, &e, m);
+    for (int i = 0; i < 3; ++i) {
+        int idx = UINT256_SIZE - e + i;
+        if (idx >= 0 && idx < UINT256_SIZE) t[idx] = m[i];
+    }
+    return memcmp(h, t, UINT256_SIZE) < 0;
+}
+
+int main() {
+    printf("Initializing TierPoW target mode test...\n");
+    int rc = 0;
+
+    // --- Compact encoding: complexity -> bits -> work ---
+    double worst = 0.0;
+    for (double c = 0.0; c <= TIER_POW_TARGET_COMPLEXITY_MAX; c += 0.37) {
+        uint32_t bits = tier_pow_target_from_complexity(c);
+        tier_pow_target_t t;
+        if (tier_pow_target_expand(bits, &t) != OP_SUCCESS) {
+            printf("FAIL: complexity %.2f encodes to invalid bits %08x\n", c, bits);
+            rc = 1;
+            break;
+        }
+        double err = fabs(tier_pow_target_complexity(bits) - c);
+        if (err > worst) worst = err;
+    }
+    printf("Compact round trip: worst error %.2e bits\n", worst);
+    if (worst > 1e-4) rc = 1;
+    if (tier_pow_target_bits_valid(0x21000001u) || tier_pow_target_bits_valid(0x1d000000u)) {
+        printf("FAIL: out-of-range bits accepted\n");
+        rc = 1;
+    }
+
+    // --- Compare kernel vs byte-wise reference, including near-ties ---
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < 200000; ++i) {
+        uint256 h;
+        uint8_t seed[8];
+        serialize_u64_be(i, seed);
+        hash256_buffer(seed, sizeof(seed), &h);
+        uint32_t bits = tier_pow_target_from_complexity((double)(i % 64) * 0.25);
+        if (i % 7 == 0) {
+            // Same top limb as the target forces the tie path.
+            tier_pow_target_t t;
+            tier_pow_target_expand(bits, &t);
+            uint8_t be[UINT256_SIZE];
+            uint256_serialize_be(&h, be, UINT256_SIZE);
+            serialize_u64_be(t.limb[0], be);
+            uint256_deserialize_be(be, UINT256_SIZE, &h);
+        }
+        tier_pow_target_t t;
+        tier_pow_target_expand(bits, &t);
+        if (tier_pow_check_target_met(&h, &t) != reference_less(&h, bits)) mismatches++;
+    }
+    printf("Compare kernel: %u mismatches vs reference\n", mismatches);
+    if (mismatches) rc = 1;
+
+    // --- Solve / verify in target mode at complexity 9.6 ---
+    const uint32_t bits = tier_pow_target_from_complexity(9.6);
+    tier_pow_challenge_t challenge;
+    double hashes = 0.0;
+    const int rounds = 64;
+    for (int r = 0; r < rounds; ++r) {
+        tier_pow_challenge_init(&challenge);
+        uint8_t seed[8];
+        serialize_u64_be(0xC0FFEE00u + r, seed);
+        hash256_buffer(seed, sizeof(seed), &challenge.challenge);
+        tier_pow_challenge_set_challenge_id(&challenge, 77 + r);
+        tier_pow_challenge_set_target_bits(&challenge, bits);
+
+        tier_pow_solve_t solve;
+        tier_pow_solve_init(&solve);
+        tier_pow_solve_t *solve_ptr = &solve;
+        tier_pow_solve_challenge(&challenge, &solve_ptr);
+        if (!solve_ptr || !isValidTierChallenge(&challenge, &solve) || tier_pow_solve_get_target_bits(&solve) != bits) {
+            printf("FAIL: target solve %d not accepted\n", r);
+            rc = 1;
+            break;
+        }
+        hashes += (double)solve.nonce + 1.0;
+    }
+    double expected = exp2(tier_pow_target_work_log2(bits));
+    printf("Target solves: mean %.0f hashes, expected %.0f\n", hashes / rounds, expected);
+    if (hashes / rounds < expected / 2.0 || hashes / rounds > expected * 2.0) rc = 1;
+
+    // --- Leading-zero challenges are untouched ---
+    tier_pow_challenge_t legacy;
+    tier_pow_challenge_init(&legacy);
+    legacy.challenge = challenge.challenge;
+    tier_pow_challenge_set_complexity(&legacy, 6);
+    tier_pow_solve_t legacy_solve;
+    tier_pow_solve_init(&legacy_solve);
+    tier_pow_solve_t *legacy_ptr = &legacy_solve;
+    tier_pow_solve_challenge(&legacy, &legacy_ptr);
+    if (!legacy_ptr || tier_pow_challenge_is_target(&legacy) || !isValidTierChallenge(&legacy, &legacy_solve)) {
+        printf("FAIL: leading-zero challenge broken\n");
+        rc = 1;
+    }
+
+    // --- Controller issues fractional targets ---
+    tier_pow_difficulty_config_t cfg;
+    tier_pow_difficulty_config_default(&cfg);
+    cfg.version = TIER_POW_VERSION_TARGET;
+    tier_pow_difficulty_t ctl;
+    tier_pow_difficulty_init(&ctl, &cfg);
+    uint32_t cur = tier_pow_difficulty_target_bits(&ctl, TIER_DESKTOP, 30);
+    const double rate = 1e7 * 1.3;  // c* = log2(600 * rate) - 2, not a whole bit
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    double tail = 0.0;
+    for (int b = 0; b < 400; ++b) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        double u = ((x >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+        double secs = -log(u) * exp2(tier_pow_target_work_log2(cur)) / rate;
+        tier_pow_difficulty_observe_target(&ctl, TIER_DESKTOP, cur, secs, &cur);
+        if (b >= 300) tail += tier_pow_target_complexity(cur);
+    }
+    double ideal = log2(600.0 * rate) - 2.0;
+    printf("Controller: mean complexity %.3f over the last 100 solves, ideal %.3f\n", tail / 100.0, ideal);
+    if (fabs(tail / 100.0 - ideal) > 0.25) rc = 1;
+
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}
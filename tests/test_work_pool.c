@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "scheduler/workPool_ops.h"
+#include "Proofs/MiniPoW/miniPoWMatrix_ops.h"
+#include "Proofs/MiniPoW/miniPoWVerifyParallel_ops.h"
+#include "Proofs/TierPoW/tierPoWSolveParallel_ops.h"
+#include "Proofs/TierPoW/tierPoWVerify_ops.h"
+
+/*
+ * Work pool behaviour: priority classes, cancellation, nested fork/join
+ * on a single worker, stealing, and the PoW kernels running on the
+ * shared pool.
+ */
+
+typedef struct {
+    _Atomic(int) gate;
+    _Atomic(uint32_t) seq;
+    uint32_t order[16];
+    pkc_pool_prio_t prio[16];
+} order_log_t;
+
+typedef struct {
+    order_log_t *log;
+    pkc_pool_prio_t prio;
+} order_task_t;
+
+static void blocker(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)cancel;
+    order_log_t *log = (order_log_t *)arg;
+    while (!atomic_load(&log->gate)) sched_yield();
+}
+
+static void record(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)cancel;
+    order_task_t *t = (order_task_t *)arg;
+    uint32_t i = atomic_fetch_add(&t->log->seq, 1);
+    if (i < 16) t->log->prio[i] = t->prio;
+}
+
+static _Atomic(uint32_t) leaf_runs;
+
+static void leaf(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)arg;
+    (void)cancel;
+    atomic_fetch_add(&leaf_runs, 1);
+}
+
+static void parent(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    pkc_pool_fork_join((pkc_pool_t *)arg, PKC_POOL_PRIO_VALIDATE, 8, leaf, NULL, cancel);
+}
+
+static void spinner(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)arg;
+    (void)cancel;
+    volatile uint64_t x = 0;
+    for (uint32_t i = 0; i < 200000; ++i) x += i;
+    atomic_fetch_add(&leaf_runs, 1);
+}
+
+static void spawner(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    pkc_pool_fork_join((pkc_pool_t *)arg, PKC_POOL_PRIO_MINE, 64, spinner, NULL, cancel);
+}
+
+typedef struct {
+    pkc_pool_t *pool;
+    _Atomic(int) started;
+    _Atomic(int) verified;
+    int verified_while_mining;
+} preempt_log_t;
+
+static void preempt_verify(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)cancel;
+    atomic_store(&((preempt_log_t *)arg)->verified, 1);
+}
+
+// Long mining kernel: yields between "chunks" until the verify task ran.
+static void preempt_miner(void *arg, const pkc_pool_cancel_t *cancel)
+{
+    (void)cancel;
+    preempt_log_t *log = (preempt_log_t *)arg;
+    atomic_store(&log->started, 1);
+    for (uint32_t chunk = 0; chunk < 2000000 && !atomic_load(&log->verified); ++chunk) {
+        pkc_pool_yield(log->pool, PKC_POOL_PRIO_MINE);
+    }
+    log->verified_while_mining = atomic_load(&log->verified);
+}
+
+int main() {
+    printf("Initializing work pool test...\n");
+    int rc = 0;
+
+    // --- Priority: one worker, held busy while both classes queue up ---
+    pkc_pool_config_t cfg = { .threads = 1, .pin = false };
+    pkc_pool_t pool;
+    if (pkc_pool_init(&pool, &cfg) != OP_SUCCESS) return 1;
+
+    order_log_t log;
+    memset(&log, 0, sizeof(log));
+    pkc_pool_group_t group;
+    pkc_pool_group_init(&group, PKC_POOL_PRIO_MINE);
+    pkc_pool_submit(&pool, PKC_POOL_PRIO_VERIFY, blocker, &log, NULL, &group);
+    while (pkc_pool_queued(&pool) != 0) sched_yield();
+
+    order_task_t tasks[6];
+    for (int i = 0; i < 6; ++i) {
+        tasks[i].log = &log;
+        tasks[i].prio = i < 3 ? PKC_POOL_PRIO_MINE : PKC_POOL_PRIO_VERIFY;
+        pkc_pool_submit(&pool, tasks[i].prio, record, &tasks[i], NULL, &group);
+    }
+    atomic_store(&log.gate, 1);
+    while (atomic_load(&group.pending) != 0) sched_yield();
+    printf("Execution order:");
+    for (int i = 0; i < 6; ++i) {
+        printf(" %s", log.prio[i] == PKC_POOL_PRIO_VERIFY ? "verify" : "mine");
+        if ((i < 3) != (log.prio[i] == PKC_POOL_PRIO_VERIFY)) rc = 1;
+    }
+    printf("\n");
+
+    // --- Cancellation: queued tasks under a cancelled token are skipped ---
+    pkc_pool_cancel_t token;
+    pkc_pool_cancel_init(&token);
+    atomic_store(&log.gate, 0);
+    pkc_pool_group_init(&group, PKC_POOL_PRIO_MINE);
+    pkc_pool_submit(&pool, PKC_POOL_PRIO_VERIFY, blocker, &log, NULL, &group);
+    while (pkc_pool_queued(&pool) != 0) sched_yield();
+    atomic_store(&leaf_runs, 0);
+    for (int i = 0; i < 10; ++i) pkc_pool_submit(&pool, PKC_POOL_PRIO_MINE, leaf, NULL, &token, &group);
+    pkc_pool_cancel(&token);
+    atomic_store(&log.gate, 1);
+    pkc_pool_wait(&pool, &group);
+    printf("Cancelled tasks run: %u of 10\n", atomic_load(&leaf_runs));
+    if (atomic_load(&leaf_runs) != 0) rc = 1;
+
+    // --- Nested fork/join on a single worker must not deadlock ---
+    atomic_store(&leaf_runs, 0);
+    pkc_pool_group_init(&group, PKC_POOL_PRIO_MINE);
+    for (int i = 0; i < 4; ++i) pkc_pool_submit(&pool, PKC_POOL_PRIO_VALIDATE, parent, &pool, NULL, &group);
+    pkc_pool_wait(&pool, &group);
+    printf("Nested fork/join: %u leaves (expected 32)\n", atomic_load(&leaf_runs));
+    if (atomic_load(&leaf_runs) != 32) rc = 1;
+    pkc_pool_destroy(&pool);
+
+    // --- Stealing: one task fans out, idle workers take from its deque ---
+    cfg.threads = 4;
+    if (pkc_pool_init(&pool, &cfg) != OP_SUCCESS) return 1;
+    atomic_store(&leaf_runs, 0);
+    pkc_pool_group_init(&group, PKC_POOL_PRIO_MINE);
+    pkc_pool_submit(&pool, PKC_POOL_PRIO_MINE, spawner, &pool, NULL, &group);
+    pkc_pool_wait(&pool, &group);
+    uint64_t stolen = 0, executed = 0;
+    for (uint32_t w = 0; w < pkc_pool_workers(&pool); ++w) {
+        stolen += atomic_load(&pool.workers[w].stolen);
+        executed += atomic_load(&pool.workers[w].executed);
+    }
+    printf("Fan-out: %u leaves, %llu tasks on workers, %llu stolen, %u NUMA node(s)\n", atomic_load(&leaf_runs),
+           (unsigned long long)executed, (unsigned long long)stolen, pool.nodes);
+    if (atomic_load(&leaf_runs) != 64) rc = 1;
+    pkc_pool_destroy(&pool);
+
+    // --- Preemption: a verify queued behind a running miner on one worker ---
+    cfg.threads = 1;
+    if (pkc_pool_init(&pool, &cfg) != OP_SUCCESS) return 1;
+    preempt_log_t plog = { .pool = &pool };
+    pkc_pool_group_init(&group, PKC_POOL_PRIO_MINE);
+    pkc_pool_submit(&pool, PKC_POOL_PRIO_MINE, preempt_miner, &plog, NULL, &group);
+    while (!atomic_load(&plog.started)) sched_yield();
+    pkc_pool_submit(&pool, PKC_POOL_PRIO_VERIFY, preempt_verify, &plog, NULL, &group);
+    // Not pkc_pool_wait: this thread must not pick the verify task up itself.
+    while (atomic_load(&group.pending) != 0) sched_yield();
+    printf("Preemption: verify %s the miner\n", plog.verified_while_mining ? "ran inside" : "waited for");
+    if (!plog.verified_while_mining) rc = 1;
+    pkc_pool_destroy(&pool);
+
+    // --- PoW kernels on the shared pool ---
+    mini_pow_Matrix *matrices = calloc(1, sizeof(mini_pow_Matrix));
+    SolvedMatricPoW *solved = calloc(1, sizeof(SolvedMatricPoW));
+    if (!matrices || !solved) return 1;
+    certificate dummy_cert;
+    memset(&dummy_cert, 0, sizeof(dummy_cert));
+    uint256 dummy_hash;
+    memset(&dummy_hash, 0, sizeof(dummy_hash));
+    construct_mini_pow_matrices(&dummy_cert, &dummy_hash, 3, 9, matrices);
+    uint32_t acc[MINI_POW_MATRIX_N];
+    for (uint32_t r = 0; r < MINI_POW_MATRIX_N; ++r) {
+        mini_pow_verify_row(matrices, solved, r, acc);
+        memcpy(solved->Matrix[r], acc, sizeof(acc));
+    }
+    bool ok = mini_pow_verify_parallel(solved, matrices, 0, NULL);
+    solved->Matrix[500][500] ^= 1u;
+    mini_pow_verify_report_t report;
+    bool bad = mini_pow_verify_parallel(solved, matrices, 0, &report);
+    printf("MiniPoW verify on pool (%u workers): valid %s, corrupt rejected at (%u, %u)\n",
+           pkc_pool_workers(pkc_pool_default()), ok ? "accepted" : "rejected", report.row, report.col);
+    if (!ok || bad || report.row != 500 || report.col != 500) rc = 1;
+
+    tier_pow_challenge_t pow;
+    tier_pow_challenge_init(&pow);
+    hash256_buffer((const uint8_t *)"pool", 4, &pow.challenge);
+    tier_pow_challenge_set_complexity(&pow, 14);
+    tier_pow_solve_t solve;
+    tier_pow_solve_init(&solve);
+    uint64_t hashes = 0;
+    OpStatus_t st = tier_pow_solve_parallel(&pow, &solve, 0, NULL, &hashes);
+    printf("TierPoW solve on pool: %s after %llu hashes\n",
+           st == OP_SUCCESS && isValidTierChallenge(&pow, &solve) ? "valid" : "FAILED", (unsigned long long)hashes);
+    if (st != OP_SUCCESS || !isValidTierChallenge(&pow, &solve)) rc = 1;
+
+    pkc_pool_cancel_init(&token);
+    pkc_pool_cancel(&token);
+    tier_pow_challenge_set_complexity(&pow, 60);
+    st = tier_pow_solve_parallel(&pow, &solve, 0, &token, &hashes);
+    printf("Cancelled search: %s\n", st == OP_INVALID_STATE ? "stopped" : "not stopped");
+    if (st != OP_INVALID_STATE) rc = 1;
+
+    free(solved);
+    free(matrices);
+    printf("%s\n", rc == 0 ? "PASS" : "FAIL");
+    return rc;
+}